@@ -702,9 +702,17 @@ void AssbinImporter::InternReadFile( const std::string& pFile, aiScene* pScene,
         uLongf uncompressedSize = Read<uint32_t>(stream);
         uLongf compressedSize = static_cast<uLongf>(stream->FileSize() - stream->Tell());
 
-        unsigned char * compressedData = new unsigned char[ compressedSize ];
-        size_t len = stream->Read( compressedData, 1, compressedSize );
-        ai_assert(len == compressedSize);
+        // inflate straight from the stream contents if they are in memory already
+        const unsigned char * compressedData = stream->GetContents();
+        unsigned char * compressedCopy = nullptr;
+        size_t len = compressedSize;
+        if (compressedData) {
+            compressedData += stream->Tell();
+        } else {
+            compressedData = compressedCopy = new unsigned char[ compressedSize ];
+            len = stream->Read( compressedCopy, 1, compressedSize );
+            ai_assert(len == compressedSize);
+        }
 
         unsigned char * uncompressedData = new unsigned char[ uncompressedSize ];
 
@@ -712,7 +720,7 @@ void AssbinImporter::InternReadFile( const std::string& pFile, aiScene* pScene,
         if(res != Z_OK)
         {
             delete [] uncompressedData;
-            delete [] compressedData;
+            delete [] compressedCopy;
             pIOHandler->Close(stream);
             throw DeadlyImportError("Zlib decompression failed.");
         }
@@ -722,7 +730,7 @@ void AssbinImporter::InternReadFile( const std::string& pFile, aiScene* pScene,
         ReadBinaryScene(&io,pScene);
 
         delete[] uncompressedData;
-        delete[] compressedData;
+        delete[] compressedCopy;
     } else {
         ReadBinaryScene(stream,pScene);
     }
@@ -54,12 +54,18 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 #include <assimp/importerdesc.h>
+#include <assimp/IOSystem.hpp>
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
 #include <ios>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <cctype>
+#include <thread>
 
 using namespace Assimp;
 
@@ -472,12 +478,19 @@ void BaseImporter::TextFileToBuffer(IOStream* stream,
 namespace Assimp {
     // Represents an import request
     struct LoadRequest {
+        // Processing state of a request
+        enum State {
+            Pending,    // queued, not yet picked up by any thread
+            Loading,    // currently being imported
+            Loaded      // done, scene is available
+        };
+
         LoadRequest(const std::string& _file, unsigned int _flags,const BatchLoader::PropertyMap* _map, unsigned int _id)
         : file(_file)
         , flags(_flags)
         , refCnt(1)
         , scene(NULL)
-        , loaded(false)
+        , state(Pending)
         , id(_id) {
             if ( _map ) {
                 map = *_map;
@@ -492,12 +505,49 @@ namespace Assimp {
         unsigned int             flags;
         unsigned int             refCnt;
         aiScene                 *scene;
-        bool                     loaded;
+        State                    state;
         BatchLoader::PropertyMap map;
         unsigned int             id;
     };
 }
 
+typedef std::list<LoadRequest>::iterator LoadReqIt;
+
+// ------------------------------------------------------------------------------------------------
+// IOSystem given to the importers of BatchLoader worker threads. Importers use the directory
+// stack as scratch state during a single import, so each worker needs a stack of its own. All
+// file access is forwarded to the IOSystem shared by the batch loader.
+class BatchWorkerIOSystem : public IOSystem {
+public:
+    explicit BatchWorkerIOSystem( IOSystem* pIO )
+    : mWrapped( pIO ) {
+        ai_assert( nullptr != pIO );
+    }
+
+    bool Exists( const char* pFile ) const override {
+        return mWrapped->Exists( pFile );
+    }
+
+    char getOsSeparator() const override {
+        return mWrapped->getOsSeparator();
+    }
+
+    IOStream* Open( const char* pFile, const char* pMode = "rb" ) override {
+        return mWrapped->Open( pFile, pMode );
+    }
+
+    void Close( IOStream* pFile ) override {
+        mWrapped->Close( pFile );
+    }
+
+    bool ComparePaths( const char* one, const char* second ) const override {
+        return mWrapped->ComparePaths( one, second );
+    }
+
+private:
+    IOSystem* mWrapped;
+};
+
 // ------------------------------------------------------------------------------------------------
 // BatchLoader::pimpl data structure
 struct Assimp::BatchData {
@@ -505,7 +555,9 @@ struct Assimp::BatchData {
     : pIOSystem( pIO )
     , pImporter( nullptr )
     , next_id(0xffff)
-    , validate( validate ) {
+    , validate( validate )
+    , numThreads( 1 )
+    , shutdown( false ) {
         ai_assert( nullptr != pIO );
         
         pImporter = new Importer();
@@ -513,19 +565,121 @@ struct Assimp::BatchData {
     }
 
     ~BatchData() {
+        StopWorkers();
+
         pImporter->SetIOHandler( nullptr ); /* get pointer back into our possession */
         delete pImporter;
     }
 
+    // Spawns numThreads-1 background workers
+    void StartWorkers() {
+        for (unsigned int i = 1; i < numThreads; ++i) {
+            workers.push_back(std::thread(&BatchData::WorkerMain, this));
+        }
+    }
+
+    // Lets all workers finish their current request and joins them
+    void StopWorkers() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            shutdown = true;
+        }
+        workAvailable.notify_all();
+        for (std::thread& t : workers) {
+            t.join();
+        }
+        workers.clear();
+        shutdown = false;
+    }
+
+    // Entry point of a worker thread, each worker imports using a private importer
+    void WorkerMain() {
+        BatchWorkerIOSystem io( pIOSystem );
+        Importer importer;
+        importer.SetIOHandler( &io );
+
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            workAvailable.wait(lock, [this] { return shutdown || !pending.empty(); });
+            if (shutdown) {
+                break;
+            }
+
+            LoadRequest* req = PopPending();
+            lock.unlock();
+            Load(importer, *req);
+            lock.lock();
+        }
+        lock.unlock();
+
+        importer.SetIOHandler( nullptr );
+    }
+
+    // Takes the next pending request from the queue, must be called with the mutex held
+    LoadRequest* PopPending() {
+        if (pending.empty()) {
+            return nullptr;
+        }
+        LoadRequest* req = pending.front();
+        pending.pop_front();
+        req->state = LoadRequest::Loading;
+        return req;
+    }
+
+    // Imports a request which has been moved to the 'Loading' state by the calling thread
+    void Load(Importer& importer, LoadRequest& req) {
+        // force validation in debug builds
+        unsigned int pp = req.flags;
+        if ( validate ) {
+            pp |= aiProcess_ValidateDataStructure;
+        }
+
+        // setup config properties if necessary
+        ImporterPimpl* pimpl = importer.Pimpl();
+        pimpl->mFloatProperties  = req.map.floats;
+        pimpl->mIntProperties    = req.map.ints;
+        pimpl->mStringProperties = req.map.strings;
+        pimpl->mMatrixProperties = req.map.matrices;
+
+        if (!DefaultLogger::isNullLogger())
+        {
+            ASSIMP_LOG_INFO("%%% BEGIN EXTERNAL FILE %%%");
+            ASSIMP_LOG_INFO_F("File: ", req.file);
+        }
+        importer.ReadFile(req.file,pp);
+        aiScene* scene = importer.GetOrphanedScene();
+
+        ASSIMP_LOG_INFO("%%% END EXTERNAL FILE %%%");
+
+        BatchLoader::CompletionCallback cb;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            cb = callback;
+        }
+        if (cb) {
+            cb(req.id, scene);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            req.scene = scene;
+            req.state = LoadRequest::Loaded;
+        }
+        requestDone.notify_all();
+    }
+
     // IO system to be used for all imports
     IOSystem* pIOSystem;
 
-    // Importer used to load all meshes
+    // Importer used to load meshes on the calling thread
     Importer* pImporter;
 
     // List of all imports
     std::list<LoadRequest> requests;
 
+    // Requests not yet picked up by any thread, in FIFO order
+    std::deque<LoadRequest*> pending;
+
     // Base path
     std::string pathBase;
 
@@ -534,9 +688,28 @@ struct Assimp::BatchData {
 
     // Validation enabled state
     bool validate;
-};
 
-typedef std::list<LoadRequest>::iterator LoadReqIt;
+    // Number of threads including the calling thread
+    unsigned int numThreads;
+
+    // Background workers
+    std::vector<std::thread> workers;
+
+    // Guards requests, pending, the request states and shutdown
+    std::mutex mutex;
+
+    // Signalled when a request is queued or the workers are shut down
+    std::condition_variable workAvailable;
+
+    // Signalled whenever a request reaches the 'Loaded' state
+    std::condition_variable requestDone;
+
+    // Set to make the workers quit
+    bool shutdown;
+
+    // Invoked for every processed request
+    BatchLoader::CompletionCallback callback;
+};
 
 // ------------------------------------------------------------------------------------------------
 BatchLoader::BatchLoader(IOSystem* pIO, bool validate ) {
@@ -548,6 +721,9 @@ BatchLoader::BatchLoader(IOSystem* pIO, bool validate ) {
 // ------------------------------------------------------------------------------------------------
 BatchLoader::~BatchLoader()
 {
+    // let the workers finish before the requests go away
+    m_data->StopWorkers();
+
     // delete all scenes what have not been polled by the user
     for ( LoadReqIt it = m_data->requests.begin();it != m_data->requests.end(); ++it) {
         delete (*it).scene;
@@ -565,12 +741,40 @@ bool BatchLoader::getValidation() const {
     return m_data->validate;
 }
 
+// ------------------------------------------------------------------------------------------------
+void BatchLoader::setNumThreads( unsigned int num ) {
+    num = std::max( num, 1u );
+    if ( num == m_data->numThreads ) {
+        return;
+    }
+
+    m_data->StopWorkers();
+    m_data->numThreads = num;
+    m_data->StartWorkers();
+
+    // hand over anything queued in the meantime
+    m_data->workAvailable.notify_all();
+}
+
+// ------------------------------------------------------------------------------------------------
+unsigned int BatchLoader::getNumThreads() const {
+    return m_data->numThreads;
+}
+
+// ------------------------------------------------------------------------------------------------
+void BatchLoader::setCompletionCallback( const CompletionCallback& callback ) {
+    std::lock_guard<std::mutex> lock( m_data->mutex );
+    m_data->callback = callback;
+}
+
 // ------------------------------------------------------------------------------------------------
 unsigned int BatchLoader::AddLoadRequest(const std::string& file,
     unsigned int steps /*= 0*/, const PropertyMap* map /*= NULL*/)
 {
     ai_assert(!file.empty());
 
+    std::unique_lock<std::mutex> lock( m_data->mutex );
+
     // check whether we have this loading request already
     for ( LoadReqIt it = m_data->requests.begin();it != m_data->requests.end(); ++it)  {
         // Call IOSystem's path comparison function here
@@ -590,54 +794,85 @@ unsigned int BatchLoader::AddLoadRequest(const std::string& file,
     }
 
     // no, we don't have it. So add it to the queue ...
-    m_data->requests.push_back(LoadRequest(file,steps,map, m_data->next_id));
-    return m_data->next_id++;
+    const unsigned int id = m_data->next_id++;
+    m_data->requests.push_back(LoadRequest(file,steps,map, id));
+    m_data->pending.push_back(&m_data->requests.back());
+    lock.unlock();
+
+    m_data->workAvailable.notify_one();
+    return id;
 }
 
 // ------------------------------------------------------------------------------------------------
 aiScene* BatchLoader::GetImport( unsigned int which )
 {
+    std::unique_lock<std::mutex> lock( m_data->mutex );
+
+    LoadReqIt it = m_data->requests.begin();
+    for ( ;it != m_data->requests.end(); ++it) {
+        if ((*it).id == which) {
+            break;
+        }
+    }
+    if ( it == m_data->requests.end() ) {
+        return nullptr;
+    }
+
+    // nobody picked it up yet, so do it ourselves instead of waiting
+    LoadRequest& req = *it;
+    if ( LoadRequest::Pending == req.state ) {
+        m_data->pending.erase( std::find( m_data->pending.begin(), m_data->pending.end(), &req ) );
+        req.state = LoadRequest::Loading;
+
+        lock.unlock();
+        m_data->Load( *m_data->pImporter, req );
+        lock.lock();
+    }
+    m_data->requestDone.wait( lock, [&req] { return LoadRequest::Loaded == req.state; } );
+
+    aiScene* sc = req.scene;
+    if (!(--req.refCnt))  {
+        m_data->requests.erase(it);
+    }
+    return sc;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool BatchLoader::TryGetImport( unsigned int which, aiScene*& scene )
+{
+    std::lock_guard<std::mutex> lock( m_data->mutex );
+
     for ( LoadReqIt it = m_data->requests.begin();it != m_data->requests.end(); ++it) {
-        if ((*it).id == which && (*it).loaded)  {
-            aiScene* sc = (*it).scene;
+        if ((*it).id == which && LoadRequest::Loaded == (*it).state)  {
+            scene = (*it).scene;
             if (!(--(*it).refCnt))  {
                 m_data->requests.erase(it);
             }
-            return sc;
+            return true;
         }
     }
-    return nullptr;
+    return false;
 }
 
-
-
 // ------------------------------------------------------------------------------------------------
 void BatchLoader::LoadAll()
 {
-    // no threaded implementation for the moment
-    for ( LoadReqIt it = m_data->requests.begin();it != m_data->requests.end(); ++it) {
-        // force validation in debug builds
-        unsigned int pp = (*it).flags;
-        if ( m_data->validate ) {
-            pp |= aiProcess_ValidateDataStructure;
-        }
+    std::unique_lock<std::mutex> lock( m_data->mutex );
 
-        // setup config properties if necessary
-        ImporterPimpl* pimpl = m_data->pImporter->Pimpl();
-        pimpl->mFloatProperties  = (*it).map.floats;
-        pimpl->mIntProperties    = (*it).map.ints;
-        pimpl->mStringProperties = (*it).map.strings;
-        pimpl->mMatrixProperties = (*it).map.matrices;
+    // help the workers - or do all the work if there are none
+    while ( LoadRequest* req = m_data->PopPending() ) {
+        lock.unlock();
+        m_data->Load( *m_data->pImporter, *req );
+        lock.lock();
+    }
 
-        if (!DefaultLogger::isNullLogger())
-        {
-            ASSIMP_LOG_INFO("%%% BEGIN EXTERNAL FILE %%%");
-            ASSIMP_LOG_INFO_F("File: ", (*it).file);
+    // wait for the requests still in flight on worker threads
+    m_data->requestDone.wait( lock, [this] {
+        for ( LoadReqIt it = m_data->requests.begin();it != m_data->requests.end(); ++it) {
+            if ( LoadRequest::Loaded != (*it).state ) {
+                return false;
+            }
         }
-        m_data->pImporter->ReadFile((*it).file,pp);
-        (*it).scene = m_data->pImporter->GetOrphanedScene();
-        (*it).loaded = true;
-
-        ASSIMP_LOG_INFO("%%% END EXTERNAL FILE %%%");
-    }
+        return true;
+    } );
 }
@@ -48,6 +48,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/DefaultLogger.hpp>
 #include <assimp/scene.h>
 #include "Importer.h"
+#include "TaskScheduler.h"
 
 using namespace Assimp;
 
@@ -55,6 +56,7 @@ using namespace Assimp;
 // Constructor to be privately used by Importer
 BaseProcess::BaseProcess() AI_NO_EXCEPT
 : shared()
+, scheduler()
 , progress()
 {
 }
@@ -74,6 +76,8 @@ void BaseProcess::ExecuteOnScene( Importer* pImp)
     progress = pImp->GetProgressHandler();
     ai_assert(progress);
 
+    scheduler = pImp->Pimpl()->mTaskScheduler;
+
     SetupProperties( pImp );
 
     // catch exceptions thrown inside the PostProcess-Step
@@ -99,6 +103,19 @@ void BaseProcess::SetupProperties(const Importer* /*pImp*/)
     // the default implementation does nothing
 }
 
+// ------------------------------------------------------------------------------------------------
+void BaseProcess::ParallelFor(unsigned int count, const std::function<void(unsigned int)>& func) const
+{
+    if (scheduler) {
+        scheduler->ParallelFor(count, func);
+        return;
+    }
+
+    for (unsigned int i = 0; i < count; ++i) {
+        func(i);
+    }
+}
+
 // ------------------------------------------------------------------------------------------------
 bool BaseProcess::RequireVerboseFormat() const
 {
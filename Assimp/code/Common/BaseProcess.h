@@ -45,6 +45,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define INCLUDED_AI_BASEPROCESS_H
 
 #include <map>
+#include <functional>
 #include <assimp/GenericProperty.h>
 
 struct aiScene;
@@ -52,6 +53,7 @@ struct aiScene;
 namespace Assimp    {
 
 class Importer;
+class TaskScheduler;
 
 // ---------------------------------------------------------------------------
 /** Helper class to allow post-processing steps to interact with each other.
@@ -275,11 +277,36 @@ public:
         return shared;
     }
 
+    // -------------------------------------------------------------------
+    /** Assign the task scheduler the step may use to process meshes
+     *  concurrently. ExecuteOnScene() assigns the Importer's scheduler.
+     * @param sched May be NULL, the step runs serially then
+    */
+    inline void SetTaskScheduler(TaskScheduler* sched)  {
+        scheduler = sched;
+    }
+
+protected:
+
+    // -------------------------------------------------------------------
+    /** Invoke a function for every index in [0,count). The calls are
+     *  spread over the threads of the assigned task scheduler, if there
+     *  is one. Results must be stored per index and reduced in index order
+     *  afterwards, so the output does not depend on the thread count.
+     * @param count Number of indices, usually pScene->mNumMeshes
+     * @param func Function to invoke, must not touch data shared
+     *   between indices
+    */
+    void ParallelFor(unsigned int count, const std::function<void(unsigned int)>& func) const;
+
 protected:
 
     /** See the doc of #SharedPostProcessInfo for more details */
     SharedPostProcessInfo* shared;
 
+    /** Task scheduler for per-mesh work, may be NULL */
+    TaskScheduler* scheduler;
+
     /** Currently active progress handler */
     ProgressHandler* progress;
 };
@@ -64,6 +64,11 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
     std::mutex loggerMutex;
 #endif
 
+// Post-processing steps may log from the importer's worker threads
+// (AI_CONFIG_GLOB_MULTITHREADING), so the stream output is always guarded.
+#include <mutex>
+static std::mutex gStreamMutex;
+
 namespace Assimp    {
 
 // ----------------------------------------------------------------------------------
@@ -370,6 +375,8 @@ DefaultLogger::~DefaultLogger() {
 void DefaultLogger::WriteToStreams(const char *message, ErrorSeverity ErrorSev ) {
     ai_assert(nullptr != message);
 
+    std::lock_guard<std::mutex> lock(gStreamMutex);
+
     // Check whether this is a repeated message
     if (! ::strncmp( message,lastMsg, lastLen-1))
     {
@@ -70,6 +70,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "PostProcessing/ProcessHelper.h"
 #include "Common/ScenePreprocessor.h"
 #include "Common/ScenePrivate.h"
+#include "Common/TaskScheduler.h"
 
 #include <assimp/BaseImporter.h>
 #include <assimp/GenericProperty.h>
@@ -104,6 +105,22 @@ namespace Assimp {
 using namespace Assimp;
 using namespace Assimp::Intern;
 
+// ------------------------------------------------------------------------------------------------
+// Creates, recreates or drops the worker threads to match AI_CONFIG_GLOB_MULTITHREADING.
+// -1 lets us decide, which currently means staying on the calling thread.
+static void SetupTaskScheduler(ImporterPimpl* pimpl, int numThreads)
+{
+    if (numThreads > 1) {
+        if (!pimpl->mTaskScheduler || pimpl->mTaskScheduler->GetNumThreads() != static_cast<unsigned int>(numThreads)) {
+            delete pimpl->mTaskScheduler;
+            pimpl->mTaskScheduler = new TaskScheduler(static_cast<unsigned int>(numThreads));
+        }
+    } else {
+        delete pimpl->mTaskScheduler;
+        pimpl->mTaskScheduler = nullptr;
+    }
+}
+
 // ------------------------------------------------------------------------------------------------
 // Intern::AllocateFromAssimpHeap serves as abstract base class. It overrides
 // new and delete (and their array counterparts) of public API classes (e.g. Logger) to
@@ -193,6 +210,9 @@ Importer::~Importer()
     // Delete shared post-processing data
     delete pimpl->mPPShared;
 
+    // Join the post-processing worker threads
+    delete pimpl->mTaskScheduler;
+
     // and finally the pimpl itself
     delete pimpl;
 }
@@ -639,6 +659,9 @@ const aiScene* Importer::ReadFile( const char* _pFile, unsigned int pFlags)
         ASSIMP_LOG_INFO("Found a matching importer for this file format: " + ext + "." );
         pimpl->mProgressHandler->UpdateFileRead( 0, fileSize );
 
+        // Importers may spread their work over worker threads, too
+        SetupTaskScheduler(pimpl, GetPropertyInteger(AI_CONFIG_GLOB_MULTITHREADING, -1));
+
         if (profiler) {
             profiler->BeginRegion("import");
         }
@@ -760,6 +783,9 @@ const aiScene* Importer::ApplyPostProcessing(unsigned int pFlags)
     }
 #endif // ! DEBUG
 
+    // Spread the per-mesh work of the steps over worker threads if requested.
+    SetupTaskScheduler(pimpl, GetPropertyInteger(AI_CONFIG_GLOB_MULTITHREADING, -1));
+
     std::unique_ptr<Profiler> profiler(GetPropertyInteger(AI_CONFIG_GLOB_MEASURE_TIME,0)?new Profiler():NULL);
     for( unsigned int a = 0; a < pimpl->mPostProcessingSteps.size(); a++)   {
 
@@ -46,6 +46,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define INCLUDED_AI_IMPORTER_H
 
 #include <map>
+#include <functional>
 #include <vector>
 #include <string>
 #include <assimp/matrix4x4.h>
@@ -58,6 +59,7 @@ namespace Assimp    {
     class BaseImporter;
     class BaseProcess;
     class SharedPostProcessInfo;
+    class TaskScheduler;
 
 
 //! @cond never
@@ -119,6 +121,10 @@ public:
     /** Used by post-process steps to share data */
     SharedPostProcessInfo* mPPShared;
 
+    /** Worker threads for importers and the post-processing pipeline,
+     *  NULL unless #AI_CONFIG_GLOB_MULTITHREADING asks for them */
+    TaskScheduler* mTaskScheduler;
+
     /// The default class constructor.
     ImporterPimpl() AI_NO_EXCEPT;
 };
@@ -138,7 +144,8 @@ ImporterPimpl::ImporterPimpl() AI_NO_EXCEPT
 , mStringProperties()
 , mMatrixProperties()
 , bExtraVerbose( false )
-, mPPShared( nullptr ) {
+, mPPShared( nullptr )
+, mTaskScheduler( nullptr ) {
     // empty
 }
 //! @endcond
@@ -150,10 +157,14 @@ struct BatchData;
 /** FOR IMPORTER PLUGINS ONLY: A helper class to the pleasure of importers
  *  that need to load many external meshes recursively.
  *
- *  The class uses several threads to load these meshes (or at least it
- *  could, this has not yet been implemented at the moment).
+ *  The class can use several threads to load these meshes, see
+ *  #setNumThreads. Each worker thread owns a private #Importer, all of
+ *  them share the IOSystem passed to the constructor - which must thus
+ *  be safe to use from several threads if more than one thread is
+ *  requested.
  *
- *  @note The class may not be used by more than one thread*/
+ *  @note The public interface may not be used by more than one thread
+ *    at a time. Only the completion callback is invoked from workers. */
 class ASSIMP_API BatchLoader
 {
     // friend of Importer
@@ -181,6 +192,17 @@ public:
     };
     //! @endcond
 
+    // -------------------------------------------------------------------
+    /** Callback invoked whenever a load request has been processed.
+     *  The first argument is the 'load request channel' returned by
+     *  AddLoadRequest(), the second the imported scene or NULL if the
+     *  import failed. The scene remains owned by the batch loader,
+     *  use GetImport() to take it.
+     *
+     *  The callback runs on the thread that performed the import,
+     *  right before the scene becomes available via TryGetImport(). */
+    typedef std::function<void(unsigned int, const aiScene*)> CompletionCallback;
+
 public:
     // -------------------------------------------------------------------
     /** Construct a batch loader from a given IO system to be used
@@ -204,7 +226,30 @@ public:
      *  @return The current validation step.
      */
     bool getValidation() const;
-    
+
+    // -------------------------------------------------------------------
+    /** Sets the number of threads used to process load requests.
+     *  The count includes the calling thread, so 0 and 1 load all
+     *  requests serially from LoadAll() and GetImport() - which is
+     *  the default. With more threads, requests are picked up by
+     *  background workers as soon as they are added.
+     *  @param  num  Number of threads.
+     */
+    void setNumThreads( unsigned int num );
+
+    // -------------------------------------------------------------------
+    /** Returns the number of threads used to process load requests.
+     *  @return The thread count, including the calling thread.
+     */
+    unsigned int getNumThreads() const;
+
+    // -------------------------------------------------------------------
+    /** Sets the callback to be invoked for every processed request.
+     *  @param  callback  The callback, pass an empty function to
+     *    remove a previously set callback.
+     */
+    void setCompletionCallback( const CompletionCallback& callback );
+
     // -------------------------------------------------------------------
     /** Add a new file to the list of files to be loaded.
      *  @param file File to be loaded
@@ -223,15 +268,31 @@ public:
     /** Get an imported scene.
      *  This polls the import from the internal request list.
      *  If an import is requested several times, this function
-     *  can be called several times, too.
+     *  can be called several times, too. If the scene hasn't been
+     *  loaded yet, the function waits for a worker to finish it
+     *  or loads it on the calling thread.
      *
      *  @param which LRWC returned by AddLoadRequest().
      *  @return NULL if there is no scene with this file name
-     *  in the queue of the scene hasn't been loaded yet. */
+     *  in the queue or the import failed. */
     aiScene* GetImport(
         unsigned int which
         );
 
+    // -------------------------------------------------------------------
+    /** Non-blocking version of GetImport().
+     *
+     *  @param which LRWC returned by AddLoadRequest().
+     *  @param scene Receives the scene if the request has been
+     *    processed, NULL if the import failed.
+     *  @return false if there is no request with this id or if it
+     *    hasn't been processed yet. The request is left untouched
+     *    in that case. */
+    bool TryGetImport(
+        unsigned int which,
+        aiScene*& scene
+        );
+
     // -------------------------------------------------------------------
     /** Waits until all scenes have been loaded. This returns
      *  immediately if no scenes are queued.*/
@@ -0,0 +1,233 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2019, assimp team
+
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+/** @file  MMapIOSystem.cpp
+ *  @brief Implementation of IOSystem mapping files into memory
+ */
+
+#include <assimp/MMapIOSystem.h>
+#include <assimp/ai_assert.h>
+
+#include <algorithm>
+#include <string.h>
+
+#ifdef _WIN32
+#   include <windows.h>
+#else
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
+using namespace Assimp;
+
+#ifdef _WIN32
+static std::wstring Utf8ToWide(const char* in)
+{
+    int size = MultiByteToWideChar(CP_UTF8, 0, in, -1, nullptr, 0);
+    // size includes terminating null; std::wstring adds null automatically
+    std::wstring out(static_cast<size_t>(size) - 1, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, in, -1, &out[0], size);
+    return out;
+}
+#endif
+
+// ----------------------------------------------------------------------------------
+MMapIOStream::MMapIOStream(const uint8_t* data, size_t size) AI_NO_EXCEPT
+: mData(data)
+, mSize(size)
+, mPos(0) {
+    // empty
+}
+
+// ----------------------------------------------------------------------------------
+MMapIOStream::~MMapIOStream()
+{
+    if (mData) {
+#ifdef _WIN32
+        ::UnmapViewOfFile(mData);
+#else
+        ::munmap(const_cast<uint8_t*>(mData), mSize);
+#endif
+        mData = nullptr;
+    }
+}
+
+// ----------------------------------------------------------------------------------
+size_t MMapIOStream::Read(void* pvBuffer,
+    size_t pSize,
+    size_t pCount)
+{
+    ai_assert(NULL != pvBuffer && 0 != pSize && 0 != pCount);
+
+    const size_t cnt = std::min(pCount, (mSize - mPos) / pSize);
+    const size_t ofs = pSize * cnt;
+    if (ofs) {
+        ::memcpy(pvBuffer, mData + mPos, ofs);
+        mPos += ofs;
+    }
+    return cnt;
+}
+
+// ----------------------------------------------------------------------------------
+size_t MMapIOStream::Write(const void* /*pvBuffer*/,
+    size_t /*pSize*/,
+    size_t /*pCount*/)
+{
+    return 0;
+}
+
+// ----------------------------------------------------------------------------------
+aiReturn MMapIOStream::Seek(size_t pOffset,
+    aiOrigin pOrigin)
+{
+    if (aiOrigin_SET == pOrigin) {
+        if (pOffset > mSize) {
+            return AI_FAILURE;
+        }
+        mPos = pOffset;
+    } else if (aiOrigin_END == pOrigin) {
+        if (pOffset > mSize) {
+            return AI_FAILURE;
+        }
+        mPos = mSize - pOffset;
+    } else {
+        if (pOffset + mPos > mSize) {
+            return AI_FAILURE;
+        }
+        mPos += pOffset;
+    }
+    return AI_SUCCESS;
+}
+
+// ----------------------------------------------------------------------------------
+size_t MMapIOStream::Tell() const
+{
+    return mPos;
+}
+
+// ----------------------------------------------------------------------------------
+size_t MMapIOStream::FileSize() const
+{
+    return mSize;
+}
+
+// ----------------------------------------------------------------------------------
+void MMapIOStream::Flush()
+{
+    // empty
+}
+
+// ----------------------------------------------------------------------------------
+const uint8_t* MMapIOStream::GetContents() const
+{
+    return mData;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Open a new file with a given path.
+IOStream* MMapIOSystem::Open(const char* strFile, const char* strMode)
+{
+    ai_assert(strFile != nullptr);
+    ai_assert(strMode != nullptr);
+
+    // only plain reads are served from a mapping
+    if (strpbrk(strMode, "wa+")) {
+        return DefaultIOSystem::Open(strFile, strMode);
+    }
+
+#ifdef _WIN32
+    HANDLE file = ::CreateFileW(Utf8ToWide(strFile).c_str(), GENERIC_READ, FILE_SHARE_READ,
+        nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (INVALID_HANDLE_VALUE == file) {
+        return nullptr;
+    }
+
+    LARGE_INTEGER size;
+    if (!::GetFileSizeEx(file, &size)) {
+        ::CloseHandle(file);
+        return DefaultIOSystem::Open(strFile, strMode);
+    }
+
+    // mapping an empty file fails, so don't even try
+    const void* data = nullptr;
+    if (size.QuadPart > 0) {
+        HANDLE mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping) {
+            data = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            ::CloseHandle(mapping);
+        }
+    }
+    ::CloseHandle(file);
+
+    if (size.QuadPart > 0 && !data) {
+        return DefaultIOSystem::Open(strFile, strMode);
+    }
+    return new MMapIOStream(static_cast<const uint8_t*>(data), static_cast<size_t>(size.QuadPart));
+#else
+    const int fd = ::open(strFile, O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    // pipes, devices and the like can't be mapped
+    struct stat info;
+    if (0 != ::fstat(fd, &info) || !S_ISREG(info.st_mode)) {
+        ::close(fd);
+        return DefaultIOSystem::Open(strFile, strMode);
+    }
+
+    // mapping an empty file fails, so don't even try
+    const size_t size = static_cast<size_t>(info.st_size);
+    void* data = nullptr;
+    if (size > 0) {
+        data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd);
+
+    if (MAP_FAILED == data) {
+        return DefaultIOSystem::Open(strFile, strMode);
+    }
+    return new MMapIOStream(static_cast<const uint8_t*>(data), size);
+#endif
+}
@@ -0,0 +1,446 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2019, assimp team
+
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+/** @file Implementation of the uniform grid to quickly find vertices close to a given position */
+
+#include <assimp/SpatialGrid.h>
+#include <assimp/ai_assert.h>
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+using namespace Assimp;
+
+namespace {
+
+    // Number of bits of each packed cell coordinate, three of them make up a cell key.
+    const unsigned int CellBits = 21;
+    const int MaxCellsPerAxis = 1 << CellBits;
+
+    // Marks an empty slot of the cell table. No packed key ever sets the topmost bit.
+    const uint64_t EmptyCell = ~uint64_t(0);
+
+    // Average number of positions per cell the cell size is chosen for.
+    const double PositionsPerCell = 2.0;
+
+    // Identical positions are at most a few denormals apart, this search range safely
+    // contains them whatever cell boundary lies in between.
+    const ai_real IdenticalRange = ai_real( 1e-20 );
+
+    // --------------------------------------------------------------------------------------------
+    uint64_t PackCell(int x, int y, int z) {
+        return uint64_t(x) | (uint64_t(y) << CellBits) | (uint64_t(z) << (2 * CellBits));
+    }
+
+    // --------------------------------------------------------------------------------------------
+    size_t HashCell(uint64_t key, size_t mask) {
+        // Fibonacci hashing, the high bits of the product are the well-mixed ones
+        return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+    }
+
+    // --------------------------------------------------------------------------------------------
+    // Checks a squared distance against the tolerance of SpatialSort::FindIdenticalPositions(),
+    // which accepts squared distances up to six units in the last place. A squared length is
+    // never negative, so its bit pattern orders the same way as its value.
+    bool IsIdentical(ai_real squareLength) {
+        static const ai_uint distance3DToleranceInULPs = 6;
+        static_assert(sizeof(ai_uint) == sizeof(ai_real), "sizeof(ai_uint) == sizeof(ai_real)");
+        ai_uint binValue;
+        ::memcpy(&binValue, &squareLength, sizeof(binValue));
+        return binValue <= distance3DToleranceInULPs;
+    }
+
+} // namespace
+
+// ------------------------------------------------------------------------------------------------
+// Constructs a grid from the given position array.
+SpatialGrid::SpatialGrid( const aiVector3D* pPositions, unsigned int pNumPositions,
+    unsigned int pElementOffset)
+: mNumCells( 0 )
+, mMin()
+, mInvCellSize( 1 )
+{
+    mDims[0] = mDims[1] = mDims[2] = 0;
+    Fill(pPositions,pNumPositions,pElementOffset);
+}
+
+// ------------------------------------------------------------------------------------------------
+SpatialGrid::SpatialGrid()
+: mNumCells( 0 )
+, mMin()
+, mInvCellSize( 1 )
+{
+    mDims[0] = mDims[1] = mDims[2] = 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Destructor
+SpatialGrid::~SpatialGrid()
+{
+    // nothing to do here, everything destructs automatically
+}
+
+// ------------------------------------------------------------------------------------------------
+void SpatialGrid::Fill( const aiVector3D* pPositions, unsigned int pNumPositions,
+    unsigned int pElementOffset,
+    bool pFinalize /*= true */)
+{
+    mPositions.clear();
+    Append(pPositions,pNumPositions,pElementOffset,pFinalize);
+}
+
+// ------------------------------------------------------------------------------------------------
+void SpatialGrid::Append( const aiVector3D* pPositions, unsigned int pNumPositions,
+    unsigned int pElementOffset,
+    bool pFinalize /*= true */)
+{
+    // Finalize() reorders the entries, bring them back into index order first
+    if (!mCells.empty()) {
+        std::vector<Entry> byIndex(mPositions.size());
+        for (const Entry& e : mPositions) {
+            byIndex[e.mIndex] = e;
+        }
+        mPositions.swap(byIndex);
+        mCells.clear();
+        mNumCells = 0;
+    }
+
+    const size_t initial = mPositions.size();
+    mPositions.reserve(initial + (pFinalize?pNumPositions:pNumPositions*2));
+    for( unsigned int a = 0; a < pNumPositions; a++)
+    {
+        const char* tempPointer = reinterpret_cast<const char*> (pPositions);
+        const aiVector3D* vec   = reinterpret_cast<const aiVector3D*> (tempPointer + a * pElementOffset);
+        mPositions.push_back( Entry( static_cast<unsigned int>(a+initial), *vec));
+    }
+
+    if (pFinalize) {
+        Finalize();
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void SpatialGrid::Finalize()
+{
+    mCells.clear();
+    mNumCells = 0;
+    mEntryOfIndex.resize(mPositions.size());
+    if (mPositions.empty()) {
+        mDims[0] = mDims[1] = mDims[2] = 0;
+        return;
+    }
+
+    // bounding box of all finite positions
+    aiVector3D minVec( ai_real( 1e10 ), ai_real( 1e10 ), ai_real( 1e10 ) );
+    aiVector3D maxVec( ai_real( -1e10 ), ai_real( -1e10 ), ai_real( -1e10 ) );
+    for (const Entry& e : mPositions) {
+        for (unsigned int a = 0; a < 3; ++a) {
+            if (e.mPosition[a] < minVec[a]) minVec[a] = e.mPosition[a];
+            if (e.mPosition[a] > maxVec[a]) maxVec[a] = e.mPosition[a];
+        }
+    }
+
+    // Choose the cell size so that the cells spanned by the non-flat axes hold about
+    // PositionsPerCell positions each. Axes thinner than a cell do not contribute to
+    // the cell count, so they are dropped and the size is recomputed for the others.
+    double extent[3];
+    bool active[3];
+    for (unsigned int a = 0; a < 3; ++a) {
+        if (minVec[a] > maxVec[a]) {
+            minVec[a] = maxVec[a] = ai_real( 0 );
+        }
+        extent[a] = double(maxVec[a]) - double(minVec[a]);
+        active[a] = extent[a] > 0.0;
+    }
+    const double numCells = std::max(1.0, double(mPositions.size()) / PositionsPerCell);
+    double cellSize = 0.0;
+    for (unsigned int pass = 0; pass < 3; ++pass) {
+        double volume = 1.0;
+        unsigned int numActive = 0;
+        for (unsigned int a = 0; a < 3; ++a) {
+            if (active[a]) {
+                volume *= extent[a];
+                ++numActive;
+            }
+        }
+        if (!numActive) {
+            break;
+        }
+        cellSize = std::pow(volume / numCells, 1.0 / numActive);
+
+        bool dropped = false;
+        for (unsigned int a = 0; a < 3; ++a) {
+            if (active[a] && extent[a] < cellSize) {
+                active[a] = false;
+                dropped = true;
+            }
+        }
+        if (!dropped) {
+            break;
+        }
+    }
+
+    // keep each cell coordinate within its bits of the cell key
+    const double maxExtent = std::max(extent[0], std::max(extent[1], extent[2]));
+    cellSize = std::max(cellSize, maxExtent / (MaxCellsPerAxis - 2));
+    if (!(cellSize > 0.0) || !std::isfinite(cellSize)) {
+        cellSize = 1.0;
+    }
+
+    mMin = minVec;
+    mInvCellSize = ai_real( 1.0 / cellSize );
+    for (unsigned int a = 0; a < 3; ++a) {
+        mDims[a] = MaxCellsPerAxis;
+        mDims[a] = std::min(ToCell(maxVec[a], a) + 1, MaxCellsPerAxis);
+    }
+
+    // bucket the positions by cell, keeping them in index order within each cell
+    for (Entry& e : mPositions) {
+        int c[3];
+        for (unsigned int a = 0; a < 3; ++a) {
+            c[a] = std::max(0, std::min(ToCell(e.mPosition[a], a), mDims[a] - 1));
+        }
+        e.mCell = PackCell(c[0], c[1], c[2]);
+    }
+    std::sort(mPositions.begin(), mPositions.end(), [](const Entry& a, const Entry& b) {
+        return a.mCell < b.mCell || (a.mCell == b.mCell && a.mIndex < b.mIndex);
+    });
+
+    for (size_t i = 0; i < mPositions.size(); ++i) {
+        mEntryOfIndex[mPositions[i].mIndex] = static_cast<unsigned int>(i);
+        if (!i || mPositions[i].mCell != mPositions[i-1].mCell) {
+            ++mNumCells;
+        }
+    }
+
+    // build the cell table with a load factor of at most one half
+    size_t capacity = 8;
+    while (capacity < size_t(mNumCells) * 2) {
+        capacity *= 2;
+    }
+    Cell empty;
+    empty.mKey = EmptyCell;
+    empty.mBegin = empty.mEnd = 0;
+    mCells.assign(capacity, empty);
+
+    const size_t mask = capacity - 1;
+    for (size_t begin = 0; begin < mPositions.size();) {
+        const uint64_t key = mPositions[begin].mCell;
+        size_t end = begin + 1;
+        while (end < mPositions.size() && mPositions[end].mCell == key) {
+            ++end;
+        }
+
+        size_t slot = HashCell(key, mask);
+        while (mCells[slot].mKey != EmptyCell) {
+            slot = (slot + 1) & mask;
+        }
+        mCells[slot].mKey = key;
+        mCells[slot].mBegin = static_cast<unsigned int>(begin);
+        mCells[slot].mEnd = static_cast<unsigned int>(end);
+        begin = end;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+int SpatialGrid::ToCell( ai_real pValue, unsigned int pAxis) const
+{
+    // The mapping is monotonic, so a position within [p-r,p+r] always falls into a cell
+    // between the ones of p-r and p+r. Out of range values are clamped to one cell outside.
+    const ai_real c = (pValue - mMin[pAxis]) * mInvCellSize;
+    if (!(c >= ai_real( 0 ))) {
+        return -1;
+    }
+    if (c >= ai_real( mDims[pAxis] )) {
+        return mDims[pAxis];
+    }
+    return static_cast<int>(c);
+}
+
+// ------------------------------------------------------------------------------------------------
+const SpatialGrid::Cell* SpatialGrid::FindCell( uint64_t pKey) const
+{
+    const size_t mask = mCells.size() - 1;
+    for (size_t slot = HashCell(pKey, mask);; slot = (slot + 1) & mask) {
+        const Cell& cell = mCells[slot];
+        if (cell.mKey == pKey) {
+            return &cell;
+        }
+        if (cell.mKey == EmptyCell) {
+            return NULL;
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void SpatialGrid::Query( const aiVector3D& pPosition, ai_real pRadius, bool pIdentical,
+    std::vector<unsigned int>& poResults) const
+{
+    if (mCells.empty()) {
+        return;
+    }
+
+    int lo[3], hi[3];
+    uint64_t numVisited = 1;
+    for (unsigned int a = 0; a < 3; ++a) {
+        lo[a] = ToCell(pPosition[a] - pRadius, a);
+        hi[a] = ToCell(pPosition[a] + pRadius, a);
+        if (hi[a] < 0 || lo[a] >= mDims[a]) {
+            return;
+        }
+        lo[a] = std::max(lo[a], 0);
+        hi[a] = std::min(hi[a], mDims[a] - 1);
+        numVisited *= uint64_t(hi[a] - lo[a] + 1);
+    }
+
+    const size_t first = poResults.size();
+    const ai_real pSquared = pRadius*pRadius;
+    bool sorted = true;
+    if (numVisited > mNumCells) {
+        // the radius is huge compared to the cells, a linear scan is cheaper
+        sorted = false;
+        for (const Entry& e : mPositions) {
+            const ai_real squareLength = (e.mPosition - pPosition).SquareLength();
+            if (pIdentical ? IsIdentical(squareLength) : squareLength < pSquared) {
+                poResults.push_back(e.mIndex);
+            }
+        }
+    }
+    else {
+        for (int z = lo[2]; z <= hi[2]; ++z) {
+            for (int y = lo[1]; y <= hi[1]; ++y) {
+                for (int x = lo[0]; x <= hi[0]; ++x) {
+                    const Cell* cell = FindCell(PackCell(x, y, z));
+                    if (!cell) {
+                        continue;
+                    }
+                    const size_t cellFirst = poResults.size();
+                    for (unsigned int i = cell->mBegin; i < cell->mEnd; ++i) {
+                        const Entry& e = mPositions[i];
+                        const ai_real squareLength = (e.mPosition - pPosition).SquareLength();
+                        if (pIdentical ? IsIdentical(squareLength) : squareLength < pSquared) {
+                            poResults.push_back(e.mIndex);
+                        }
+                    }
+                    // each cell is in index order, only results from several cells need sorting
+                    if (cellFirst != first && cellFirst != poResults.size()) {
+                        sorted = false;
+                    }
+                }
+            }
+        }
+    }
+    if (!sorted) {
+        std::sort(poResults.begin() + first, poResults.end());
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void SpatialGrid::FindPositions( const aiVector3D& pPosition,
+    ai_real pRadius, std::vector<unsigned int>& poResults) const
+{
+    poResults.resize( 0 );
+    Query(pPosition, pRadius, false, poResults);
+}
+
+// ------------------------------------------------------------------------------------------------
+void SpatialGrid::FindIdenticalPositions( const aiVector3D& pPosition,
+    std::vector<unsigned int>& poResults) const
+{
+    poResults.resize( 0 );
+    Query(pPosition, IdenticalRange, true, poResults);
+}
+
+// ------------------------------------------------------------------------------------------------
+void SpatialGrid::FindAllPositions( ai_real pRadius, std::vector<unsigned int>& poOffsets,
+    std::vector<unsigned int>& poResults) const
+{
+    poOffsets.resize(mPositions.size() + 1);
+    poResults.resize( 0 );
+    poResults.reserve(mPositions.size() * 2);
+    for (size_t i = 0; i < mPositions.size(); ++i) {
+        poOffsets[i] = static_cast<unsigned int>(poResults.size());
+        Query(mPositions[mEntryOfIndex[i]].mPosition, pRadius, false, poResults);
+    }
+    poOffsets.back() = static_cast<unsigned int>(poResults.size());
+}
+
+// ------------------------------------------------------------------------------------------------
+void SpatialGrid::FindAllIdenticalPositions( std::vector<unsigned int>& poOffsets,
+    std::vector<unsigned int>& poResults) const
+{
+    poOffsets.resize(mPositions.size() + 1);
+    poResults.resize( 0 );
+    poResults.reserve(mPositions.size() * 2);
+    for (size_t i = 0; i < mPositions.size(); ++i) {
+        poOffsets[i] = static_cast<unsigned int>(poResults.size());
+        Query(mPositions[mEntryOfIndex[i]].mPosition, IdenticalRange, true, poResults);
+    }
+    poOffsets.back() = static_cast<unsigned int>(poResults.size());
+}
+
+// ------------------------------------------------------------------------------------------------
+unsigned int SpatialGrid::GenerateMappingTable(std::vector<unsigned int>& fill, ai_real pRadius) const
+{
+    fill.assign(mPositions.size(),UINT_MAX);
+
+    unsigned int t=0;
+    std::vector<unsigned int> found;
+    for (size_t i = 0; i < mPositions.size(); ++i) {
+        if (fill[i] != UINT_MAX) {
+            continue;
+        }
+        fill[i] = t;
+
+        FindPositions(mPositions[mEntryOfIndex[i]].mPosition, pRadius, found);
+        for (unsigned int idx : found) {
+            if (fill[idx] == UINT_MAX) {
+                fill[idx] = t;
+            }
+        }
+        ++t;
+    }
+    return t;
+}
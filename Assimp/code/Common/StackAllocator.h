@@ -0,0 +1,98 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2019, assimp team
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file StackAllocator.h
+ *  @brief Defines a monotonic allocator handing out memory from a few large
+ *    blocks, for parsers creating huge numbers of short-lived objects.
+ */
+#pragma once
+#ifndef AI_STACKALLOCATOR_H_INC
+#define AI_STACKALLOCATOR_H_INC
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Assimp {
+
+// --------------------------------------------------------------------------------------------
+/** @brief A monotonic (stack) allocator.
+ *
+ *  Memory is carved from blocks that grow geometrically up to a fixed size,
+ *  individual allocations are never freed. All memory is released at once
+ *  when the allocator is destroyed or #FreeAll() is called. The allocator does
+ *  not run destructors, objects placed into it have to be destroyed by hand.
+ *
+ *  @note The allocator is not thread-safe. */
+// --------------------------------------------------------------------------------------------
+class StackAllocator {
+public:
+    StackAllocator();
+    ~StackAllocator();
+
+    // --------------------------------------------------------------------
+    /** @brief Returns a block of byteSize bytes, suitably aligned for
+     *    any fundamental type. */
+    void *Allocate(size_t byteSize);
+
+    // --------------------------------------------------------------------
+    /** @brief Releases all memory handed out so far. */
+    void FreeAll();
+
+private:
+    StackAllocator(const StackAllocator &) = delete;
+    StackAllocator &operator=(const StackAllocator &) = delete;
+
+    static const size_t StartBytesPerBlock = 16 * 1024;
+    static const size_t MaxBytesPerBlock = 64 * 1024 * 1024;
+
+    std::vector<uint8_t *> blocks;
+    size_t blockSize;
+    size_t blockUsed;
+    size_t nextBlockSize;
+};
+
+} // Namespace Assimp
+
+#include "StackAllocator.inl"
+
+#endif // AI_STACKALLOCATOR_H_INC
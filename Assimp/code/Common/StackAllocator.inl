@@ -0,0 +1,93 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2019, assimp team
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file StackAllocator.inl
+ *  @brief Inline implementation of the monotonic #StackAllocator.
+ */
+
+namespace Assimp {
+
+// --------------------------------------------------------------------------------------------
+inline StackAllocator::StackAllocator()
+: blocks()
+, blockSize(0)
+, blockUsed(0)
+, nextBlockSize(StartBytesPerBlock) {
+    // empty
+}
+
+// --------------------------------------------------------------------------------------------
+inline StackAllocator::~StackAllocator() {
+    FreeAll();
+}
+
+// --------------------------------------------------------------------------------------------
+inline void *StackAllocator::Allocate(size_t byteSize) {
+    // keep every allocation aligned for the most demanding fundamental type
+    const size_t alignment = alignof(std::max_align_t);
+    byteSize = (byteSize + alignment - 1) & ~(alignment - 1);
+
+    if (blocks.empty() || blockUsed + byteSize > blockSize) {
+        // oversized requests get a block of their own
+        blockSize = byteSize > nextBlockSize ? byteSize : nextBlockSize;
+        blocks.push_back(new uint8_t[blockSize]);
+        blockUsed = 0;
+        nextBlockSize = nextBlockSize * 2 < MaxBytesPerBlock ? nextBlockSize * 2 : MaxBytesPerBlock;
+    }
+
+    void *p = blocks.back() + blockUsed;
+    blockUsed += byteSize;
+    return p;
+}
+
+// --------------------------------------------------------------------------------------------
+inline void StackAllocator::FreeAll() {
+    for (uint8_t *block : blocks) {
+        delete[] block;
+    }
+    blocks.clear();
+    blockSize = 0;
+    blockUsed = 0;
+    nextBlockSize = StartBytesPerBlock;
+}
+
+} // Namespace Assimp
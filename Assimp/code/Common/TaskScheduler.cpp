@@ -0,0 +1,227 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2019, assimp team
+
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+/** @file Implementation of the TaskScheduler helper class
+ */
+
+#include "TaskScheduler.h"
+#include <assimp/ai_assert.h>
+
+#include <algorithm>
+#include <cstdint>
+
+using namespace Assimp;
+
+namespace {
+    // Set while a thread executes a job, nested jobs run serially there
+    thread_local bool gInsideJob = false;
+}
+
+// ------------------------------------------------------------------------------------------------
+TaskScheduler::TaskScheduler(unsigned int numThreads)
+: mQueues()
+, mWorkers()
+, mJobMutex()
+, mJobPosted()
+, mJobDone()
+, mJobId( 0 )
+, mShutdown( false )
+, mJob( nullptr )
+, mRemaining( 0 )
+, mErrorMutex()
+, mErrorIndex( 0 )
+, mError() {
+    numThreads = std::max(numThreads, 1u);
+    for (unsigned int i = 0; i < numThreads; ++i) {
+        mQueues.push_back(new Queue());
+    }
+
+    // queue 0 is served by whoever calls ParallelFor()
+    for (unsigned int i = 1; i < numThreads; ++i) {
+        mWorkers.emplace_back(&TaskScheduler::WorkerMain, this, i);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+TaskScheduler::~TaskScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(mJobMutex);
+        mShutdown = true;
+    }
+    mJobPosted.notify_all();
+
+    for (std::thread& worker : mWorkers) {
+        worker.join();
+    }
+    for (Queue* queue : mQueues) {
+        delete queue;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void TaskScheduler::ParallelFor(unsigned int count, const std::function<void(unsigned int)>& func) {
+    if (0 == count) {
+        return;
+    }
+
+    // nothing to gain from waking up the workers
+    if (mWorkers.empty() || 1 == count || gInsideJob) {
+        for (unsigned int i = 0; i < count; ++i) {
+            func(i);
+        }
+        return;
+    }
+
+    ai_assert(nullptr == mJob);
+    mJob = &func;
+    mError = nullptr;
+    mErrorIndex = count;
+    mRemaining = count;
+
+    // hand every thread a contiguous block of indices, stealing balances the rest
+    const unsigned int numQueues = GetNumThreads();
+    for (unsigned int q = 0; q < numQueues; ++q) {
+        const unsigned int begin = static_cast<unsigned int>((static_cast<uint64_t>(count) * q) / numQueues);
+        const unsigned int end = static_cast<unsigned int>((static_cast<uint64_t>(count) * (q + 1)) / numQueues);
+
+        std::lock_guard<std::mutex> lock(mQueues[q]->mMutex);
+        for (unsigned int i = begin; i < end; ++i) {
+            mQueues[q]->mIndices.push_back(i);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mJobMutex);
+        ++mJobId;
+    }
+    mJobPosted.notify_all();
+
+    // the calling thread helps out until all queues are empty
+    gInsideJob = true;
+    unsigned int index;
+    while (PopIndex(0, index)) {
+        RunIndex(index);
+    }
+    gInsideJob = false;
+
+    // wait for the invocations still running on the workers
+    {
+        std::unique_lock<std::mutex> lock(mJobMutex);
+        mJobDone.wait(lock, [this] { return 0 == mRemaining.load(); });
+    }
+    mJob = nullptr;
+
+    if (mError) {
+        std::exception_ptr error = mError;
+        mError = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void TaskScheduler::WorkerMain(unsigned int queue) {
+    gInsideJob = true;
+
+    unsigned int lastJob = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mJobMutex);
+            mJobPosted.wait(lock, [this, lastJob] { return mShutdown || mJobId != lastJob; });
+            if (mShutdown) {
+                return;
+            }
+            lastJob = mJobId;
+        }
+
+        unsigned int index;
+        while (PopIndex(queue, index)) {
+            RunIndex(index);
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+bool TaskScheduler::PopIndex(unsigned int queue, unsigned int& index) {
+    // take from the front of our own queue to walk our block in order ...
+    {
+        Queue* own = mQueues[queue];
+        std::lock_guard<std::mutex> lock(own->mMutex);
+        if (!own->mIndices.empty()) {
+            index = own->mIndices.front();
+            own->mIndices.pop_front();
+            return true;
+        }
+    }
+
+    // ... and steal from the back of the others' queues once it is empty
+    const unsigned int numQueues = GetNumThreads();
+    for (unsigned int i = 1; i < numQueues; ++i) {
+        Queue* victim = mQueues[(queue + i) % numQueues];
+        std::lock_guard<std::mutex> lock(victim->mMutex);
+        if (!victim->mIndices.empty()) {
+            index = victim->mIndices.back();
+            victim->mIndices.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+// ------------------------------------------------------------------------------------------------
+void TaskScheduler::RunIndex(unsigned int index) {
+    try {
+        (*mJob)(index);
+    } catch (...) {
+        // keep the error of the lowest index so failures are reported deterministically
+        std::lock_guard<std::mutex> lock(mErrorMutex);
+        if (index < mErrorIndex) {
+            mErrorIndex = index;
+            mError = std::current_exception();
+        }
+    }
+
+    if (1 == mRemaining.fetch_sub(1)) {
+        std::lock_guard<std::mutex> lock(mJobMutex);
+        mJobDone.notify_all();
+    }
+}
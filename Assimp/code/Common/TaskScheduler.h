@@ -0,0 +1,146 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2019, assimp team
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file TaskScheduler.h
+ *  @brief Defines a small work-stealing thread pool used to run the
+ *    per-mesh work of post-processing steps concurrently.
+ */
+#pragma once
+#ifndef AI_TASKSCHEDULER_H_INC
+#define AI_TASKSCHEDULER_H_INC
+
+#include <assimp/defs.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Assimp {
+
+// --------------------------------------------------------------------------------------------
+/** @brief A work-stealing task scheduler.
+ *
+ *  The scheduler owns numThreads-1 worker threads, the thread calling
+ *  #ParallelFor() always takes part in the work as well. The index range of a
+ *  job is split evenly into per-thread queues. Each thread works through its
+ *  own queue from the front, and once it is empty steals from the back of the
+ *  other queues, so a few big meshes don't serialize the job.
+ *
+ *  The scheduler does not define any ordering between the invocations of a
+ *  job. Callers are expected to write per-index results into separate slots
+ *  and to reduce them in index order afterwards, this keeps the output
+ *  identical to a serial run.
+ *
+ *  @note Only one job can be in flight at a time, ParallelFor() must not be
+ *    called concurrently from several threads. Nested calls from inside a
+ *    job are executed serially on the calling worker. */
+// --------------------------------------------------------------------------------------------
+class ASSIMP_API TaskScheduler {
+public:
+    // ----------------------------------------------------------------------------
+    /** @brief Construct the scheduler and spawn its worker threads
+     *  @param numThreads Total number of threads to run jobs on, including
+     *    the calling thread. Values below 2 leave everything serial. */
+    explicit TaskScheduler(unsigned int numThreads);
+
+    // ----------------------------------------------------------------------------
+    /** @brief Destructor, joins all worker threads */
+    ~TaskScheduler();
+
+    // ----------------------------------------------------------------------------
+    /** @brief Get the total number of threads jobs are executed on */
+    unsigned int GetNumThreads() const {
+        return static_cast<unsigned int>(mQueues.size());
+    }
+
+    // ----------------------------------------------------------------------------
+    /** @brief Invoke a function once for every index in [0,count)
+     *
+     *  Returns after all invocations have completed. If invocations throw,
+     *  the exception raised for the lowest index is rethrown on the calling
+     *  thread once the job has drained.
+     *  @param count Number of indices
+     *  @param func Function to invoke, must be safe to call concurrently
+     *    for different indices. */
+    void ParallelFor(unsigned int count, const std::function<void(unsigned int)>& func);
+
+private:
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    //! Index queue owned by one thread, it pops from the front while the others steal from the back
+    struct Queue {
+        std::mutex mMutex;
+        std::deque<unsigned int> mIndices;
+    };
+
+    void WorkerMain(unsigned int queue);
+    bool PopIndex(unsigned int queue, unsigned int& index);
+    void RunIndex(unsigned int index);
+
+    //! One queue per thread, queue 0 belongs to the calling thread
+    std::vector<Queue*> mQueues;
+    std::vector<std::thread> mWorkers;
+
+    //! Signals workers that a new job has been posted or shutdown was requested
+    std::mutex mJobMutex;
+    std::condition_variable mJobPosted;
+    std::condition_variable mJobDone;
+    unsigned int mJobId;
+    bool mShutdown;
+
+    //! The current job and its bookkeeping
+    const std::function<void(unsigned int)>* mJob;
+    std::atomic<unsigned int> mRemaining;
+    std::mutex mErrorMutex;
+    unsigned int mErrorIndex;
+    std::exception_ptr mError;
+};
+
+} // Namespace Assimp
+
+#endif // AI_TASKSCHEDULER_H_INC
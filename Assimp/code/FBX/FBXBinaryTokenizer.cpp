@@ -49,10 +49,19 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "FBXTokenizer.h"
 #include "FBXUtil.h"
+#include "Common/TaskScheduler.h"
 #include <assimp/defs.h>
 #include <stdint.h>
 #include <assimp/Exceptional.h>
 #include <assimp/ByteSwapper.h>
+#include <functional>
+#include <limits>
+
+#ifdef ASSIMP_BUILD_NO_OWN_ZLIB
+#   include <zlib.h>
+#else
+#   include "../contrib/zlib/zlib.h"
+#endif
 
 namespace Assimp {
 namespace FBX {
@@ -339,7 +348,7 @@ void ReadData(const char*& sbegin_out, const char*& send_out, const char* input,
 
 
 // ------------------------------------------------------------------------------------------------
-bool ReadScope(TokenList& output_tokens, const char* input, const char*& cursor, const char* end, bool const is64bits)
+bool ReadScope(TokenList& output_tokens, StackAllocator& token_allocator, const char* input, const char*& cursor, const char* end, bool const is64bits)
 {
     // the first word contains the offset at which this block ends
 	const uint64_t end_offset = is64bits ? ReadDoubleWord(input, cursor, end) : ReadWord(input, cursor, end);
@@ -401,7 +410,7 @@ bool ReadScope(TokenList& output_tokens, const char* input, const char*& cursor,
 
         // XXX this is vulnerable to stack overflowing ..
         while(Offset(input, cursor) < end_offset - sentinel_block_length) {
-			ReadScope(output_tokens, input, cursor, input + end_offset - sentinel_block_length, is64bits);
+			ReadScope(output_tokens, token_allocator, input, cursor, input + end_offset - sentinel_block_length, is64bits);
         }
         output_tokens.push_back(new_Token(cursor, cursor + 1, TokenType_CLOSE_BRACKET, Offset(input, cursor) ));
 
@@ -424,7 +433,7 @@ bool ReadScope(TokenList& output_tokens, const char* input, const char*& cursor,
 
 // ------------------------------------------------------------------------------------------------
 // TODO: Test FBX Binary files newer than the 7500 version to check if the 64 bits address behaviour is consistent
-void TokenizeBinary(TokenList& output_tokens, const char* input, size_t length)
+void TokenizeBinary(TokenList& output_tokens, const char* input, size_t length, StackAllocator& token_allocator)
 {
     ai_assert(input);
 
@@ -454,12 +463,142 @@ void TokenizeBinary(TokenList& output_tokens, const char* input, size_t length)
 	const bool is64bits = version >= 7500;
     const char *end = input + length;
     while (cursor < end ) {
-		if (!ReadScope(output_tokens, input, cursor, input + length, is64bits)) {
+		if (!ReadScope(output_tokens, token_allocator, input, cursor, input + length, is64bits)) {
             break;
         }
     }
 }
 
+// ------------------------------------------------------------------------------------------------
+void DecompressBinaryArrays(TokenList& tokens, std::vector<char>& arena, TaskScheduler* scheduler,
+    StackAllocator& token_allocator)
+{
+    // a binary array token is the type code, followed by the element count,
+    // the encoding and the length of the (compressed) data, see ReadData()
+    const size_t k_header = 1 + 3 * sizeof(uint32_t);
+
+    struct CompressedArray {
+        size_t token;
+        size_t offset;
+        size_t length;
+    };
+
+    // find all zlib-compressed arrays and lay out their uncompressed copies
+    std::vector<CompressedArray> arrays;
+    size_t total = 0;
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        const Token& t = *tokens[i];
+        if (t.Type() != TokenType_DATA || !t.IsBinary() || static_cast<size_t>(t.end() - t.begin()) < k_header) {
+            continue;
+        }
+
+        size_t stride = 0;
+        switch (*t.begin())
+        {
+        case 'f':
+        case 'i':
+            stride = 4;
+            break;
+
+        case 'd':
+        case 'l':
+            stride = 8;
+            break;
+
+        default:
+            continue;
+        };
+
+        const char* cursor = t.begin() + 1;
+        const uint32_t count = ReadWord(t.begin(), cursor, t.end());
+        const uint32_t encoding = ReadWord(t.begin(), cursor, t.end());
+        if (encoding != 1) {
+            continue;
+        }
+
+        const size_t length = stride * count;
+        if (length > std::numeric_limits<uint32_t>::max()) {
+            TokenizeError("uncompressed array is too large", t.Offset());
+        }
+
+        CompressedArray arr = { i, total, length };
+        arrays.push_back(arr);
+        total += k_header + length;
+    }
+
+    if (arrays.empty()) {
+        return;
+    }
+    arena.resize(total);
+
+    // inflate each array into its slot, these are independent of each other
+    const std::function<void(unsigned int)> inflateArray = [&](unsigned int index) {
+        const CompressedArray& arr = arrays[index];
+        const Token& t = *tokens[arr.token];
+        char* out = &arena[arr.offset];
+
+        // copy type code and element count, then mark the data as uncompressed
+        const char* cursor = t.begin() + 5;
+        ReadWord(t.begin(), cursor, t.end());
+        const uint32_t comp_len = ReadWord(t.begin(), cursor, t.end());
+        if (comp_len > static_cast<size_t>(t.end() - cursor)) {
+            TokenizeError("compressed array length is out of bounds", t.Offset());
+        }
+
+        uint32_t encoding = 0;
+        uint32_t length = static_cast<uint32_t>(arr.length);
+        AI_SWAP4(encoding);
+        AI_SWAP4(length);
+        ::memcpy(out, t.begin(), 5);
+        ::memcpy(out + 5, &encoding, sizeof(uint32_t));
+        ::memcpy(out + 9, &length, sizeof(uint32_t));
+
+        z_stream zstream;
+        zstream.opaque = Z_NULL;
+        zstream.zalloc = Z_NULL;
+        zstream.zfree  = Z_NULL;
+        zstream.data_type = Z_BINARY;
+
+        if(Z_OK != inflateInit(&zstream)) {
+            TokenizeError("failure initializing zlib", t.Offset());
+        }
+
+        zstream.next_in   = reinterpret_cast<Bytef*>( const_cast<char*>(cursor) );
+        zstream.avail_in  = comp_len;
+
+        zstream.avail_out = static_cast<uInt>(arr.length);
+        zstream.next_out  = reinterpret_cast<Bytef*>(out + k_header);
+        const int ret = inflate(&zstream, Z_FINISH);
+        const uLong inflated = zstream.total_out;
+        inflateEnd(&zstream);
+
+        if (ret != Z_STREAM_END) {
+            TokenizeError("failure decompressing compressed data section", t.Offset());
+        }
+
+        // the element count is all the parser goes by, so the data has to fill exactly that many elements
+        if (inflated != arr.length) {
+            TokenizeError("decompressed array size does not match its element count", t.Offset());
+        }
+    };
+
+    if (scheduler) {
+        scheduler->ParallelFor(static_cast<unsigned int>(arrays.size()), inflateArray);
+    } else {
+        for (unsigned int i = 0; i < arrays.size(); ++i) {
+            inflateArray(i);
+        }
+    }
+
+    // swap the compressed tokens for tokens pointing to the uncompressed copies
+    for (const CompressedArray& arr : arrays) {
+        const Token* old = tokens[arr.token];
+        const char* begin = &arena[arr.offset];
+        tokens[arr.token] = new_Token(begin, begin + k_header + arr.length, TokenType_DATA, old->Offset());
+        delete_Token(old);
+    }
+}
+
 } // !FBX
 } // !Assimp
 
@@ -284,11 +284,11 @@ Document::Document(const Parser& parser, const ImportSettings& settings)
 // ------------------------------------------------------------------------------------------------
 Document::~Document()
 {
-    for(ObjectMap::value_type& v : objects) {
+    for(const ObjectMap::value_type& v : objects) {
         delete v.second;
     }
 
-    for(ConnectionMap::value_type& v : src_connections) {
+    for(const ConnectionMap::value_type& v : src_connections) {
         delete v.second;
     }
     // |dest_connections| contain the same Connection objects as the |src_connections|
@@ -377,7 +377,7 @@ void Document::ReadObjects()
 
     // add a dummy entry to represent the Model::RootNode object (id 0),
     // which is only indirectly defined in the input file
-    objects[0] = new LazyObject(0L, *eobjects, *this);
+    objects.insert(0L, new LazyObject(0L, *eobjects, *this));
 
     const Scope& sobjects = *eobjects->Compound();
     for(const ElementMap::value_type& el : sobjects.Elements()) {
@@ -400,17 +400,20 @@ void Document::ReadObjects()
             DOMError("encountered object with implicitly defined id 0",el.second);
         }
 
-        if(objects.find(id) != objects.end()) {
-            DOMWarning("encountered duplicate object id, ignoring first occurrence",el.second);
-        }
-
-        objects[id] = new LazyObject(id, *el.second, *this);
+        objects.insert(id, new LazyObject(id, *el.second, *this));
 
         // grab all animation stacks upfront since there is no listing of them
         if(!strcmp(el.first.c_str(),"AnimationStack")) {
             animationStacks.push_back(id);
         }
     }
+
+    // sort once all objects are known, duplicates are only detected now
+    objects.sort();
+    objects.unique([](LazyObject* dropped, LazyObject* kept) {
+        DOMWarning("encountered duplicate object id, ignoring first occurrence",&kept->GetElement());
+        delete dropped;
+    });
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -514,9 +517,12 @@ void Document::ReadConnections()
 
         // add new connection
         const Connection* const c = new Connection(insertionOrder++,src,dest,prop,*this);
-        src_connections.insert(ConnectionMap::value_type(src,c));
-        dest_connections.insert(ConnectionMap::value_type(dest,c));
+        src_connections.insert(src,c);
+        dest_connections.insert(dest,c);
     }
+
+    src_connections.sort();
+    dest_connections.sort();
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -46,6 +46,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef INCLUDED_AI_FBX_DOCUMENT_H
 #define INCLUDED_AI_FBX_DOCUMENT_H
 
+#include <algorithm>
 #include <numeric>
 #include <stdint.h>
 #include <assimp/mesh.h>
@@ -1000,15 +1001,97 @@ public:
     const Document& doc;
 };
 
+/** Map from object ids to values, stored as a flat vector sorted by id.
+ *
+ *  Entries are appended while the document is read and sorted once all of
+ *  them are known, lookups are binary searches afterwards. Entries with the
+ *  same id keep their insertion order, like in a std::multimap. For files
+ *  with many thousands of objects this is much cheaper than one heap node
+ *  per entry. */
+template <typename T>
+class IdMap
+{
+public:
+    typedef std::pair<uint64_t, T> value_type;
+    typedef typename std::vector<value_type>::const_iterator const_iterator;
+
+    IdMap()
+    : sorted(true)
+    {}
+
+    /** append an entry, the map must be sorted before it is queried */
+    void insert(uint64_t id, T value) {
+        sorted = sorted && (entries.empty() || entries.back().first <= id);
+        entries.push_back(value_type(id, value));
+    }
+
+    void sort() {
+        if (!sorted) {
+            std::stable_sort(entries.begin(), entries.end(), CompareIds());
+            sorted = true;
+        }
+    }
+
+    /** keep only the last entry of each id, discard(dropped, kept) is
+     *  called for all others. The map must be sorted. */
+    template <typename F>
+    void unique(F discard) {
+        ai_assert(sorted);
+        typename std::vector<value_type>::iterator out = entries.begin();
+        for (typename std::vector<value_type>::iterator it = entries.begin(); it != entries.end(); ++it) {
+            if (out != entries.begin() && (out - 1)->first == it->first) {
+                discard((out - 1)->second, it->second);
+                *(out - 1) = *it;
+                continue;
+            }
+            *out++ = *it;
+        }
+        entries.erase(out, entries.end());
+    }
+
+    const_iterator find(uint64_t id) const {
+        ai_assert(sorted);
+        const_iterator it = std::lower_bound(entries.begin(), entries.end(), value_type(id, T()), CompareIds());
+        return it != entries.end() && it->first == id ? it : entries.end();
+    }
+
+    std::pair<const_iterator, const_iterator> equal_range(uint64_t id) const {
+        ai_assert(sorted);
+        return std::equal_range(entries.begin(), entries.end(), value_type(id, T()), CompareIds());
+    }
+
+    const_iterator begin() const {
+        return entries.begin();
+    }
+
+    const_iterator end() const {
+        return entries.end();
+    }
+
+    size_t size() const {
+        return entries.size();
+    }
+
+private:
+    struct CompareIds {
+        bool operator()(const value_type& a, const value_type& b) const {
+            return a.first < b.first;
+        }
+    };
+
+    std::vector<value_type> entries;
+    bool sorted;
+};
+
 // XXX again, unique_ptr would be useful. shared_ptr is too
 // bloated since the objects have a well-defined single owner
 // during their entire lifetime (Document). FBX files have
 // up to many thousands of objects (most of which we never use),
 // so the memory overhead for them should be kept at a minimum.
-typedef std::map<uint64_t, LazyObject*> ObjectMap;
+typedef IdMap<LazyObject*> ObjectMap;
 typedef std::fbx_unordered_map<std::string, std::shared_ptr<const PropertyTable> > PropertyTemplateMap;
 
-typedef std::multimap<uint64_t, const Connection*> ConnectionMap;
+typedef IdMap<const Connection*> ConnectionMap;
 
 /** DOM class for global document settings, a single instance per document can
  *  be accessed via Document.Globals(). */
@@ -53,6 +53,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "FBXUtil.h"
 #include "FBXDocument.h"
 #include "FBXConverter.h"
+#include "Common/Importer.h"
 
 #include <assimp/StreamReader.h>
 #include <assimp/MemoryIOWrapper.h>
@@ -92,6 +93,7 @@ static const aiImporterDesc desc = {
 // ------------------------------------------------------------------------------------------------
 // Constructor to be privately used by #Importer
 FBXImporter::FBXImporter()
+: scheduler()
 {
 }
 
@@ -142,6 +144,7 @@ void FBXImporter::SetupProperties(const Importer* pImp)
     settings.useLegacyEmbeddedTextureNaming = pImp->GetPropertyBool(AI_CONFIG_IMPORT_FBX_EMBEDDED_TEXTURES_LEGACY_NAMING, false);
     settings.removeEmptyBones = pImp->GetPropertyBool(AI_CONFIG_IMPORT_REMOVE_EMPTY_BONES, true);
     settings.convertToMeters = pImp->GetPropertyBool(AI_CONFIG_FBX_CONVERT_TO_M, false);
+    scheduler = pImp->Pimpl()->mTaskScheduler;
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -158,24 +161,38 @@ void FBXImporter::InternReadFile( const std::string& pFile, aiScene* pScene, IOS
     // then becomes very large, too. Assimp doesn't support
     // streaming for its output data structures so the net win with
     // streaming input data would be very low.
+    // Binary files are tokenized in place if the stream already holds
+    // them in memory, the text tokenizer needs a 0-terminated copy.
     std::vector<char> contents;
-    contents.resize(stream->FileSize()+1);
-    stream->Read( &*contents.begin(), 1, contents.size()-1 );
-    contents[ contents.size() - 1 ] = 0;
-    const char* const begin = &*contents.begin();
+    const char* begin = reinterpret_cast<const char*>(stream->GetContents());
+    size_t length = stream->FileSize();
+    if (!begin || length < 18 || strncmp(begin,"Kaydara FBX Binary",18)) {
+        contents.resize(length+1);
+        stream->Read( &*contents.begin(), 1, length );
+        contents[ length ] = 0;
+        begin = &*contents.begin();
+        length = contents.size();
+    }
 
     // broadphase tokenizing pass in which we identify the core
     // syntax elements of FBX (brackets, commas, key:value mappings)
+    // all tokens come from one allocator, which releases them in one go
+    StackAllocator token_allocator;
     TokenList tokens;
+    std::vector<char> arrays;
     try {
 
         bool is_binary = false;
         if (!strncmp(begin,"Kaydara FBX Binary",18)) {
             is_binary = true;
-            TokenizeBinary(tokens,begin,contents.size());
+            TokenizeBinary(tokens,begin,length,token_allocator);
+
+            // inflate compressed arrays up front so they can be spread
+            // over worker threads, the parser then only copies them
+            DecompressBinaryArrays(tokens,arrays,scheduler,token_allocator);
         }
         else {
-            Tokenize(tokens,begin);
+            Tokenize(tokens,begin,token_allocator);
         }
 
         // use this information to construct a very rudimentary
@@ -195,10 +212,10 @@ void FBXImporter::InternReadFile( const std::string& pFile, aiScene* pScene, IOS
         // assimp universal format (M)
         SetFileScale( size_relative_to_cm * 0.01f);
 
-        std::for_each(tokens.begin(),tokens.end(),Util::delete_fun<Token>());
+        std::for_each(tokens.begin(),tokens.end(),Util::destroy_fun<Token>());
     }
     catch(std::exception&) {
-        std::for_each(tokens.begin(),tokens.end(),Util::delete_fun<Token>());
+        std::for_each(tokens.begin(),tokens.end(),Util::destroy_fun<Token>());
         throw;
     }
 }
@@ -53,6 +53,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 namespace Assimp    {
 
+class TaskScheduler;
+
 // TinyFormatter.h
 namespace Formatter {
     template <typename T,typename TR, typename A> class basic_formatter;
@@ -93,6 +95,7 @@ protected:
 
 private:
     FBX::ImportSettings settings;
+    TaskScheduler* scheduler;
 }; // !class FBXImporter
 
 } // end of namespace Assimp
@@ -116,7 +116,10 @@ namespace FBX {
 // ------------------------------------------------------------------------------------------------
 Element::Element(const Token& key_token, Parser& parser)
 : key_token(key_token)
+, compound()
 {
+    StackAllocator& allocator = parser.allocator;
+
     TokenPtr n = nullptr;
     do {
         n = parser.AdvanceToNextToken();
@@ -146,7 +149,7 @@ Element::Element(const Token& key_token, Parser& parser)
         }
 
         if (n->Type() == TokenType_OPEN_BRACKET) {
-            compound.reset(new Scope(parser));
+            compound = new_Scope(parser);
 
             // current token should be a TOK_CLOSE_BRACKET
             n = parser.CurrentToken();
@@ -167,11 +170,16 @@ Element::Element(const Token& key_token, Parser& parser)
 Element::~Element()
 {
      // no need to delete tokens, they are owned by the parser
+    if (compound) {
+        delete_Scope(compound);
+    }
 }
 
 // ------------------------------------------------------------------------------------------------
 Scope::Scope(Parser& parser,bool topLevel)
 {
+    StackAllocator& allocator = parser.allocator;
+
     if(!topLevel) {
         TokenPtr t = parser.CurrentToken();
         if (t->Type() != TokenType_OPEN_BRACKET) {
@@ -208,7 +216,7 @@ Scope::Scope(Parser& parser,bool topLevel)
 Scope::~Scope()
 {
     for(ElementMap::value_type& v : elements) {
-        delete v.second;
+        delete_Element(v.second);
     }
 }
 
@@ -218,15 +226,18 @@ Parser::Parser (const TokenList& tokens, bool is_binary)
 , last()
 , current()
 , cursor(tokens.begin())
+, allocator()
+, root()
 , is_binary(is_binary)
 {
-    root.reset(new Scope(*this,true));
+    root = new_Scope(*this,true);
 }
 
 // ------------------------------------------------------------------------------------------------
 Parser::~Parser()
 {
-    // empty
+    // the memory itself goes away with the allocator
+    delete_Scope(root);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -68,8 +68,12 @@ typedef std::fbx_unordered_multimap< std::string, Element* > ElementMap;
 
 typedef std::pair<ElementMap::const_iterator,ElementMap::const_iterator> ElementCollection;
 
-#   define new_Scope new Scope
-#   define new_Element new Element
+// scopes and elements are placed into the StackAllocator named allocator,
+// which is owned by the parser. Destroy them with delete_Scope/delete_Element.
+#   define new_Scope new (allocator.Allocate(sizeof(Scope))) Scope
+#   define new_Element new (allocator.Allocate(sizeof(Element))) Element
+#   define delete_Scope(_p) (_p)->~Scope()
+#   define delete_Element(_p) (_p)->~Element()
 
 
 /** FBX data entity that consists of a key:value tuple.
@@ -90,7 +94,7 @@ public:
     ~Element();
 
     const Scope* Compound() const {
-        return compound.get();
+        return compound;
     }
 
     const Token& KeyToken() const {
@@ -104,7 +108,7 @@ public:
 private:
     const Token& key_token;
     TokenList tokens;
-    std::unique_ptr<Scope> compound;
+    Scope* compound;
 };
 
 /** FBX data entity that consists of a 'scope', a collection
@@ -163,7 +167,7 @@ public:
     ~Parser();
 
     const Scope& GetRootScope() const {
-        return *root.get();
+        return *root;
     }
 
     bool IsBinary() const {
@@ -183,7 +187,8 @@ private:
 
     TokenPtr last, current;
     TokenList::const_iterator cursor;
-    std::unique_ptr<Scope> root;
+    StackAllocator allocator;
+    Scope* root;
 
     const bool is_binary;
 };
@@ -47,11 +47,15 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define INCLUDED_AI_FBX_TOKENIZER_H
 
 #include "FBXCompileConfig.h"
+#include "Common/StackAllocator.h"
 #include <assimp/ai_assert.h>
 #include <vector>
 #include <string>
 
 namespace Assimp {
+
+class TaskScheduler;
+
 namespace FBX {
 
 /** Rough classification for text FBX tokens used for constructing the
@@ -157,7 +161,10 @@ private:
 typedef const Token* TokenPtr;
 typedef std::vector< TokenPtr > TokenList;
 
-#define new_Token new Token
+// tokens are placed into the StackAllocator named token_allocator, which
+// releases their memory in one go. Destroy them with delete_Token.
+#define new_Token new (token_allocator.Allocate(sizeof(Token))) Token
+#define delete_Token(_p) (_p)->~Token()
 
 
 /** Main FBX tokenizer function. Transform input buffer into a list of preprocessed tokens.
@@ -166,8 +173,9 @@ typedef std::vector< TokenPtr > TokenList;
  *
  * @param output_tokens Receives a list of all tokens in the input data.
  * @param input_buffer Textual input buffer to be processed, 0-terminated.
+ * @param token_allocator Receives the memory of the tokens.
  * @throw DeadlyImportError if something goes wrong */
-void Tokenize(TokenList& output_tokens, const char* input);
+void Tokenize(TokenList& output_tokens, const char* input, StackAllocator& token_allocator);
 
 
 /** Tokenizer function for binary FBX files.
@@ -177,8 +185,25 @@ void Tokenize(TokenList& output_tokens, const char* input);
  * @param output_tokens Receives a list of all tokens in the input data.
  * @param input_buffer Binary input buffer to be processed.
  * @param length Length of input buffer, in bytes. There is no 0-terminal.
+ * @param token_allocator Receives the memory of the tokens.
+ * @throw DeadlyImportError if something goes wrong */
+void TokenizeBinary(TokenList& output_tokens, const char* input, size_t length, StackAllocator& token_allocator);
+
+
+/** Inflates all zlib-compressed array properties of a binary token list.
+ *
+ *  Every compressed array token is replaced by a token referencing an
+ *  uncompressed copy of the array, so the parser only has to copy the data.
+ *  The arrays are independent of each other and are inflated concurrently
+ *  if a scheduler is given.
+ *
+ * @param tokens Token list as produced by #TokenizeBinary, modified in place.
+ * @param arena Receives the uncompressed arrays. Must outlive the tokens.
+ * @param scheduler Worker threads to use, may be NULL.
+ * @param token_allocator Receives the memory of the replacement tokens.
  * @throw DeadlyImportError if something goes wrong */
-void TokenizeBinary(TokenList& output_tokens, const char* input, size_t length);
+void DecompressBinaryArrays(TokenList& tokens, std::vector<char>& arena, TaskScheduler* scheduler,
+    StackAllocator& token_allocator);
 
 
 } // ! FBX
@@ -66,6 +66,15 @@ struct delete_fun
     }
 };
 
+/** helper for std::for_each to destroy all items placed into a #StackAllocator */
+template<typename T>
+struct destroy_fun
+{
+    void operator()(const volatile T* del) {
+        del->~T();
+    }
+};
+
 /** Get a string representation for a #TokenType. */
 const char* TokenTypeString(TokenType t);
 
@@ -89,7 +89,8 @@ static const aiImporterDesc desc = {
 // Constructor to be privately used by Importer
 IRRImporter::IRRImporter()
 : fps()
-, configSpeedFlag(){
+, configSpeedFlag()
+, configNumThreads( 1 ) {
     // empty
 }
 
@@ -138,6 +139,10 @@ void IRRImporter::SetupProperties(const Importer* pImp)
 
     // AI_CONFIG_FAVOUR_SPEED
     configSpeedFlag = (0 != pImp->GetPropertyInteger(AI_CONFIG_FAVOUR_SPEED,0));
+
+    // AI_CONFIG_GLOB_MULTITHREADING
+    const int threads = pImp->GetPropertyInteger(AI_CONFIG_GLOB_MULTITHREADING,-1);
+    configNumThreads = threads > 1 ? threads : 1;
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -933,6 +938,7 @@ void IRRImporter::InternReadFile( const std::string& pFile,
 
     // Batch loader used to load external models
     BatchLoader batch(pIOHandler);
+    batch.setNumThreads(configNumThreads);
 //  batch.SetBasePath(pFile);
 
     cameras.reserve(5);
@@ -289,6 +289,9 @@ private:
 
     /** Configuration option: speed flag was set? */
     bool configSpeedFlag;
+
+    /** Configuration option: threads used to load external files */
+    unsigned int configNumThreads;
 };
 
 } // end of namespace Assimp
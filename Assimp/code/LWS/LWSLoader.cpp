@@ -137,7 +137,8 @@ LWSImporter::LWSImporter()
     first(),
     last(),
     fps(),
-    noSkeletonMesh()
+    noSkeletonMesh(),
+    configNumThreads(1)
 {
     // nothing to do here
 }
@@ -194,6 +195,10 @@ void LWSImporter::SetupProperties(const Importer* pImp)
     }
 
     noSkeletonMesh = pImp->GetPropertyInteger(AI_CONFIG_IMPORT_NO_SKELETON_MESHES,0) != 0;
+
+    // AI_CONFIG_GLOB_MULTITHREADING
+    const int threads = pImp->GetPropertyInteger(AI_CONFIG_GLOB_MULTITHREADING,-1);
+    configNumThreads = threads > 1 ? threads : 1;
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -531,6 +536,7 @@ void LWSImporter::InternReadFile( const std::string& pFile, aiScene* pScene,
 
     // Construct a Batchimporter to read more files recursively
     BatchLoader batch(pIOHandler);
+    batch.setNumThreads(configNumThreads);
 //  batch.SetBasePath(pFile);
 
     // Construct an array to receive the flat output graph
@@ -248,6 +248,8 @@ private:
     double first,last,fps;
 
     bool noSkeletonMesh;
+
+    unsigned int configNumThreads;
 };
 
 } // end of namespace Assimp
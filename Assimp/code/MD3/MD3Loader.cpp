@@ -357,6 +357,7 @@ MD3Importer::MD3Importer()
     : configFrameID  (0)
     , configHandleMP (true)
     , configSpeedFlag()
+    , configNumThreads (1)
     , pcHeader()
     , mBuffer()
     , fileSize()
@@ -481,6 +482,10 @@ void MD3Importer::SetupProperties(const Importer* pImp)
 
     // AI_CONFIG_FAVOUR_SPEED
     configSpeedFlag = (0 != pImp->GetPropertyInteger(AI_CONFIG_FAVOUR_SPEED,0));
+
+    // AI_CONFIG_GLOB_MULTITHREADING
+    const int threads = pImp->GetPropertyInteger(AI_CONFIG_GLOB_MULTITHREADING,-1);
+    configNumThreads = threads > 1 ? threads : 1;
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -585,6 +590,7 @@ bool MD3Importer::ReadMultipartFile()
 
         // now read these three files
         BatchLoader batch(mIOHandler);
+        batch.setNumThreads(configNumThreads);
         const unsigned int _lower = batch.AddLoadRequest(lower,0,&props);
         const unsigned int _upper = batch.AddLoadRequest(upper,0,&props);
         const unsigned int _head  = batch.AddLoadRequest(head,0,&props);
@@ -303,6 +303,9 @@ protected:
     /** Configuration option: speed flag was set? */
     bool configSpeedFlag;
 
+    /** Configuration option: threads used to load multi-part files */
+    unsigned int configNumThreads;
+
     /** Header of the MD3 file */
     BE_NCONST MD3::Header* pcHeader;
 
@@ -46,7 +46,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ObjFileImporter.h"
 #include "ObjFileParser.h"
 #include "ObjFileData.h"
+#include "Common/Importer.h"
 #include <assimp/IOStreamBuffer.h>
+#include <assimp/MemoryIOWrapper.h>
 #include <memory>
 #include <assimp/DefaultIOSystem.h>
 #include <assimp/Importer.hpp>
@@ -79,7 +81,8 @@ using namespace std;
 ObjFileImporter::ObjFileImporter()
 : m_Buffer()
 , m_pRootObject( nullptr )
-, m_strAbsPath( std::string(1, DefaultIOSystem().getOsSeparator()) ) {}
+, m_strAbsPath( std::string(1, DefaultIOSystem().getOsSeparator()) )
+, m_scheduler( nullptr ) {}
 
 // ------------------------------------------------------------------------------------------------
 //  Destructor.
@@ -106,6 +109,12 @@ const aiImporterDesc* ObjFileImporter::GetInfo() const {
     return &desc;
 }
 
+// ------------------------------------------------------------------------------------------------
+//  Setup configuration properties for the loader
+void ObjFileImporter::SetupProperties(const Importer* pImp) {
+    m_scheduler = pImp->Pimpl()->mTaskScheduler;
+}
+
 // ------------------------------------------------------------------------------------------------
 //  Obj-file import implementation
 void ObjFileImporter::InternReadFile( const std::string &file, aiScene* pScene, IOSystem* pIOHandler) {
@@ -122,8 +131,20 @@ void ObjFileImporter::InternReadFile( const std::string &file, aiScene* pScene,
         throw DeadlyImportError( "OBJ-file is too small.");
     }
 
+    // If there are worker threads the file is parsed concurrently in chunks,
+    // which needs all of it in memory. Read it up front instead of streaming it.
+    std::vector<char> contents;
+    std::unique_ptr<IOStream> memoryStream;
+    if ( nullptr != m_scheduler && nullptr == fileStream->GetContents() ) {
+        contents.resize( fileSize );
+        if ( fileStream->Read( &contents[ 0 ], 1, fileSize ) != fileSize ) {
+            throw DeadlyImportError( "Failed to read file " + file + "." );
+        }
+        memoryStream.reset( new MemoryIOStream( reinterpret_cast<const uint8_t*>( &contents[ 0 ] ), fileSize ) );
+    }
+
     IOStreamBuffer<char> streamedBuffer;
-    streamedBuffer.open( fileStream.get() );
+    streamedBuffer.open( memoryStream ? memoryStream.get() : fileStream.get() );
 
     // Allocate buffer and read file into it
     //TextFileToBuffer( fileStream.get(),m_Buffer);
@@ -142,7 +163,7 @@ void ObjFileImporter::InternReadFile( const std::string &file, aiScene* pScene,
     }
 
     // parse the file into a temporary representation
-    ObjFileParser parser( streamedBuffer, modelName, pIOHandler, m_progress, file);
+    ObjFileParser parser( streamedBuffer, modelName, pIOHandler, m_progress, file, m_scheduler );
 
     // And create the proper return structures out of it
     CreateDataFromImport(parser.GetModel(), pScene);
@@ -56,6 +56,8 @@ namespace ObjFile {
     struct Model;
 }
 
+class TaskScheduler;
+
 // ------------------------------------------------------------------------------------------------
 /// \class  ObjFileImporter
 /// \brief  Imports a waveform obj file
@@ -77,6 +79,9 @@ private:
     //! \brief  Appends the supported extension.
     const aiImporterDesc* GetInfo () const;
 
+    //! \brief  Picks up the worker threads of the importer.
+    void SetupProperties(const Importer* pImp);
+
     //! \brief  File import implementation.
     void InternReadFile(const std::string& pFile, aiScene* pScene, IOSystem* pIOHandler);
 
@@ -114,6 +119,8 @@ private:
     ObjFile::Object *m_pRootObject;
     //! Absolute pathname of model in file system
     std::string m_strAbsPath;
+    //! Worker threads of the importer, may be NULL
+    TaskScheduler *m_scheduler;
 };
 
 // ------------------------------------------------------------------------------------------------
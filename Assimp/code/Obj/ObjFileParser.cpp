@@ -46,13 +46,26 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ObjFileMtlImporter.h"
 #include "ObjTools.h"
 #include "ObjFileData.h"
+#include "Common/TaskScheduler.h"
 #include <assimp/ParsingUtils.h>
 #include <assimp/BaseImporter.h>
 #include <assimp/DefaultIOSystem.h>
 #include <assimp/DefaultLogger.hpp>
 #include <assimp/material.h>
 #include <assimp/Importer.hpp>
+#include <assimp/fast_atof.h>
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   include <emmintrin.h>
+#   define ASSIMP_OBJ_SSE2
+#   ifdef _MSC_VER
+#       include <intrin.h>
+#   endif
+#endif
 
 namespace Assimp {
 
@@ -65,20 +78,23 @@ ObjFileParser::ObjFileParser()
 , m_uiLine( 0 )
 , m_pIO( nullptr )
 , m_progress( nullptr )
-, m_originalObjFileName() {
+, m_originalObjFileName()
+, m_scheduler( nullptr ) {
     // empty
 }
 
 ObjFileParser::ObjFileParser( IOStreamBuffer<char> &streamBuffer, const std::string &modelName,
                               IOSystem *io, ProgressHandler* progress,
-                              const std::string &originalObjFileName) :
+                              const std::string &originalObjFileName,
+                              TaskScheduler *scheduler) :
     m_DataIt(),
     m_DataItEnd(),
     m_pModel(nullptr),
     m_uiLine(0),
     m_pIO( io ),
     m_progress(progress),
-    m_originalObjFileName(originalObjFileName)
+    m_originalObjFileName(originalObjFileName),
+    m_scheduler(scheduler)
 {
     std::fill_n(m_buffer,Buffersize,0);
 
@@ -117,8 +133,20 @@ void ObjFileParser::parseFile( IOStreamBuffer<char> &streamBuffer ) {
     unsigned int processed = 0;
     size_t lastFilePos( 0 );
 
+    // Files held in memory are parsed in place, in chunks, if there are worker threads to share them.
+    // Serially the chunks would only cost an extra copy of everything
+    const char *data = nullptr;
+    size_t size = 0;
+    if ( nullptr != m_scheduler && streamBuffer.getRemainingContents( data, size ) ) {
+        parseChunks( data, size );
+        return;
+    }
+
     std::vector<char> buffer;
+    size_t line = streamBuffer.getLineNumber();
     while ( streamBuffer.getNextDataLine( buffer, '\\' ) ) {
+        m_uiLine = static_cast<unsigned int>( line );
+        line = streamBuffer.getLineNumber();
         m_DataIt = buffer.begin();
         m_DataItEnd = buffer.end();
 
@@ -131,113 +159,649 @@ void ObjFileParser::parseFile( IOStreamBuffer<char> &streamBuffer ) {
             m_progress->UpdateFileRead( processed, progressTotal );
         }
 
-        // parse line
-        switch (*m_DataIt) {
-        case 'v': // Parse a vertex texture coordinate
-            {
-                ++m_DataIt;
-                if (*m_DataIt == ' ' || *m_DataIt == '\t') {
-                    size_t numComponents = getNumComponentsInDataDefinition();
-                    if (numComponents == 3) {
-                        // read in vertex definition
-                        getVector3(m_pModel->m_Vertices);
-                    } else if (numComponents == 4) {
-                        // read in vertex definition (homogeneous coords)
-                        getHomogeneousVector3(m_pModel->m_Vertices);
-                    } else if (numComponents == 6) {
-                        // read vertex and vertex-color
-                        getTwoVectors3(m_pModel->m_Vertices, m_pModel->m_VertexColors);
-                    }
-                } else if (*m_DataIt == 't') {
-                    // read in texture coordinate ( 2D or 3D )
-                    ++m_DataIt;
-                    size_t dim = getTexCoordVector(m_pModel->m_TextureCoord);
-                    m_pModel->m_TextureCoordDim = std::max(m_pModel->m_TextureCoordDim, (unsigned int)dim);
-                } else if (*m_DataIt == 'n') {
-                    // Read in normal vector definition
-                    ++m_DataIt;
-                    getVector3( m_pModel->m_Normals );
+        parseLine();
+    }
+}
+
+void ObjFileParser::parseLine() {
+    switch (*m_DataIt) {
+    case 'v': // Parse a vertex texture coordinate
+        {
+            ++m_DataIt;
+            if (*m_DataIt == ' ' || *m_DataIt == '\t') {
+                size_t numComponents = getNumComponentsInDataDefinition();
+                if (numComponents == 3) {
+                    // read in vertex definition
+                    getVector3(m_pModel->m_Vertices);
+                } else if (numComponents == 4) {
+                    // read in vertex definition (homogeneous coords)
+                    getHomogeneousVector3(m_pModel->m_Vertices);
+                } else if (numComponents == 6) {
+                    // read vertex and vertex-color
+                    getTwoVectors3(m_pModel->m_Vertices, m_pModel->m_VertexColors);
                 }
+            } else if (*m_DataIt == 't') {
+                // read in texture coordinate ( 2D or 3D )
+                ++m_DataIt;
+                size_t dim = getTexCoordVector(m_pModel->m_TextureCoord);
+                m_pModel->m_TextureCoordDim = std::max(m_pModel->m_TextureCoordDim, (unsigned int)dim);
+            } else if (*m_DataIt == 'n') {
+                // Read in normal vector definition
+                ++m_DataIt;
+                getVector3( m_pModel->m_Normals );
             }
-            break;
+        }
+        break;
+
+    case 'p': // Parse a face, line or point statement
+    case 'l':
+    case 'f':
+        {
+            getFace(*m_DataIt == 'f' ? aiPrimitiveType_POLYGON : (*m_DataIt == 'l'
+                ? aiPrimitiveType_LINE : aiPrimitiveType_POINT));
+        }
+        break;
+
+    case '#': // Parse a comment
+        {
+            getComment();
+        }
+        break;
+
+    case 'u': // Parse a material desc. setter
+        {
+            std::string name;
+
+            getNameNoSpace(m_DataIt, m_DataItEnd, name);
+
+            size_t nextSpace = name.find(" ");
+            if (nextSpace != std::string::npos)
+                name = name.substr(0, nextSpace);
 
-        case 'p': // Parse a face, line or point statement
-        case 'l':
-        case 'f':
+            if(name == "usemtl")
             {
-                getFace(*m_DataIt == 'f' ? aiPrimitiveType_POLYGON : (*m_DataIt == 'l'
-                    ? aiPrimitiveType_LINE : aiPrimitiveType_POINT));
+                getMaterialDesc();
             }
+        }
+        break;
+
+    case 'm': // Parse a material library or merging group ('mg')
+        {
+            std::string name;
+
+            getNameNoSpace(m_DataIt, m_DataItEnd, name);
+
+            size_t nextSpace = name.find(" ");
+            if (nextSpace != std::string::npos)
+                name = name.substr(0, nextSpace);
+
+            if (name == "mg")
+                getGroupNumberAndResolution();
+            else if(name == "mtllib")
+                getMaterialLib();
+			else
+				goto pf_skip_line;
+        }
+        break;
+
+    case 'g': // Parse group name
+        {
+            getGroupName();
+        }
+        break;
+
+    case 's': // Parse group number
+        {
+            getGroupNumber();
+        }
+        break;
+
+    case 'o': // Parse object name
+        {
+            getObjectName();
+        }
+        break;
+
+    default:
+        {
+pf_skip_line:
+            m_DataIt = skipLine<DataArrayIt>( m_DataIt, m_DataItEnd, m_uiLine );
+        }
+        break;
+    }
+}
+
+// -------------------------------------------------------------------
+//  Chunked parsing of in-memory files.
+//
+//  The file is split into newline-aligned chunks which are scanned
+//  independently on the worker threads of the task scheduler. Vertex
+//  data and face indices are parsed in place into per-chunk arrays.
+//  Statements that depend on the parser state (materials, groups,
+//  objects, ...) and anything unusual are only recorded and handled
+//  by the regular line parser while the chunks are merged in file order.
+// -------------------------------------------------------------------
+
+namespace ObjFile {
+
+/// A newline-aligned part of the file and the records parsed from it.
+struct Chunk {
+    enum RecordType {
+        Vertex = 0,
+        ColoredVertex,
+        Normal,
+        TexCoord,
+        Face,
+        Line
+    };
+
+    /// A run of records of the same type, in file order.
+    struct Run {
+        RecordType type;
+        unsigned int count;
+        /// Start of the statement for Line runs, which always have a count of 1.
+        const char *line;
+    };
+
+    /// A face, indices are resolved during the merge.
+    struct FaceRecord {
+        aiPrimitiveType type;
+        unsigned int firstIndex;
+        unsigned int numIndices;
+        const char *line;
+    };
+
+    /// A face index as written in the file.
+    struct Index {
+        int value;
+        unsigned short slashes;
+        bool firstInGroup;
+    };
+
+    const char *begin;
+    const char *end;
+    /// Line feeds in the file before the chunk.
+    unsigned int firstLine;
+    std::vector<Run> runs;
+    std::vector<aiVector3D> vertices;
+    std::vector<aiVector3D> colors;
+    std::vector<aiVector3D> normals;
+    std::vector<aiVector3D> texCoords;
+    unsigned int texCoordDim;
+    std::vector<FaceRecord> faces;
+    std::vector<Index> indices;
+
+    Chunk()
+    : begin( nullptr )
+    , end( nullptr )
+    , firstLine( 0 )
+    , texCoordDim( 0 ) {
+        // empty
+    }
+
+    void add( RecordType type, const char *line = nullptr ) {
+        if ( type != Line && !runs.empty() && runs.back().type == type ) {
+            ++runs.back().count;
+            return;
+        }
+        Run run = { type, 1, line };
+        runs.push_back( run );
+    }
+};
+
+}
+
+namespace {
+
+#ifdef ASSIMP_OBJ_SSE2
+inline unsigned int findFirstBit( unsigned int mask ) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward( &index, mask );
+    return static_cast<unsigned int>( index );
+#else
+    return static_cast<unsigned int>( __builtin_ctz( mask ) );
+#endif
+}
+#endif
+
+// Returns the first line end or line continuation in [it, end). Scans
+// 16 characters at a time where SSE2 is available.
+const char *findStatementEnd( const char *it, const char *end ) {
+#ifdef ASSIMP_OBJ_SSE2
+    const __m128i lf = _mm_set1_epi8( '\n' );
+    const __m128i cr = _mm_set1_epi8( '\r' );
+    const __m128i ff = _mm_set1_epi8( '\f' );
+    const __m128i nul = _mm_setzero_si128();
+    const __m128i bs = _mm_set1_epi8( '\\' );
+    while ( end - it >= 16 ) {
+        const __m128i v = _mm_loadu_si128( reinterpret_cast<const __m128i*>( it ) );
+        const __m128i hits = _mm_or_si128(
+            _mm_or_si128( _mm_cmpeq_epi8( v, lf ), _mm_cmpeq_epi8( v, cr ) ),
+            _mm_or_si128( _mm_or_si128( _mm_cmpeq_epi8( v, ff ), _mm_cmpeq_epi8( v, nul ) ), _mm_cmpeq_epi8( v, bs ) ) );
+        const unsigned int mask = static_cast<unsigned int>( _mm_movemask_epi8( hits ) );
+        if ( 0 != mask ) {
+            return it + findFirstBit( mask );
+        }
+        it += 16;
+    }
+#endif
+    while ( it != end && !IsLineEnd( *it ) && *it != '\\' ) {
+        ++it;
+    }
+    return it;
+}
+
+// Copies the data line starting at it into line, exactly the way
+// IOStreamBuffer::getNextDataLine() does, and returns the start of the next line.
+const char *copyDataLine( const char *it, const char *end, std::vector<char> &line ) {
+    line.clear();
+    bool continuationFound = false;
+    while ( it < end ) {
+        if ( '\\' == *it ) {
+            continuationFound = true;
+            ++it;
+        }
+        if ( it >= end ) {
             break;
+        }
+        if ( IsLineEnd( *it ) ) {
+            if ( !continuationFound ) {
+                break;
+            }
+            // skip line end
+            while ( it < end && *it != '\n' ) {
+                ++it;
+            }
+            ++it;
+            continuationFound = false;
+            if ( it >= end ) {
+                break;
+            }
+        }
+        line.push_back( *it );
+        ++it;
+    }
+    line.push_back( '\n' );
+    line.push_back( '\0' );
+    return it < end ? it + 1 : end;
+}
 
-        case '#': // Parse a comment
-            {
-                getComment();
+// Parses up to max numbers separated by blanks from [it, end). Returns the
+// number of values or -1 if the statement is anything but plain numbers.
+int parseNumbers( const char *it, const char *end, ai_real *out, int max ) {
+    int count = 0;
+    for ( ;; ) {
+        while ( it != end && IsSpace( *it ) ) {
+            ++it;
+        }
+        if ( it == end ) {
+            return count;
+        }
+
+        const char c = *it;
+        if ( count == max || !IsNumeric( c ) ) {
+            return -1;
+        }
+        try {
+            it = fast_atoreal_move<ai_real>( it, out[ count++ ] );
+        } catch ( const std::invalid_argument & ) {
+            return -1;
+        }
+        if ( it != end && !IsSpace( *it ) ) {
+            return -1;
+        }
+    }
+}
+
+// Parses the indices of a face statement. Returns false if the regular
+// parser has to deal with the statement.
+bool parseFace( const char *it, const char *end, aiPrimitiveType type, ObjFile::Chunk &chunk ) {
+    // skip the keyword
+    while ( it != end && !IsSpace( *it ) ) {
+        ++it;
+    }
+
+    ObjFile::Chunk::FaceRecord face = { type, static_cast<unsigned int>( chunk.indices.size() ), 0, nullptr };
+    unsigned short slashes = 0;
+    bool firstInGroup = true;
+    while ( it != end ) {
+        if ( '/' == *it ) {
+            if ( type == aiPrimitiveType_POINT || ++slashes > 2 ) {
+                return false;
             }
-            break;
+            ++it;
+            continue;
+        }
+        if ( IsSpace( *it ) ) {
+            slashes = 0;
+            firstInGroup = true;
+            ++it;
+            continue;
+        }
 
-        case 'u': // Parse a material desc. setter
-            {
-                std::string name;
+        // the regular parser has a few quirks with leading zeros and signs
+        const bool negative = '-' == *it;
+        const char *digits = negative ? it + 1 : it;
+        if ( digits == end || *digits < '1' || *digits > '9' ) {
+            return false;
+        }
+        int value = 0;
+        const char *cur = digits;
+        while ( cur != end && *cur >= '0' && *cur <= '9' ) {
+            if ( cur - digits == 9 ) {
+                return false;
+            }
+            value = value * 10 + ( *cur - '0' );
+            ++cur;
+        }
+        if ( cur != end && '/' != *cur && !IsSpace( *cur ) ) {
+            return false;
+        }
 
-                getNameNoSpace(m_DataIt, m_DataItEnd, name);
+        ObjFile::Chunk::Index index = { negative ? -value : value, slashes, firstInGroup };
+        chunk.indices.push_back( index );
+        firstInGroup = false;
+        it = cur;
+    }
 
-                size_t nextSpace = name.find(" ");
-                if (nextSpace != std::string::npos)
-                    name = name.substr(0, nextSpace);
+    face.numIndices = static_cast<unsigned int>( chunk.indices.size() ) - face.firstIndex;
+    if ( 0 == face.numIndices ) {
+        return false;
+    }
+    chunk.faces.push_back( face );
+    return true;
+}
 
-                if(name == "usemtl")
-                {
-                    getMaterialDesc();
+// Parses one statement in [it, end). Returns false if the regular parser
+// has to deal with the statement.
+bool parseStatement( const char *it, const char *end, ObjFile::Chunk &chunk ) {
+    ai_real values[ 6 ];
+    const size_t length = end - it;
+    switch ( *it ) {
+    case 'v':
+        if ( length < 2 ) {
+            return true;
+        }
+        if ( IsSpace( it[ 1 ] ) ) {
+            const int count = parseNumbers( it + 1, end, values, 6 );
+            if ( 3 == count ) {
+                chunk.vertices.push_back( aiVector3D( values[ 0 ], values[ 1 ], values[ 2 ] ) );
+                chunk.add( ObjFile::Chunk::Vertex );
+            } else if ( 4 == count && 0 != values[ 3 ] ) {
+                const ai_real w = values[ 3 ];
+                chunk.vertices.push_back( aiVector3D( values[ 0 ] / w, values[ 1 ] / w, values[ 2 ] / w ) );
+                chunk.add( ObjFile::Chunk::Vertex );
+            } else if ( 6 == count ) {
+                chunk.vertices.push_back( aiVector3D( values[ 0 ], values[ 1 ], values[ 2 ] ) );
+                chunk.colors.push_back( aiVector3D( values[ 3 ], values[ 4 ], values[ 5 ] ) );
+                chunk.add( ObjFile::Chunk::ColoredVertex );
+            } else {
+                return false;
+            }
+            return true;
+        }
+        if ( 't' == it[ 1 ] ) {
+            if ( length < 3 || !IsSpace( it[ 2 ] ) ) {
+                return false;
+            }
+            const int count = parseNumbers( it + 2, end, values, 3 );
+            if ( 2 != count && 3 != count ) {
+                return false;
+            }
+            if ( 2 == count ) {
+                values[ 2 ] = 0;
+            }
+            // Coerce nan and inf to 0 as is the OBJ default value
+            for ( int i = 0; i < 3; ++i ) {
+                if ( !std::isfinite( values[ i ] ) ) {
+                    values[ i ] = 0;
                 }
             }
+            chunk.texCoords.push_back( aiVector3D( values[ 0 ], values[ 1 ], values[ 2 ] ) );
+            chunk.texCoordDim = std::max( chunk.texCoordDim, static_cast<unsigned int>( count ) );
+            chunk.add( ObjFile::Chunk::TexCoord );
+            return true;
+        }
+        if ( 'n' == it[ 1 ] ) {
+            if ( length < 3 || !IsSpace( it[ 2 ] ) || 3 != parseNumbers( it + 2, end, values, 3 ) ) {
+                return false;
+            }
+            chunk.normals.push_back( aiVector3D( values[ 0 ], values[ 1 ], values[ 2 ] ) );
+            chunk.add( ObjFile::Chunk::Normal );
+            return true;
+        }
+        // ignored by the regular parser as well
+        return true;
+
+    case 'p':
+    case 'l':
+    case 'f':
+        if ( !parseFace( it, end, 'f' == *it ? aiPrimitiveType_POLYGON : ( 'l' == *it
+                ? aiPrimitiveType_LINE : aiPrimitiveType_POINT ), chunk ) ) {
+            return false;
+        }
+        chunk.faces.back().line = it;
+        chunk.add( ObjFile::Chunk::Face );
+        return true;
+
+    case 'u':
+    case 'm':
+    case 'g':
+    case 's':
+    case 'o':
+        return false;
+
+    default:
+        // comments and unknown statements
+        return true;
+    }
+}
+
+// Parses all statements starting in the chunk.
+void parseChunk( ObjFile::Chunk &chunk, const char *fileEnd ) {
+    std::vector<char> scratch;
+    const char *it = chunk.begin;
+    while ( it < chunk.end ) {
+        const char *end = findStatementEnd( it, fileEnd );
+
+        // line continuations and the last line of a file without a line end
+        // are left to the regular parser, it and fast_atof need a terminator
+        if ( end == fileEnd || '\\' == *end ) {
+            chunk.add( ObjFile::Chunk::Line, it );
+            it = copyDataLine( it, fileEnd, scratch );
+            continue;
+        }
+
+        if ( it != end && !parseStatement( it, end, chunk ) ) {
+            chunk.add( ObjFile::Chunk::Line, it );
+        }
+        it = end + 1;
+    }
+}
+
+// Returns true if a data line starts right behind the line feed at it.
+bool isDataLineStart( const char *begin, const char *it ) {
+    // a backslash anywhere in the line makes it continue on the next one
+    while ( it != begin && '\n' != *( it - 1 ) ) {
+        --it;
+        if ( '\\' == *it ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+void ObjFileParser::parseChunks( const char *data, size_t size ) {
+    static const size_t MinChunkSize = 64 * 1024;
+    const char *end = data + size;
+
+    // a few chunks per thread balance the load, small files stay in one piece
+    size_t numChunks = 1;
+    if ( nullptr != m_scheduler ) {
+        numChunks = std::max<size_t>( 1, std::min<size_t>( m_scheduler->GetNumThreads() * 4, size / MinChunkSize ) );
+    }
+
+    std::vector<ObjFile::Chunk> chunks( numChunks );
+    const char *begin = data;
+    unsigned int lines = m_uiLine;
+    size_t used = 0;
+    for ( size_t i = 1; i < numChunks; ++i ) {
+        const char *it = data + size / numChunks * i;
+        if ( it <= begin ) {
+            continue;
+        }
+        // move the split behind the next line feed that ends a data line
+        it = static_cast<const char*>( ::memchr( it, '\n', end - it ) );
+        while ( nullptr != it && !isDataLineStart( data, it ) ) {
+            it = static_cast<const char*>( ::memchr( it + 1, '\n', end - it - 1 ) );
+        }
+        if ( nullptr == it || it + 1 >= end ) {
             break;
+        }
+        chunks[ used ].begin = begin;
+        chunks[ used ].end = it + 1;
+        chunks[ used ].firstLine = lines;
+        lines += static_cast<unsigned int>( std::count( begin, it + 1, '\n' ) );
+        begin = it + 1;
+        ++used;
+    }
+    chunks[ used ].begin = begin;
+    chunks[ used ].end = end;
+    chunks[ used ].firstLine = lines;
+    chunks.resize( used + 1 );
+
+    if ( nullptr != m_scheduler && chunks.size() > 1 ) {
+        m_scheduler->ParallelFor( static_cast<unsigned int>( chunks.size() ), [&]( unsigned int i ) {
+            parseChunk( chunks[ i ], end );
+        } );
+    } else {
+        for ( ObjFile::Chunk &chunk : chunks ) {
+            parseChunk( chunk, end );
+        }
+    }
 
-        case 'm': // Parse a material library or merging group ('mg')
-            {
-                std::string name;
+    std::vector<char> line;
+    for ( ObjFile::Chunk &chunk : chunks ) {
+        mergeChunk( chunk, end, line );
+        m_progress->UpdateFileRead( static_cast<unsigned int>( chunk.end - data ), static_cast<unsigned int>( size ) );
 
-                getNameNoSpace(m_DataIt, m_DataItEnd, name);
+        // release the chunk's arrays as early as possible
+        chunk = ObjFile::Chunk();
+    }
+}
 
-                size_t nextSpace = name.find(" ");
-                if (nextSpace != std::string::npos)
-                    name = name.substr(0, nextSpace);
+void ObjFileParser::mergeChunk( const ObjFile::Chunk &chunk, const char *end, std::vector<char> &line ) {
+    // statements handed to the regular parser get their line numbers, counted up to them lazily
+    const char *counted = chunk.begin;
+    unsigned int lines = chunk.firstLine;
+    auto seekLine = [&]( const char *statement ) {
+        lines += static_cast<unsigned int>( std::count( counted, statement, '\n' ) );
+        counted = statement;
+        m_uiLine = lines;
+    };
+
+    size_t vertex = 0, color = 0, normal = 0, texCoord = 0, face = 0;
+    for ( const ObjFile::Chunk::Run &run : chunk.runs ) {
+        switch ( run.type ) {
+        case ObjFile::Chunk::Vertex:
+            m_pModel->m_Vertices.insert( m_pModel->m_Vertices.end(),
+                chunk.vertices.begin() + vertex, chunk.vertices.begin() + vertex + run.count );
+            vertex += run.count;
+            break;
 
-                if (name == "mg")
-                    getGroupNumberAndResolution();
-                else if(name == "mtllib")
-                    getMaterialLib();
-				else
-					goto pf_skip_line;
-            }
+        case ObjFile::Chunk::ColoredVertex:
+            m_pModel->m_Vertices.insert( m_pModel->m_Vertices.end(),
+                chunk.vertices.begin() + vertex, chunk.vertices.begin() + vertex + run.count );
+            m_pModel->m_VertexColors.insert( m_pModel->m_VertexColors.end(),
+                chunk.colors.begin() + color, chunk.colors.begin() + color + run.count );
+            vertex += run.count;
+            color += run.count;
             break;
 
-        case 'g': // Parse group name
-            {
-                getGroupName();
-            }
+        case ObjFile::Chunk::Normal:
+            m_pModel->m_Normals.insert( m_pModel->m_Normals.end(),
+                chunk.normals.begin() + normal, chunk.normals.begin() + normal + run.count );
+            normal += run.count;
             break;
 
-        case 's': // Parse group number
-            {
-                getGroupNumber();
-            }
+        case ObjFile::Chunk::TexCoord:
+            m_pModel->m_TextureCoord.insert( m_pModel->m_TextureCoord.end(),
+                chunk.texCoords.begin() + texCoord, chunk.texCoords.begin() + texCoord + run.count );
+            texCoord += run.count;
             break;
 
-        case 'o': // Parse object name
-            {
-                getObjectName();
+        case ObjFile::Chunk::Face:
+            for ( unsigned int i = 0; i < run.count; ++i, ++face ) {
+                const ObjFile::Chunk::FaceRecord &record = chunk.faces[ face ];
+
+                // same index rules as getFace(), relative indices refer to the data read so far
+                const int vSize = static_cast<int>( m_pModel->m_Vertices.size() );
+                const int vtSize = static_cast<int>( m_pModel->m_TextureCoord.size() );
+                const int vnSize = static_cast<int>( m_pModel->m_Normals.size() );
+                const bool vt = !m_pModel->m_TextureCoord.empty();
+                const bool vn = !m_pModel->m_Normals.empty();
+
+                ObjFile::Face *objFace = new ObjFile::Face( record.type );
+                bool hasNormal = false;
+                int shift = 0;
+                for ( unsigned int j = 0; j < record.numIndices; ++j ) {
+                    const ObjFile::Chunk::Index &index = chunk.indices[ record.firstIndex + j ];
+                    if ( index.firstInGroup ) {
+                        shift = 0;
+                    }
+                    int iPos = index.slashes + shift;
+                    if ( iPos == 1 && !vt && vn ) {
+                        // skip texture coords for normals if there are no tex coords
+                        iPos = 2;
+                        shift = 1;
+                    }
+                    if ( iPos > 2 ) {
+                        delete objFace;
+                        objFace = nullptr;
+                        break;
+                    }
+
+                    if ( 0 == iPos ) {
+                        objFace->m_vertices.push_back( index.value > 0 ? index.value - 1 : vSize + index.value );
+                    } else if ( 1 == iPos ) {
+                        objFace->m_texturCoords.push_back( index.value > 0 ? index.value - 1 : vtSize + index.value );
+                    } else {
+                        objFace->m_normals.push_back( index.value > 0 ? index.value - 1 : vnSize + index.value );
+                        hasNormal = true;
+                    }
+                }
+
+                if ( nullptr == objFace ) {
+                    // let the regular parser report the statement
+                    seekLine( record.line );
+                    copyDataLine( record.line, end, line );
+                    m_DataIt = line.begin();
+                    m_DataItEnd = line.end();
+                    parseLine();
+                } else if ( objFace->m_vertices.empty() ) {
+                    ASSIMP_LOG_ERROR("Obj: Ignoring empty face");
+                    delete objFace;
+                } else {
+                    storeFace( objFace, hasNormal );
+                }
             }
             break;
 
-        default:
-            {
-pf_skip_line:
-                m_DataIt = skipLine<DataArrayIt>( m_DataIt, m_DataItEnd, m_uiLine );
-            }
+        case ObjFile::Chunk::Line:
+            seekLine( run.line );
+            copyDataLine( run.line, end, line );
+            m_DataIt = line.begin();
+            m_DataItEnd = line.end();
+            parseLine();
             break;
         }
     }
+
+    m_pModel->m_TextureCoordDim = std::max( m_pModel->m_TextureCoordDim, chunk.texCoordDim );
+    seekLine( chunk.end );
 }
 
 void ObjFileParser::copyNextWord(char *pBuffer, size_t length) {
@@ -328,7 +892,7 @@ size_t ObjFileParser::getTexCoordVector( std::vector<aiVector3D> &point3d_array
         copyNextWord( m_buffer, Buffersize );
         z = ( ai_real ) fast_atof( m_buffer );
     } else {
-        throw DeadlyImportError( "OBJ: Invalid number of components" );
+        throw DeadlyImportError( "OBJ: Invalid number of components on line " + std::to_string( m_uiLine + 1 ) );
     }
 
     // Coerce nan and inf to 0 as is the OBJ default value
@@ -376,7 +940,7 @@ void ObjFileParser::getHomogeneousVector3( std::vector<aiVector3D> &point3d_arra
     w = ( ai_real ) fast_atof( m_buffer );
 
     if (w == 0)
-      throw DeadlyImportError("OBJ: Invalid component in homogeneous vector (Division by zero)");
+      throw DeadlyImportError("OBJ: Invalid component in homogeneous vector (Division by zero) on line " + std::to_string(m_uiLine + 1));
 
     point3d_array.push_back( aiVector3D( x/w, y/w, z/w ) );
     m_DataIt = skipLine<DataArrayIt>( m_DataIt, m_DataItEnd, m_uiLine );
@@ -497,7 +1061,7 @@ void ObjFileParser::getFace( aiPrimitiveType type ) {
             } else {
                 //On error, std::atoi will return 0 which is not a valid value
                 delete face;
-                throw DeadlyImportError("OBJ: Invalid face indice");
+                throw DeadlyImportError("OBJ: Invalid face indice on line " + std::to_string(m_uiLine + 1));
             }
 
         }
@@ -512,6 +1076,13 @@ void ObjFileParser::getFace( aiPrimitiveType type ) {
         return;
     }
 
+    storeFace( face, hasNormal );
+
+    // Skip the rest of the line
+    m_DataIt = skipLine<DataArrayIt>( m_DataIt, m_DataItEnd, m_uiLine );
+}
+
+void ObjFileParser::storeFace( ObjFile::Face *face, bool hasNormal ) {
     // Set active material, if one set
     if( NULL != m_pModel->m_pCurrentMaterial ) {
         face->m_pMaterial = m_pModel->m_pCurrentMaterial;
@@ -536,8 +1107,6 @@ void ObjFileParser::getFace( aiPrimitiveType type ) {
     if( !m_pModel->m_pCurrentMesh->m_hasNormals && hasNormal ) {
         m_pModel->m_pCurrentMesh->m_hasNormals = true;
     }
-    // Skip the rest of the line
-    m_DataIt = skipLine<DataArrayIt>( m_DataIt, m_DataItEnd, m_uiLine );
 }
 
 void ObjFileParser::getMaterialDesc() {
@@ -869,8 +1438,8 @@ bool ObjFileParser::needsNewMesh( const std::string &materialName )
 //  Shows an error in parsing process.
 void ObjFileParser::reportErrorTokenInFace()
 {
+    ASSIMP_LOG_ERROR_F("OBJ: Not supported token in face description detected on line ", m_uiLine + 1);
     m_DataIt = skipLine<DataArrayIt>( m_DataIt, m_DataItEnd, m_uiLine );
-    ASSIMP_LOG_ERROR("OBJ: Not supported token in face description detected");
 }
 
 // -------------------------------------------------------------------
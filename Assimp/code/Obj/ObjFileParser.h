@@ -59,11 +59,14 @@ namespace ObjFile {
     struct Material;
     struct Point3;
     struct Point2;
+    struct Face;
+    struct Chunk;
 }
 
 class ObjFileImporter;
 class IOSystem;
 class ProgressHandler;
+class TaskScheduler;
 
 /// \class  ObjFileParser
 /// \brief  Parser for a obj waveform file
@@ -78,7 +81,8 @@ public:
     /// @brief  The default constructor.
     ObjFileParser();
     /// @brief  Constructor with data array.
-    ObjFileParser( IOStreamBuffer<char> &streamBuffer, const std::string &modelName, IOSystem* io, ProgressHandler* progress, const std::string &originalObjFileName);
+    ObjFileParser( IOStreamBuffer<char> &streamBuffer, const std::string &modelName, IOSystem* io, ProgressHandler* progress, const std::string &originalObjFileName,
+        TaskScheduler *scheduler = nullptr);
     /// @brief  Destructor
     ~ObjFileParser();
     /// @brief  If you want to load in-core data.
@@ -89,6 +93,12 @@ public:
 protected:
     /// Parse the loaded file
     void parseFile( IOStreamBuffer<char> &streamBuffer );
+    /// Parse the line in the current buffer.
+    void parseLine();
+    /// Parse in-memory data in newline-aligned chunks, concurrently if possible.
+    void parseChunks( const char *data, size_t size );
+    /// Append a parsed chunk to the model, in file order.
+    void mergeChunk( const ObjFile::Chunk &chunk, const char *end, std::vector<char> &line );
     /// Method to copy the new delimited word in the current line.
     void copyNextWord(char *pBuffer, size_t length);
     /// Method to copy the new line.
@@ -107,6 +117,8 @@ protected:
     void getVector2(std::vector<aiVector2D> &point2d_array);
     /// Stores the following face.
     void getFace(aiPrimitiveType type);
+    /// Assigns a face to the current mesh.
+    void storeFace(ObjFile::Face *face, bool hasNormal);
     /// Reads the material description.
     void getMaterialDesc();
     /// Gets a comment.
@@ -148,7 +160,7 @@ private:
     DataArrayIt m_DataItEnd;
     //! Pointer to model instance
     std::unique_ptr<ObjFile::Model> m_pModel;
-    //! Current line (for debugging)
+    //! Zero-based line of the statement being parsed, for error messages
     unsigned int m_uiLine;
     //! Helper buffer
     char m_buffer[Buffersize];
@@ -158,6 +170,8 @@ private:
     ProgressHandler* m_progress;
     /// Path to the current model, name of the obj file where the buffer comes from
     const std::string m_originalObjFileName;
+    //! Worker threads for the chunked parser, may be NULL
+    TaskScheduler *m_scheduler;
 };
 
 }   // Namespace Assimp
@@ -50,6 +50,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/ByteSwapper.h>
 #include "PlyLoader.h"
 
+#include <limits.h>
+
 using namespace Assimp;
 
 // ------------------------------------------------------------------------------------------------
@@ -623,9 +625,17 @@ bool PLY::DOM::ParseInstanceBinary(IOStreamBuffer<char> &streamBuffer, DOM* p_pc
     return false;
   }
 
-  streamBuffer.getNextBlock(buffer);
-  unsigned int bufferSize = static_cast<unsigned int>(buffer.size());
-  const char* pCur = (char*)&buffer[0];
+  // parse the body in place if the stream holds the file in memory already
+  const char* pCur = nullptr;
+  size_t remaining = 0;
+  unsigned int bufferSize = 0;
+  if (streamBuffer.size() <= UINT_MAX && streamBuffer.getRemainingContents(pCur, remaining)) {
+    bufferSize = static_cast<unsigned int>(remaining);
+  } else {
+    streamBuffer.getNextBlock(buffer);
+    bufferSize = static_cast<unsigned int>(buffer.size());
+    pCur = (char*)&buffer[0];
+  }
   if (!p_pcOut->ParseElementInstanceListsBinary(streamBuffer, buffer, pCur, bufferSize, loader, p_bBE))
   {
       ASSIMP_LOG_DEBUG("PLY::DOM::ParseInstanceBinary() failure");
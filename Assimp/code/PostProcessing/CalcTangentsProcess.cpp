@@ -97,9 +97,15 @@ void CalcTangentsProcess::Execute( aiScene* pScene)
 
     ASSIMP_LOG_DEBUG("CalcTangentsProcess begin");
 
+    // meshes are independent, so they may be processed concurrently
+    std::vector<char> processed(pScene->mNumMeshes, 0);
+    ParallelFor(pScene->mNumMeshes, [&](unsigned int a) {
+        processed[a] = ProcessMesh( pScene->mMeshes[a],a);
+    });
+
     bool bHas = false;
     for ( unsigned int a = 0; a < pScene->mNumMeshes; a++ ) {
-        if(ProcessMesh( pScene->mMeshes[a],a))bHas = true;
+        if(processed[a])bHas = true;
     }
 
     if ( bHas ) {
@@ -235,17 +241,17 @@ bool CalcTangentsProcess::ProcessMesh( aiMesh* pMesh, unsigned int meshIndex)
 
 
     // create a helper to quickly find locally close vertices among the vertex array
-    // FIX: check whether we can reuse the SpatialSort of a previous step
-    SpatialSort* vertexFinder = NULL;
-    SpatialSort  _vertexFinder;
+    // FIX: check whether we can reuse the SpatialGrid of a previous step
+    SpatialGrid* vertexFinder = NULL;
+    SpatialGrid  _vertexFinder;
     float posEpsilon;
     if (shared)
     {
-        std::vector<std::pair<SpatialSort,float> >* avf;
+        std::vector<std::pair<SpatialGrid,float> >* avf;
         shared->GetProperty(AI_SPP_SPATIAL_SORT,avf);
         if (avf)
         {
-            std::pair<SpatialSort,float>& blubb = avf->operator [] (meshIndex);
+            std::pair<SpatialGrid,float>& blubb = avf->operator [] (meshIndex);
             vertexFinder = &blubb.first;
             posEpsilon = blubb.second;;
         }
@@ -256,7 +262,10 @@ bool CalcTangentsProcess::ProcessMesh( aiMesh* pMesh, unsigned int meshIndex)
         vertexFinder = &_vertexFinder;
         posEpsilon = ComputePositionEpsilon(pMesh);
     }
-    std::vector<unsigned int> verticesFound;
+
+    // look up the vertices close to each position in one go
+    std::vector<unsigned int> firstFound, verticesFound;
+    vertexFinder->FindAllPositions( posEpsilon, firstFound, verticesFound);
 
     const float fLimit = std::cos(configMaxAngle);
     std::vector<unsigned int> closeVertices;
@@ -268,20 +277,19 @@ bool CalcTangentsProcess::ProcessMesh( aiMesh* pMesh, unsigned int meshIndex)
         if( vertexDone[a])
             continue;
 
-        const aiVector3D& origPos = pMesh->mVertices[a];
         const aiVector3D& origNorm = pMesh->mNormals[a];
         const aiVector3D& origTang = pMesh->mTangents[a];
         const aiVector3D& origBitang = pMesh->mBitangents[a];
         closeVertices.resize( 0 );
 
-        // find all vertices close to that position
-        vertexFinder->FindPositions( origPos, posEpsilon, verticesFound);
+        // all vertices close to that position
+        const unsigned int firstClose = firstFound[a], endClose = firstFound[a+1];
 
-        closeVertices.reserve (verticesFound.size()+5);
+        closeVertices.reserve (endClose-firstClose+5);
         closeVertices.push_back( a);
 
         // look among them for other vertices sharing the same normal and a close-enough tangent/bitangent
-        for( unsigned int b = 0; b < verticesFound.size(); b++)
+        for( unsigned int b = firstClose; b < endClose; b++)
         {
             unsigned int idx = verticesFound[b];
             if( vertexDone[idx])
@@ -91,12 +91,20 @@ void FindDegeneratesProcess::SetupProperties(const Importer* pImp) {
 // Executes the post processing step on the given imported data.
 void FindDegeneratesProcess::Execute( aiScene* pScene) {
     ASSIMP_LOG_DEBUG("FindDegeneratesProcess begin");
-    for (unsigned int i = 0; i < pScene->mNumMeshes;++i)
-    {
+
+    // meshes are independent, so they may be processed concurrently
+    std::vector<char> remove_me(pScene->mNumMeshes, 0);
+    ParallelFor(pScene->mNumMeshes, [&](unsigned int i) {
         //Do not process point cloud, ExecuteOnMesh works only with faces data
-        if ((pScene->mMeshes[i]->mPrimitiveTypes != aiPrimitiveType::aiPrimitiveType_POINT) && ExecuteOnMesh(pScene->mMeshes[i])) {
+        if (pScene->mMeshes[i]->mPrimitiveTypes != aiPrimitiveType::aiPrimitiveType_POINT) {
+            remove_me[i] = ExecuteOnMesh(pScene->mMeshes[i]);
+        }
+    });
+
+    // remove back to front, so the indices of the meshes still to be removed stay valid
+    for (unsigned int i = pScene->mNumMeshes; i-- > 0;) {
+        if (remove_me[i]) {
             removeMesh(pScene, i);
-            --i; //the current i is removed, do not skip the next one
         }
     }
     ASSIMP_LOG_DEBUG("FindDegeneratesProcess finished");
@@ -95,9 +95,15 @@ void GenVertexNormalsProcess::Execute( aiScene* pScene)
         throw DeadlyImportError("Post-processing order mismatch: expecting pseudo-indexed (\"verbose\") vertices here");
     }
 
+    // meshes are independent, so they may be processed concurrently
+    std::vector<char> processed(pScene->mNumMeshes, 0);
+    ParallelFor(pScene->mNumMeshes, [&](unsigned int a) {
+        processed[a] = GenMeshVertexNormals( pScene->mMeshes[a],a);
+    });
+
     bool bHas = false;
     for( unsigned int a = 0; a < pScene->mNumMeshes; ++a) {
-        if(GenMeshVertexNormals( pScene->mMeshes[a],a))
+        if (processed[a])
             bHas = true;
     }
 
@@ -156,17 +162,17 @@ bool GenVertexNormalsProcess::GenMeshVertexNormals (aiMesh* pMesh, unsigned int
         }
     }
 
-    // Set up a SpatialSort to quickly find all vertices close to a given position
-    // check whether we can reuse the SpatialSort of a previous step.
-    SpatialSort* vertexFinder = NULL;
-    SpatialSort  _vertexFinder;
+    // Set up a SpatialGrid to quickly find all vertices close to a given position
+    // check whether we can reuse the SpatialGrid of a previous step.
+    SpatialGrid* vertexFinder = NULL;
+    SpatialGrid  _vertexFinder;
     ai_real posEpsilon = ai_real( 1e-5 );
     if (shared) {
-        std::vector<std::pair<SpatialSort,ai_real> >* avf;
+        std::vector<std::pair<SpatialGrid,ai_real> >* avf;
         shared->GetProperty(AI_SPP_SPATIAL_SORT,avf);
         if (avf)
         {
-            std::pair<SpatialSort,ai_real>& blubb = avf->operator [] (meshIndex);
+            std::pair<SpatialGrid,ai_real>& blubb = avf->operator [] (meshIndex);
             vertexFinder = &blubb.first;
             posEpsilon = blubb.second;
         }
@@ -176,7 +182,11 @@ bool GenVertexNormalsProcess::GenMeshVertexNormals (aiMesh* pMesh, unsigned int
         vertexFinder = &_vertexFinder;
         posEpsilon = ComputePositionEpsilon(pMesh);
     }
-    std::vector<unsigned int> verticesFound;
+
+    // Look up the vertices sharing each position in one go, the neighbours of
+    // vertex i are verticesFound[firstFound[i]] ... verticesFound[firstFound[i+1]-1]
+    std::vector<unsigned int> firstFound, verticesFound;
+    vertexFinder->FindAllPositions( posEpsilon, firstFound, verticesFound);
     aiVector3D* pcNew = new aiVector3D[pMesh->mNumVertices];
 
     if (configMaxAngle >= AI_DEG_TO_RAD( 175.f ))   {
@@ -190,17 +200,17 @@ bool GenVertexNormalsProcess::GenMeshVertexNormals (aiMesh* pMesh, unsigned int
             }
 
             // Get all vertices that share this one ...
-            vertexFinder->FindPositions( pMesh->mVertices[i], posEpsilon, verticesFound);
+            const unsigned int begin = firstFound[i], end = firstFound[i+1];
 
             aiVector3D pcNor;
-            for (unsigned int a = 0; a < verticesFound.size(); ++a) {
+            for (unsigned int a = begin; a < end; ++a) {
                 const aiVector3D& v = pMesh->mNormals[verticesFound[a]];
                 if (is_not_qnan(v.x))pcNor += v;
             }
             pcNor.NormalizeSafe();
 
             // Write the smoothed normal back to all affected normals
-            for (unsigned int a = 0; a < verticesFound.size(); ++a)
+            for (unsigned int a = begin; a < end; ++a)
             {
                 unsigned int vidx = verticesFound[a];
                 pcNew[vidx] = pcNor;
@@ -214,12 +224,12 @@ bool GenVertexNormalsProcess::GenMeshVertexNormals (aiMesh* pMesh, unsigned int
         const ai_real fLimit = std::cos(configMaxAngle);
         for (unsigned int i = 0; i < pMesh->mNumVertices;++i)   {
             // Get all vertices that share this one ...
-            vertexFinder->FindPositions( pMesh->mVertices[i] , posEpsilon, verticesFound);
+            const unsigned int begin = firstFound[i], end = firstFound[i+1];
 
             aiVector3D vr = pMesh->mNormals[i];
 
             aiVector3D pcNor;
-            for (unsigned int a = 0; a < verticesFound.size(); ++a) {
+            for (unsigned int a = begin; a < end; ++a) {
                 aiVector3D v = pMesh->mNormals[verticesFound[a]];
 
                 // Check whether the angle between the two normals is not too large.
@@ -43,9 +43,14 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 /** @file Implementation of the post processing step to improve the cache locality of a mesh.
  * <br>
- * The algorithm is roughly basing on this paper:
+ * The default algorithm is roughly basing on this paper:
  * http://www.cs.princeton.edu/gfx/pubs/Sander_2007_%3ETR/tipsy.pdf
- *   .. although overdraw reduction isn't implemented yet ...
+ *   .. although overdraw reduction isn't implemented for it ...
+ * <br>
+ * The alternative one is Tom Forsyth's linear-speed vertex cache optimisation:
+ * https://tomforsyth1000.github.io/papers/fast_vert_cache_opt.html
+ * It is followed by a vertex fetch reordering pass and optionally by sorting
+ * clusters of faces for less overdraw, as described in the Tipsify paper.
  */
 
 // internal headers
@@ -56,6 +61,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
 #include <assimp/DefaultLogger.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits.h>
 #include <stdio.h>
 #include <stack>
 
@@ -64,7 +72,9 @@ using namespace Assimp;
 // ------------------------------------------------------------------------------------------------
 // Constructor to be privately used by Importer
 ImproveCacheLocalityProcess::ImproveCacheLocalityProcess()
-: mConfigCacheDepth(PP_ICL_PTCACHE_SIZE) {
+: mConfigCacheDepth(PP_ICL_PTCACHE_SIZE)
+, mConfigAlgorithm(0)
+, mConfigOverdrawThreshold(0.f) {
     // empty
 }
 
@@ -85,8 +95,365 @@ bool ImproveCacheLocalityProcess::IsActive( unsigned int pFlags) const {
 void ImproveCacheLocalityProcess::SetupProperties(const Importer* pImp) {
     // AI_CONFIG_PP_ICL_PTCACHE_SIZE controls the target cache size for the optimizer
     mConfigCacheDepth = pImp->GetPropertyInteger(AI_CONFIG_PP_ICL_PTCACHE_SIZE,PP_ICL_PTCACHE_SIZE);
+
+    // AI_CONFIG_PP_ICL_ALGORITHM selects Tipsify or Forsyth's algorithm, the latter
+    // optionally followed by overdraw ordering
+    mConfigAlgorithm = pImp->GetPropertyInteger(AI_CONFIG_PP_ICL_ALGORITHM,0);
+    mConfigOverdrawThreshold = pImp->GetPropertyFloat(AI_CONFIG_PP_ICL_OVERDRAW_THRESHOLD,0.f);
+}
+
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+// Simulates a FIFO post-transform cache of the given size over the faces of a mesh and returns
+// the number of cache misses. The number of vertices referenced by the faces is stored in
+// piNumUsed, so ACMR (misses per face) and ATVR (misses per vertex) can be derived.
+unsigned int CountCacheMisses(const aiMesh* pMesh, unsigned int iCacheSize, unsigned int* piNumUsed) {
+    // a vertex is in cache if less than iCacheSize misses happened since it was loaded
+    std::vector<unsigned int> stamps(pMesh->mNumVertices, 0);
+    unsigned int iStamp = iCacheSize + 1;
+    unsigned int iNumUsed = 0;
+    for (unsigned int f = 0; f < pMesh->mNumFaces; ++f) {
+        const aiFace& face = pMesh->mFaces[f];
+        for (unsigned int i = 0; i < face.mNumIndices; ++i) {
+            unsigned int& stamp = stamps[face.mIndices[i]];
+            if (!stamp) {
+                ++iNumUsed;
+            }
+            if (iStamp - stamp > iCacheSize) {
+                stamp = iStamp++;
+            }
+        }
+    }
+    *piNumUsed = iNumUsed;
+    return iStamp - (iCacheSize + 1);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Tom Forsyth's scoring constants
+const float CacheDecayPower = 1.5f;
+const float LastTriScore = 0.75f;
+const float ValenceBoostScale = 2.0f;
+const float ValenceBoostPower = 0.5f;
+const unsigned int ValenceScoreTableSize = 32;
+
+// ------------------------------------------------------------------------------------------------
+// Reorders the triangles of an index buffer with Forsyth's algorithm for an LRU cache of the
+// given size. The vertex with the best score is the one whose triangles should be emitted next:
+// vertices recently used and vertices with few remaining triangles score high.
+void OptimizeForsyth(const std::vector<unsigned int>& indices, unsigned int iNumVertices,
+        unsigned int iCacheSize, std::vector<unsigned int>& out) {
+    const unsigned int iNumFaces = static_cast<unsigned int>(indices.size() / 3);
+
+    // score tables for all cache positions and for small valences
+    std::vector<float> cacheScores(iCacheSize);
+    for (unsigned int i = 0; i < iCacheSize; ++i) {
+        // the three vertices of the last triangle get a fixed score, so that no
+        // preference is given to any of its edges
+        cacheScores[i] = i < 3 ? LastTriScore :
+            std::pow(1.f - float(i - 3) / float(iCacheSize - 3), CacheDecayPower);
+    }
+    float valenceScores[ValenceScoreTableSize];
+    for (unsigned int i = 1; i < ValenceScoreTableSize; ++i) {
+        valenceScores[i] = ValenceBoostScale * std::pow(float(i), -ValenceBoostPower);
+    }
+    const auto vertexScore = [&](int iCachePos, unsigned int iNumLive) -> float {
+        if (!iNumLive) {
+            return -1.f;
+        }
+        const float score = iCachePos >= 0 ? cacheScores[iCachePos] : 0.f;
+        return score + (iNumLive < ValenceScoreTableSize ? valenceScores[iNumLive] :
+            ValenceBoostScale * std::pow(float(iNumLive), -ValenceBoostPower));
+    };
+
+    // vertex-triangle adjacency, the live triangles of each vertex are kept at the front
+    std::vector<unsigned int> numLive(iNumVertices, 0);
+    for (unsigned int idx : indices) {
+        ++numLive[idx];
+    }
+    std::vector<unsigned int> offsets(iNumVertices + 1, 0);
+    for (unsigned int v = 0; v < iNumVertices; ++v) {
+        offsets[v + 1] = offsets[v] + numLive[v];
+    }
+    std::vector<unsigned int> adjacency(indices.size());
+    {
+        std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+        for (unsigned int i = 0; i < indices.size(); ++i) {
+            adjacency[fill[indices[i]]++] = i / 3;
+        }
+    }
+
+    std::vector<int> cachePos(iNumVertices, -1);
+    std::vector<float> vertexScores(iNumVertices);
+    for (unsigned int v = 0; v < iNumVertices; ++v) {
+        vertexScores[v] = vertexScore(-1, numLive[v]);
+    }
+
+    std::vector<float> faceScores(iNumFaces);
+    std::vector<char> emitted(iNumFaces, 0);
+    unsigned int iBest = 0;
+    for (unsigned int f = 0; f < iNumFaces; ++f) {
+        faceScores[f] = vertexScores[indices[f*3]] + vertexScores[indices[f*3+1]] + vertexScores[indices[f*3+2]];
+        if (faceScores[f] > faceScores[iBest]) {
+            iBest = f;
+        }
+    }
+
+    // the simulated LRU cache, it overflows by up to three vertices during an update
+    std::vector<unsigned int> cache, newCache;
+    cache.reserve(iCacheSize + 3);
+    newCache.reserve(iCacheSize + 3);
+
+    out.clear();
+    out.reserve(indices.size());
+    unsigned int iCursor = 0;
+    for (unsigned int iNumEmitted = 0; iNumEmitted < iNumFaces; ++iNumEmitted) {
+        if (UINT_MAX == iBest) {
+            // dead end - continue with the next face in input order
+            while (emitted[iCursor]) {
+                ++iCursor;
+            }
+            iBest = iCursor;
+        }
+
+        const unsigned int* tri = &indices[iBest * 3];
+        out.insert(out.end(), tri, tri + 3);
+        emitted[iBest] = 1;
+
+        // remove the face from the live lists of its vertices and put them in front of the cache
+        newCache.clear();
+        for (unsigned int k = 0; k < 3; ++k) {
+            const unsigned int v = tri[k];
+            unsigned int* live = &adjacency[offsets[v]];
+            unsigned int* last = live + --numLive[v];
+            *std::find(live, last, iBest) = *last;
+            // degenerate faces reference a vertex more than once
+            if (std::find(newCache.begin(), newCache.end(), v) == newCache.end()) {
+                newCache.push_back(v);
+            }
+        }
+        for (unsigned int v : cache) {
+            if (v != tri[0] && v != tri[1] && v != tri[2]) {
+                newCache.push_back(v);
+            }
+        }
+
+        // update the scores of all vertices which moved in or out of the cache
+        for (unsigned int i = 0; i < newCache.size(); ++i) {
+            const unsigned int v = newCache[i];
+            cachePos[v] = i < iCacheSize ? int(i) : -1;
+            vertexScores[v] = vertexScore(cachePos[v], numLive[v]);
+        }
+
+        // and pick the best of their remaining faces
+        iBest = UINT_MAX;
+        float fBestScore = -1.f;
+        for (unsigned int v : newCache) {
+            const unsigned int* live = &adjacency[offsets[v]];
+            for (unsigned int i = 0; i < numLive[v]; ++i) {
+                const unsigned int f = live[i];
+                const float score = vertexScores[indices[f*3]] + vertexScores[indices[f*3+1]] + vertexScores[indices[f*3+2]];
+                faceScores[f] = score;
+                if (score > fBestScore) {
+                    fBestScore = score;
+                    iBest = f;
+                }
+            }
+        }
+
+        newCache.resize(std::min(static_cast<unsigned int>(newCache.size()), iCacheSize));
+        cache.swap(newCache);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Splits a cache-optimized index buffer into clusters and sorts them so that faces on the outside
+// of the mesh are drawn first. Clusters end where the running ACMR drops below fThreshold times the
+// ACMR of the enclosing run between two cache flushes, which keeps most of the cache efficiency.
+void OptimizeOverdraw(std::vector<unsigned int>& indices, const aiVector3D* pPositions,
+        unsigned int iNumVertices, unsigned int iCacheSize, float fThreshold) {
+    const unsigned int iNumFaces = static_cast<unsigned int>(indices.size() / 3);
+    if (iNumFaces < 2) {
+        return;
+    }
+
+    std::vector<unsigned int> stamps(iNumVertices, 0);
+    unsigned int iStamp = iCacheSize + 1;
+    const auto countMisses = [&](unsigned int f) -> unsigned int {
+        unsigned int iMisses = 0;
+        for (unsigned int k = 0; k < 3; ++k) {
+            unsigned int& stamp = stamps[indices[f*3+k]];
+            if (iStamp - stamp > iCacheSize) {
+                stamp = iStamp++;
+                ++iMisses;
+            }
+        }
+        return iMisses;
+    };
+    const auto flushCache = [&]() {
+        iStamp += iCacheSize + 1;
+    };
+
+    // hard boundaries: faces which do not share any vertex with the cache
+    std::vector<unsigned int> hard;
+    for (unsigned int f = 0; f < iNumFaces; ++f) {
+        if (countMisses(f) == 3 || !f) {
+            hard.push_back(f);
+        }
+    }
+    hard.push_back(iNumFaces);
+
+    // soft boundaries within each of them
+    std::vector<unsigned int> clusters;
+    for (unsigned int h = 0; h + 1 < hard.size(); ++h) {
+        const unsigned int iStart = hard[h], iEnd = hard[h+1];
+
+        flushCache();
+        unsigned int iMisses = 0;
+        for (unsigned int f = iStart; f < iEnd; ++f) {
+            iMisses += countMisses(f);
+        }
+        const float fTarget = fThreshold * float(iMisses) / float(iEnd - iStart);
+
+        flushCache();
+        clusters.push_back(iStart);
+        unsigned int iRunMisses = 0, iRunFaces = 0;
+        for (unsigned int f = iStart; f < iEnd; ++f) {
+            iRunMisses += countMisses(f);
+            ++iRunFaces;
+            if (float(iRunMisses) <= fTarget * float(iRunFaces) && f + 1 < iEnd) {
+                clusters.push_back(f + 1);
+                flushCache();
+                iRunMisses = iRunFaces = 0;
+            }
+        }
+        // a trailing run which did not reach the target is merged into the one before
+        if (iRunFaces && clusters.back() != iStart) {
+            clusters.pop_back();
+        }
+    }
+    clusters.push_back(iNumFaces);
+
+    // area-weighted centroid of the mesh
+    aiVector3D meshCentroid;
+    ai_real fMeshArea = 0.f;
+    for (unsigned int f = 0; f < iNumFaces; ++f) {
+        const aiVector3D& a = pPositions[indices[f*3]], &b = pPositions[indices[f*3+1]], &c = pPositions[indices[f*3+2]];
+        const ai_real fArea = ((b - a) ^ (c - a)).Length();
+        meshCentroid += (a + b + c) * fArea;
+        fMeshArea += fArea;
+    }
+    if (fMeshArea > 0.f) {
+        meshCentroid /= fMeshArea * 3.f;
+    }
+
+    // clusters whose faces point away from the center are drawn first
+    const unsigned int iNumClusters = static_cast<unsigned int>(clusters.size() - 1);
+    std::vector<std::pair<float, unsigned int> > order(iNumClusters);
+    for (unsigned int c = 0; c < iNumClusters; ++c) {
+        aiVector3D centroid, normal;
+        ai_real fArea = 0.f;
+        for (unsigned int f = clusters[c]; f < clusters[c+1]; ++f) {
+            const aiVector3D& a = pPositions[indices[f*3]], &b = pPositions[indices[f*3+1]], &d = pPositions[indices[f*3+2]];
+            const aiVector3D n = (b - a) ^ (d - a);
+            const ai_real fFaceArea = n.Length();
+            centroid += (a + b + d) * fFaceArea;
+            normal += n;
+            fArea += fFaceArea;
+        }
+        if (fArea > 0.f) {
+            centroid /= fArea * 3.f;
+        }
+        order[c] = std::make_pair(-float((centroid - meshCentroid) * normal.NormalizeSafe()), c);
+    }
+    std::stable_sort(order.begin(), order.end());
+
+    std::vector<unsigned int> sorted;
+    sorted.reserve(indices.size());
+    for (const auto& entry : order) {
+        sorted.insert(sorted.end(), indices.begin() + clusters[entry.second] * 3, indices.begin() + clusters[entry.second + 1] * 3);
+    }
+    indices.swap(sorted);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Moves the entries of a per-vertex array to their new places
+template <typename T>
+void RemapArray(T*& pArray, const std::vector<unsigned int>& remap) {
+    if (!pArray) {
+        return;
+    }
+    T* pOut = new T[remap.size()];
+    for (unsigned int i = 0; i < remap.size(); ++i) {
+        pOut[remap[i]] = pArray[i];
+    }
+    delete[] pArray;
+    pArray = pOut;
+}
+
+// ------------------------------------------------------------------------------------------------
+template <typename XMesh>
+void RemapVertexArrays(XMesh* pMesh, const std::vector<unsigned int>& remap) {
+    RemapArray(pMesh->mVertices, remap);
+    RemapArray(pMesh->mNormals, remap);
+    RemapArray(pMesh->mTangents, remap);
+    RemapArray(pMesh->mBitangents, remap);
+    for (unsigned int i = 0; i < AI_MAX_NUMBER_OF_COLOR_SETS; ++i) {
+        RemapArray(pMesh->mColors[i], remap);
+    }
+    for (unsigned int i = 0; i < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++i) {
+        RemapArray(pMesh->mTextureCoords[i], remap);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Renumbers the vertices in the order they are first referenced by the faces, so the vertex
+// fetches of the cache-optimized face order walk the vertex buffer linearly.
+void ReorderVerticesForFetch(aiMesh* pMesh) {
+    std::vector<unsigned int> remap(pMesh->mNumVertices, UINT_MAX);
+    unsigned int iNext = 0;
+    for (unsigned int f = 0; f < pMesh->mNumFaces; ++f) {
+        const aiFace& face = pMesh->mFaces[f];
+        for (unsigned int i = 0; i < face.mNumIndices; ++i) {
+            if (UINT_MAX == remap[face.mIndices[i]]) {
+                remap[face.mIndices[i]] = iNext++;
+            }
+        }
+    }
+    // unreferenced vertices go to the end
+    bool bIdentity = true;
+    for (unsigned int v = 0; v < pMesh->mNumVertices; ++v) {
+        if (UINT_MAX == remap[v]) {
+            remap[v] = iNext++;
+        }
+        bIdentity = bIdentity && remap[v] == v;
+    }
+    if (bIdentity) {
+        return;
+    }
+
+    RemapVertexArrays(pMesh, remap);
+    for (unsigned int i = 0; i < pMesh->mNumAnimMeshes; ++i) {
+        if (pMesh->mAnimMeshes[i]->mNumVertices == pMesh->mNumVertices) {
+            RemapVertexArrays(pMesh->mAnimMeshes[i], remap);
+        }
+    }
+    for (unsigned int b = 0; b < pMesh->mNumBones; ++b) {
+        aiBone* bone = pMesh->mBones[b];
+        for (unsigned int w = 0; w < bone->mNumWeights; ++w) {
+            bone->mWeights[w].mVertexId = remap[bone->mWeights[w].mVertexId];
+        }
+    }
+    for (unsigned int f = 0; f < pMesh->mNumFaces; ++f) {
+        aiFace& face = pMesh->mFaces[f];
+        for (unsigned int i = 0; i < face.mNumIndices; ++i) {
+            face.mIndices[i] = remap[face.mIndices[i]];
+        }
+    }
 }
 
+} // namespace
+
 // ------------------------------------------------------------------------------------------------
 // Executes the post processing step on the given imported data.
 void ImproveCacheLocalityProcess::Execute( aiScene* pScene) {
@@ -97,10 +464,17 @@ void ImproveCacheLocalityProcess::Execute( aiScene* pScene) {
 
     ASSIMP_LOG_DEBUG("ImproveCacheLocalityProcess begin");
 
+    // meshes are independent, so they may be processed concurrently
+    std::vector<ai_real> results(pScene->mNumMeshes, static_cast<ai_real>(0.f));
+    ParallelFor(pScene->mNumMeshes, [&](unsigned int a) {
+        results[a] = ProcessMesh( pScene->mMeshes[a],a);
+    });
+
+    // sum up in mesh order to keep the statistics reproducible
     float out = 0.f;
     unsigned int numf = 0, numm = 0;
     for( unsigned int a = 0; a < pScene->mNumMeshes; ++a ){
-        const float res = ProcessMesh( pScene->mMeshes[a],a);
+        const float res = results[a];
         if (res) {
             numf += pScene->mMeshes[a]->mNumFaces;
             out  += res;
@@ -137,39 +511,18 @@ ai_real ImproveCacheLocalityProcess::ProcessMesh( aiMesh* pMesh, unsigned int me
     }
 
     ai_real fACMR = 3.f;
+    ai_real fATVR = 1.f;
     const aiFace* const pcEnd = pMesh->mFaces+pMesh->mNumFaces;
 
-    // Input ACMR is for logging purposes only
+    // Input ACMR is for logging purposes only. Reordering faces does not change which vertices
+    // are referenced, so iNumUsed also serves the output ATVR
+    unsigned int iNumUsed = 0;
     if (!DefaultLogger::isNullLogger())     {
 
-        unsigned int* piFIFOStack = new unsigned int[mConfigCacheDepth];
-        memset(piFIFOStack,0xff,mConfigCacheDepth*sizeof(unsigned int));
-        unsigned int* piCur = piFIFOStack;
-        const unsigned int* const piCurEnd = piFIFOStack + mConfigCacheDepth;
-
         // count the number of cache misses
-        unsigned int iCacheMisses = 0;
-        for (const aiFace* pcFace = pMesh->mFaces;pcFace != pcEnd;++pcFace) {
-            for (unsigned int qq = 0; qq < 3;++qq) {
-                bool bInCache = false;
-                for (unsigned int* pp = piFIFOStack;pp < piCurEnd;++pp) {
-                    if (*pp == pcFace->mIndices[qq])    {
-                        // the vertex is in cache
-                        bInCache = true;
-                        break;
-                    }
-                }
-                if (!bInCache)  {
-                    ++iCacheMisses;
-                    if (piCurEnd == piCur) {
-                        piCur = piFIFOStack;
-                    }
-                    *piCur++ = pcFace->mIndices[qq];
-                }
-            }
-        }
-        delete[] piFIFOStack;
+        const unsigned int iCacheMisses = CountCacheMisses(pMesh, mConfigCacheDepth, &iNumUsed);
         fACMR = (ai_real) iCacheMisses / pMesh->mNumFaces;
+        fATVR = (ai_real) iCacheMisses / iNumUsed;
         if (3.0 == fACMR)   {
             char szBuff[128]; // should be sufficiently large in every case
 
@@ -182,6 +535,10 @@ ai_real ImproveCacheLocalityProcess::ProcessMesh( aiMesh* pMesh, unsigned int me
         }
     }
 
+    if (1 == mConfigAlgorithm) {
+        return ProcessMeshForsyth(pMesh, meshNum, fACMR, fATVR);
+    }
+
     // first we need to build a vertex-triangle adjacency list
     VertexTriangleAdjacency adj(pMesh->mFaces,pMesh->mNumFaces, pMesh->mNumVertices,true);
 
@@ -355,7 +712,8 @@ ai_real ImproveCacheLocalityProcess::ProcessMesh( aiMesh* pMesh, unsigned int me
 
         // very intense verbose logging ... prepare for much text if there are many meshes
         if ( DefaultLogger::get()->getLogSeverity() == Logger::VERBOSE) {
-            ASSIMP_LOG_DEBUG_F("Mesh %u | ACMR in: ", meshNum, " out: ", fACMR, " | ~", fACMR2, ((fACMR - fACMR2) / fACMR) * 100.f);
+            ASSIMP_LOG_DEBUG_F("Mesh %u | ACMR in: ", meshNum, " out: ", fACMR, " | ~", fACMR2, ((fACMR - fACMR2) / fACMR) * 100.f,
+                " | ATVR in: ", fATVR, " out: ", (float)iCacheMisses / iNumUsed);
         }
 
         fACMR2 *= pMesh->mNumFaces;
@@ -377,3 +735,42 @@ ai_real ImproveCacheLocalityProcess::ProcessMesh( aiMesh* pMesh, unsigned int me
 
     return fACMR2;
 }
+
+// ------------------------------------------------------------------------------------------------
+// Reorders the faces of a mesh with Forsyth's algorithm, sorts them for overdraw if enabled and
+// renumbers the vertices for fetch locality
+ai_real ImproveCacheLocalityProcess::ProcessMeshForsyth( aiMesh* pMesh, unsigned int meshNum,
+        ai_real fACMR, ai_real fATVR) {
+    // the scoring function needs room for the three vertices of the last triangle
+    const unsigned int iCacheSize = std::max(mConfigCacheDepth, 4u);
+
+    std::vector<unsigned int> indices;
+    indices.reserve(pMesh->mNumFaces * 3);
+    for (unsigned int f = 0; f < pMesh->mNumFaces; ++f) {
+        const aiFace& face = pMesh->mFaces[f];
+        indices.insert(indices.end(), face.mIndices, face.mIndices + 3);
+    }
+
+    std::vector<unsigned int> optimized;
+    OptimizeForsyth(indices, pMesh->mNumVertices, iCacheSize, optimized);
+    if (mConfigOverdrawThreshold > 0.f) {
+        OptimizeOverdraw(optimized, pMesh->mVertices, pMesh->mNumVertices, mConfigCacheDepth, mConfigOverdrawThreshold);
+    }
+
+    for (unsigned int f = 0; f < pMesh->mNumFaces; ++f) {
+        std::copy(optimized.begin() + f * 3, optimized.begin() + f * 3 + 3, pMesh->mFaces[f].mIndices);
+    }
+    ReorderVerticesForFetch(pMesh);
+
+    if (DefaultLogger::isNullLogger()) {
+        return static_cast<ai_real>(0.f);
+    }
+    unsigned int iNumUsed = 0;
+    const unsigned int iCacheMisses = CountCacheMisses(pMesh, mConfigCacheDepth, &iNumUsed);
+    if ( DefaultLogger::get()->getLogSeverity() == Logger::VERBOSE) {
+        const float fACMR2 = (float)iCacheMisses / pMesh->mNumFaces;
+        ASSIMP_LOG_DEBUG_F("Mesh ", meshNum, " | ACMR in: ", fACMR, " out: ", fACMR2, " | ~", ((fACMR - fACMR2) / fACMR) * 100.f,
+            " | ATVR in: ", fATVR, " out: ", (float)iCacheMisses / iNumUsed);
+    }
+    return static_cast<ai_real>(iCacheMisses);
+}
@@ -58,6 +58,8 @@ namespace Assimp
 /** The ImproveCacheLocalityProcess reorders all faces for improved vertex
  *  cache locality. It tries to arrange all faces to fans and to render
  *  faces which share vertices directly one after the other.
+ *  Alternatively it runs Forsyth's algorithm, reorders the vertices in the
+ *  order they are fetched and optionally sorts the faces for less overdraw.
  *
  *  @note This step expects triagulated input data.
  */
@@ -90,10 +92,25 @@ protected:
      */
     ai_real ProcessMesh( aiMesh* pMesh, unsigned int meshNum);
 
+    // -------------------------------------------------------------------
+    /** Optimizes the given mesh with Forsyth's algorithm
+     * @param pMesh The mesh to process.
+     * @param meshNum Index of the mesh to process
+     * @param fACMR Input ACMR, for logging
+     * @param fATVR Input ATVR, for logging
+     */
+    ai_real ProcessMeshForsyth( aiMesh* pMesh, unsigned int meshNum, ai_real fACMR, ai_real fATVR);
+
 private:
     //! Configuration parameter: specifies the size of the cache to
     //! optimize the vertex data for.
     unsigned int mConfigCacheDepth;
+
+    //! Configuration parameter: 0 for Tipsify, 1 for Forsyth's algorithm
+    int mConfigAlgorithm;
+
+    //! Configuration parameter: ACMR threshold for overdraw ordering, 0 if disabled
+    float mConfigOverdrawThreshold;
 };
 
 } // end of namespace Assimp
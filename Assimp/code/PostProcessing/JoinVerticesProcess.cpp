@@ -52,13 +52,24 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ProcessHelper.h"
 #include <assimp/Vertex.h>
 #include <assimp/TinyFormatter.h>
+#include <limits.h>
 #include <stdio.h>
+#include <string.h>
+#include <cmath>
+#include <limits>
+#include <memory>
 #include <unordered_set>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define ASSIMP_JIV_SSE2
+#   include <emmintrin.h>
+#endif
+
 using namespace Assimp;
 // ------------------------------------------------------------------------------------------------
 // Constructor to be privately used by Importer
 JoinVerticesProcess::JoinVerticesProcess()
+: mExactMatch( false )
 {
     // nothing to do here
 }
@@ -76,6 +87,13 @@ bool JoinVerticesProcess::IsActive( unsigned int pFlags) const
 {
     return (pFlags & aiProcess_JoinIdenticalVertices) != 0;
 }
+// ------------------------------------------------------------------------------------------------
+// Setup import configuration
+void JoinVerticesProcess::SetupProperties(const Importer* pImp)
+{
+    mExactMatch = 0 != pImp->GetPropertyInteger(AI_CONFIG_PP_JIV_EXACT_MATCH, 0);
+}
+
 // ------------------------------------------------------------------------------------------------
 // Executes the post processing step on the given imported data.
 void JoinVerticesProcess::Execute( aiScene* pScene)
@@ -90,10 +108,15 @@ void JoinVerticesProcess::Execute( aiScene* pScene)
         }
     }
 
-    // execute the step
+    // execute the step, meshes are independent so they may be processed concurrently
+    std::vector<int> numVertices(pScene->mNumMeshes, 0);
+    ParallelFor(pScene->mNumMeshes, [&](unsigned int a) {
+        numVertices[a] = ProcessMesh( pScene->mMeshes[a],a);
+    });
+
     int iNumVertices = 0;
     for( unsigned int a = 0; a < pScene->mNumMeshes; a++)
-        iNumVertices += ProcessMesh( pScene->mMeshes[a],a);
+        iNumVertices += numVertices[a];
 
     // if logging is active, print detailed statistics
     if (!DefaultLogger::isNullLogger()) {
@@ -159,6 +182,144 @@ bool areVerticesEqual(const Vertex &lhs, const Vertex &rhs, bool complex)
     return true;
 }
 
+// ------------------------------------------------------------------------------------------------
+// Lookup table of the exact-match mode. Each vertex is flattened into a record of all channels
+// present in the mesh and its animation meshes, with -0 folded into +0 and every NaN into the
+// same quiet NaN. Two vertices are equal exactly if their records are bitwise identical, which
+// is checked 16 bytes at a time.
+class ExactVertexTable {
+public:
+    explicit ExactVertexTable(const aiMesh *pMesh)
+    : mRecordSize(0) {
+        const unsigned int numVertices = pMesh->mNumVertices;
+        addChannels(pMesh);
+        for (unsigned int i = 0; i < pMesh->mNumAnimMeshes; ++i) {
+            // an animation mesh with fewer vertices than the mesh can't be read for all of them
+            const aiAnimMesh *animMesh = pMesh->mAnimMeshes[i];
+            if (animMesh != nullptr && animMesh->mNumVertices >= numVertices) {
+                addChannels(animMesh);
+            }
+        }
+
+        // interleave the channels into one record per vertex
+        mRecords.resize(size_t(numVertices) * mRecordSize);
+        size_t offset = 0;
+        for (const Channel &channel : mChannels) {
+            for (unsigned int v = 0; v < numVertices; ++v) {
+                const ai_real *in = channel.data + size_t(v) * channel.components;
+                ai_real *out = &mRecords[size_t(v) * mRecordSize + offset];
+                for (unsigned int c = 0; c < channel.components; ++c) {
+                    out[c] = canonical(in[c]);
+                }
+            }
+            offset += channel.components;
+        }
+
+        // FNV-1a over the 32 bit words of each record
+        mHashes.resize(numVertices);
+        const size_t numWords = mRecordSize * sizeof(ai_real) / sizeof(uint32_t);
+        for (unsigned int v = 0; v < numVertices; ++v) {
+            const char *record = reinterpret_cast<const char*>(getRecord(v));
+            uint64_t hash = 0xcbf29ce484222325ull;
+            for (size_t w = 0; w < numWords; ++w) {
+                uint32_t word;
+                ::memcpy(&word, record + w * sizeof(uint32_t), sizeof(word));
+                hash = (hash ^ word) * 0x100000001b3ull;
+            }
+            mHashes[v] = static_cast<uint32_t>(hash ^ (hash >> 32));
+        }
+
+        size_t capacity = 16;
+        while (capacity < size_t(numVertices) * 2) {
+            capacity *= 2;
+        }
+        mSlots.assign(capacity, UINT_MAX);
+    }
+
+    // Returns the first vertex inserted before with the same record as the given one. If
+    // there is none, the vertex is inserted and its own index is returned.
+    unsigned int findOrInsert(unsigned int vertex) {
+        const size_t mask = mSlots.size() - 1;
+        const uint32_t hash = mHashes[vertex];
+        for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+            const unsigned int other = mSlots[slot];
+            if (other == UINT_MAX) {
+                mSlots[slot] = vertex;
+                return vertex;
+            }
+            if (mHashes[other] == hash && areRecordsEqual(getRecord(other), getRecord(vertex))) {
+                return other;
+            }
+        }
+    }
+
+private:
+    struct Channel {
+        const ai_real *data;
+        unsigned int components;
+    };
+
+    // -0 becomes +0 and every NaN the same quiet NaN, whatever its sign and payload
+    static ai_real canonical(ai_real value) {
+        return std::isnan(value) ? std::numeric_limits<ai_real>::quiet_NaN() : value + ai_real(0.0);
+    }
+
+    template<class XMesh>
+    void addChannels(const XMesh *pMesh) {
+        if (pMesh->HasPositions()) {
+            addChannel(&pMesh->mVertices[0].x, 3);
+        }
+        if (pMesh->HasNormals()) {
+            addChannel(&pMesh->mNormals[0].x, 3);
+        }
+        if (pMesh->HasTangentsAndBitangents()) {
+            addChannel(&pMesh->mTangents[0].x, 3);
+            addChannel(&pMesh->mBitangents[0].x, 3);
+        }
+        for (unsigned int i = 0; pMesh->HasTextureCoords(i); ++i) {
+            addChannel(&pMesh->mTextureCoords[i][0].x, 3);
+        }
+        for (unsigned int i = 0; pMesh->HasVertexColors(i); ++i) {
+            addChannel(&pMesh->mColors[i][0].r, 4);
+        }
+    }
+
+    void addChannel(const ai_real *data, unsigned int components) {
+        Channel channel;
+        channel.data = data;
+        channel.components = components;
+        mChannels.push_back(channel);
+        mRecordSize += components;
+    }
+
+    const ai_real *getRecord(unsigned int vertex) const {
+        return &mRecords[size_t(vertex) * mRecordSize];
+    }
+
+    bool areRecordsEqual(const ai_real *lhs, const ai_real *rhs) const {
+        const char *a = reinterpret_cast<const char*>(lhs);
+        const char *b = reinterpret_cast<const char*>(rhs);
+        const size_t size = mRecordSize * sizeof(ai_real);
+        size_t i = 0;
+#ifdef ASSIMP_JIV_SSE2
+        for (; i + 16 <= size; i += 16) {
+            const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)) != 0xffff) {
+                return false;
+            }
+        }
+#endif
+        return 0 == ::memcmp(a + i, b + i, size - i);
+    }
+
+    std::vector<Channel> mChannels;
+    size_t mRecordSize;
+    std::vector<ai_real> mRecords;
+    std::vector<uint32_t> mHashes;
+    std::vector<unsigned int> mSlots;
+};
+
 template<class XMesh>
 void updateXMeshVertices(XMesh *pMesh, std::vector<Vertex> &uniqueVertices) {
     // replace vertex data with the unique data sets
@@ -266,11 +427,17 @@ int JoinVerticesProcess::ProcessMesh( aiMesh* pMesh, unsigned int meshIndex)
     std::vector<unsigned int> replaceIndex( pMesh->mNumVertices, 0xffffffff);
 
     // float posEpsilonSqr;
-    SpatialSort* vertexFinder = NULL;
-    SpatialSort _vertexFinder;
+    SpatialGrid* vertexFinder = NULL;
+    SpatialGrid _vertexFinder;
 
-    typedef std::pair<SpatialSort,float> SpatPair;
-    if (shared) {
+    // the exact-match mode gets along without any spatial lookup
+    std::unique_ptr<ExactVertexTable> exactTable;
+    if (mExactMatch) {
+        exactTable.reset(new ExactVertexTable(pMesh));
+    }
+
+    typedef std::pair<SpatialGrid,float> SpatPair;
+    if (shared && !exactTable) {
         std::vector<SpatPair >* avf;
         shared->GetProperty(AI_SPP_SPATIAL_SORT,avf);
         if (avf)    {
@@ -279,7 +446,7 @@ int JoinVerticesProcess::ProcessMesh( aiMesh* pMesh, unsigned int meshIndex)
             // posEpsilonSqr = blubb.second;
         }
     }
-    if (!vertexFinder)  {
+    if (!vertexFinder && !exactTable)  {
         // bad, need to compute it.
         _vertexFinder.Fill(pMesh->mVertices, pMesh->mNumVertices, sizeof( aiVector3D));
         vertexFinder = &_vertexFinder;
@@ -310,11 +477,22 @@ int JoinVerticesProcess::ProcessMesh( aiMesh* pMesh, unsigned int meshIndex)
             continue;
         }
 
+        if (exactTable) {
+            // the first vertex with the same data is the unique one, all others refer to it
+            const unsigned int first = exactTable->findOrInsert(a);
+            if (first != a) {
+                replaceIndex[a] = replaceIndex[first] | 0x80000000;
+                continue;
+            }
+        }
+
         // collect the vertex data
         Vertex v(pMesh,a);
 
         // collect all vertices that are close enough to the given position
-        vertexFinder->FindIdenticalPositions( v.position, verticesFound);
+        if (vertexFinder) {
+            vertexFinder->FindIdenticalPositions( v.position, verticesFound);
+        }
         unsigned int matchIndex = 0xffffffff;
 
         // check all unique vertices close to the position if this vertex is already present among them
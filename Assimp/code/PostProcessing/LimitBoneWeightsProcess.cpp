@@ -78,9 +78,10 @@ bool LimitBoneWeightsProcess::IsActive( unsigned int pFlags) const
 // Executes the post processing step on the given imported data.
 void LimitBoneWeightsProcess::Execute( aiScene* pScene) {
     ASSIMP_LOG_DEBUG("LimitBoneWeightsProcess begin");
-    for (unsigned int a = 0; a < pScene->mNumMeshes; ++a ) {
+    // meshes are independent, so they may be processed concurrently
+    ParallelFor(pScene->mNumMeshes, [&](unsigned int a) {
         ProcessMesh(pScene->mMeshes[a]);
-    }
+    });
 
     ASSIMP_LOG_DEBUG("LimitBoneWeightsProcess end");
 }
@@ -51,6 +51,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/scene.h>
 
 #include <assimp/SpatialSort.h>
+#include <assimp/SpatialGrid.h>
 #include "Common/BaseProcess.h"
 #include <assimp/ParsingUtils.h>
 
@@ -335,7 +336,7 @@ const char* MappingTypeToString(aiTextureMapping in);
 aiMesh* MakeSubmesh(const aiMesh *superMesh, const std::vector<unsigned int> &subMeshFaces, unsigned int subFlags);
 
 // -------------------------------------------------------------------------------
-// Utility postprocess step to share the spatial sort tree between
+// Utility postprocess step to share the spatial grid between
 // all steps which use it to speedup its computations.
 class ComputeSpatialSortProcess : public BaseProcess
 {
@@ -347,7 +348,7 @@ class ComputeSpatialSortProcess : public BaseProcess
 
     void Execute( aiScene* pScene)
     {
-        typedef std::pair<SpatialSort, ai_real> _Type;
+        typedef std::pair<SpatialGrid, ai_real> _Type;
         ASSIMP_LOG_DEBUG("Generate spatially-sorted vertex cache");
 
         std::vector<_Type>* p = new std::vector<_Type>(pScene->mNumMeshes);
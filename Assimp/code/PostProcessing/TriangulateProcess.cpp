@@ -102,13 +102,19 @@ void TriangulateProcess::Execute( aiScene* pScene)
 {
     ASSIMP_LOG_DEBUG("TriangulateProcess begin");
 
+    // meshes are independent, so they may be processed concurrently
+    std::vector<char> processed(pScene->mNumMeshes, 0);
+    ParallelFor(pScene->mNumMeshes, [&](unsigned int a) {
+        if (pScene->mMeshes[ a ]) {
+            processed[ a ] = TriangulateMesh( pScene->mMeshes[ a ] );
+        }
+    });
+
     bool bHas = false;
     for( unsigned int a = 0; a < pScene->mNumMeshes; a++)
     {
-        if (pScene->mMeshes[ a ]) {
-            if ( TriangulateMesh( pScene->mMeshes[ a ] ) ) {
-                bHas = true;
-            }
+        if ( processed[ a ] ) {
+            bHas = true;
         }
     }
     if ( bHas ) {
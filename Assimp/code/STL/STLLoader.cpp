@@ -188,13 +188,17 @@ void STLImporter::InternReadFile( const std::string& pFile, aiScene* pScene, IOS
 
     fileSize = (unsigned int)file->FileSize();
 
-    // allocate storage and copy the contents of the file to a memory buffer
-    // (terminate it with zero)
+    // binary files are read in place if the stream already holds them in
+    // memory. Otherwise allocate storage and copy the contents of the file
+    // to a memory buffer (terminate it with zero)
     std::vector<char> buffer2;
-    TextFileToBuffer(file.get(),buffer2);
+    this->mBuffer = reinterpret_cast<const char*>(file->GetContents());
+    if (!mBuffer || !IsBinarySTL(mBuffer, fileSize)) {
+        TextFileToBuffer(file.get(),buffer2);
+        this->mBuffer = &buffer2[0];
+    }
 
     this->pScene = pScene;
-    this->mBuffer = &buffer2[0];
 
     // the default vertex color is light gray.
     clrColorDefault.r = clrColorDefault.g = clrColorDefault.b = clrColorDefault.a = (ai_real) 0.6;
@@ -528,6 +528,15 @@ namespace glTF2
 
         bool LoadFromStream(IOStream& stream, size_t length = 0, size_t baseOffset = 0);
 
+		/// \fn bool MapFromStream(const shared_ptr<IOStream>& stream, size_t length, size_t baseOffset)
+		/// Reference the data in place if the stream exposes its contents (\ref IOStream::GetContents) instead of copying it.
+		/// The buffer keeps the stream open as long as it references the data.
+		/// \param [in] stream - stream to reference.
+		/// \param [in] length - size of the data, in bytes.
+		/// \param [in] baseOffset - offset of the data in the stream, in bytes.
+		/// \return false if the stream doesn't expose its contents or the range is out of bounds, the buffer is not changed then.
+		bool MapFromStream(const shared_ptr<IOStream>& stream, size_t length, size_t baseOffset);
+
 		/// \fn void EncodedRegion_Mark(const size_t pOffset, const size_t pEncodedData_Length, uint8_t* pDecodedData, const size_t pDecodedData_Length, const std::string& pID)
 		/// Mark region of "bufferView" as encoded. When data is request from such region then "bufferView" use decoded data.
 		/// \param [in] pOffset - offset from begin of "bufferView" to encoded region, in bytes.
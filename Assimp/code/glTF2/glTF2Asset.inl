@@ -416,6 +416,19 @@ inline bool Buffer::LoadFromStream(IOStream& stream, size_t length, size_t baseO
     return true;
 }
 
+inline bool Buffer::MapFromStream(const shared_ptr<IOStream>& stream, size_t length, size_t baseOffset)
+{
+    const uint8_t* contents = stream->GetContents();
+    if (!contents || baseOffset > stream->FileSize() || length > stream->FileSize() - baseOffset) {
+        return false;
+    }
+
+    // the data is only read from, the deleter just keeps the stream alive
+    byteLength = length;
+    mData.reset(const_cast<uint8_t*>(contents + baseOffset), [stream](uint8_t*) {});
+    return true;
+}
+
 inline void Buffer::EncodedRegion_Mark(const size_t pOffset, const size_t pEncodedData_Length, uint8_t* pDecodedData, const size_t pDecodedData_Length, const std::string& pID)
 {
 	// Check pointer to data
@@ -1394,7 +1407,8 @@ inline void Asset::Load(const std::string& pFile, bool isBinary)
 
     // Fill the buffer instance for the current file embedded contents
     if (mBodyLength > 0) {
-        if (!mBodyBuffer->LoadFromStream(*stream, mBodyLength, mBodyOffset)) {
+        if (!mBodyBuffer->MapFromStream(stream, mBodyLength, mBodyOffset) &&
+                !mBodyBuffer->LoadFromStream(*stream, mBodyLength, mBodyOffset)) {
             throw DeadlyImportError("GLTF: Unable to read gltf file");
         }
     }
@@ -1310,7 +1310,20 @@ with 'slow' file formats like X or Collada might scale well with multiple concur
 
 @section automt Internal threading
 
-Internal multi-threading is not currently implemented.
+The post-processing pipeline can spread its per-mesh work over several threads. This is opt-in: set
+#AI_CONFIG_GLOB_MULTITHREADING to the number of threads to use, e.g.
+
+@code
+Assimp::Importer importer;
+importer.SetPropertyInteger(AI_CONFIG_GLOB_MULTITHREADING, 4);
+const aiScene* scene = importer.ReadFile(file, aiProcessPreset_TargetRealtime_MaxQuality);
+@endcode
+
+The worker threads belong to the #Assimp::Importer instance and live until it is destroyed or the property is
+reset. The resulting scene is identical to a single-threaded import; only the order of log messages may differ.
+Some importers use the same threads: IRR, LWS and MD3 load their external files concurrently and the FBX importer
+inflates the compressed arrays of binary files in parallel.
+Since log messages can be emitted from the worker threads, custom log streams must be thread-safe in this mode.
 */
 
 /**
@@ -122,6 +122,16 @@ public:
      *  See fflush() for more details.
      */
     virtual void Flush() = 0;
+
+    // -------------------------------------------------------------------
+    /** @brief Get a pointer to the whole file contents, if available
+     *
+     *  Streams which keep the file in memory anyway (i.e. a memory
+     *  mapping) may expose it here, so importers can parse it in place
+     *  instead of reading a copy. The pointer stays valid until the
+     *  stream is closed and is not affected by Read() or Seek().
+     *  @return NULL if the stream can't provide it (the default). */
+    virtual const uint8_t* GetContents() const;
 }; //! class IOStream
 
 // ----------------------------------------------------------------------------------
@@ -135,6 +145,12 @@ inline
 IOStream::~IOStream() {
     // empty
 }
+
+// ----------------------------------------------------------------------------------
+inline
+const uint8_t* IOStream::GetContents() const {
+    return nullptr;
+}
 // ----------------------------------------------------------------------------------
 
 } //!namespace Assimp
@@ -97,6 +97,10 @@ public:
     /// @return The current file pos.
     size_t getFilePos() const;
 
+    /// @brief  Returns the number of line feeds consumed by getNextDataLine() so far.
+    /// @return The zero-based line the next data line starts on.
+    size_t getLineNumber() const;
+
     /// @brief  Will read the next line.
     /// @param  buffer      The buffer for the next line.
     /// @return true if successful.
@@ -112,6 +116,13 @@ public:
     /// @return true if successful.
     bool getNextBlock( std::vector<T> &buffer );
 
+    /// @brief  Will return the rest of the stream in place, if the stream exposes
+    ///         its contents (see IOStream::GetContents). The rest is consumed then.
+    /// @param  data        Receives the start of the remaining data.
+    /// @param  size        Receives the number of remaining elements.
+    /// @return false if the stream can't provide its contents.
+    bool getRemainingContents( const T *&data, size_t &size );
+
 private:
     IOStream *m_stream;
     size_t m_filesize;
@@ -121,6 +132,7 @@ private:
     std::vector<T> m_cache;
     size_t m_cachePos;
     size_t m_filePos;
+    size_t m_lineNumber;
 };
 
 template<class T>
@@ -132,7 +144,8 @@ IOStreamBuffer<T>::IOStreamBuffer( size_t cache )
 , m_numBlocks( 0 )
 , m_blockIdx( 0 )
 , m_cachePos( 0 )
-, m_filePos( 0 ) {
+, m_filePos( 0 )
+, m_lineNumber( 0 ) {
     m_cache.resize( cache );
     std::fill( m_cache.begin(), m_cache.end(), '\n' );
 }
@@ -187,6 +200,7 @@ bool IOStreamBuffer<T>::close() {
     m_blockIdx  = 0;
     m_cachePos  = 0;
     m_filePos   = 0;
+    m_lineNumber = 0;
 
     return true;
 }
@@ -239,6 +253,12 @@ size_t IOStreamBuffer<T>::getFilePos() const {
     return m_filePos;
 }
 
+template<class T>
+inline
+size_t IOStreamBuffer<T>::getLineNumber() const {
+    return m_lineNumber;
+}
+
 template<class T>
 inline
 bool IOStreamBuffer<T>::getNextDataLine( std::vector<T> &buffer, T continuationToken ) {
@@ -266,6 +286,7 @@ bool IOStreamBuffer<T>::getNextDataLine( std::vector<T> &buffer, T continuationT
                     ++m_cachePos;
                 }
                 ++m_cachePos;
+                ++m_lineNumber;
                 continuationFound = false;
             }
         }
@@ -284,6 +305,9 @@ bool IOStreamBuffer<T>::getNextDataLine( std::vector<T> &buffer, T continuationT
     }
     
     buffer[ i ] = '\n';
+    if ( m_cachePos < m_cacheSize && '\n' == m_cache[ m_cachePos ] ) {
+        ++m_lineNumber;
+    }
     ++m_cachePos;
 
     return true;
@@ -352,4 +376,25 @@ bool IOStreamBuffer<T>::getNextBlock( std::vector<T> &buffer) {
     return true;
 }
 
+template<class T>
+inline
+bool IOStreamBuffer<T>::getRemainingContents( const T *&data, size_t &size ) {
+    const uint8_t *contents = m_stream->GetContents();
+    if ( nullptr == contents ) {
+        return false;
+    }
+
+    // position of the first element not handed out yet
+    const size_t pos = 0 == m_filePos ? 0 : m_filePos - m_cacheSize + m_cachePos;
+    data = reinterpret_cast<const T*>( contents ) + pos;
+    size = m_filesize - pos;
+
+    // nothing left to read
+    m_filePos = m_filesize;
+    m_cachePos = 0;
+    m_blockIdx = m_numBlocks;
+
+    return true;
+}
+
 } // !ns Assimp
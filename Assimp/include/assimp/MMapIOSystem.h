@@ -0,0 +1,128 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2019, assimp team
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file MMapIOSystem.h
+ *  @brief Implementation of IOSystem mapping files into memory.
+ */
+#pragma once
+#ifndef AI_MMAPIOSYSTEM_H_INC
+#define AI_MMAPIOSYSTEM_H_INC
+
+#include <assimp/DefaultIOSystem.h>
+#include <assimp/IOStream.hpp>
+
+namespace Assimp    {
+
+// ----------------------------------------------------------------------------------
+//! @class  MMapIOStream
+//! @brief  Read-only IOStream on top of a file mapped into memory.
+//!
+//! The mapped contents are exposed through GetContents(), so importers can parse
+//! them in place instead of reading a copy of the file.
+class ASSIMP_API MMapIOStream : public IOStream {
+    friend class MMapIOSystem;
+
+protected:
+    MMapIOStream(const uint8_t* data, size_t size) AI_NO_EXCEPT;
+
+public:
+    /** Destructor public to allow simple deletion to unmap the file. */
+    ~MMapIOStream();
+
+    // -------------------------------------------------------------------
+    /// Read from stream
+    size_t Read(void* pvBuffer,
+        size_t pSize,
+        size_t pCount) override;
+
+    // -------------------------------------------------------------------
+    /// Write to stream, always fails as mappings are read-only
+    size_t Write(const void* pvBuffer,
+        size_t pSize,
+        size_t pCount) override;
+
+    // -------------------------------------------------------------------
+    /// Seek specific position
+    aiReturn Seek(size_t pOffset,
+        aiOrigin pOrigin) override;
+
+    // -------------------------------------------------------------------
+    /// Get current seek position
+    size_t Tell() const override;
+
+    // -------------------------------------------------------------------
+    /// Get size of file
+    size_t FileSize() const override;
+
+    // -------------------------------------------------------------------
+    /// Flush file contents, nothing to do for read-only mappings
+    void Flush() override;
+
+    // -------------------------------------------------------------------
+    /// Get the mapped file contents
+    const uint8_t* GetContents() const override;
+
+private:
+    //  Start of the mapping, NULL for empty files
+    const uint8_t* mData;
+    //  Size of the mapping
+    size_t mSize;
+    //  Read cursor
+    size_t mPos;
+};
+
+// ---------------------------------------------------------------------------
+/** IOSystem mapping files opened for reading into memory.
+ *
+ *  Files opened in any other mode, or which can't be mapped, are handled
+ *  like DefaultIOSystem does. Use it with Importer::SetIOHandler() to
+ *  avoid the full-file copy some importers make of their input. */
+class ASSIMP_API MMapIOSystem : public DefaultIOSystem {
+public:
+    // -------------------------------------------------------------------
+    /** Open a new file with a given path. */
+    IOStream* Open( const char* pFile, const char* pMode = "rb") override;
+};
+
+} //!ns Assimp
+
+#endif //AI_MMAPIOSYSTEM_H_INC
@@ -136,6 +136,12 @@ public:
         ai_assert(false); // won't be needed
     }
 
+    // -------------------------------------------------------------------
+    // Get the whole buffer
+    const uint8_t* GetContents() const {
+        return buffer;
+    }
+
 private:
     const uint8_t* buffer;
     size_t length,pos;
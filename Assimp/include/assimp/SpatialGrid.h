@@ -0,0 +1,210 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2019, assimp team
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** Uniform grid to quickly find vertices close to a given location */
+#ifndef AI_SPATIALGRID_H_INC
+#define AI_SPATIALGRID_H_INC
+
+#include <vector>
+#include <stdint.h>
+#include <assimp/types.h>
+
+namespace Assimp {
+
+// ------------------------------------------------------------------------------------------------
+/** Drop-in replacement for #SpatialSort which buckets the positions into a uniform grid.
+ * The occupied cells are kept in an open-addressing hash table keyed by their integer
+ * coordinates, so a query only visits the cells overlapping the search radius. Unlike the
+ * sorting plane of #SpatialSort this does not degrade when many vertices lay on a common plane,
+ * as is typical for architectural models. The cell size is chosen from the bounding box so
+ * that each cell holds about two positions.
+ *
+ * All query results are ordered by ascending vertex index. #FindAllPositions() answers the
+ * query for every stored position at once and returns a compressed adjacency list. */
+// ------------------------------------------------------------------------------------------------
+class ASSIMP_API SpatialGrid
+{
+public:
+
+    SpatialGrid();
+
+    // ------------------------------------------------------------------------------------
+    /** Constructs a grid from the given position array.
+     * @param pPositions Pointer to the first position vector of the array.
+     * @param pNumPositions Number of vectors to expect in that array.
+     * @param pElementOffset Offset in bytes from the beginning of one vector in memory
+     *   to the beginning of the next vector. */
+    SpatialGrid( const aiVector3D* pPositions, unsigned int pNumPositions,
+        unsigned int pElementOffset);
+
+    /** Destructor */
+    ~SpatialGrid();
+
+public:
+
+    // ------------------------------------------------------------------------------------
+    /** Sets the input data for the grid. This replaces existing data, if any.
+     *  The new data receives new indices in ascending order.
+     *
+     * @param pPositions Pointer to the first position vector of the array.
+     * @param pNumPositions Number of vectors to expect in that array.
+     * @param pElementOffset Offset in bytes from the beginning of one vector in memory
+     *   to the beginning of the next vector.
+     * @param pFinalize Specifies whether the grid is built after the new data has
+     *   been added. This is required before any query. If you don't finalize yet,
+     *   you can use #Append() to add data from other sources.*/
+    void Fill( const aiVector3D* pPositions, unsigned int pNumPositions,
+        unsigned int pElementOffset,
+        bool pFinalize = true);
+
+    // ------------------------------------------------------------------------------------
+    /** Same as #Fill(), except the method appends to existing data in the grid. */
+    void Append( const aiVector3D* pPositions, unsigned int pNumPositions,
+        unsigned int pElementOffset,
+        bool pFinalize = true);
+
+    // ------------------------------------------------------------------------------------
+    /** Builds the grid over all positions added so far. Required after calls to
+     *  #Append() with the pFinalize parameter set to false. */
+    void Finalize();
+
+    // ------------------------------------------------------------------------------------
+    /** Fills an array with the indices of all positions close to the given position.
+     * @param pPosition The position to look for vertices.
+     * @param pRadius Maximal distance from the position a vertex may have to be counted in.
+     * @param poResults The container to store the indices of the found positions.
+     *   Will be emptied by the call so it may contain anything.*/
+    void FindPositions( const aiVector3D& pPosition, ai_real pRadius,
+        std::vector<unsigned int>& poResults) const;
+
+    // ------------------------------------------------------------------------------------
+    /** Fills an array with indices of all positions identical to the given position,
+     *  using the same tolerance of a few floating-point units as
+     *  SpatialSort::FindIdenticalPositions().
+     * @param pPosition The position to look for vertices.
+     * @param poResults The container to store the indices of the found positions.
+     *   Will be emptied by the call so it may contain anything.*/
+    void FindIdenticalPositions( const aiVector3D& pPosition,
+        std::vector<unsigned int>& poResults) const;
+
+    // ------------------------------------------------------------------------------------
+    /** Runs #FindPositions() for every stored position at once. The neighbours of
+     *  position i are poResults[poOffsets[i]] ... poResults[poOffsets[i+1]-1]; each
+     *  position is contained in its own list.
+     * @param pRadius Maximal distance from a position a vertex may have to be counted in.
+     * @param poOffsets Receives the number of positions plus one offsets.
+     * @param poResults Receives the concatenated neighbour lists. */
+    void FindAllPositions( ai_real pRadius, std::vector<unsigned int>& poOffsets,
+        std::vector<unsigned int>& poResults) const;
+
+    // ------------------------------------------------------------------------------------
+    /** Runs #FindIdenticalPositions() for every stored position at once. The layout
+     *  of the results matches #FindAllPositions(). */
+    void FindAllIdenticalPositions( std::vector<unsigned int>& poOffsets,
+        std::vector<unsigned int>& poResults) const;
+
+    // ------------------------------------------------------------------------------------
+    /** Compute a table that maps each vertex ID referring to a spatially close
+     *  enough position to the same output ID. Output IDs are assigned in ascending order
+     *  from 0...n, each one to the lowest vertex ID not mapped yet and all unmapped
+     *  positions within the radius of it.
+     * @param fill Will be filled with numPositions entries.
+     * @param pRadius Maximal distance from the position a vertex may have to
+     *   be counted in.
+     *  @return Number of unique vertices (n).  */
+    unsigned int GenerateMappingTable(std::vector<unsigned int>& fill,
+        ai_real pRadius) const;
+
+protected:
+    /** An entry in the grid. Consists of a vertex index, its position and the key of the
+     * cell it falls into */
+    struct Entry {
+        uint64_t mCell; ///< Packed integer coordinates of the cell
+        unsigned int mIndex; ///< The vertex referred by this entry
+        aiVector3D mPosition; ///< Position
+
+        Entry() AI_NO_EXCEPT
+        : mCell( 0 ), mIndex( 999999999 ), mPosition() {
+            // empty
+        }
+        Entry( unsigned int pIndex, const aiVector3D& pPosition)
+        : mCell( 0 ), mIndex( pIndex), mPosition( pPosition) {
+            // empty
+        }
+    };
+
+    /** A slot of the cell hash table, referring to a range of #mPositions */
+    struct Cell {
+        uint64_t mKey;
+        unsigned int mBegin;
+        unsigned int mEnd;
+    };
+
+    /** Appends the indices of all positions within the radius to poResults */
+    void Query( const aiVector3D& pPosition, ai_real pRadius, bool pIdentical,
+        std::vector<unsigned int>& poResults) const;
+
+    /** Returns the hash table slot of the given cell, or NULL if it is empty */
+    const Cell* FindCell( uint64_t pKey) const;
+
+    /** Returns the clamped integer coordinate of a position on one axis */
+    int ToCell( ai_real pValue, unsigned int pAxis) const;
+
+    // all positions, sorted by cell. Before #Finalize() in order of their indices.
+    std::vector<Entry> mPositions;
+
+    // for each vertex index the entry in mPositions referring to it
+    std::vector<unsigned int> mEntryOfIndex;
+
+    // hash table of occupied cells, its size is a power of two
+    std::vector<Cell> mCells;
+    unsigned int mNumCells;
+
+    // grid origin, inverse cell size and number of cells along each axis
+    aiVector3D mMin;
+    ai_real mInvCellSize;
+    int mDims[3];
+};
+
+} // end of namespace Assimp
+
+#endif // AI_SPATIALGRID_H_INC
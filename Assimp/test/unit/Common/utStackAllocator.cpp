@@ -0,0 +1,132 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2019, assimp team
+
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+copyright notice, this list of conditions and the
+following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the
+following disclaimer in the documentation and/or other
+materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+contributors may be used to endorse or promote products
+derived from this software without specific prior
+written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+#include "UnitTestPCH.h"
+
+#include "Common/StackAllocator.h"
+
+#include <cstring>
+#include <vector>
+
+using namespace Assimp;
+
+class utStackAllocator : public ::testing::Test {
+protected:
+    struct Allocation {
+        uint8_t *data;
+        size_t size;
+        uint8_t fill;
+    };
+
+    // fills the allocation with a pattern of its own, so overlapping ones are caught later
+    static Allocation allocateFilled(StackAllocator &allocator, size_t size, uint8_t fill) {
+        Allocation allocation = { static_cast<uint8_t *>(allocator.Allocate(size)), size, fill };
+        memset(allocation.data, fill, size);
+        return allocation;
+    }
+
+    static void expectIntact(const std::vector<Allocation> &allocations) {
+        for (const Allocation &allocation : allocations) {
+            size_t wrong = 0;
+            for (size_t i = 0; i < allocation.size; ++i) {
+                wrong += allocation.data[i] != allocation.fill;
+            }
+            EXPECT_EQ(0u, wrong) << "allocation of " << allocation.size << " bytes was overwritten";
+        }
+    }
+};
+
+TEST_F(utStackAllocator, alignmentTest) {
+    StackAllocator allocator;
+    const size_t alignment = alignof(std::max_align_t);
+    for (size_t size = 1; size < 1000; ++size) {
+        void *p = allocator.Allocate(size);
+        ASSERT_NE(nullptr, p);
+        EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(p) % alignment) << "allocation of " << size << " bytes";
+    }
+}
+
+TEST_F(utStackAllocator, allocationsDontOverlapTest) {
+    StackAllocator allocator;
+    std::vector<Allocation> allocations;
+
+    // small sizes fill up and roll over a few blocks
+    for (unsigned int i = 0; i < 20000; ++i) {
+        allocations.push_back(allocateFilled(allocator, 1 + i % 61, static_cast<uint8_t>(i)));
+    }
+    expectIntact(allocations);
+}
+
+TEST_F(utStackAllocator, oversizedAllocationTest) {
+    StackAllocator allocator;
+    std::vector<Allocation> allocations;
+    allocations.push_back(allocateFilled(allocator, 100, 1));
+
+    // far larger than the first block, it has to get one of its own
+    allocations.push_back(allocateFilled(allocator, 1024 * 1024, 2));
+    allocations.push_back(allocateFilled(allocator, 100, 3));
+
+    // and larger than any block the allocator would ever pick by itself
+    allocations.push_back(allocateFilled(allocator, 65 * 1024 * 1024, 4));
+    allocations.push_back(allocateFilled(allocator, 100, 5));
+
+    const size_t alignment = alignof(std::max_align_t);
+    for (const Allocation &allocation : allocations) {
+        EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(allocation.data) % alignment);
+    }
+    expectIntact(allocations);
+}
+
+TEST_F(utStackAllocator, freeAllTest) {
+    StackAllocator allocator;
+    for (unsigned int i = 0; i < 1000; ++i) {
+        allocator.Allocate(100);
+    }
+    allocator.FreeAll();
+    allocator.FreeAll();
+
+    std::vector<Allocation> allocations;
+    for (unsigned int i = 0; i < 1000; ++i) {
+        allocations.push_back(allocateFilled(allocator, 100, static_cast<uint8_t>(i)));
+    }
+    expectIntact(allocations);
+}
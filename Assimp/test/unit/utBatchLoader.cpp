@@ -44,6 +44,11 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Common/Importer.h"
 #include "TestIOSystem.h"
 
+#include <assimp/DefaultIOSystem.h>
+#include <assimp/scene.h>
+
+#include <atomic>
+
 using namespace ::Assimp;
 
 class BatchLoaderTest : public ::testing::Test {
@@ -79,3 +84,80 @@ TEST_F( BatchLoaderTest, validateAccessTest ) {
     BatchLoader loader2( m_io, true );
     EXPECT_TRUE( loader2.getValidation() );
 }
+
+TEST_F( BatchLoaderTest, numThreadsAccessTest ) {
+    BatchLoader loader( m_io );
+    EXPECT_EQ( 1u, loader.getNumThreads() );
+    loader.setNumThreads( 4 );
+    EXPECT_EQ( 4u, loader.getNumThreads() );
+    loader.setNumThreads( 0 );
+    EXPECT_EQ( 1u, loader.getNumThreads() );
+}
+
+TEST_F( BatchLoaderTest, getImportWithoutLoadAllTest ) {
+    DefaultIOSystem io;
+    for ( unsigned int threads = 1; threads <= 2; ++threads ) {
+        BatchLoader loader( &io );
+        loader.setNumThreads( threads );
+        const unsigned int id = loader.AddLoadRequest( ASSIMP_TEST_MODELS_DIR "/PLY/cube.ply" );
+
+        aiScene *scene = loader.GetImport( id );
+        ASSERT_NE( nullptr, scene );
+        EXPECT_EQ( 1u, scene->mNumMeshes );
+        delete scene;
+
+        // the request is gone once it has been polled
+        EXPECT_EQ( nullptr, loader.GetImport( id ) );
+    }
+}
+
+TEST_F( BatchLoaderTest, concurrentLoadTest ) {
+    static const char *files[] = {
+        ASSIMP_TEST_MODELS_DIR "/PLY/cube.ply",
+        ASSIMP_TEST_MODELS_DIR "/PLY/cube_binary.ply",
+        ASSIMP_TEST_MODELS_DIR "/PLY/Wuson.ply",
+        ASSIMP_TEST_MODELS_DIR "/STL/Spider_ascii.stl",
+        ASSIMP_TEST_MODELS_DIR "/STL/Spider_binary.stl",
+        ASSIMP_TEST_MODELS_DIR "/STL/Wuson.stl"
+    };
+    static const unsigned int numFiles = sizeof( files ) / sizeof( files[ 0 ] );
+
+    DefaultIOSystem io;
+    BatchLoader serial( &io );
+    BatchLoader loader( &io );
+    loader.setNumThreads( 4 );
+
+    std::atomic<unsigned int> numCallbacks( 0 );
+    loader.setCompletionCallback( [ &numCallbacks ]( unsigned int, const aiScene *scene ) {
+        EXPECT_NE( nullptr, scene );
+        ++numCallbacks;
+    } );
+
+    unsigned int serialIds[ numFiles ], ids[ numFiles ];
+    for ( unsigned int i = 0; i < numFiles; ++i ) {
+        serialIds[ i ] = serial.AddLoadRequest( files[ i ] );
+        ids[ i ] = loader.AddLoadRequest( files[ i ] );
+    }
+    serial.LoadAll();
+    loader.LoadAll();
+    EXPECT_EQ( numFiles, numCallbacks.load() );
+
+    for ( unsigned int i = 0; i < numFiles; ++i ) {
+        aiScene *expected = serial.GetImport( serialIds[ i ] );
+        aiScene *scene = nullptr;
+        ASSERT_TRUE( loader.TryGetImport( ids[ i ], scene ) );
+        ASSERT_NE( nullptr, expected );
+        ASSERT_NE( nullptr, scene );
+
+        ASSERT_EQ( expected->mNumMeshes, scene->mNumMeshes );
+        for ( unsigned int m = 0; m < scene->mNumMeshes; ++m ) {
+            EXPECT_EQ( expected->mMeshes[ m ]->mNumVertices, scene->mMeshes[ m ]->mNumVertices );
+            EXPECT_EQ( expected->mMeshes[ m ]->mNumFaces, scene->mMeshes[ m ]->mNumFaces );
+        }
+        delete expected;
+        delete scene;
+
+        // already taken
+        EXPECT_FALSE( loader.TryGetImport( ids[ i ], scene ) );
+    }
+}
@@ -0,0 +1,160 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2019, assimp team
+
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+copyright notice, this list of conditions and the
+following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the
+following disclaimer in the documentation and/or other
+materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+contributors may be used to endorse or promote products
+derived from this software without specific prior
+written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+#include "UnitTestPCH.h"
+
+#include "FBX/FBXDocument.h"
+
+#include <map>
+#include <random>
+
+using namespace Assimp::FBX;
+
+class utFBXIdMap : public ::testing::Test {
+protected:
+    typedef IdMap<int> Map;
+
+    // ids repeat and arrive out of order, like objects in a file that redefines some of them
+    static void fill(Map &map, std::multimap<uint64_t, int> &reference, unsigned int count, unsigned int idRange) {
+        std::mt19937 random(42);
+        std::uniform_int_distribution<uint64_t> ids(0, idRange - 1);
+        for (unsigned int i = 0; i < count; ++i) {
+            const uint64_t id = ids(random) * 0x100000001ull;
+            map.insert(id, static_cast<int>(i));
+            reference.insert(std::make_pair(id, static_cast<int>(i)));
+        }
+    }
+};
+
+TEST_F(utFBXIdMap, emptyTest) {
+    Map map;
+    map.sort();
+    EXPECT_EQ(0u, map.size());
+    EXPECT_TRUE(map.begin() == map.end());
+    EXPECT_TRUE(map.find(1) == map.end());
+}
+
+TEST_F(utFBXIdMap, insertAndFindTest) {
+    Map map;
+    std::multimap<uint64_t, int> reference;
+    fill(map, reference, 1000, 500);
+    map.sort();
+
+    // iteration order matches the multimap, entries of the same id in the order they were inserted
+    ASSERT_EQ(reference.size(), map.size());
+    Map::const_iterator it = map.begin();
+    for (const std::pair<const uint64_t, int> &entry : reference) {
+        EXPECT_EQ(entry.first, it->first);
+        EXPECT_EQ(entry.second, it->second);
+        ++it;
+    }
+
+    for (uint64_t id = 0; id < 500; ++id) {
+        const uint64_t key = id * 0x100000001ull;
+        std::pair<Map::const_iterator, Map::const_iterator> range = map.equal_range(key);
+        std::pair<std::multimap<uint64_t, int>::const_iterator, std::multimap<uint64_t, int>::const_iterator> expected = reference.equal_range(key);
+
+        ASSERT_EQ(std::distance(expected.first, expected.second), std::distance(range.first, range.second));
+        for (; range.first != range.second; ++range.first, ++expected.first) {
+            EXPECT_EQ(expected.first->second, range.first->second);
+        }
+
+        EXPECT_EQ(reference.count(key) != 0, map.find(key) != map.end());
+        EXPECT_TRUE(map.find(key + 1) == map.end());
+    }
+}
+
+TEST_F(utFBXIdMap, overwriteTest) {
+    Map map;
+    std::multimap<uint64_t, int> inserted;
+    fill(map, inserted, 1000, 300);
+    map.sort();
+
+    // a std::map written in the same order ends up with the last value of each id
+    std::map<uint64_t, int> reference;
+    for (const std::pair<const uint64_t, int> &entry : inserted) {
+        reference[entry.first] = entry.second;
+    }
+
+    size_t discarded = 0;
+    map.unique([&](int dropped, int kept) {
+        EXPECT_LT(dropped, kept);
+        ++discarded;
+    });
+    EXPECT_EQ(inserted.size() - reference.size(), discarded);
+
+    ASSERT_EQ(reference.size(), map.size());
+    for (const std::pair<const uint64_t, int> &entry : reference) {
+        Map::const_iterator it = map.find(entry.first);
+        ASSERT_TRUE(it != map.end());
+        EXPECT_EQ(entry.second, it->second);
+    }
+}
+
+TEST_F(utFBXIdMap, growthTest) {
+    Map map;
+    std::map<uint64_t, int> reference;
+
+    // in order, the map never has to sort
+    for (unsigned int i = 0; i < 100000; ++i) {
+        map.insert(i * 7ull, static_cast<int>(i));
+        reference[i * 7ull] = static_cast<int>(i);
+    }
+    map.sort();
+    ASSERT_EQ(reference.size(), map.size());
+
+    // reversed, it does
+    Map reversed;
+    for (unsigned int i = 100000; i-- > 0;) {
+        reversed.insert(i * 7ull, static_cast<int>(i));
+    }
+    reversed.sort();
+    ASSERT_EQ(reference.size(), reversed.size());
+
+    for (const std::pair<const uint64_t, int> &entry : reference) {
+        Map::const_iterator a = map.find(entry.first), b = reversed.find(entry.first);
+        ASSERT_TRUE(a != map.end() && b != reversed.end());
+        EXPECT_EQ(entry.second, a->second);
+        EXPECT_EQ(entry.second, b->second);
+    }
+    EXPECT_TRUE(map.find(1) == map.end());
+}
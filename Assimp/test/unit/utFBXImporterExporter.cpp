@@ -282,3 +282,101 @@ TEST_F(utFBXImporterExporter, fbxTokenizeTestTest) {
     //const aiScene* scene = importer.ReadFile(ASSIMP_TEST_MODELS_DIR "/FBX/transparentTest2.fbx", aiProcess_ValidateDataStructure);
     //EXPECT_NE(nullptr, scene);
 }
+
+TEST_F(utFBXImporterExporter, importCompressedArraysMultithreaded) {
+    Assimp::Importer serialImporter;
+    const aiScene *serial = serialImporter.ReadFile(ASSIMP_TEST_MODELS_DIR "/FBX/spider.fbx", aiProcess_ValidateDataStructure);
+    ASSERT_NE(nullptr, serial);
+
+    Assimp::Importer parallelImporter;
+    parallelImporter.SetPropertyInteger(AI_CONFIG_GLOB_MULTITHREADING, 4);
+    const aiScene *parallel = parallelImporter.ReadFile(ASSIMP_TEST_MODELS_DIR "/FBX/spider.fbx", aiProcess_ValidateDataStructure);
+    ASSERT_NE(nullptr, parallel);
+
+    ASSERT_EQ(serial->mNumMeshes, parallel->mNumMeshes);
+    for (unsigned int i = 0; i < serial->mNumMeshes; ++i) {
+        const aiMesh *a = serial->mMeshes[i];
+        const aiMesh *b = parallel->mMeshes[i];
+        ASSERT_EQ(a->mNumVertices, b->mNumVertices);
+        ASSERT_EQ(a->mNumFaces, b->mNumFaces);
+        EXPECT_EQ(0, memcmp(a->mVertices, b->mVertices, a->mNumVertices * sizeof(aiVector3D)));
+        EXPECT_EQ(0, memcmp(a->mNormals, b->mNormals, a->mNumVertices * sizeof(aiVector3D)));
+    }
+
+    // arrays compressed with zlib must come out the same as their uncompressed counterparts
+    Assimp::Importer compressedImporter;
+    compressedImporter.SetPropertyInteger(AI_CONFIG_GLOB_MULTITHREADING, 4);
+    const aiScene *compressed = compressedImporter.ReadFile(ASSIMP_TEST_MODELS_DIR "/FBX/boxWithCompressedCTypeArray.FBX", aiProcess_ValidateDataStructure);
+    ASSERT_NE(nullptr, compressed);
+    Assimp::Importer uncompressedImporter;
+    const aiScene *uncompressed = uncompressedImporter.ReadFile(ASSIMP_TEST_MODELS_DIR "/FBX/boxWithUncompressedCTypeArray.FBX", aiProcess_ValidateDataStructure);
+    ASSERT_NE(nullptr, uncompressed);
+    ASSERT_EQ(uncompressed->mNumMeshes, compressed->mNumMeshes);
+    ASSERT_EQ(uncompressed->mMeshes[0]->mNumVertices, compressed->mMeshes[0]->mNumVertices);
+    EXPECT_EQ(0, memcmp(uncompressed->mMeshes[0]->mVertices, compressed->mMeshes[0]->mVertices, compressed->mMeshes[0]->mNumVertices * sizeof(aiVector3D)));
+}
+
+TEST_F(utFBXImporterExporter, importCompressedNumericArrays) {
+    // the same file with every float, double, int and long array zlib-compressed
+    Assimp::Importer uncompressedImporter;
+    const aiScene *uncompressed = uncompressedImporter.ReadFile(ASSIMP_TEST_MODELS_NONBSD_DIR "/FBX/2013_BINARY/multiple_animations_test.fbx", aiProcess_ValidateDataStructure);
+    ASSERT_NE(nullptr, uncompressed);
+
+    for (int threads : { 0, 4 }) {
+        Assimp::Importer compressedImporter;
+        compressedImporter.SetPropertyInteger(AI_CONFIG_GLOB_MULTITHREADING, threads);
+        const aiScene *compressed = compressedImporter.ReadFile(ASSIMP_TEST_MODELS_NONBSD_DIR "/FBX/2013_BINARY/multiple_animations_test_compressed.fbx", aiProcess_ValidateDataStructure);
+        ASSERT_NE(nullptr, compressed);
+
+        ASSERT_EQ(uncompressed->mNumMeshes, compressed->mNumMeshes);
+        for (unsigned int i = 0; i < compressed->mNumMeshes; ++i) {
+            const aiMesh *a = uncompressed->mMeshes[i];
+            const aiMesh *b = compressed->mMeshes[i];
+            ASSERT_EQ(a->mNumVertices, b->mNumVertices);
+            ASSERT_EQ(a->mNumFaces, b->mNumFaces);
+            EXPECT_EQ(0, memcmp(a->mVertices, b->mVertices, a->mNumVertices * sizeof(aiVector3D)));
+            for (unsigned int f = 0; f < a->mNumFaces; ++f) {
+                ASSERT_EQ(a->mFaces[f].mNumIndices, b->mFaces[f].mNumIndices);
+                EXPECT_EQ(0, memcmp(a->mFaces[f].mIndices, b->mFaces[f].mIndices, a->mFaces[f].mNumIndices * sizeof(unsigned int)));
+            }
+        }
+
+        // key times are long arrays and key values float arrays
+        ASSERT_EQ(uncompressed->mNumAnimations, compressed->mNumAnimations);
+        ASSERT_LT(0u, compressed->mNumAnimations);
+        for (unsigned int i = 0; i < compressed->mNumAnimations; ++i) {
+            const aiAnimation *a = uncompressed->mAnimations[i];
+            const aiAnimation *b = compressed->mAnimations[i];
+            EXPECT_EQ(a->mDuration, b->mDuration);
+            ASSERT_EQ(a->mNumChannels, b->mNumChannels);
+            for (unsigned int c = 0; c < a->mNumChannels; ++c) {
+                const aiNodeAnim *x = a->mChannels[c];
+                const aiNodeAnim *y = b->mChannels[c];
+                ASSERT_EQ(x->mNumPositionKeys, y->mNumPositionKeys);
+                ASSERT_EQ(x->mNumRotationKeys, y->mNumRotationKeys);
+                ASSERT_EQ(x->mNumScalingKeys, y->mNumScalingKeys);
+                for (unsigned int k = 0; k < x->mNumPositionKeys; ++k) {
+                    EXPECT_EQ(x->mPositionKeys[k].mTime, y->mPositionKeys[k].mTime);
+                    EXPECT_EQ(x->mPositionKeys[k].mValue, y->mPositionKeys[k].mValue);
+                }
+                for (unsigned int k = 0; k < x->mNumRotationKeys; ++k) {
+                    EXPECT_EQ(x->mRotationKeys[k].mTime, y->mRotationKeys[k].mTime);
+                    EXPECT_EQ(x->mRotationKeys[k].mValue, y->mRotationKeys[k].mValue);
+                }
+                for (unsigned int k = 0; k < x->mNumScalingKeys; ++k) {
+                    EXPECT_EQ(x->mScalingKeys[k].mTime, y->mScalingKeys[k].mTime);
+                    EXPECT_EQ(x->mScalingKeys[k].mValue, y->mScalingKeys[k].mValue);
+                }
+            }
+        }
+    }
+}
+
+TEST_F(utFBXImporterExporter, rejectCompressedArrayShorterThanCount) {
+    // the vertex array claims one vertex more than its compressed data holds
+    for (int threads : { 0, 4 }) {
+        Assimp::Importer importer;
+        importer.SetPropertyInteger(AI_CONFIG_GLOB_MULTITHREADING, threads);
+        EXPECT_EQ(nullptr, importer.ReadFile(ASSIMP_TEST_MODELS_DIR "/FBX/boxWithShortCompressedArray.fbx", aiProcess_ValidateDataStructure));
+    }
+}
@@ -41,4 +41,203 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 ---------------------------------------------------------------------------
 */
 
-#include "UnitTestPCH.h"
\ No newline at end of file
+#include "UnitTestPCH.h"
+
+#include <assimp/Importer.hpp>
+#include <assimp/config.h>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+
+#include <algorithm>
+#include <array>
+#include <string>
+#include <vector>
+
+using namespace Assimp;
+
+class utImproveCacheLocality : public ::testing::Test {
+protected:
+    typedef std::array<float, 9> Triangle;
+
+    // A regular grid of quads split into triangles, the quads are listed in a scrambled order. The two
+    // triangles of a quad stay together, a mesh without any reuse at all is skipped by the step
+    static std::string scrambledGrid(unsigned int size) {
+        std::string obj;
+        for (unsigned int y = 0; y <= size; ++y) {
+            for (unsigned int x = 0; x <= size; ++x) {
+                obj += "v " + std::to_string(x) + " " + std::to_string(y) + " " + std::to_string((x * y) % 3) + "\n";
+            }
+        }
+        const unsigned int numQuads = size * size;
+        for (unsigned int i = 0; i < numQuads; ++i) {
+            // 7919 is prime, so this visits every quad once
+            const unsigned int q = (i * 7919) % numQuads, x = q % size, y = q / size;
+            const unsigned int v = y * (size + 1) + x + 1;
+            obj += "f " + std::to_string(v) + " " + std::to_string(v + 1) + " " + std::to_string(v + size + 2) + "\n";
+            obj += "f " + std::to_string(v) + " " + std::to_string(v + size + 2) + " " + std::to_string(v + size + 1) + "\n";
+        }
+        return obj;
+    }
+
+    // Two boxes around the origin, every side a separate patch of size x size quads. The sides of
+    // the inner box face inwards and are listed first, the outer box faces outwards. The patches are
+    // inset so no vertex is shared between sides and each one starts a new cluster
+    static std::string nestedBoxes(unsigned int size) {
+        std::string obj;
+        unsigned int base = 1;
+        for (int box = 0; box < 2; ++box) {
+            const bool inward = box == 0;
+            const float extent = inward ? 4.f : 8.f, step = (2.f * extent - 1.f) / size;
+            for (unsigned int axis = 0; axis < 3; ++axis) {
+                for (int sign = -1; sign <= 1; sign += 2) {
+                    for (unsigned int j = 0; j <= size; ++j) {
+                        for (unsigned int i = 0; i <= size; ++i) {
+                            float p[3];
+                            p[axis] = sign * extent;
+                            p[(axis + 1) % 3] = -extent + 0.5f + i * step;
+                            p[(axis + 2) % 3] = -extent + 0.5f + j * step;
+                            obj += "v " + std::to_string(p[0]) + " " + std::to_string(p[1]) + " " + std::to_string(p[2]) + "\n";
+                        }
+                    }
+                    // counter-clockwise quads face along +axis, flip them for the other side and the inner box
+                    const bool flip = (sign < 0) != inward;
+                    for (unsigned int j = 0; j < size; ++j) {
+                        for (unsigned int i = 0; i < size; ++i) {
+                            const unsigned int v00 = base + j * (size + 1) + i, v10 = v00 + 1;
+                            const unsigned int v01 = v00 + size + 1, v11 = v01 + 1;
+                            const unsigned int quad[2][3] = { { v00, v10, v11 }, { v00, v11, v01 } };
+                            for (const unsigned int *t : quad) {
+                                obj += "f " + std::to_string(t[0]) + " " + std::to_string(flip ? t[2] : t[1]) + " " +
+                                       std::to_string(flip ? t[1] : t[2]) + "\n";
+                            }
+                        }
+                    }
+                    base += (size + 1) * (size + 1);
+                }
+            }
+        }
+        return obj;
+    }
+
+    // Whether a face points away from the origin
+    static bool facesOutwards(const aiMesh *mesh, unsigned int face) {
+        const unsigned int *idx = mesh->mFaces[face].mIndices;
+        const aiVector3D &a = mesh->mVertices[idx[0]], &b = mesh->mVertices[idx[1]], &c = mesh->mVertices[idx[2]];
+        return ((b - a) ^ (c - a)) * (a + b + c) > 0.f;
+    }
+
+    // Average cache miss ratio of a FIFO cache
+    static float acmr(const aiMesh *mesh, unsigned int cacheSize) {
+        std::vector<unsigned int> fifo;
+        unsigned int misses = 0;
+        for (unsigned int f = 0; f < mesh->mNumFaces; ++f) {
+            for (unsigned int i = 0; i < 3; ++i) {
+                const unsigned int v = mesh->mFaces[f].mIndices[i];
+                if (std::find(fifo.begin(), fifo.end(), v) == fifo.end()) {
+                    ++misses;
+                    fifo.push_back(v);
+                    if (fifo.size() > cacheSize) {
+                        fifo.erase(fifo.begin());
+                    }
+                }
+            }
+        }
+        return float(misses) / mesh->mNumFaces;
+    }
+
+    // The positions of all triangles, sorted
+    static std::vector<Triangle> triangles(const aiMesh *mesh) {
+        std::vector<Triangle> result;
+        for (unsigned int f = 0; f < mesh->mNumFaces; ++f) {
+            Triangle t;
+            for (unsigned int i = 0; i < 3; ++i) {
+                const aiVector3D &p = mesh->mVertices[mesh->mFaces[f].mIndices[i]];
+                t[i * 3] = p.x;
+                t[i * 3 + 1] = p.y;
+                t[i * 3 + 2] = p.z;
+            }
+            result.push_back(t);
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    // Checks that the vertices are numbered in the order the faces reference them
+    static void expectFetchOrder(const aiMesh *mesh) {
+        unsigned int next = 0;
+        for (unsigned int f = 0; f < mesh->mNumFaces; ++f) {
+            for (unsigned int i = 0; i < 3; ++i) {
+                const unsigned int v = mesh->mFaces[f].mIndices[i];
+                ASSERT_LE(v, next);
+                if (v == next) {
+                    ++next;
+                }
+            }
+        }
+        EXPECT_EQ(mesh->mNumVertices, next);
+    }
+};
+
+// ------------------------------------------------------------------------------------------------
+TEST_F(utImproveCacheLocality, forsythReducesCacheMisses) {
+    const std::string obj = scrambledGrid(32);
+
+    Importer reference;
+    const aiScene *input = reference.ReadFileFromMemory(obj.c_str(), obj.size(), aiProcess_JoinIdenticalVertices);
+    ASSERT_NE(nullptr, input);
+    ASSERT_EQ(1u, input->mNumMeshes);
+
+    Importer importer;
+    importer.SetPropertyInteger(AI_CONFIG_PP_ICL_ALGORITHM, 1);
+    const aiScene *output = importer.ReadFileFromMemory(obj.c_str(), obj.size(),
+            aiProcess_JoinIdenticalVertices | aiProcess_ImproveCacheLocality | aiProcess_ValidateDataStructure);
+    ASSERT_NE(nullptr, output);
+
+    const aiMesh *before = input->mMeshes[0];
+    const aiMesh *after = output->mMeshes[0];
+    ASSERT_EQ(before->mNumVertices, after->mNumVertices);
+    EXPECT_TRUE(triangles(before) == triangles(after));
+    expectFetchOrder(after);
+
+    const float acmrBefore = acmr(before, PP_ICL_PTCACHE_SIZE);
+    const float acmrAfter = acmr(after, PP_ICL_PTCACHE_SIZE);
+    EXPECT_LT(acmrAfter, 1.f);
+    EXPECT_LT(acmrAfter, acmrBefore * 0.5f);
+}
+
+// ------------------------------------------------------------------------------------------------
+TEST_F(utImproveCacheLocality, overdrawOrderKeepsFaces) {
+    const std::string obj = scrambledGrid(32);
+
+    Importer reference;
+    const aiScene *input = reference.ReadFileFromMemory(obj.c_str(), obj.size(), aiProcess_JoinIdenticalVertices);
+    ASSERT_NE(nullptr, input);
+
+    Importer importer;
+    importer.SetPropertyInteger(AI_CONFIG_PP_ICL_ALGORITHM, 1);
+    importer.SetPropertyFloat(AI_CONFIG_PP_ICL_OVERDRAW_THRESHOLD, 1.05f);
+    const aiScene *output = importer.ReadFileFromMemory(obj.c_str(), obj.size(),
+            aiProcess_JoinIdenticalVertices | aiProcess_ImproveCacheLocality | aiProcess_ValidateDataStructure);
+    ASSERT_NE(nullptr, output);
+
+    const aiMesh *after = output->mMeshes[0];
+    EXPECT_TRUE(triangles(input->mMeshes[0]) == triangles(after));
+    expectFetchOrder(after);
+    EXPECT_LT(acmr(after, PP_ICL_PTCACHE_SIZE), acmr(input->mMeshes[0], PP_ICL_PTCACHE_SIZE) * 0.5f);
+
+    // with known clusters every outward facing one has to be drawn before the inward facing ones
+    const std::string boxes = nestedBoxes(4);
+    const aiScene *nested = importer.ReadFileFromMemory(boxes.c_str(), boxes.size(),
+            aiProcess_JoinIdenticalVertices | aiProcess_ImproveCacheLocality | aiProcess_ValidateDataStructure);
+    ASSERT_NE(nullptr, nested);
+    const aiMesh *sorted = nested->mMeshes[0];
+    ASSERT_EQ(12u * 4u * 4u * 2u, sorted->mNumFaces);
+    unsigned int numOutwards = 0;
+    for (unsigned int f = 0; f < sorted->mNumFaces; ++f) {
+        if (facesOutwards(sorted, f)) {
+            EXPECT_EQ(f, numOutwards);
+            ++numOutwards;
+        }
+    }
+    EXPECT_EQ(sorted->mNumFaces / 2, numOutwards);
+}
@@ -41,6 +41,11 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "UnitTestPCH.h"
 
 #include <assimp/scene.h>
+#include <assimp/Importer.hpp>
+#include <assimp/config.h>
+
+#include <cmath>
+#include <limits>
 
 #include "PostProcessing/JoinVerticesProcess.h"
 
@@ -142,3 +147,83 @@ TEST_F(utJoinVertices, testProcess) {
     }
     EXPECT_EQ(150.f*299.f*3.f, fSum); // gaussian sum equation
 }
+
+// ------------------------------------------------------------------------------------------------
+TEST_F(utJoinVertices, testExactMatch) {
+    Importer importer;
+    importer.SetPropertyBool(AI_CONFIG_PP_JIV_EXACT_MATCH, true);
+    piProcess->SetupProperties(&importer);
+
+    // -0 and +0 are still the same value ...
+    pcMesh->mNormals[607] = aiVector3D(-0.f, 0.f, -0.f);
+    // ... but a difference below the epsilon of the default mode is not
+    pcMesh->mTextureCoords[0][610] = aiVector3D(1e-6f, 0.f, 0.f);
+
+    piProcess->ProcessMesh(pcMesh,0);
+
+    ASSERT_EQ(300U, pcMesh->mNumFaces);
+    ASSERT_EQ(301U, pcMesh->mNumVertices);
+
+    // the first occurrence of each vertex is kept, in order
+    for (unsigned int i = 0; i < 300; ++i) {
+        EXPECT_EQ((float)i, pcMesh->mVertices[i].x);
+    }
+    EXPECT_EQ(10.f, pcMesh->mVertices[300].x);
+    EXPECT_EQ(1e-6f, pcMesh->mTextureCoords[0][300].x);
+
+    for (unsigned int i = 0; i < 300; ++i) {
+        const aiFace& face = pcMesh->mFaces[i];
+        for (unsigned int a = 0; a < 3; ++a) {
+            const unsigned int expected = (3 * i + a == 610) ? 300 : (3 * i + a) % 300;
+            EXPECT_EQ(expected, face.mIndices[a]);
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+TEST_F(utJoinVertices, testExactMatchNaN) {
+    Importer importer;
+    importer.SetPropertyBool(AI_CONFIG_PP_JIV_EXACT_MATCH, true);
+    piProcess->SetupProperties(&importer);
+
+    // NaNs of any sign and payload are the same value
+    pcMesh->mTangents[5].x = std::nanf("1");
+    pcMesh->mTangents[305].x = std::nanf("2");
+    pcMesh->mTangents[605].x = -std::numeric_limits<float>::quiet_NaN();
+
+    piProcess->ProcessMesh(pcMesh,0);
+
+    ASSERT_EQ(300U, pcMesh->mNumVertices);
+    EXPECT_TRUE(std::isnan(pcMesh->mTangents[5].x));
+    EXPECT_EQ(5U, pcMesh->mFaces[101].mIndices[2]);
+    EXPECT_EQ(5U, pcMesh->mFaces[201].mIndices[2]);
+}
+
+// ------------------------------------------------------------------------------------------------
+TEST_F(utJoinVertices, testExactMatchAnimMeshWithoutPositions) {
+    Importer importer;
+    importer.SetPropertyBool(AI_CONFIG_PP_JIV_EXACT_MATCH, true);
+    piProcess->SetupProperties(&importer);
+
+    // an animation mesh that only moves the normals, so it has no positions of its own
+    aiAnimMesh *animMesh = new aiAnimMesh();
+    animMesh->mNumVertices = 900;
+    animMesh->mNormals = new aiVector3D[900];
+    for (unsigned int i = 0; i < 900; ++i) {
+        animMesh->mNormals[i] = aiVector3D(0.f);
+    }
+    animMesh->mNormals[610] = aiVector3D(1.f, 0.f, 0.f);
+    pcMesh->mNumAnimMeshes = 1;
+    pcMesh->mAnimMeshes = new aiAnimMesh*[1];
+    pcMesh->mAnimMeshes[0] = animMesh;
+
+    piProcess->ProcessMesh(pcMesh,0);
+
+    // the vertex only differs in the animation mesh, which still keeps it apart
+    ASSERT_EQ(301U, pcMesh->mNumVertices);
+    ASSERT_EQ(301U, animMesh->mNumVertices);
+    EXPECT_EQ(nullptr, animMesh->mVertices);
+    EXPECT_EQ(10.f, pcMesh->mVertices[300].x);
+    EXPECT_EQ(1.f, animMesh->mNormals[300].x);
+    EXPECT_EQ(300U, pcMesh->mFaces[203].mIndices[1]);
+}
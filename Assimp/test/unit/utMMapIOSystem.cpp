@@ -0,0 +1,169 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2019, assimp team
+
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+copyright notice, this list of conditions and the
+following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the
+following disclaimer in the documentation and/or other
+materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+contributors may be used to endorse or promote products
+derived from this software without specific prior
+written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+#include "UnitTestPCH.h"
+#include "UnitTestFileGenerator.h"
+
+#include <assimp/MMapIOSystem.h>
+#include <assimp/Exporter.hpp>
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+
+#include <cstdio>
+#include <memory>
+
+using namespace Assimp;
+
+class utMMapIOSystem : public ::testing::Test {
+protected:
+    // Both scenes must have the same meshes, bit by bit
+    void expectSameMeshes(const aiScene *expected, const aiScene *scene) {
+        ASSERT_NE(nullptr, expected);
+        ASSERT_NE(nullptr, scene);
+        ASSERT_EQ(expected->mNumMeshes, scene->mNumMeshes);
+        for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
+            const aiMesh *a = expected->mMeshes[i], *b = scene->mMeshes[i];
+            ASSERT_EQ(a->mNumVertices, b->mNumVertices);
+            ASSERT_EQ(a->mNumFaces, b->mNumFaces);
+            EXPECT_EQ(0, memcmp(a->mVertices, b->mVertices, a->mNumVertices * sizeof(aiVector3D)));
+        }
+    }
+
+    // Imports a file through the default IO system and the mapping one
+    void expectSameImport(const char *file) {
+        Importer expected, importer;
+        importer.SetIOHandler(new MMapIOSystem());
+        expectSameMeshes(expected.ReadFile(file, aiProcess_ValidateDataStructure),
+                importer.ReadFile(file, aiProcess_ValidateDataStructure));
+    }
+};
+
+static const char data[] = "Lorem ipsum dolor sit amet, consectetur adipiscing elit.";
+
+TEST_F(utMMapIOSystem, readSeekTest) {
+    char fpath[] = { TMP_PATH "mmapio.XXXXXX" };
+    FILE *fs = MakeTmpFile(fpath);
+    ASSERT_NE(nullptr, fs);
+    EXPECT_EQ(sizeof(data), std::fwrite(data, 1, sizeof(data), fs));
+    std::fclose(fs);
+
+    {
+        MMapIOSystem io;
+        std::unique_ptr<IOStream> stream(io.Open(fpath, "rb"));
+        ASSERT_NE(nullptr, stream.get());
+        EXPECT_EQ(sizeof(data), stream->FileSize());
+        ASSERT_NE(nullptr, stream->GetContents());
+        EXPECT_EQ(0, memcmp(data, stream->GetContents(), sizeof(data)));
+
+        char buffer[6] = {};
+        EXPECT_EQ(aiReturn_SUCCESS, stream->Seek(6, aiOrigin_SET));
+        EXPECT_EQ(1u, stream->Read(buffer, 5, 1));
+        EXPECT_STREQ("ipsum", buffer);
+        EXPECT_EQ(11u, stream->Tell());
+
+        // reads are clamped to the end of the file
+        EXPECT_EQ(aiReturn_SUCCESS, stream->Seek(4, aiOrigin_END));
+        EXPECT_EQ(0u, stream->Read(buffer, 5, 1));
+        EXPECT_EQ(aiReturn_FAILURE, stream->Seek(sizeof(data) + 1, aiOrigin_SET));
+
+        // mappings are read-only
+        EXPECT_EQ(0u, stream->Write(data, 1, 1));
+    }
+    remove(fpath);
+}
+
+TEST_F(utMMapIOSystem, emptyAndMissingFileTest) {
+    char fpath[] = { TMP_PATH "mmapio.XXXXXX" };
+    FILE *fs = MakeTmpFile(fpath);
+    ASSERT_NE(nullptr, fs);
+    std::fclose(fs);
+
+    {
+        MMapIOSystem io;
+        std::unique_ptr<IOStream> stream(io.Open(fpath, "rb"));
+        ASSERT_NE(nullptr, stream.get());
+        EXPECT_EQ(0u, stream->FileSize());
+
+        EXPECT_EQ(nullptr, io.Open(TMP_PATH "mmapio_does_not_exist", "rb"));
+    }
+    remove(fpath);
+}
+
+TEST_F(utMMapIOSystem, writeModeFallsBackToFileTest) {
+    char fpath[] = { TMP_PATH "mmapio.XXXXXX" };
+    FILE *fs = MakeTmpFile(fpath);
+    ASSERT_NE(nullptr, fs);
+    std::fclose(fs);
+
+    {
+        MMapIOSystem io;
+        std::unique_ptr<IOStream> stream(io.Open(fpath, "wb"));
+        ASSERT_NE(nullptr, stream.get());
+        EXPECT_EQ(nullptr, stream->GetContents());
+        EXPECT_EQ(sizeof(data), stream->Write(data, 1, sizeof(data)));
+    }
+    remove(fpath);
+}
+
+TEST_F(utMMapIOSystem, importBinaryFilesInPlaceTest) {
+    expectSameImport(ASSIMP_TEST_MODELS_DIR "/FBX/spider.fbx");
+    expectSameImport(ASSIMP_TEST_MODELS_DIR "/glTF2/2CylinderEngine-glTF-Binary/2CylinderEngine.glb");
+    expectSameImport(ASSIMP_TEST_MODELS_DIR "/PLY/cube_binary.ply");
+    expectSameImport(ASSIMP_TEST_MODELS_DIR "/STL/Spider_binary.stl");
+}
+
+#ifndef ASSIMP_BUILD_NO_EXPORT
+TEST_F(utMMapIOSystem, importAssbinFromMemoryTest) {
+    Importer expected;
+    const aiScene *scene = expected.ReadFile(ASSIMP_TEST_MODELS_DIR "/FBX/spider.fbx", aiProcess_ValidateDataStructure);
+    ASSERT_NE(nullptr, scene);
+
+    // memory streams expose their contents as well
+    Exporter exporter;
+    const aiExportDataBlob *blob = exporter.ExportToBlob(scene, "assbin");
+    ASSERT_NE(nullptr, blob);
+
+    Importer importer;
+    expectSameMeshes(scene, importer.ReadFileFromMemory(blob->data, blob->size, aiProcess_ValidateDataStructure, "assbin"));
+}
+#endif // ASSIMP_BUILD_NO_EXPORT
@@ -49,6 +49,10 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/Exporter.hpp>
 #include <assimp/postprocess.h>
 
+#include <cstdio>
+#include <fstream>
+#include <string>
+
 using namespace Assimp;
 
 static const float VertComponents[ 24 * 3 ] = {
@@ -482,3 +486,106 @@ TEST_F(utObjImportExport, import_with_line_continuations) {
     EXPECT_NEAR(vertices[2].y, 0.5f, threshold);
     EXPECT_NEAR(vertices[2].z, -0.5f, threshold);
 }
+
+TEST_F(utObjImportExport, import_in_parallel_chunks) {
+    // a grid large enough to be split into several chunks, mixing absolute and
+    // relative indices, material switches, groups and line continuations
+    std::string objModel = "# generated grid\n";
+    const int size = 96;
+    for (int y = 0; y <= size; ++y) {
+        for (int x = 0; x <= size; ++x) {
+            objModel += "v " + std::to_string(x * 0.25) + " " + std::to_string(y * 0.5) + " " + std::to_string((x * y) % 7 - 3.125) + "\n";
+            objModel += "vt " + std::to_string(x / float(size)) + " " + std::to_string(y / float(size)) + "\n";
+        }
+        objModel += "vn 0 0 1\n";
+    }
+    for (int y = 0; y < size; ++y) {
+        objModel += (y % 3) ? "usemtl first\n" : "usemtl second\n";
+        objModel += "g row" + std::to_string(y % 5) + "\n";
+        for (int x = 0; x < size; ++x) {
+            const int i = y * (size + 1) + x + 1;
+            const int n = y + 1;
+            if ((x + y) % 4 == 0) {
+                objModel += "f " + std::to_string(i) + "/" + std::to_string(i) + "/" + std::to_string(n) + " " +
+                    std::to_string(i + 1) + "/" + std::to_string(i + 1) + "/" + std::to_string(n) + " \\\n  " +
+                    std::to_string(i + size + 2) + "/" + std::to_string(i + size + 2) + "/" + std::to_string(n) + "\n";
+            } else {
+                objModel += "f " + std::to_string(i) + "//" + std::to_string(n) + " " + std::to_string(i + 1) + "//" +
+                    std::to_string(n) + "\t" + std::to_string(i + size + 1) + "//" + std::to_string(n) + " -1//-1\r\n";
+            }
+        }
+    }
+
+    // the reference goes through the streaming parser, one line at a time
+    const char *fileName = "import_in_parallel_chunks_out.obj";
+    {
+        std::ofstream file(fileName, std::ios::binary);
+        file << objModel;
+    }
+    Assimp::Importer serialImporter;
+    const aiScene *serial = serialImporter.ReadFile(fileName, aiProcess_ValidateDataStructure);
+    std::remove(fileName);
+    ASSERT_NE(nullptr, serial);
+
+    Assimp::Importer parallelImporter;
+    parallelImporter.SetPropertyInteger(AI_CONFIG_GLOB_MULTITHREADING, 4);
+    const aiScene *parallel = parallelImporter.ReadFileFromMemory(objModel.c_str(), objModel.size(), aiProcess_ValidateDataStructure);
+    ASSERT_NE(nullptr, parallel);
+
+    ASSERT_EQ(serial->mNumMeshes, parallel->mNumMeshes);
+    ASSERT_EQ(serial->mNumMaterials, parallel->mNumMaterials);
+    for (unsigned int m = 0; m < serial->mNumMeshes; ++m) {
+        const aiMesh *a = serial->mMeshes[m];
+        const aiMesh *b = parallel->mMeshes[m];
+        ASSERT_EQ(a->mNumVertices, b->mNumVertices);
+        ASSERT_EQ(a->mNumFaces, b->mNumFaces);
+        EXPECT_EQ(a->mMaterialIndex, b->mMaterialIndex);
+        EXPECT_EQ(0, memcmp(a->mVertices, b->mVertices, a->mNumVertices * sizeof(aiVector3D)));
+        ASSERT_EQ(a->HasNormals(), b->HasNormals());
+        if (a->HasNormals()) {
+            EXPECT_EQ(0, memcmp(a->mNormals, b->mNormals, a->mNumVertices * sizeof(aiVector3D)));
+        }
+        ASSERT_EQ(a->HasTextureCoords(0), b->HasTextureCoords(0));
+        if (a->HasTextureCoords(0)) {
+            EXPECT_EQ(0, memcmp(a->mTextureCoords[0], b->mTextureCoords[0], a->mNumVertices * sizeof(aiVector3D)));
+        }
+        for (unsigned int f = 0; f < a->mNumFaces; ++f) {
+            ASSERT_EQ(a->mFaces[f].mNumIndices, b->mFaces[f].mNumIndices);
+            EXPECT_EQ(0, memcmp(a->mFaces[f].mIndices, b->mFaces[f].mIndices, a->mFaces[f].mNumIndices * sizeof(unsigned int)));
+        }
+    }
+}
+
+TEST_F(utObjImportExport, malformed_statement_reports_line) {
+    // long enough for the error to end up in a late chunk, with every kind of line
+    // end and a continuation before it so lines can't simply be counted by statements
+    std::string objModel = "# line numbers\n\n";
+    for (int i = 0; i < 20000; ++i) {
+        objModel += "v " + std::to_string(i) + " 0.5 \\\n  1.5\r\n";
+        objModel += (i % 3) ? "vn 0 0 1\n" : "\n";
+    }
+    objModel += "f 1 2 3\n";
+    const size_t line = std::count(objModel.begin(), objModel.end(), '\n') + 1;
+    objModel += "f 1 0 3\n";
+    objModel += "f 4 5 6\n";
+
+    const std::string expected = "on line " + std::to_string(line);
+    for (int threads : { 0, 4 }) {
+        Assimp::Importer importer;
+        importer.SetPropertyInteger(AI_CONFIG_GLOB_MULTITHREADING, threads);
+        EXPECT_EQ(nullptr, importer.ReadFileFromMemory(objModel.c_str(), objModel.size(), 0));
+        EXPECT_NE(std::string::npos, std::string(importer.GetErrorString()).find(expected)) << importer.GetErrorString();
+    }
+
+    // the same through the streaming parser
+    const char *fileName = "malformed_statement_reports_line_out.obj";
+    {
+        std::ofstream file(fileName, std::ios::binary);
+        file << objModel;
+    }
+    Assimp::Importer importer;
+    const aiScene *scene = importer.ReadFile(fileName, 0);
+    std::remove(fileName);
+    EXPECT_EQ(nullptr, scene);
+    EXPECT_NE(std::string::npos, std::string(importer.GetErrorString()).find(expected)) << importer.GetErrorString();
+}
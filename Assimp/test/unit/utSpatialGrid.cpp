@@ -0,0 +1,258 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2019, assimp team
+
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+copyright notice, this list of conditions and the
+following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the
+following disclaimer in the documentation and/or other
+materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+contributors may be used to endorse or promote products
+derived from this software without specific prior
+written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+#include "UnitTestPCH.h"
+
+#include <assimp/SpatialGrid.h>
+#include <assimp/SpatialSort.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+using namespace Assimp;
+
+class utSpatialGrid : public ::testing::Test {
+protected:
+    // all indices within the radius, found the slow way
+    static std::vector<unsigned int> bruteForce(const std::vector<aiVector3D> &positions, const aiVector3D &p, ai_real radius) {
+        std::vector<unsigned int> found;
+        for (unsigned int i = 0; i < positions.size(); ++i) {
+            if ((positions[i] - p).SquareLength() < radius * radius) {
+                found.push_back(i);
+            }
+        }
+        return found;
+    }
+
+    // random positions snapped to a coarse lattice, so that many of them coincide
+    static std::vector<aiVector3D> randomPositions(unsigned int count) {
+        std::vector<aiVector3D> positions;
+        for (unsigned int i = 0; i < count; ++i) {
+            positions.push_back(aiVector3D(
+                    ai_real(rand() % 40) * ai_real(0.25),
+                    ai_real(rand() % 40) * ai_real(0.25),
+                    ai_real(rand() % 4) * ai_real(0.25)));
+        }
+        return positions;
+    }
+
+    // A flat-shaded building: a stack of floor slabs and the walls between them, tessellated
+    // into quads with four vertices of their own. Each inner position is shared by several
+    // vertices and almost all of them lay on a few axis-aligned planes.
+    static std::vector<aiVector3D> buildingPositions(unsigned int floors, unsigned int size, unsigned int height) {
+        std::vector<aiVector3D> positions;
+        const auto quad = [&positions](const aiVector3D &o, const aiVector3D &u, const aiVector3D &v) {
+            positions.push_back(o);
+            positions.push_back(o + u);
+            positions.push_back(o + u + v);
+            positions.push_back(o + v);
+        };
+        const ai_real s = ai_real(0.5);
+        for (unsigned int f = 0; f < floors; ++f) {
+            const ai_real z = ai_real(f * height) * s;
+            for (unsigned int y = 0; y < size; ++y) {
+                for (unsigned int x = 0; x < size; ++x) {
+                    quad(aiVector3D(x * s, y * s, z), aiVector3D(s, 0, 0), aiVector3D(0, s, 0));
+                }
+            }
+            for (unsigned int h = 0; h < height; ++h) {
+                const ai_real wz = z + h * s;
+                for (unsigned int i = 0; i < size; ++i) {
+                    quad(aiVector3D(i * s, 0, wz), aiVector3D(s, 0, 0), aiVector3D(0, 0, s));
+                    quad(aiVector3D(i * s, size * s, wz), aiVector3D(s, 0, 0), aiVector3D(0, 0, s));
+                    quad(aiVector3D(0, i * s, wz), aiVector3D(0, s, 0), aiVector3D(0, 0, s));
+                    quad(aiVector3D(size * s, i * s, wz), aiVector3D(0, s, 0), aiVector3D(0, 0, s));
+                }
+            }
+        }
+        return positions;
+    }
+};
+
+// ------------------------------------------------------------------------------------------------
+TEST_F(utSpatialGrid, emptyGridFindsNothing) {
+    SpatialGrid grid;
+    grid.Fill(nullptr, 0, sizeof(aiVector3D));
+
+    std::vector<unsigned int> found(3, 1);
+    grid.FindPositions(aiVector3D(0, 0, 0), 1, found);
+    EXPECT_TRUE(found.empty());
+
+    std::vector<unsigned int> offsets;
+    grid.FindAllPositions(1, offsets, found);
+    ASSERT_EQ(1u, offsets.size());
+    EXPECT_EQ(0u, offsets[0]);
+    EXPECT_TRUE(found.empty());
+}
+
+// ------------------------------------------------------------------------------------------------
+TEST_F(utSpatialGrid, findPositionsMatchesBruteForce) {
+    srand(7);
+    const std::vector<aiVector3D> positions = randomPositions(2000);
+    SpatialGrid grid(&positions[0], (unsigned int)positions.size(), sizeof(aiVector3D));
+
+    std::vector<unsigned int> found;
+    for (ai_real radius : { ai_real(1e-4), ai_real(0.3), ai_real(1.1), ai_real(100) }) {
+        for (unsigned int i = 0; i < positions.size(); i += 7) {
+            grid.FindPositions(positions[i], radius, found);
+            EXPECT_EQ(bruteForce(positions, positions[i], radius), found);
+        }
+
+        // positions away from the stored ones, including outside of the bounding box
+        const aiVector3D probes[] = { aiVector3D(ai_real(4.1), ai_real(3.3), ai_real(0.4)), aiVector3D(-1, -1, -1), aiVector3D(12, 5, 0) };
+        for (const aiVector3D &p : probes) {
+            grid.FindPositions(p, radius, found);
+            EXPECT_EQ(bruteForce(positions, p, radius), found);
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+TEST_F(utSpatialGrid, findIdenticalPositionsMatchesSpatialSort) {
+    srand(11);
+    std::vector<aiVector3D> positions = randomPositions(1000);
+    // some positions which are close, but not identical
+    for (unsigned int i = 0; i < 100; ++i) {
+        positions.push_back(positions[i] + aiVector3D(ai_real(1e-3), 0, 0));
+    }
+    SpatialGrid grid(&positions[0], (unsigned int)positions.size(), sizeof(aiVector3D));
+    SpatialSort sort(&positions[0], (unsigned int)positions.size(), sizeof(aiVector3D));
+
+    std::vector<unsigned int> expected, found;
+    for (const aiVector3D &p : positions) {
+        sort.FindIdenticalPositions(p, expected);
+        std::sort(expected.begin(), expected.end());
+        grid.FindIdenticalPositions(p, found);
+        EXPECT_EQ(expected, found);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+TEST_F(utSpatialGrid, findAllPositionsFillsAdjacency) {
+    srand(13);
+    const std::vector<aiVector3D> positions = randomPositions(1500);
+
+    // built in three parts to exercise Append()
+    SpatialGrid grid;
+    grid.Fill(&positions[0], 500, sizeof(aiVector3D), false);
+    grid.Append(&positions[500], 500, sizeof(aiVector3D));
+    grid.Append(&positions[1000], 500, sizeof(aiVector3D));
+
+    const ai_real radius = ai_real(0.3);
+    std::vector<unsigned int> offsets, neighbours, found;
+    grid.FindAllPositions(radius, offsets, neighbours);
+    ASSERT_EQ(positions.size() + 1, offsets.size());
+    EXPECT_EQ(neighbours.size(), offsets.back());
+    for (unsigned int i = 0; i < positions.size(); ++i) {
+        const std::vector<unsigned int> slice(neighbours.begin() + offsets[i], neighbours.begin() + offsets[i + 1]);
+        EXPECT_EQ(bruteForce(positions, positions[i], radius), slice);
+    }
+
+    grid.FindAllIdenticalPositions(offsets, neighbours);
+    ASSERT_EQ(positions.size() + 1, offsets.size());
+    for (unsigned int i = 0; i < positions.size(); ++i) {
+        const std::vector<unsigned int> slice(neighbours.begin() + offsets[i], neighbours.begin() + offsets[i + 1]);
+        grid.FindIdenticalPositions(positions[i], found);
+        EXPECT_EQ(found, slice);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+TEST_F(utSpatialGrid, generateMappingTable) {
+    // three clusters and a lone position
+    const aiVector3D positions[] = {
+        aiVector3D(0, 0, 0), aiVector3D(5, 0, 0), aiVector3D(ai_real(0.001), 0, 0),
+        aiVector3D(0, 5, 0), aiVector3D(5, 0, ai_real(0.001)), aiVector3D(0, ai_real(5.001), 0),
+        aiVector3D(9, 9, 9)
+    };
+    SpatialGrid grid(positions, 7, sizeof(aiVector3D));
+
+    std::vector<unsigned int> fill;
+    EXPECT_EQ(4u, grid.GenerateMappingTable(fill, ai_real(0.01)));
+    const unsigned int expected[] = { 0, 1, 0, 2, 1, 2, 3 };
+    EXPECT_EQ(std::vector<unsigned int>(expected, expected + 7), fill);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Benchmark on an architectural model: both structures must agree, the timings are printed.
+TEST_F(utSpatialGrid, planarBenchmark) {
+    const std::vector<aiVector3D> positions = buildingPositions(4, 128, 8);
+    const unsigned int count = (unsigned int)positions.size();
+
+    aiVector3D minVec(1e10f, 1e10f, 1e10f), maxVec(-1e10f, -1e10f, -1e10f);
+    for (const aiVector3D &p : positions) {
+        minVec.x = std::min(minVec.x, p.x);
+        minVec.y = std::min(minVec.y, p.y);
+        minVec.z = std::min(minVec.z, p.z);
+        maxVec.x = std::max(maxVec.x, p.x);
+        maxVec.y = std::max(maxVec.y, p.y);
+        maxVec.z = std::max(maxVec.z, p.z);
+    }
+    // the epsilon the post-processing steps use
+    const ai_real radius = (maxVec - minVec).Length() * ai_real(1e-4);
+
+    typedef std::chrono::high_resolution_clock Clock;
+    const Clock::time_point sortStart = Clock::now();
+    SpatialSort sort(&positions[0], count, sizeof(aiVector3D));
+    std::vector<std::vector<unsigned int>> expected(count);
+    for (unsigned int i = 0; i < count; ++i) {
+        sort.FindPositions(positions[i], radius, expected[i]);
+    }
+    const Clock::time_point gridStart = Clock::now();
+    SpatialGrid grid(&positions[0], count, sizeof(aiVector3D));
+    std::vector<unsigned int> offsets, neighbours;
+    grid.FindAllPositions(radius, offsets, neighbours);
+    const Clock::time_point gridEnd = Clock::now();
+
+    std::cout << count << " positions: SpatialSort "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(gridStart - sortStart).count() << " ms, SpatialGrid "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(gridEnd - gridStart).count() << " ms" << std::endl;
+
+    ASSERT_EQ(count + 1, offsets.size());
+    for (unsigned int i = 0; i < count; ++i) {
+        std::sort(expected[i].begin(), expected[i].end());
+        const std::vector<unsigned int> slice(neighbours.begin() + offsets[i], neighbours.begin() + offsets[i + 1]);
+        ASSERT_EQ(expected[i], slice);
+    }
+}
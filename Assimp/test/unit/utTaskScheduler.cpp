@@ -0,0 +1,168 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2019, assimp team
+
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+copyright notice, this list of conditions and the
+following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the
+following disclaimer in the documentation and/or other
+materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+contributors may be used to endorse or promote products
+derived from this software without specific prior
+written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+#include "UnitTestPCH.h"
+
+#include "Common/TaskScheduler.h"
+
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+#include <atomic>
+#include <stdexcept>
+
+using namespace Assimp;
+
+class utTaskScheduler : public ::testing::Test {
+protected:
+    // compares the post-processed geometry of two imports bit by bit
+    static void expectSameMeshes(const aiScene *expected, const aiScene *actual) {
+        ASSERT_EQ(expected->mNumMeshes, actual->mNumMeshes);
+        for (unsigned int m = 0; m < expected->mNumMeshes; ++m) {
+            const aiMesh *a = expected->mMeshes[m];
+            const aiMesh *b = actual->mMeshes[m];
+            ASSERT_EQ(a->mNumVertices, b->mNumVertices);
+            ASSERT_EQ(a->mNumFaces, b->mNumFaces);
+            ASSERT_EQ(a->mNumBones, b->mNumBones);
+            EXPECT_EQ(0, memcmp(a->mVertices, b->mVertices, a->mNumVertices * sizeof(aiVector3D)));
+            ASSERT_EQ(a->HasNormals(), b->HasNormals());
+            if (a->HasNormals()) {
+                EXPECT_EQ(0, memcmp(a->mNormals, b->mNormals, a->mNumVertices * sizeof(aiVector3D)));
+            }
+            ASSERT_EQ(a->HasTangentsAndBitangents(), b->HasTangentsAndBitangents());
+            if (a->HasTangentsAndBitangents()) {
+                EXPECT_EQ(0, memcmp(a->mTangents, b->mTangents, a->mNumVertices * sizeof(aiVector3D)));
+                EXPECT_EQ(0, memcmp(a->mBitangents, b->mBitangents, a->mNumVertices * sizeof(aiVector3D)));
+            }
+            for (unsigned int f = 0; f < a->mNumFaces; ++f) {
+                ASSERT_EQ(a->mFaces[f].mNumIndices, b->mFaces[f].mNumIndices);
+                EXPECT_EQ(0, memcmp(a->mFaces[f].mIndices, b->mFaces[f].mIndices, a->mFaces[f].mNumIndices * sizeof(unsigned int)));
+            }
+            for (unsigned int n = 0; n < a->mNumBones; ++n) {
+                ASSERT_EQ(a->mBones[n]->mNumWeights, b->mBones[n]->mNumWeights);
+                EXPECT_EQ(0, memcmp(a->mBones[n]->mWeights, b->mBones[n]->mWeights, a->mBones[n]->mNumWeights * sizeof(aiVertexWeight)));
+            }
+        }
+    }
+
+    static void expectSameImport(const char *file) {
+        const unsigned int flags = aiProcessPreset_TargetRealtime_MaxQuality | aiProcess_FindDegenerates;
+
+        Importer serial;
+        serial.SetPropertyInteger(AI_CONFIG_GLOB_MULTITHREADING, 0);
+        const aiScene *expected = serial.ReadFile(file, flags);
+        ASSERT_NE(nullptr, expected);
+
+        Importer parallel;
+        parallel.SetPropertyInteger(AI_CONFIG_GLOB_MULTITHREADING, 4);
+        const aiScene *actual = parallel.ReadFile(file, flags);
+        ASSERT_NE(nullptr, actual);
+
+        expectSameMeshes(expected, actual);
+    }
+};
+
+TEST_F(utTaskScheduler, visitsEveryIndexOnceTest) {
+    TaskScheduler scheduler(4);
+    EXPECT_EQ(4u, scheduler.GetNumThreads());
+
+    std::vector<std::atomic<unsigned int>> visits(1000);
+    for (unsigned int run = 0; run < 10; ++run) {
+        scheduler.ParallelFor(static_cast<unsigned int>(visits.size()), [&](unsigned int i) {
+            ++visits[i];
+        });
+    }
+    for (size_t i = 0; i < visits.size(); ++i) {
+        EXPECT_EQ(10u, visits[i].load());
+    }
+}
+
+TEST_F(utTaskScheduler, emptyAndSerialJobsTest) {
+    TaskScheduler scheduler(1);
+    EXPECT_EQ(1u, scheduler.GetNumThreads());
+
+    unsigned int calls = 0;
+    scheduler.ParallelFor(0, [&](unsigned int) { ++calls; });
+    EXPECT_EQ(0u, calls);
+    scheduler.ParallelFor(8, [&](unsigned int) { ++calls; });
+    EXPECT_EQ(8u, calls);
+}
+
+TEST_F(utTaskScheduler, rethrowsLowestIndexErrorTest) {
+    TaskScheduler scheduler(4);
+
+    std::atomic<unsigned int> calls(0);
+    try {
+        scheduler.ParallelFor(100, [&](unsigned int i) {
+            ++calls;
+            if (i == 17 || i == 80) {
+                throw std::runtime_error(std::to_string(i));
+            }
+        });
+        FAIL() << "expected an exception";
+    } catch (const std::runtime_error &e) {
+        EXPECT_STREQ("17", e.what());
+    }
+
+    // the job drains completely before the error is reported
+    EXPECT_EQ(100u, calls.load());
+
+    // and the scheduler is still usable afterwards
+    std::atomic<unsigned int> sum(0);
+    scheduler.ParallelFor(10, [&](unsigned int i) { sum += i; });
+    EXPECT_EQ(45u, sum.load());
+}
+
+TEST_F(utTaskScheduler, nestedJobsRunSeriallyTest) {
+    TaskScheduler scheduler(3);
+
+    std::atomic<unsigned int> calls(0);
+    scheduler.ParallelFor(6, [&](unsigned int) {
+        scheduler.ParallelFor(5, [&](unsigned int) { ++calls; });
+    });
+    EXPECT_EQ(30u, calls.load());
+}
+
+TEST_F(utTaskScheduler, postProcessingMatchesSerialRunTest) {
+    expectSameImport(ASSIMP_TEST_MODELS_DIR "/FBX/spider.fbx");
+    expectSameImport(ASSIMP_TEST_MODELS_DIR "/X/BCN_Epileptic.X");
+}
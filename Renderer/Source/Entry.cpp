@@ -8,6 +8,8 @@
 #include "examples/imgui_impl_dx11.h"
 
 #include "Primitives/GraphicsContext.h"
+#include "Primitives/GpuProfiler.h"
+#include "Primitives/Profiler.h"
 #include "Renderer/Renderer.h"
 
 // The Renderer class is the main application class, so making it static a  allows for the Window Procedure to easily access it for events. Not very good design,
@@ -96,6 +98,7 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 	{
 		// Initializes DirectX 11
 		GraphicsContext::Init(window);
+		GpuProfiler::Init();
 	}
 	catch (...)
 	{
@@ -122,23 +125,30 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 	// Variable that keeps track of delta time
 	float deltaTime = 0.f;
 
+	Profiler::SetThreadName("Main");
+
 	MSG message;
 	// This is the main loop of the application and continues till the window is closed
 	while (IsRunning)
 	{
 		// Get the time before the frame
 		QueryPerformanceCounter(&lastTickTime);
+		Profiler::Begin("Frame");
+		GpuProfiler::BeginFrame();
 
 		// Windows event handler to ensure our application responds to window events
+		Profiler::Begin("Messages");
 		while (PeekMessage(&message, window, NULL, NULL, PM_REMOVE))
 		{
 			TranslateMessage(&message);
 			DispatchMessage(&message);
 		}
+		Profiler::End();
 
 		// Render
 		GRenderer->Render(deltaTime);
 
+		Profiler::Begin("ImGui");
 		ImGui_ImplDX11_NewFrame();
 		ImGui_ImplWin32_NewFrame();
 		ImGui::NewFrame();
@@ -146,14 +156,24 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 		GRenderer->RenderGui();
 
 		ImGui::Render();
+		GpuProfiler::Begin("ImGui");
 		ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
 
 		// Update windows for ImGui viewports.
 		ImGui::UpdatePlatformWindows();
 		ImGui::RenderPlatformWindowsDefault();
+		GpuProfiler::End();
+		Profiler::End();
 
 		// Present the rendered frame to the user
+		GpuProfiler::EndFrame();
+		Profiler::Begin("Present");
 		GraphicsContext::SwapChain->Present(0, 0);
+		Profiler::End();
+
+		// Everything the frame timed is collected for the profiler window, which shows it next frame
+		Profiler::End();
+		Profiler::EndFrame();
 
 		// Get the time after the tick
 		QueryPerformanceCounter(&currentTickTime);
@@ -168,6 +188,7 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 	// Set it to nullptr so if the Window Procedure tries to access it, we don't crash
 	GRenderer = nullptr;
 
+	GpuProfiler::DeInit();
 	GraphicsContext::DeInit();
 	ImGui_ImplWin32_Shutdown();
 
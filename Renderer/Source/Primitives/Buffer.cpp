@@ -38,6 +38,12 @@ void VertexBuffer::Set(const void* data, unsigned int elementCount)
 	}
 }
 
+void VertexBuffer::Update(const void* data, unsigned int firstElement, unsigned int elementCount)
+{
+	D3D11_BOX box = { firstElement * m_Layout.stride, 0, 0, (firstElement + elementCount) * m_Layout.stride, 1, 1 };
+	GraphicsContext::Context->UpdateSubresource(p_Buffer.Get(), 0, &box, data, 0, 0);
+}
+
 void VertexBuffer::Create(const void* data)
 {
 	UINT cpuAccess = 0;
@@ -82,12 +88,12 @@ IndexBuffer::IndexBuffer(BufferAccess access, const unsigned int* indices, unsig
 
 void IndexBuffer::Bind() const
 {
-	GraphicsContext::Context->IASetIndexBuffer(p_Buffer.Get(), DXGI_FORMAT_R32_UINT, 0);
+	GraphicsContext::BindIndexBuffer(this);
 }
 
 void IndexBuffer::Unbind() const
 {
-	GraphicsContext::Context->IASetIndexBuffer(NULL, DXGI_FORMAT_UNKNOWN, 0);
+	GraphicsContext::BindIndexBuffer(nullptr);
 }
 
 void IndexBuffer::Set(const unsigned int* indices, unsigned int indexCount)
@@ -106,6 +112,12 @@ void IndexBuffer::Set(const unsigned int* indices, unsigned int indexCount)
 	}
 }
 
+void IndexBuffer::Update(const unsigned int* indices, unsigned int firstIndex, unsigned int indexCount)
+{
+	D3D11_BOX box = { firstIndex * (UINT) sizeof(unsigned int), 0, 0, (firstIndex + indexCount) * (UINT) sizeof(unsigned int), 1, 1 };
+	GraphicsContext::Context->UpdateSubresource(p_Buffer.Get(), 0, &box, indices, 0, 0);
+}
+
 void IndexBuffer::Create(const unsigned int* indices)
 {
 	UINT cpuAccess = 0;
@@ -171,6 +183,12 @@ ConstantBuffer::ConstantBuffer(const void* data, size_t size, ConstantBufferTarg
 	}
 }
 
+ConstantBuffer::ConstantBuffer(size_t size, ConstantBufferTarget target, ConstantRingBuffer* ring)
+	: ConstantBuffer(nullptr, size, target)
+{
+	p_Ring = ring;
+}
+
 void ConstantBuffer::Bind(unsigned int slot)
 {
 	switch (m_Target)
@@ -198,3 +216,130 @@ void ConstantBuffer::Set(const void* data)
 	memcpy(sr.pData, data, m_Size);
 	GraphicsContext::Context->Unmap(p_Buffer.Get(), 0);
 }
+
+unsigned int ConstantBuffer::Push(const void* data)
+{
+	return p_Ring->Push(data, (uint32_t) m_Size);
+}
+
+void ConstantBuffer::BindRecord(unsigned int slot, unsigned int record)
+{
+	if (!GraphicsContext::SupportsConstantBufferOffsets())
+	{
+		// Without D3D11.1 offsets, fall back to copying the record into our own buffer
+		Set(p_Ring->GetPacker().GetRecord(record));
+		Bind(slot);
+		return;
+	}
+
+	UINT firstConstant = record / ConstantPacker::ConstantSize;
+	UINT numConstants = ConstantPacker::GetRecordSize((uint32_t) m_Size) / ConstantPacker::ConstantSize;
+	switch (m_Target)
+	{
+	case ConstantBufferTarget::VertexShader: GraphicsContext::BindVSConstantBufferRange(this, p_Ring->GetBuffer(), slot, firstConstant, numConstants); break;
+	case ConstantBufferTarget::PixelShader: GraphicsContext::BindPSConstantBufferRange(this, p_Ring->GetBuffer(), slot, firstConstant, numConstants); break;
+	}
+
+	m_Slot = slot;
+}
+
+ConstantRingBuffer::ConstantRingBuffer(size_t capacity)
+	: m_Capacity(ConstantPacker::GetRecordSize((uint32_t) capacity))
+{
+	Create();
+}
+
+void ConstantRingBuffer::Upload()
+{
+	Write(m_Packer.GetData(), m_Packer.GetSize());
+}
+
+void ConstantRingBuffer::Write(const void* data, size_t size)
+{
+	if (size == 0) return;
+
+	if (size > m_Capacity)
+	{
+		while (m_Capacity < size) m_Capacity *= 2;
+		Create();
+	}
+
+	// The whole frame's constants land with this one map
+	D3D11_MAPPED_SUBRESOURCE sr;
+	GraphicsContext::Context->Map(p_Buffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, NULL, &sr);
+	memcpy(sr.pData, data, size);
+	GraphicsContext::Context->Unmap(p_Buffer.Get(), 0);
+}
+
+void ConstantRingBuffer::Create()
+{
+	D3D11_BUFFER_DESC desc;
+	ZeroMemory(&desc, sizeof(D3D11_BUFFER_DESC));
+	desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+	desc.ByteWidth = (UINT) m_Capacity;
+	desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	desc.MiscFlags = NULL;
+	desc.Usage = D3D11_USAGE_DYNAMIC;
+
+	HRESULT hr = GraphicsContext::Device->CreateBuffer(&desc, NULL, &p_Buffer);
+	if (FAILED(hr))
+	{
+		MessageBox(NULL, L"Failed to create constant ring buffer!", L"Object Error", MB_OK | MB_ICONERROR);
+		__debugbreak();
+	}
+}
+
+StructuredBuffer::StructuredBuffer(unsigned int stride, unsigned int elementCount)
+	: m_Stride(stride), m_Capacity(elementCount > 0 ? elementCount : 1)
+{
+	Create();
+}
+
+void StructuredBuffer::Set(const void* data, unsigned int elementCount)
+{
+	if (elementCount == 0) return;
+
+	if (elementCount > m_Capacity)
+	{
+		while (m_Capacity < elementCount) m_Capacity *= 2;
+		Create();
+	}
+
+	D3D11_MAPPED_SUBRESOURCE sr;
+	GraphicsContext::Context->Map(p_Buffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, NULL, &sr);
+	memcpy(sr.pData, data, elementCount * m_Stride);
+	GraphicsContext::Context->Unmap(p_Buffer.Get(), 0);
+}
+
+void StructuredBuffer::Create()
+{
+	D3D11_BUFFER_DESC desc;
+	ZeroMemory(&desc, sizeof(D3D11_BUFFER_DESC));
+	desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+	desc.ByteWidth = m_Capacity * m_Stride;
+	desc.StructureByteStride = m_Stride;
+	desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	desc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+	desc.Usage = D3D11_USAGE_DYNAMIC;
+
+	HRESULT hr = GraphicsContext::Device->CreateBuffer(&desc, NULL, &p_Buffer);
+	if (FAILED(hr))
+	{
+		MessageBox(NULL, L"Failed to create structured buffer!", L"Object Error", MB_OK | MB_ICONERROR);
+		__debugbreak();
+	}
+
+	D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc;
+	ZeroMemory(&srvDesc, sizeof(D3D11_SHADER_RESOURCE_VIEW_DESC));
+	srvDesc.Format = DXGI_FORMAT_UNKNOWN;
+	srvDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+	srvDesc.Buffer.FirstElement = 0;
+	srvDesc.Buffer.NumElements = m_Capacity;
+
+	hr = GraphicsContext::Device->CreateShaderResourceView(p_Buffer.Get(), &srvDesc, &p_View);
+	if (FAILED(hr))
+	{
+		MessageBox(NULL, L"Failed to create structured buffer view!", L"Object Error", MB_OK | MB_ICONERROR);
+		__debugbreak();
+	}
+}
@@ -2,89 +2,15 @@
 #include <d3d11.h>
 #include <wrl.h>
 #include <vector>
-#include <string>
-#include <initializer_list>
+
+#include "ConstantPacker.h"
+#include "VertexLayout.h"
 
 enum class BufferAccess
 {
 	Static, Dynamic
 };
 
-enum class ElementDataType
-{
-	float1, float2, float3, float4
-};
-
-struct VertexElement
-{
-	std::string semantic;
-	ElementDataType type;
-
-	bool operator==(const VertexElement& other) const
-	{
-		return semantic == other.semantic && type == other.type;
-	}
-
-	bool operator!=(const VertexElement& other) const
-	{
-		return semantic != other.semantic || type != other.type;
-	}
-
-	unsigned int GetSize() const
-	{
-		switch (type)
-		{
-		case ElementDataType::float1: return (unsigned int) sizeof(float);
-		case ElementDataType::float2: return (unsigned int) sizeof(float) * 2;
-		case ElementDataType::float3: return (unsigned int) sizeof(float) * 3;
-		case ElementDataType::float4: return (unsigned int) sizeof(float) * 4;
-		}
-
-		return 0;
-	}
-};
-
-struct VertexLayout
-{
-	VertexLayout(std::initializer_list<VertexElement> list)
-		: elements(list)
-	{
-		for (auto& element : elements)
-		{
-			stride += element.GetSize();
-		}
-	}
-
-	bool operator==(const VertexLayout& other) const
-	{
-		if (elements.size() != other.elements.size())
-			return false;
-
-		for (int i = 0; i < elements.size(); i++)
-		{
-			if (elements[i] != other.elements[i]) return false;
-		}
-
-		return true;
-	}
-
-	bool operator!=(const VertexLayout& other) const
-	{
-		if (elements.size() != other.elements.size())
-			return true;
-
-		for (int i = 0; i < elements.size(); i++)
-		{
-			if (elements[i] != other.elements[i]) return true;
-		}
-
-		return false;
-	}
-
-	std::vector<VertexElement> elements;
-	unsigned int stride = 0;
-};
-
 class VertexBuffer
 {
 public:
@@ -95,6 +21,8 @@ public:
 	void Unbind() const;
 
 	void Set(const void* data, unsigned int elementCount);
+	// Static buffers only, overwrites elementCount elements starting at firstElement without recreating the buffer
+	void Update(const void* data, unsigned int firstElement, unsigned int elementCount);
 
 	const VertexLayout& GetLayout() const { return m_Layout; }
 	ID3D11Buffer* GetBuffer() const { return p_Buffer.Get(); }
@@ -119,6 +47,8 @@ public:
 	void Unbind() const;
 
 	void Set(const unsigned int* indices, unsigned int indexCount);
+	// Static buffers only, like VertexBuffer::Update
+	void Update(const unsigned int* indices, unsigned int firstIndex, unsigned int indexCount);
 
 	ID3D11Buffer* GetBuffer() const { return p_Buffer.Get(); }
 	unsigned int GetSize() const { return m_Size; }
@@ -137,10 +67,40 @@ enum class ConstantBufferTarget
 	VertexShader, PixelShader
 };
 
+// One large dynamic buffer that receives every streamed constant record of a frame with a single map
+class ConstantRingBuffer
+{
+public:
+	ConstantRingBuffer(size_t capacity);
+	~ConstantRingBuffer() = default;
+
+	// Starts a new frame, records pushed before are gone
+	void Reset() { m_Packer.Reset(); }
+	uint32_t Push(const void* data, uint32_t size) { return m_Packer.Push(data, size); }
+
+	// Copies everything pushed this frame to the GPU, growing the buffer if it doesn't fit
+	void Upload();
+	// Same for a copy of the pushed records, e.g. one recorded into a CommandList
+	void Write(const void* data, size_t size);
+
+	const ConstantPacker& GetPacker() const { return m_Packer; }
+	ID3D11Buffer* GetBuffer() const { return p_Buffer.Get(); }
+
+private:
+	void Create();
+
+	Microsoft::WRL::ComPtr<ID3D11Buffer> p_Buffer = nullptr;
+
+	size_t m_Capacity;
+	ConstantPacker m_Packer;
+};
+
 class ConstantBuffer
 {
 public:
 	ConstantBuffer(const void* data, size_t size, ConstantBufferTarget target);
+	// Streaming mode: records are pushed into a ring shared with other constant buffers and bound by offset
+	ConstantBuffer(size_t size, ConstantBufferTarget target, ConstantRingBuffer* ring);
 	~ConstantBuffer() = default;
 
 	void Bind(unsigned int slot = 0);
@@ -148,6 +108,10 @@ public:
 
 	void Set(const void* data);
 
+	// Streaming mode only. Push returns the record to pass to BindRecord once the ring has been uploaded
+	unsigned int Push(const void* data);
+	void BindRecord(unsigned int slot, unsigned int record);
+
 	ID3D11Buffer* GetBuffer() const { return p_Buffer.Get(); }
 	void SetUnboundSlot() { m_Slot = -1; }
 
@@ -157,4 +121,28 @@ private:
 	size_t m_Size;
 	unsigned int m_Slot = -1;
 	ConstantBufferTarget m_Target;
+	ConstantRingBuffer* p_Ring = nullptr;
+};
+
+// Array of structures shaders read through a shader resource view, rewritten from the CPU whenever needed
+class StructuredBuffer
+{
+public:
+	StructuredBuffer(unsigned int stride, unsigned int elementCount);
+	~StructuredBuffer() = default;
+
+	// Replaces the contents, recreating the buffer if they don't fit
+	void Set(const void* data, unsigned int elementCount);
+
+	unsigned int GetStride() const { return m_Stride; }
+	ID3D11ShaderResourceView* GetView() const { return p_View.Get(); }
+
+private:
+	void Create();
+
+	Microsoft::WRL::ComPtr<ID3D11Buffer> p_Buffer = nullptr;
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> p_View = nullptr;
+
+	unsigned int m_Stride;
+	unsigned int m_Capacity;
 };
@@ -0,0 +1,32 @@
+#include <algorithm>
+
+#include "CommandList.h"
+
+void CommandList::WriteBuffer(WriteTarget target, void* buffer, const void* data, uint32_t size)
+{
+	Commands::WriteBuffer command = { buffer, target, size };
+	uint8_t* position = Allocate(Commands::WriteBuffer::Type, sizeof(command), size);
+
+	memcpy(position, &command, sizeof(command));
+	if (size > 0) memcpy(position + AlignUp(sizeof(command)), data, size);
+}
+
+void CommandList::ClearRenderTarget(void* target, const float color[4])
+{
+	Commands::ClearRenderTarget command = { target, { color[0], color[1], color[2], color[3] } };
+	Push(command);
+}
+
+uint8_t* CommandList::Allocate(CommandType type, size_t commandSize, size_t extraSize)
+{
+	size_t size = sizeof(Header) + AlignUp(commandSize) + AlignUp(extraSize);
+	if (m_Size + size > m_Data.size()) m_Data.resize(std::max(m_Data.size() * 2, m_Size + size));
+
+	uint8_t* position = m_Data.data() + m_Size;
+	Header header = { type, 0, (uint32_t) size };
+	memcpy(position, &header, sizeof(header));
+
+	m_Size += size;
+	++m_Count;
+	return position + sizeof(Header);
+}
@@ -0,0 +1,175 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+class VertexBuffer;
+class IndexBuffer;
+class ConstantBuffer;
+class ConstantRingBuffer;
+class StructuredBuffer;
+class VertexShader;
+class PixelShader;
+
+// Everything a frame asks of the device, as commands packed back to back into one block of memory.
+// Recording only copies plain values and the pointers of whatever is bound, it never touches the device,
+// so a frame can be recorded anywhere and handed to any CommandBackend to replay or inspect.
+
+enum class CommandType : uint16_t
+{
+	BindVertexBuffer,
+	BindIndexBuffer,
+	BindInstanceBuffer,
+	BindVertexShader,
+	BindPixelShader,
+	BindConstantBuffer,
+	BindConstantRecord,
+	BindStructuredBuffer,
+	BindRenderTarget,
+	WriteBuffer,
+	DrawIndexedInstanced,
+	ClearRenderTarget,
+	ClearDepth,
+	BeginScope,
+	EndScope,
+	Count
+};
+
+// Stage a constant buffer is bound for, only used to tell the registers of the stages apart
+enum class ShaderStage : uint32_t
+{
+	Vertex, Pixel
+};
+
+// What a WriteBuffer command overwrites, the written bytes follow the command
+enum class WriteTarget : uint32_t
+{
+	VertexBuffer, ConstantBuffer, ConstantRingBuffer, StructuredBuffer, IndexBuffer
+};
+
+namespace Commands
+{
+	struct BindVertexBuffer { static constexpr CommandType Type = CommandType::BindVertexBuffer; const VertexBuffer* buffer; };
+	struct BindIndexBuffer { static constexpr CommandType Type = CommandType::BindIndexBuffer; const IndexBuffer* buffer; };
+	struct BindInstanceBuffer { static constexpr CommandType Type = CommandType::BindInstanceBuffer; const VertexBuffer* buffer; };
+	struct BindVertexShader { static constexpr CommandType Type = CommandType::BindVertexShader; VertexShader* shader; };
+	struct BindPixelShader { static constexpr CommandType Type = CommandType::BindPixelShader; PixelShader* shader; };
+	struct BindConstantBuffer { static constexpr CommandType Type = CommandType::BindConstantBuffer; ConstantBuffer* buffer; ShaderStage stage; uint32_t slot; };
+	// A record pushed into the buffer's ring this frame
+	struct BindConstantRecord { static constexpr CommandType Type = CommandType::BindConstantRecord; ConstantBuffer* buffer; ShaderStage stage; uint32_t slot; uint32_t record; };
+	struct BindStructuredBuffer { static constexpr CommandType Type = CommandType::BindStructuredBuffer; StructuredBuffer* buffer; ShaderStage stage; uint32_t slot; };
+	struct WriteBuffer { static constexpr CommandType Type = CommandType::WriteBuffer; void* buffer; WriteTarget target; uint32_t size; };
+	struct DrawIndexedInstanced
+	{
+		static constexpr CommandType Type = CommandType::DrawIndexedInstanced;
+		uint32_t indexCount;
+		uint32_t instanceCount;
+		uint32_t firstIndex;
+		int32_t baseVertex;
+		uint32_t firstInstance;
+	};
+	// Targets are the backend's own views, passed through untouched
+	struct ClearRenderTarget { static constexpr CommandType Type = CommandType::ClearRenderTarget; void* target; float color[4]; };
+	struct ClearDepth { static constexpr CommandType Type = CommandType::ClearDepth; void* target; float depth; };
+	// The depth target may be null
+	struct BindRenderTarget { static constexpr CommandType Type = CommandType::BindRenderTarget; void* target; void* depth; };
+	// Brackets commands the backend can time, the name has to outlive the list like a string literal
+	struct BeginScope { static constexpr CommandType Type = CommandType::BeginScope; const char* name; };
+	struct EndScope { static constexpr CommandType Type = CommandType::EndScope; };
+}
+
+class CommandList
+{
+public:
+	// Every command starts with this, size includes the header and any data that follows the command
+	struct Header
+	{
+		CommandType type;
+		uint16_t padding;
+		uint32_t size;
+	};
+
+	static constexpr size_t Alignment = 8;
+
+	void Clear() { m_Size = 0; m_Count = 0; }
+
+	void BindVertexBuffer(const VertexBuffer* buffer) { Push(Commands::BindVertexBuffer{ buffer }); }
+	void BindIndexBuffer(const IndexBuffer* buffer) { Push(Commands::BindIndexBuffer{ buffer }); }
+	void BindInstanceBuffer(const VertexBuffer* buffer) { Push(Commands::BindInstanceBuffer{ buffer }); }
+	void BindVertexShader(VertexShader* shader) { Push(Commands::BindVertexShader{ shader }); }
+	void BindPixelShader(PixelShader* shader) { Push(Commands::BindPixelShader{ shader }); }
+	void BindConstantBuffer(ConstantBuffer* buffer, ShaderStage stage, uint32_t slot) { Push(Commands::BindConstantBuffer{ buffer, stage, slot }); }
+	void BindConstantRecord(ConstantBuffer* buffer, ShaderStage stage, uint32_t slot, uint32_t record) { Push(Commands::BindConstantRecord{ buffer, stage, slot, record }); }
+	void BindStructuredBuffer(StructuredBuffer* buffer, ShaderStage stage, uint32_t slot) { Push(Commands::BindStructuredBuffer{ buffer, stage, slot }); }
+
+	// Copies size bytes of data into the list, they are written to the buffer when the command is replayed
+	void WriteBuffer(WriteTarget target, void* buffer, const void* data, uint32_t size);
+
+	void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t baseVertex, uint32_t firstInstance)
+	{
+		Push(Commands::DrawIndexedInstanced{ indexCount, instanceCount, firstIndex, baseVertex, firstInstance });
+	}
+
+	void ClearRenderTarget(void* target, const float color[4]);
+	void ClearDepth(void* target, float depth) { Push(Commands::ClearDepth{ target, depth }); }
+	void BindRenderTarget(void* target, void* depth) { Push(Commands::BindRenderTarget{ target, depth }); }
+
+	// Scopes nest, every BeginScope needs an EndScope after it
+	void BeginScope(const char* name) { Push(Commands::BeginScope{ name }); }
+	void EndScope() { Push(Commands::EndScope{}); }
+
+	// Walks the commands in recording order
+	class Iterator
+	{
+	public:
+		Iterator(const uint8_t* position) : p_Position(position) {}
+
+		const Header& GetHeader() const { return *(const Header*) p_Position; }
+		CommandType GetType() const { return GetHeader().type; }
+
+		template<typename Command>
+		const Command& Get() const { return *(const Command*) (p_Position + sizeof(Header)); }
+		// Bytes following a WriteBuffer command
+		const void* GetData() const { return p_Position + sizeof(Header) + AlignUp(sizeof(Commands::WriteBuffer)); }
+
+		Iterator& operator ++() { p_Position += GetHeader().size; return *this; }
+		bool operator !=(const Iterator& other) const { return p_Position != other.p_Position; }
+		const Iterator& operator *() const { return *this; }
+
+	private:
+		const uint8_t* p_Position;
+	};
+
+	Iterator begin() const { return Iterator(m_Data.data()); }
+	Iterator end() const { return Iterator(m_Data.data() + m_Size); }
+
+	size_t GetCount() const { return m_Count; }
+	size_t GetSize() const { return m_Size; }
+
+private:
+	static constexpr size_t AlignUp(size_t size) { return (size + Alignment - 1) & ~(Alignment - 1); }
+
+	// Reserves room for a command and extra bytes after it, returns where the command goes
+	uint8_t* Allocate(CommandType type, size_t commandSize, size_t extraSize);
+
+	template<typename Command>
+	void Push(const Command& command)
+	{
+		memcpy(Allocate(Command::Type, sizeof(Command), 0), &command, sizeof(Command));
+	}
+
+	// Kept between frames, so recording settles into never allocating
+	std::vector<uint8_t> m_Data;
+	size_t m_Size = 0;
+	size_t m_Count = 0;
+};
+
+// Takes a recorded list and does something with every command in it
+class CommandBackend
+{
+public:
+	virtual ~CommandBackend() = default;
+
+	virtual void Execute(const CommandList& list) = 0;
+};
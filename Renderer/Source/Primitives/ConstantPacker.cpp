@@ -0,0 +1,24 @@
+#include <cstring>
+
+#include "ConstantPacker.h"
+
+uint32_t ConstantPacker::Push(const void* data, uint32_t size)
+{
+	uint32_t offset = m_Size;
+	uint32_t recordSize = GetRecordSize(size);
+
+	// Grow geometrically so a frame only reallocates while the scene is growing
+	if (offset + recordSize > m_Data.size())
+	{
+		size_t capacity = m_Data.empty() ? RecordAlignment * 64 : m_Data.size();
+		while (capacity < offset + recordSize) capacity *= 2;
+		m_Data.resize(capacity);
+	}
+
+	memcpy(m_Data.data() + offset, data, size);
+	// Zero the padding so the bytes past the record are deterministic on the GPU side too
+	memset(m_Data.data() + offset + size, 0, recordSize - size);
+	m_Size = offset + recordSize;
+
+	return offset;
+}
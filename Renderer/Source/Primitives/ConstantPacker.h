@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// Packs the constant records of a whole frame back to back into one block of memory,
+// so they can be copied into a single GPU buffer with one map and bound by offset.
+// Every record starts on a 256 byte boundary, which is the granularity D3D11.1 binds constant buffer ranges at.
+class ConstantPacker
+{
+public:
+	static constexpr uint32_t RecordAlignment = 256;
+	// Size of one shader constant, the unit ranges are bound in
+	static constexpr uint32_t ConstantSize = 16;
+
+	void Reset() { m_Size = 0; }
+
+	// Copies a record into the frame and returns its byte offset
+	uint32_t Push(const void* data, uint32_t size);
+
+	const uint8_t* GetData() const { return m_Data.data(); }
+	const uint8_t* GetRecord(uint32_t offset) const { return m_Data.data() + offset; }
+	uint32_t GetSize() const { return m_Size; }
+
+	// Bytes a record of the given size occupies, including the padding up to the next record
+	static uint32_t GetRecordSize(uint32_t size) { return (size + RecordAlignment - 1) & ~(RecordAlignment - 1); }
+
+private:
+	std::vector<uint8_t> m_Data;
+	uint32_t m_Size = 0;
+};
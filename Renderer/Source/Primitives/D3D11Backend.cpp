@@ -0,0 +1,109 @@
+#include "D3D11Backend.h"
+#include "GraphicsContext.h"
+#include "GpuProfiler.h"
+#include "Buffer.h"
+#include "Shader.h"
+
+void D3D11Backend::Execute(const CommandList& list)
+{
+	auto& context = GraphicsContext::Context;
+
+	for (auto& command : list)
+	{
+		switch (command.GetType())
+		{
+		case CommandType::BindVertexBuffer:
+			GraphicsContext::BindVertexBuffer(command.Get<Commands::BindVertexBuffer>().buffer);
+			break;
+		case CommandType::BindIndexBuffer:
+			GraphicsContext::BindIndexBuffer(command.Get<Commands::BindIndexBuffer>().buffer);
+			break;
+		case CommandType::BindInstanceBuffer:
+			GraphicsContext::BindInstanceBuffer(command.Get<Commands::BindInstanceBuffer>().buffer);
+			break;
+		case CommandType::BindVertexShader:
+			GraphicsContext::BindVertexShader(command.Get<Commands::BindVertexShader>().shader);
+			break;
+		case CommandType::BindPixelShader:
+			GraphicsContext::BindPixelShader(command.Get<Commands::BindPixelShader>().shader);
+			break;
+		case CommandType::BindConstantBuffer:
+		{
+			// The buffer knows which stage it belongs to
+			auto& bind = command.Get<Commands::BindConstantBuffer>();
+			bind.buffer->Bind(bind.slot);
+			break;
+		}
+		case CommandType::BindConstantRecord:
+		{
+			auto& bind = command.Get<Commands::BindConstantRecord>();
+			bind.buffer->BindRecord(bind.slot, bind.record);
+			break;
+		}
+		case CommandType::BindStructuredBuffer:
+		{
+			auto& bind = command.Get<Commands::BindStructuredBuffer>();
+			if (bind.stage == ShaderStage::Vertex)
+				GraphicsContext::BindVSShaderResource(bind.buffer, bind.slot);
+			else
+				GraphicsContext::BindPSShaderResource(bind.buffer, bind.slot);
+			break;
+		}
+		case CommandType::BindRenderTarget:
+		{
+			auto& bind = command.Get<Commands::BindRenderTarget>();
+			GraphicsContext::BindRenderTarget((ID3D11RenderTargetView*) bind.target, (ID3D11DepthStencilView*) bind.depth);
+			break;
+		}
+		case CommandType::WriteBuffer:
+		{
+			auto& write = command.Get<Commands::WriteBuffer>();
+			switch (write.target)
+			{
+			case WriteTarget::VertexBuffer:
+			{
+				auto buffer = (VertexBuffer*) write.buffer;
+				buffer->Set(command.GetData(), write.size / buffer->GetLayout().stride);
+				break;
+			}
+			case WriteTarget::ConstantBuffer: ((ConstantBuffer*) write.buffer)->Set(command.GetData()); break;
+			case WriteTarget::ConstantRingBuffer: ((ConstantRingBuffer*) write.buffer)->Write(command.GetData(), write.size); break;
+			case WriteTarget::StructuredBuffer:
+			{
+				auto buffer = (StructuredBuffer*) write.buffer;
+				buffer->Set(command.GetData(), write.size / buffer->GetStride());
+				break;
+			}
+			case WriteTarget::IndexBuffer: ((IndexBuffer*) write.buffer)->Set((const unsigned int*) command.GetData(), write.size / sizeof(unsigned int)); break;
+			}
+			break;
+		}
+		case CommandType::DrawIndexedInstanced:
+		{
+			auto& draw = command.Get<Commands::DrawIndexedInstanced>();
+			GraphicsContext::DrawIndexedInstanced(draw.indexCount, draw.instanceCount, draw.firstIndex, draw.baseVertex, draw.firstInstance);
+			break;
+		}
+		case CommandType::ClearRenderTarget:
+		{
+			auto& clear = command.Get<Commands::ClearRenderTarget>();
+			context->ClearRenderTargetView((ID3D11RenderTargetView*) clear.target, clear.color);
+			break;
+		}
+		case CommandType::ClearDepth:
+		{
+			auto& clear = command.Get<Commands::ClearDepth>();
+			context->ClearDepthStencilView((ID3D11DepthStencilView*) clear.target, D3D11_CLEAR_DEPTH, clear.depth, 0);
+			break;
+		}
+		case CommandType::BeginScope:
+			GpuProfiler::Begin(command.Get<Commands::BeginScope>().name);
+			break;
+		case CommandType::EndScope:
+			GpuProfiler::End();
+			break;
+		default:
+			break;
+		}
+	}
+}
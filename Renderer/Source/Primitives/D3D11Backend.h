@@ -0,0 +1,10 @@
+#pragma once
+#include "CommandList.h"
+
+// Replays command lists on GraphicsContext's device context, binds go through its state cache like everything else.
+// Scopes are timed by the GpuProfiler
+class D3D11Backend : public CommandBackend
+{
+public:
+	void Execute(const CommandList& list) override;
+};
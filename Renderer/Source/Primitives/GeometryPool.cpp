@@ -0,0 +1,79 @@
+#include <algorithm>
+
+#include "GeometryPool.h"
+
+std::unordered_map<VertexLayout, std::vector<GeometryPool::Block<VertexBuffer>>, VertexLayoutHasher> GeometryPool::m_VertexBlocks;
+std::vector<GeometryPool::Block<IndexBuffer>> GeometryPool::m_IndexBlocks;
+
+namespace
+{
+	// First block with room, otherwise a new one at least blockSize large
+	template<typename Block, typename Create>
+	Block* AllocateFrom(std::vector<Block>& blocks, unsigned int count, unsigned int blockSize, unsigned int& offset, Create create)
+	{
+		for (auto& block : blocks)
+		{
+			offset = block.allocator.Allocate(count);
+			if (offset != OffsetAllocator::Invalid) return &block;
+		}
+
+		unsigned int size = std::max(count, blockSize);
+		blocks.push_back({ create(size), OffsetAllocator(size) });
+		offset = blocks.back().allocator.Allocate(count);
+		return &blocks.back();
+	}
+
+	template<typename Block, typename Buffer>
+	void FreeFrom(std::vector<Block>& blocks, const Buffer* buffer, unsigned int offset, unsigned int count)
+	{
+		auto block = std::find_if(blocks.begin(), blocks.end(), [buffer](const Block& block) { return block.buffer.get() == buffer; });
+		if (block == blocks.end()) return;
+
+		block->allocator.Free(offset, count);
+
+		// Keep the first block around for whatever gets loaded next, give any other empty one back
+		if (blocks.size() > 1 && block->allocator.GetFreeSize() == block->allocator.GetSize()) blocks.erase(block);
+	}
+}
+
+GeometryAllocation GeometryPool::Allocate(const VertexLayout& layout, unsigned int vertexCount, unsigned int indexCount)
+{
+	GeometryAllocation allocation;
+	allocation.vertexCount = vertexCount;
+	allocation.indexCount = indexCount;
+
+	auto vertexBlock = AllocateFrom(m_VertexBlocks[layout], vertexCount, VertexBlockSize, allocation.vertexOffset,
+		[&layout](unsigned int size) { return std::make_unique<VertexBuffer>(layout, BufferAccess::Static, nullptr, size); });
+	auto indexBlock = AllocateFrom(m_IndexBlocks, indexCount, IndexBlockSize, allocation.indexOffset,
+		[](unsigned int size) { return std::make_unique<IndexBuffer>(BufferAccess::Static, nullptr, size); });
+
+	allocation.vertexBuffer = vertexBlock->buffer.get();
+	allocation.indexBuffer = indexBlock->buffer.get();
+
+	return allocation;
+}
+
+void GeometryPool::Free(const GeometryAllocation& allocation)
+{
+	if (allocation.vertexBuffer)
+	{
+		auto blocks = m_VertexBlocks.find(allocation.vertexBuffer->GetLayout());
+		if (blocks != m_VertexBlocks.end()) FreeFrom(blocks->second, allocation.vertexBuffer, allocation.vertexOffset, allocation.vertexCount);
+	}
+
+	if (allocation.indexBuffer) FreeFrom(m_IndexBlocks, allocation.indexBuffer, allocation.indexOffset, allocation.indexCount);
+}
+
+void GeometryPool::Release()
+{
+	m_VertexBlocks.clear();
+	m_IndexBlocks.clear();
+}
+
+size_t GeometryPool::GetBufferCount()
+{
+	size_t count = m_IndexBlocks.size();
+	for (auto& blocks : m_VertexBlocks) count += blocks.second.size();
+
+	return count;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "Buffer.h"
+#include "OffsetAllocator.h"
+
+// A range of the shared geometry buffers, drawn with vertexOffset as the base vertex and indexOffset as the start index
+struct GeometryAllocation
+{
+	VertexBuffer* vertexBuffer = nullptr;
+	IndexBuffer* indexBuffer = nullptr;
+	unsigned int vertexOffset = 0;
+	unsigned int vertexCount = 0;
+	unsigned int indexOffset = 0;
+	unsigned int indexCount = 0;
+};
+
+// Sub-allocates the geometry of every mesh out of a few large static buffers.
+// There is one list of vertex buffers per vertex layout and one list of index buffers, each grown a block at a time,
+// so meshes loaded one after the other usually share buffers and can be drawn without rebinding anything.
+class GeometryPool
+{
+public:
+	static GeometryAllocation Allocate(const VertexLayout& layout, unsigned int vertexCount, unsigned int indexCount);
+	static void Free(const GeometryAllocation& allocation);
+
+	// Destroys every buffer, anything still allocated from them must not be drawn again
+	static void Release();
+
+	static size_t GetBufferCount();
+
+private:
+	template<typename Buffer>
+	struct Block
+	{
+		std::unique_ptr<Buffer> buffer;
+		OffsetAllocator allocator;
+	};
+
+	// In elements. Meshes that don't fit get a block of their own
+	static constexpr unsigned int VertexBlockSize = 1 << 20;
+	static constexpr unsigned int IndexBlockSize = 4 << 20;
+
+	static std::unordered_map<VertexLayout, std::vector<Block<VertexBuffer>>, VertexLayoutHasher> m_VertexBlocks;
+	static std::vector<Block<IndexBuffer>> m_IndexBlocks;
+};
@@ -0,0 +1,134 @@
+#include "GpuProfiler.h"
+#include "GraphicsContext.h"
+
+GpuProfiler::Frame GpuProfiler::m_Frames[FramesInFlight];
+unsigned int GpuProfiler::m_CurrentFrame = 0;
+bool GpuProfiler::m_InFrame = false;
+
+unsigned int GpuProfiler::m_OpenScopes[Profiler::MaxDepth];
+unsigned int GpuProfiler::m_Depth = 0;
+
+uint32_t GpuProfiler::m_Track = 0;
+
+void GpuProfiler::Init()
+{
+	D3D11_QUERY_DESC disjointDesc = { D3D11_QUERY_TIMESTAMP_DISJOINT, 0 };
+	D3D11_QUERY_DESC timestampDesc = { D3D11_QUERY_TIMESTAMP, 0 };
+
+	// Failing to create a query only costs us the GPU timings, so frames without all of theirs are never begun
+	for (auto& frame : m_Frames)
+	{
+		bool created = SUCCEEDED(GraphicsContext::Device->CreateQuery(&disjointDesc, &frame.disjoint)) &&
+			SUCCEEDED(GraphicsContext::Device->CreateQuery(&timestampDesc, &frame.start));
+		for (auto& scope : frame.scopes)
+		{
+			created = created && SUCCEEDED(GraphicsContext::Device->CreateQuery(&timestampDesc, &scope.begin)) &&
+				SUCCEEDED(GraphicsContext::Device->CreateQuery(&timestampDesc, &scope.end));
+		}
+
+		if (!created) frame.disjoint = nullptr;
+	}
+
+	m_Track = Profiler::CreateTrack("GPU");
+}
+
+void GpuProfiler::DeInit()
+{
+	for (auto& frame : m_Frames) frame = Frame();
+	m_InFrame = false;
+	m_Depth = 0;
+}
+
+void GpuProfiler::BeginFrame()
+{
+	// Oldest first, so the track gets its events in order. Stop at the first frame that isn't done, the ones after it can't be either
+	for (unsigned int i = 1; i <= FramesInFlight; i++)
+	{
+		auto& frame = m_Frames[(m_CurrentFrame + i) % FramesInFlight];
+		if (frame.pending && !Resolve(frame)) break;
+	}
+
+	m_CurrentFrame = (m_CurrentFrame + 1) % FramesInFlight;
+	auto& frame = m_Frames[m_CurrentFrame];
+	frame.pending = false;
+	frame.scopeCount = 0;
+	m_Depth = 0;
+
+	m_InFrame = frame.disjoint != nullptr;
+	if (!m_InFrame) return;
+
+	frame.cpuStart = Profiler::Now();
+	GraphicsContext::Context->Begin(frame.disjoint.Get());
+	GraphicsContext::Context->End(frame.start.Get());
+}
+
+void GpuProfiler::EndFrame()
+{
+	if (!m_InFrame) return;
+
+	// Scopes left open end with the frame
+	while (m_Depth > 0) End();
+
+	auto& frame = m_Frames[m_CurrentFrame];
+	GraphicsContext::Context->End(frame.disjoint.Get());
+	frame.pending = true;
+	m_InFrame = false;
+}
+
+void GpuProfiler::Begin(const char* name)
+{
+	if (!m_InFrame) return;
+
+	auto& frame = m_Frames[m_CurrentFrame];
+	unsigned int index = MaxScopes;
+	if (frame.scopeCount < MaxScopes)
+	{
+		index = frame.scopeCount++;
+		auto& scope = frame.scopes[index];
+		scope.name = name;
+		scope.depth = m_Depth;
+		GraphicsContext::Context->End(scope.begin.Get());
+	}
+
+	if (m_Depth < Profiler::MaxDepth) m_OpenScopes[m_Depth] = index;
+	++m_Depth;
+}
+
+void GpuProfiler::End()
+{
+	if (!m_InFrame || m_Depth == 0) return;
+
+	--m_Depth;
+	if (m_Depth >= Profiler::MaxDepth) return;
+
+	unsigned int index = m_OpenScopes[m_Depth];
+	if (index < MaxScopes) GraphicsContext::Context->End(m_Frames[m_CurrentFrame].scopes[index].end.Get());
+}
+
+bool GpuProfiler::Resolve(Frame& frame)
+{
+	auto& context = GraphicsContext::Context;
+
+	// Everything in the frame was issued before the disjoint query ended, so once it is done the timestamps are too
+	D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint;
+	if (context->GetData(frame.disjoint.Get(), &disjoint, sizeof(disjoint), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK) return false;
+	frame.pending = false;
+
+	uint64_t start;
+	if (disjoint.Disjoint || context->GetData(frame.start.Get(), &start, sizeof(start), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK) return true;
+
+	double toNanoseconds = 1e9 / (double) disjoint.Frequency;
+	for (unsigned int i = 0; i < frame.scopeCount; i++)
+	{
+		auto& scope = frame.scopes[i];
+		uint64_t begin, end;
+		if (context->GetData(scope.begin.Get(), &begin, sizeof(begin), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+			context->GetData(scope.end.Get(), &end, sizeof(end), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+			continue;
+
+		Profiler::Record(m_Track, scope.name, frame.cpuStart + uint64_t((begin - start) * toNanoseconds),
+			frame.cpuStart + uint64_t((end - start) * toNanoseconds), scope.depth);
+	}
+
+	return true;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <wrl.h>
+#include <d3d11.h>
+
+#include "Profiler.h"
+
+// Times scopes on the GPU with timestamp queries and records them on a "GPU" track of the Profiler.
+// Queries are read back a few frames later without ever waiting on the device, so GPU scopes show up in the profiler's frames late.
+// D3D11 has no clock shared with the CPU, so every frame's scopes are placed from the CPU time the frame was begun
+class GpuProfiler
+{
+public:
+	// Frames that can wait on their queries at once, a frame whose queries still aren't ready when its slot comes around is dropped
+	static constexpr unsigned int FramesInFlight = 4;
+	static constexpr unsigned int MaxScopes = 64;
+
+	static void Init();
+	static void DeInit();
+
+	// Everything timed in a frame goes between these, scopes outside of them are ignored
+	static void BeginFrame();
+	static void EndFrame();
+
+	// End() closes the last scope opened. Past MaxScopes in a frame scopes still balance, they just aren't timed
+	static void Begin(const char* name);
+	static void End();
+
+private:
+	struct Scope
+	{
+		const char* name;
+		uint32_t depth;
+		Microsoft::WRL::ComPtr<ID3D11Query> begin;
+		Microsoft::WRL::ComPtr<ID3D11Query> end;
+	};
+
+	struct Frame
+	{
+		// Timestamps are only comparable if the GPU's clock didn't change in between, which this tells
+		Microsoft::WRL::ComPtr<ID3D11Query> disjoint;
+		Microsoft::WRL::ComPtr<ID3D11Query> start;
+		Scope scopes[MaxScopes];
+		unsigned int scopeCount = 0;
+		uint64_t cpuStart = 0;
+		bool pending = false;
+	};
+
+	// Records the frame's scopes if its queries are done, returns false if they aren't yet
+	static bool Resolve(Frame& frame);
+
+	static Frame m_Frames[FramesInFlight];
+	static unsigned int m_CurrentFrame;
+	static bool m_InFrame;
+
+	// Open scopes, as indices into the current frame's scopes, MaxScopes for ones that aren't timed
+	static unsigned int m_OpenScopes[Profiler::MaxDepth];
+	static unsigned int m_Depth;
+
+	static uint32_t m_Track;
+};
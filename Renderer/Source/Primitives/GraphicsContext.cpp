@@ -1,3 +1,4 @@
+#include <cstring>
 #include <exception>
 
 #include "GraphicsContext.h"
@@ -5,21 +6,31 @@
 #include "examples/imgui_impl_dx11.h"
 
 #include "Buffer.h"
+#include "GeometryPool.h"
 #include "Shader.h"
 
 Microsoft::WRL::ComPtr<ID3D11Device> GraphicsContext::Device = nullptr;
 Microsoft::WRL::ComPtr<ID3D11DeviceContext> GraphicsContext::Context = nullptr;
+Microsoft::WRL::ComPtr<ID3D11DeviceContext1> GraphicsContext::Context1 = nullptr;
 Microsoft::WRL::ComPtr<IDXGISwapChain> GraphicsContext::SwapChain = nullptr;
 
-const VertexBuffer* GraphicsContext::m_LastVertexBuffer = nullptr;
 const VertexBuffer* GraphicsContext::m_CurrentVertexBuffer = nullptr;
 const VertexShader* GraphicsContext::m_CurrentVertexShader = nullptr;
+const VertexBuffer* GraphicsContext::m_CurrentInstanceBuffer = nullptr;
+bool GraphicsContext::m_InputLayoutDirty = false;
+
+std::unordered_map<GraphicsContext::InputLayoutKey, Microsoft::WRL::ComPtr<ID3D11InputLayout>, GraphicsContext::InputLayoutKeyHasher>
+	GraphicsContext::m_InputLayouts;
 
 ConstantBuffer* GraphicsContext::m_BoundVSConstantBuffers[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
 ID3D11Buffer* GraphicsContext::m_VSConstantBuffers[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
 ConstantBuffer* GraphicsContext::m_BoundPSConstantBuffers[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
 ID3D11Buffer* GraphicsContext::m_PSConstantBuffers[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
 
+bool GraphicsContext::m_ConstantBufferOffsets = false;
+
+StateCache GraphicsContext::m_StateCache;
+
 void GraphicsContext::Init(HWND window)
 {
 	// This describes the settings of the swap chain.
@@ -76,17 +87,30 @@ void GraphicsContext::Init(HWND window)
 		m_BoundPSConstantBuffers[i] = nullptr;
 	}
 
+	// Binding constant buffer ranges by offset needs the D3D11.1 context and driver support
+	D3D11_FEATURE_DATA_D3D11_OPTIONS options;
+	if (SUCCEEDED(Context.As(&Context1)) &&
+		SUCCEEDED(Device->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options))))
+	{
+		m_ConstantBufferOffsets = options.ConstantBufferOffsetting;
+	}
+
 	ImGui_ImplDX11_Init(Device.Get(), Context.Get());
 }
 
 void GraphicsContext::DeInit()
 {
+	// Every mesh is gone by now, the buffers they were allocated from can go too
+	GeometryPool::Release();
+	m_InputLayouts.clear();
 	ImGui_ImplDX11_Shutdown();
 }
 
 void GraphicsContext::BindVertexBuffer(const VertexBuffer* buffer)
 {
-	m_LastVertexBuffer = m_CurrentVertexBuffer;
+	// Keyed on the D3D buffer rather than the VertexBuffer, Set() may recreate it
+	if (!m_StateCache.Bind(StateCache::VertexBuffer, buffer ? buffer->GetBuffer() : nullptr)) return;
+
 	m_CurrentVertexBuffer = buffer;
 	
 	ID3D11Buffer* d3dbuffer;
@@ -104,13 +128,40 @@ void GraphicsContext::BindVertexBuffer(const VertexBuffer* buffer)
 	}
 	offset = 0;
 
-	InputLayoutSetup();
+	m_InputLayoutDirty = true;
 
 	Context->IASetVertexBuffers(0, 1, &d3dbuffer, &stride, &offset);
 }
 
+void GraphicsContext::BindIndexBuffer(const IndexBuffer* buffer)
+{
+	if (!m_StateCache.Bind(StateCache::IndexBuffer, buffer ? buffer->GetBuffer() : nullptr)) return;
+
+	if (buffer)
+		Context->IASetIndexBuffer(buffer->GetBuffer(), DXGI_FORMAT_R32_UINT, 0);
+	else
+		Context->IASetIndexBuffer(NULL, DXGI_FORMAT_UNKNOWN, 0);
+}
+
+void GraphicsContext::BindInstanceBuffer(const VertexBuffer* buffer)
+{
+	if (!m_StateCache.Bind(StateCache::InstanceBuffer, buffer ? buffer->GetBuffer() : nullptr)) return;
+
+	m_CurrentInstanceBuffer = buffer;
+
+	ID3D11Buffer* d3dbuffer = buffer ? buffer->GetBuffer() : nullptr;
+	UINT stride = buffer ? buffer->GetLayout().stride : 0;
+	UINT offset = 0;
+
+	m_InputLayoutDirty = true;
+
+	Context->IASetVertexBuffers(1, 1, &d3dbuffer, &stride, &offset);
+}
+
 void GraphicsContext::BindVertexShader(const VertexShader* shader)
 {
+	if (!m_StateCache.Bind(StateCache::VertexShader, shader)) return;
+
 	m_CurrentVertexShader = shader;
 
 	ID3D11VertexShader* d3dshader;
@@ -124,24 +175,35 @@ void GraphicsContext::BindVertexShader(const VertexShader* shader)
 		d3dshader = nullptr;
 	}
 
-	InputLayoutSetup();
+	m_InputLayoutDirty = true;
 
 	Context->VSSetShader(d3dshader, NULL, 0);
 }
 
+void GraphicsContext::BindPixelShader(const PixelShader* shader)
+{
+	if (!m_StateCache.Bind(StateCache::PixelShader, shader)) return;
+
+	Context->PSSetShader(shader ? shader->GetShader() : NULL, NULL, 0);
+}
+
 void GraphicsContext::BindVSConstantBuffer(const ConstantBuffer* buffer, unsigned int slot)
 {
 	if (slot >= D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT)
 	{
 		MessageBox(NULL, L"Constant Buffer cannot be bound to the slot", L"Runtime Error", MB_OK | MB_ICONERROR);
+		return;
 	}
 
+	if (!m_StateCache.Bind(StateCache::VSConstantBuffer + slot, buffer ? buffer->GetBuffer() : nullptr)) return;
+
 	if (m_BoundVSConstantBuffers[slot]) m_BoundVSConstantBuffers[slot]->SetUnboundSlot();
 
 	m_BoundVSConstantBuffers[slot] = const_cast<ConstantBuffer*>(buffer);
-	m_VSConstantBuffers[slot] = buffer->GetBuffer();
+	m_VSConstantBuffers[slot] = buffer ? buffer->GetBuffer() : nullptr;
 
-	Context->VSSetConstantBuffers(0, D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT, m_VSConstantBuffers);
+	// Only set the slot that changed, re-setting all of them would also reset the offsets of bound ranges
+	Context->VSSetConstantBuffers(slot, 1, &m_VSConstantBuffers[slot]);
 }
 
 void GraphicsContext::BindPSConstantBuffer(const ConstantBuffer* buffer, unsigned int slot)
@@ -149,40 +211,166 @@ void GraphicsContext::BindPSConstantBuffer(const ConstantBuffer* buffer, unsigne
 	if (slot >= D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT)
 	{
 		MessageBox(NULL, L"Constant Buffer cannot be bound to the slot", L"Runtime Error", MB_OK | MB_ICONERROR);
+		return;
 	}
 
+	if (!m_StateCache.Bind(StateCache::PSConstantBuffer + slot, buffer ? buffer->GetBuffer() : nullptr)) return;
+
 	if (m_BoundPSConstantBuffers[slot]) m_BoundPSConstantBuffers[slot]->SetUnboundSlot();
 
 	m_BoundPSConstantBuffers[slot] = const_cast<ConstantBuffer*>(buffer);
-	m_PSConstantBuffers[slot] = buffer->GetBuffer();
+	m_PSConstantBuffers[slot] = buffer ? buffer->GetBuffer() : nullptr;
+
+	Context->PSSetConstantBuffers(slot, 1, &m_PSConstantBuffers[slot]);
+}
+
+void GraphicsContext::BindVSConstantBufferRange(const ConstantBuffer* owner, ID3D11Buffer* buffer, unsigned int slot, unsigned int firstConstant, unsigned int numConstants)
+{
+	if (slot >= D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT)
+	{
+		MessageBox(NULL, L"Constant Buffer cannot be bound to the slot", L"Runtime Error", MB_OK | MB_ICONERROR);
+		return;
+	}
+
+	if (!m_StateCache.Bind(StateCache::VSConstantBuffer + slot, buffer, firstConstant)) return;
+
+	if (m_BoundVSConstantBuffers[slot] && m_BoundVSConstantBuffers[slot] != owner) m_BoundVSConstantBuffers[slot]->SetUnboundSlot();
+
+	m_BoundVSConstantBuffers[slot] = const_cast<ConstantBuffer*>(owner);
+	m_VSConstantBuffers[slot] = buffer;
+
+	Context1->VSSetConstantBuffers1(slot, 1, &buffer, &firstConstant, &numConstants);
+}
+
+void GraphicsContext::BindPSConstantBufferRange(const ConstantBuffer* owner, ID3D11Buffer* buffer, unsigned int slot, unsigned int firstConstant, unsigned int numConstants)
+{
+	if (slot >= D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT)
+	{
+		MessageBox(NULL, L"Constant Buffer cannot be bound to the slot", L"Runtime Error", MB_OK | MB_ICONERROR);
+		return;
+	}
+
+	if (!m_StateCache.Bind(StateCache::PSConstantBuffer + slot, buffer, firstConstant)) return;
+
+	if (m_BoundPSConstantBuffers[slot] && m_BoundPSConstantBuffers[slot] != owner) m_BoundPSConstantBuffers[slot]->SetUnboundSlot();
+
+	m_BoundPSConstantBuffers[slot] = const_cast<ConstantBuffer*>(owner);
+	m_PSConstantBuffers[slot] = buffer;
+
+	Context1->PSSetConstantBuffers1(slot, 1, &buffer, &firstConstant, &numConstants);
+}
+
+void GraphicsContext::BindVSShaderResource(const StructuredBuffer* buffer, unsigned int slot)
+{
+	if (slot >= ShaderResourceSlots)
+	{
+		MessageBox(NULL, L"Shader resource cannot be bound to the slot", L"Runtime Error", MB_OK | MB_ICONERROR);
+		return;
+	}
+
+	// Keyed on the view, Set() may recreate it
+	ID3D11ShaderResourceView* view = buffer ? buffer->GetView() : nullptr;
+	if (!m_StateCache.Bind(StateCache::VSShaderResource + slot, view)) return;
+
+	Context->VSSetShaderResources(slot, 1, &view);
+}
+
+void GraphicsContext::BindPSShaderResource(const StructuredBuffer* buffer, unsigned int slot)
+{
+	if (slot >= ShaderResourceSlots)
+	{
+		MessageBox(NULL, L"Shader resource cannot be bound to the slot", L"Runtime Error", MB_OK | MB_ICONERROR);
+		return;
+	}
+
+	ID3D11ShaderResourceView* view = buffer ? buffer->GetView() : nullptr;
+	if (!m_StateCache.Bind(StateCache::PSShaderResource + slot, view)) return;
 
-	Context->PSSetConstantBuffers(0, D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT, m_PSConstantBuffers);
+	Context->PSSetShaderResources(slot, 1, &view);
+}
+
+void GraphicsContext::BindRenderTarget(ID3D11RenderTargetView* target, ID3D11DepthStencilView* depth)
+{
+	// Both have to be checked, either one changing means binding the pair again
+	bool changed = m_StateCache.Bind(StateCache::RenderTarget, target);
+	changed = m_StateCache.Bind(StateCache::DepthStencil, depth) || changed;
+	if (!changed) return;
+
+	Context->OMSetRenderTargets(1, &target, depth);
+}
+
+void GraphicsContext::DrawIndexedInstanced(unsigned int indexCount, unsigned int instanceCount, unsigned int firstIndex, int baseVertex, unsigned int firstInstance)
+{
+	if (m_InputLayoutDirty)
+	{
+		InputLayoutSetup();
+		m_InputLayoutDirty = false;
+	}
+
+	Context->DrawIndexedInstanced(indexCount, instanceCount, firstIndex, baseVertex, firstInstance);
+}
+
+bool GraphicsContext::InputLayoutKey::operator==(const InputLayoutKey& other) const
+{
+	if (vertexLayout != other.vertexLayout || instanceLayout != other.instanceLayout || shaderHash != other.shaderHash) return false;
+	if (shaderBlob == other.shaderBlob) return true;
+	if (!shaderBlob || !other.shaderBlob || shaderBlob->GetBufferSize() != other.shaderBlob->GetBufferSize()) return false;
+
+	return std::memcmp(shaderBlob->GetBufferPointer(), other.shaderBlob->GetBufferPointer(), shaderBlob->GetBufferSize()) == 0;
+}
+
+size_t GraphicsContext::InputLayoutKeyHasher::operator()(const InputLayoutKey& key) const
+{
+	return HashCombine(HashCombine(key.vertexLayout.hash, key.instanceLayout.hash), key.shaderHash);
 }
 
 void GraphicsContext::InputLayoutSetup()
 {
 	if (!m_CurrentVertexShader || !m_CurrentVertexBuffer) return;
 
-	if (!m_LastVertexBuffer || m_LastVertexBuffer->GetLayout() != m_CurrentVertexBuffer->GetLayout())
+	InputLayoutKey key =
+	{
+		m_CurrentVertexBuffer->GetLayout(),
+		m_CurrentInstanceBuffer ? m_CurrentInstanceBuffer->GetLayout() : VertexLayout{},
+		m_CurrentVertexShader->GetBlob(),
+		m_CurrentVertexShader->GetBlobHash()
+	};
+
+	auto it = m_InputLayouts.find(key);
+	if (it == m_InputLayouts.end())
 	{
 		std::vector<D3D11_INPUT_ELEMENT_DESC> layout;
 
-		for (auto& element : m_CurrentVertexBuffer->GetLayout().elements)
+		auto addElements = [&layout](const VertexLayout& source, UINT slot)
 		{
-			DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
-
-			switch (element.type)
+			for (auto& element : source.elements)
 			{
-			case ElementDataType::float1: format = DXGI_FORMAT_R32_FLOAT; break;
-			case ElementDataType::float2: format = DXGI_FORMAT_R32G32_FLOAT; break;
-			case ElementDataType::float3: format = DXGI_FORMAT_R32G32B32_FLOAT; break;
-			case ElementDataType::float4: format = DXGI_FORMAT_R32G32B32A32_FLOAT; break;
+				DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+
+				switch (element.type)
+				{
+				case ElementDataType::float1: format = DXGI_FORMAT_R32_FLOAT; break;
+				case ElementDataType::float2: format = DXGI_FORMAT_R32G32_FLOAT; break;
+				case ElementDataType::float3: format = DXGI_FORMAT_R32G32B32_FLOAT; break;
+				case ElementDataType::float4: format = DXGI_FORMAT_R32G32B32A32_FLOAT; break;
+				case ElementDataType::half2: format = DXGI_FORMAT_R16G16_FLOAT; break;
+				case ElementDataType::half4: format = DXGI_FORMAT_R16G16B16A16_FLOAT; break;
+				case ElementDataType::snorm16x2: format = DXGI_FORMAT_R16G16_SNORM; break;
+				case ElementDataType::unorm16x2: format = DXGI_FORMAT_R16G16_UNORM; break;
+				case ElementDataType::unorm8x4: format = DXGI_FORMAT_R8G8B8A8_UNORM; break;
+				}
+
+				if (element.perInstance)
+					layout.push_back({ element.semantic.c_str(), element.index, format, slot, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 });
+				else
+					layout.push_back({ element.semantic.c_str(), element.index, format, slot, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 });
 			}
+		};
 
-			layout.push_back({ element.semantic.c_str(), 0, format, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 });
-		}
+		addElements(m_CurrentVertexBuffer->GetLayout(), 0);
+		if (m_CurrentInstanceBuffer) addElements(m_CurrentInstanceBuffer->GetLayout(), 1);
 
-		ID3D11InputLayout* iLayout;
+		Microsoft::WRL::ComPtr<ID3D11InputLayout> iLayout;
 		HRESULT hr = Device->CreateInputLayout
 		(
 			layout.data(), (UINT) layout.size(),
@@ -196,8 +384,10 @@ void GraphicsContext::InputLayoutSetup()
 			return;
 		}
 
-		Context->IASetInputLayout(iLayout);
-		iLayout->Release();
+		it = m_InputLayouts.emplace(std::move(key), iLayout).first;
 	}
+
+	ID3D11InputLayout* iLayout = it->second.Get();
+	if (m_StateCache.Bind(StateCache::InputLayout, iLayout)) Context->IASetInputLayout(iLayout);
 }
 
@@ -1,10 +1,17 @@
 #pragma once
 #include <wrl.h>
-#include <d3d11.h>
+#include <d3d11_1.h>
+#include <unordered_map>
+
+#include "StateCache.h"
+#include "VertexLayout.h"
 
 class VertexBuffer;
+class IndexBuffer;
 class ConstantBuffer;
+class StructuredBuffer;
 class VertexShader;
+class PixelShader;
 
 class GraphicsContext
 {
@@ -13,24 +20,76 @@ public:
 	static void DeInit();
 
 	static void BindVertexBuffer(const VertexBuffer* buffer);
+	static void BindIndexBuffer(const IndexBuffer* buffer);
+	// Per-instance data goes in the second input slot, next to the bound vertex buffer
+	static void BindInstanceBuffer(const VertexBuffer* buffer);
 	static void BindVertexShader(const VertexShader* shader);
+	static void BindPixelShader(const PixelShader* shader);
 
 	static void BindVSConstantBuffer(const ConstantBuffer* buffer, unsigned int slot);
 	static void BindPSConstantBuffer(const ConstantBuffer* buffer, unsigned int slot);
 
+	// Binds numConstants 16-byte constants of buffer starting at firstConstant, both multiples of 16.
+	// Needs SupportsConstantBufferOffsets()
+	static void BindVSConstantBufferRange(const ConstantBuffer* owner, ID3D11Buffer* buffer, unsigned int slot, unsigned int firstConstant, unsigned int numConstants);
+	static void BindPSConstantBufferRange(const ConstantBuffer* owner, ID3D11Buffer* buffer, unsigned int slot, unsigned int firstConstant, unsigned int numConstants);
+	static bool SupportsConstantBufferOffsets() { return m_ConstantBufferOffsets; }
+
+	// Binds the buffer's view to a t register, only the first few registers are tracked by the state cache
+	static void BindVSShaderResource(const StructuredBuffer* buffer, unsigned int slot);
+	static void BindPSShaderResource(const StructuredBuffer* buffer, unsigned int slot);
+	static constexpr unsigned int ShaderResourceSlots = StateCache::PSShaderResource - StateCache::VSShaderResource;
+
+	// Binds a single render target, depth may be null
+	static void BindRenderTarget(ID3D11RenderTargetView* target, ID3D11DepthStencilView* depth);
+
+	// Draws with whatever is bound, first picking the input layout for the bound buffers and vertex shader
+	static void DrawIndexedInstanced(unsigned int indexCount, unsigned int instanceCount, unsigned int firstIndex, int baseVertex, unsigned int firstInstance);
+
+	// Every bind above goes through this first and is dropped if it wouldn't change anything
+	static StateCache& GetStateCache() { return m_StateCache; }
+
 	static Microsoft::WRL::ComPtr<ID3D11Device> Device;
 	static Microsoft::WRL::ComPtr<ID3D11DeviceContext> Context;
+	static Microsoft::WRL::ComPtr<ID3D11DeviceContext1> Context1;
 	static Microsoft::WRL::ComPtr<IDXGISwapChain> SwapChain;
 
 private:
 	static void InputLayoutSetup();
 
-	static const VertexBuffer* m_LastVertexBuffer;
 	static const VertexBuffer* m_CurrentVertexBuffer;
 	static const VertexShader* m_CurrentVertexShader;
+	static const VertexBuffer* m_CurrentInstanceBuffer;
+	// The shader and the buffers can change in any order, in between they need not match, so the input layout waits for the draw
+	static bool m_InputLayoutDirty;
+
+	// An input layout covers both slots, so it depends on both layouts and on the shader's input signature.
+	// Compared in full, the hashes only pick the bucket
+	struct InputLayoutKey
+	{
+		VertexLayout vertexLayout;
+		VertexLayout instanceLayout;
+		// Shaders with the same bytecode can share input layouts
+		Microsoft::WRL::ComPtr<ID3DBlob> shaderBlob;
+		size_t shaderHash = 0;
+
+		bool operator==(const InputLayoutKey& other) const;
+	};
+
+	struct InputLayoutKeyHasher
+	{
+		size_t operator()(const InputLayoutKey& key) const;
+	};
+
+	// Every input layout created so far
+	static std::unordered_map<InputLayoutKey, Microsoft::WRL::ComPtr<ID3D11InputLayout>, InputLayoutKeyHasher> m_InputLayouts;
 
 	static ConstantBuffer* m_BoundVSConstantBuffers[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
 	static ID3D11Buffer* m_VSConstantBuffers[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
 	static ConstantBuffer* m_BoundPSConstantBuffers[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
 	static ID3D11Buffer* m_PSConstantBuffers[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
+
+	static bool m_ConstantBufferOffsets;
+
+	static StateCache m_StateCache;
 };
\ No newline at end of file
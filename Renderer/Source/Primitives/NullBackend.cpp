@@ -0,0 +1,180 @@
+#include <algorithm>
+
+#include "NullBackend.h"
+
+namespace
+{
+	// Constant buffer registers the state cache has slots for
+	constexpr uint32_t ConstantBufferSlots = StateCache::PSConstantBuffer - StateCache::VSConstantBuffer;
+
+	constexpr uint32_t ShaderResourceSlots = StateCache::PSShaderResource - StateCache::VSShaderResource;
+
+	uint32_t ConstantBufferSlot(ShaderStage stage, uint32_t slot)
+	{
+		return (stage == ShaderStage::Vertex ? StateCache::VSConstantBuffer : StateCache::PSConstantBuffer) + slot;
+	}
+
+	uint32_t ShaderResourceSlot(ShaderStage stage, uint32_t slot)
+	{
+		return (stage == ShaderStage::Vertex ? StateCache::VSShaderResource : StateCache::PSShaderResource) + slot;
+	}
+}
+
+void NullBackend::Execute(const CommandList& list)
+{
+	size_t index = 0;
+	for (auto& command : list)
+	{
+		auto type = command.GetType();
+		if (type >= CommandType::Count)
+		{
+			// Nothing after this can be trusted to be where the header says
+			Error(index, "unknown command");
+			return;
+		}
+
+		++m_Stats.commands[(size_t) type];
+
+		switch (type)
+		{
+		case CommandType::BindVertexBuffer:
+			m_VertexBuffer = command.Get<Commands::BindVertexBuffer>().buffer;
+			Bind(StateCache::VertexBuffer, m_VertexBuffer);
+			break;
+		case CommandType::BindIndexBuffer:
+			m_IndexBuffer = command.Get<Commands::BindIndexBuffer>().buffer;
+			Bind(StateCache::IndexBuffer, m_IndexBuffer);
+			break;
+		case CommandType::BindInstanceBuffer:
+			Bind(StateCache::InstanceBuffer, command.Get<Commands::BindInstanceBuffer>().buffer);
+			break;
+		case CommandType::BindVertexShader:
+			m_VertexShader = command.Get<Commands::BindVertexShader>().shader;
+			Bind(StateCache::VertexShader, m_VertexShader);
+			break;
+		case CommandType::BindPixelShader:
+			m_PixelShader = command.Get<Commands::BindPixelShader>().shader;
+			Bind(StateCache::PixelShader, m_PixelShader);
+			break;
+		case CommandType::BindConstantBuffer:
+		{
+			auto& bind = command.Get<Commands::BindConstantBuffer>();
+			if (bind.slot >= ConstantBufferSlots)
+				Error(index, "constant buffer slot out of range");
+			else
+				Bind(ConstantBufferSlot(bind.stage, bind.slot), bind.buffer);
+			break;
+		}
+		case CommandType::BindConstantRecord:
+		{
+			auto& bind = command.Get<Commands::BindConstantRecord>();
+			if (bind.buffer == nullptr)
+				Error(index, "constant record without a buffer");
+			else if (bind.slot >= ConstantBufferSlots)
+				Error(index, "constant buffer slot out of range");
+			else
+				Bind(ConstantBufferSlot(bind.stage, bind.slot), bind.buffer, bind.record);
+			break;
+		}
+		case CommandType::BindStructuredBuffer:
+		{
+			auto& bind = command.Get<Commands::BindStructuredBuffer>();
+			if (bind.slot >= ShaderResourceSlots)
+				Error(index, "shader resource slot out of range");
+			else
+				Bind(ShaderResourceSlot(bind.stage, bind.slot), bind.buffer);
+			break;
+		}
+		case CommandType::BindRenderTarget:
+		{
+			auto& bind = command.Get<Commands::BindRenderTarget>();
+			if (bind.target == nullptr) Error(index, "render target bind without a render target");
+
+			m_RenderTarget = bind.target;
+			Bind(StateCache::RenderTarget, bind.target);
+			Bind(StateCache::DepthStencil, bind.depth);
+			break;
+		}
+		case CommandType::WriteBuffer:
+		{
+			auto& write = command.Get<Commands::WriteBuffer>();
+			if (write.buffer == nullptr)
+				Error(index, "write without a buffer");
+			else if (write.size == 0)
+				Error(index, "empty write");
+			else if (write.target > WriteTarget::IndexBuffer)
+				Error(index, "unknown write target");
+
+			m_Stats.bytesWritten += write.size;
+			break;
+		}
+		case CommandType::DrawIndexedInstanced:
+		{
+			auto& draw = command.Get<Commands::DrawIndexedInstanced>();
+			if (m_VertexBuffer == nullptr || m_IndexBuffer == nullptr)
+				Error(index, "draw without vertex and index buffers");
+			else if (m_VertexShader == nullptr || m_PixelShader == nullptr)
+				Error(index, "draw without shaders");
+			else if (m_RenderTarget == nullptr)
+				Error(index, "draw without a render target");
+			else if (draw.indexCount == 0 || draw.instanceCount == 0)
+				Error(index, "empty draw");
+
+			++m_Stats.draws;
+			m_Stats.instances += draw.instanceCount;
+			m_Stats.indices += uint64_t(draw.indexCount) * draw.instanceCount;
+			break;
+		}
+		case CommandType::ClearRenderTarget:
+			if (command.Get<Commands::ClearRenderTarget>().target == nullptr) Error(index, "clear without a render target");
+			break;
+		case CommandType::ClearDepth:
+			if (command.Get<Commands::ClearDepth>().target == nullptr) Error(index, "clear without a depth target");
+			break;
+		case CommandType::BeginScope:
+			if (command.Get<Commands::BeginScope>().name == nullptr) Error(index, "scope without a name");
+			m_Stats.maxScopeDepth = std::max(m_Stats.maxScopeDepth, ++m_ScopeDepth);
+			break;
+		case CommandType::EndScope:
+			if (m_ScopeDepth == 0)
+				Error(index, "end of a scope that was never begun");
+			else
+				--m_ScopeDepth;
+			break;
+		default:
+			break;
+		}
+
+		++index;
+	}
+
+	// Every list has to close what it opens, the next one may go to another backend
+	if (m_ScopeDepth > 0)
+	{
+		Error(index, "scope left open");
+		m_ScopeDepth = 0;
+	}
+}
+
+void NullBackend::Reset()
+{
+	m_Stats = {};
+	m_Errors.clear();
+	m_StateCache.Invalidate();
+	m_StateCache.ResetCounters();
+	m_VertexBuffer = m_IndexBuffer = m_VertexShader = m_PixelShader = m_RenderTarget = nullptr;
+	m_ScopeDepth = 0;
+}
+
+void NullBackend::Error(size_t command, const char* message)
+{
+	m_Errors.push_back("Command " + std::to_string(command) + ": " + message);
+}
+
+void NullBackend::Bind(uint32_t slot, const void* object, uint32_t offset)
+{
+	if (m_StateCache.Bind(slot, object, offset))
+		++m_Stats.stateChanges;
+	else
+		++m_Stats.redundantStates;
+}
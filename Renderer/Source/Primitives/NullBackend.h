@@ -0,0 +1,50 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include "CommandList.h"
+#include "StateCache.h"
+
+struct NullBackendStats
+{
+	unsigned int commands[(size_t) CommandType::Count] = {};
+	unsigned int draws = 0;
+	uint64_t instances = 0;
+	uint64_t indices = 0;
+	uint64_t bytesWritten = 0;
+	// Binds that would have reached the device and ones the state cache would have dropped
+	unsigned int stateChanges = 0;
+	unsigned int redundantStates = 0;
+	// Deepest scopes were nested
+	unsigned int maxScopeDepth = 0;
+};
+
+// Runs command lists without a device: checks every command is valid where it is, and counts what would have happened.
+// Lets frame logic be tested and benchmarked without a device.
+class NullBackend : public CommandBackend
+{
+public:
+	void Execute(const CommandList& list) override;
+
+	// Forgets the stats, the errors and everything bound
+	void Reset();
+
+	const NullBackendStats& GetStats() const { return m_Stats; }
+	// One message per invalid command, numbered by its position in the list. Scopes left open by a list are reported after its last command
+	const std::vector<std::string>& GetErrors() const { return m_Errors; }
+
+private:
+	void Error(size_t command, const char* message);
+	void Bind(uint32_t slot, const void* object, uint32_t offset = 0);
+
+	NullBackendStats m_Stats;
+	std::vector<std::string> m_Errors;
+
+	StateCache m_StateCache;
+	const void* m_VertexBuffer = nullptr;
+	const void* m_IndexBuffer = nullptr;
+	const void* m_VertexShader = nullptr;
+	const void* m_PixelShader = nullptr;
+	const void* m_RenderTarget = nullptr;
+	unsigned int m_ScopeDepth = 0;
+};
@@ -0,0 +1,82 @@
+#include <cassert>
+
+#include "OffsetAllocator.h"
+
+OffsetAllocator::OffsetAllocator(uint32_t size)
+	: m_Size(size), m_FreeSize(size)
+{
+	if (size > 0) Insert(0, size);
+}
+
+uint32_t OffsetAllocator::Allocate(uint32_t size)
+{
+	if (size == 0) return 0;
+
+	auto best = m_BySize.lower_bound(size);
+	if (best == m_BySize.end()) return Invalid;
+
+	uint32_t offset = best->second;
+	uint32_t rangeSize = best->first;
+	Erase(m_ByOffset.find(offset));
+
+	// Whatever is left over stays free
+	if (rangeSize > size) Insert(offset + size, rangeSize - size);
+
+	m_FreeSize -= size;
+	return offset;
+}
+
+void OffsetAllocator::Free(uint32_t offset, uint32_t size)
+{
+	if (size == 0) return;
+	assert(offset + size <= m_Size);
+
+	m_FreeSize += size;
+
+	auto next = m_ByOffset.lower_bound(offset);
+	assert(next == m_ByOffset.end() || next->first >= offset + size);
+
+	if (next != m_ByOffset.end() && next->first == offset + size)
+	{
+		size += next->second;
+		next = std::next(next);
+		Erase(std::prev(next));
+	}
+
+	if (next != m_ByOffset.begin())
+	{
+		auto previous = std::prev(next);
+		assert(previous->first + previous->second <= offset);
+
+		if (previous->first + previous->second == offset)
+		{
+			offset = previous->first;
+			size += previous->second;
+			Erase(previous);
+		}
+	}
+
+	Insert(offset, size);
+}
+
+void OffsetAllocator::Insert(uint32_t offset, uint32_t size)
+{
+	m_ByOffset.emplace(offset, size);
+	m_BySize.emplace(size, offset);
+}
+
+void OffsetAllocator::Erase(std::map<uint32_t, uint32_t>::iterator range)
+{
+	// Several free ranges can have the same size, find the one at this offset
+	auto sized = m_BySize.equal_range(range->second);
+	for (auto it = sized.first; it != sized.second; ++it)
+	{
+		if (it->second == range->first)
+		{
+			m_BySize.erase(it);
+			break;
+		}
+	}
+
+	m_ByOffset.erase(range);
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <cstdint>
+#include <map>
+
+// Hands out ranges of a fixed size space, e.g. elements of a buffer, without touching the memory itself.
+// Allocation picks the smallest free range that fits, freeing merges the range with its free neighbours.
+class OffsetAllocator
+{
+public:
+	static constexpr uint32_t Invalid = ~0u;
+
+	OffsetAllocator() = default;
+	OffsetAllocator(uint32_t size);
+
+	// Returns the offset of the range, or Invalid if no free range is large enough. Empty ranges are always at 0
+	uint32_t Allocate(uint32_t size);
+	void Free(uint32_t offset, uint32_t size);
+
+	uint32_t GetSize() const { return m_Size; }
+	uint32_t GetFreeSize() const { return m_FreeSize; }
+	// Largest single allocation that would currently succeed
+	uint32_t GetLargestFree() const { return m_BySize.empty() ? 0 : m_BySize.rbegin()->first; }
+
+private:
+	void Insert(uint32_t offset, uint32_t size);
+	void Erase(std::map<uint32_t, uint32_t>::iterator range);
+
+	uint32_t m_Size = 0;
+	uint32_t m_FreeSize = 0;
+
+	// Free ranges, by offset for merging and by size for the best fit search
+	std::map<uint32_t, uint32_t> m_ByOffset;
+	std::multimap<uint32_t, uint32_t> m_BySize;
+};
@@ -0,0 +1,318 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+
+#include "Profiler.h"
+
+namespace
+{
+	// An event in a ring. The collecting thread can read a slot while it is being overwritten, the fields are atomic so that
+	// is only ever a torn event it throws away, never undefined behavior. Relaxed loads and stores are plain moves anyway
+	struct Slot
+	{
+		std::atomic<const char*> name;
+		std::atomic<uint64_t> begin;
+		std::atomic<uint64_t> end;
+		std::atomic<uint32_t> depth;
+	};
+
+	struct Track
+	{
+		// Only touched with g_Mutex held
+		std::string name;
+
+		// Written by the track's thread alone, which only ever publishes finished events by moving written forward.
+		// collected is how far EndFrame() has read
+		Slot events[Profiler::RingSize];
+		std::atomic<uint64_t> written{ 0 };
+		uint64_t collected = 0;
+
+		// Scopes the track's thread has open
+		const char* openNames[Profiler::MaxDepth];
+		uint64_t openBegins[Profiler::MaxDepth];
+		uint32_t depth = 0;
+	};
+
+	// Tracks are never freed, a thread that exits leaves its events to be collected and its track to the timeline.
+	// They are only added with g_Mutex held, and published by moving g_TrackCount past them, so finding one takes no lock
+	std::mutex g_Mutex;
+	std::unique_ptr<Track> g_Tracks[Profiler::MaxTracks];
+	std::atomic<uint32_t> g_TrackCount{ 0 };
+	thread_local Track* t_Track = nullptr;
+	thread_local bool t_Untracked = false;
+
+	std::deque<ProfileFrame> g_Frames;
+	uint64_t g_FrameBegin = Profiler::Now();
+	uint64_t g_DroppedEvents = 0;
+	bool g_Paused = false;
+
+	// Returns the index of the new track, or MaxTracks if there is no room for another
+	uint32_t AddTrack(const char* name)
+	{
+		std::lock_guard<std::mutex> lock(g_Mutex);
+		uint32_t index = g_TrackCount.load(std::memory_order_relaxed);
+		if (index == Profiler::MaxTracks) return index;
+
+		g_Tracks[index] = std::make_unique<Track>();
+		g_Tracks[index]->name = name ? name : "Thread " + std::to_string(index);
+		g_TrackCount.store(index + 1, std::memory_order_release);
+		return index;
+	}
+
+	// Null for threads that came after every track was taken, their scopes aren't recorded
+	Track* GetThreadTrack()
+	{
+		if (t_Track == nullptr && !t_Untracked)
+		{
+			uint32_t index = AddTrack(nullptr);
+			if (index < Profiler::MaxTracks) t_Track = g_Tracks[index].get();
+			else t_Untracked = true;
+		}
+
+		return t_Track;
+	}
+
+	void Push(Track& track, const char* name, uint64_t begin, uint64_t end, uint32_t depth)
+	{
+		uint64_t index = track.written.load(std::memory_order_relaxed);
+		Slot& slot = track.events[index % Profiler::RingSize];
+		slot.name.store(name, std::memory_order_relaxed);
+		slot.begin.store(begin, std::memory_order_relaxed);
+		slot.end.store(end, std::memory_order_relaxed);
+		slot.depth.store(depth, std::memory_order_relaxed);
+		track.written.store(index + 1, std::memory_order_release);
+	}
+
+	// Copies whatever the track finished since the last collection, leaving out anything its thread may have been overwriting meanwhile
+	void Collect(Track& track, uint32_t index, std::vector<ProfileEvent>& events)
+	{
+		// The slot after the last published event may be getting written right now, and it belongs to the oldest event in the ring.
+		// So only the newest RingSize - 1 events can be read
+		auto readable = [](uint64_t written) { return written >= Profiler::RingSize ? written - Profiler::RingSize + 1 : 0; };
+
+		uint64_t written = track.written.load(std::memory_order_acquire);
+		uint64_t first = std::max(track.collected, readable(written));
+
+		size_t start = events.size();
+		for (uint64_t i = first; i < written; i++)
+		{
+			Slot& slot = track.events[i % Profiler::RingSize];
+			events.push_back({ slot.name.load(std::memory_order_relaxed), slot.begin.load(std::memory_order_relaxed),
+				slot.end.load(std::memory_order_relaxed), slot.depth.load(std::memory_order_relaxed), index });
+		}
+
+		// Anything the thread got around to overwriting while we copied is thrown away
+		std::atomic_thread_fence(std::memory_order_acquire);
+		uint64_t safe = readable(track.written.load(std::memory_order_relaxed));
+		if (safe > first)
+		{
+			size_t torn = (size_t) std::min(safe - first, written - first);
+			events.erase(events.begin() + start, events.begin() + start + torn);
+			first += torn;
+		}
+
+		g_DroppedEvents += first - track.collected;
+		track.collected = written;
+	}
+
+	void AppendEscaped(std::string& out, const char* text)
+	{
+		for (; *text; text++)
+		{
+			char c = *text;
+			if (c == '"' || c == '\\')
+			{
+				out += '\\';
+				out += c;
+			}
+			else if ((unsigned char) c < 0x20)
+			{
+				char escaped[8];
+				snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+				out += escaped;
+			}
+			else
+			{
+				out += c;
+			}
+		}
+	}
+
+	// Chrome wants microseconds
+	void AppendTime(std::string& out, uint64_t nanoseconds)
+	{
+		char time[32];
+		snprintf(time, sizeof(time), "%llu.%03llu", (unsigned long long) (nanoseconds / 1000), (unsigned long long) (nanoseconds % 1000));
+		out += time;
+	}
+}
+
+uint64_t Profiler::Now()
+{
+	return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Profiler::Begin(const char* name)
+{
+	Track* track = GetThreadTrack();
+	if (track == nullptr) return;
+
+	if (track->depth < MaxDepth)
+	{
+		track->openNames[track->depth] = name;
+		track->openBegins[track->depth] = Now();
+	}
+	++track->depth;
+}
+
+void Profiler::End()
+{
+	Track* track = GetThreadTrack();
+	if (track == nullptr || track->depth == 0) return;
+
+	uint32_t depth = --track->depth;
+	if (depth < MaxDepth) Push(*track, track->openNames[depth], track->openBegins[depth], Now(), depth);
+}
+
+void Profiler::SetThreadName(const char* name)
+{
+	Track* track = GetThreadTrack();
+	if (track == nullptr) return;
+
+	std::lock_guard<std::mutex> lock(g_Mutex);
+	track->name = name;
+}
+
+uint32_t Profiler::CreateTrack(const char* name)
+{
+	return AddTrack(name);
+}
+
+void Profiler::Record(uint32_t track, const char* name, uint64_t begin, uint64_t end, uint32_t depth)
+{
+	if (track >= g_TrackCount.load(std::memory_order_acquire)) return;
+	Push(*g_Tracks[track], name, begin, end, depth);
+}
+
+void Profiler::EndFrame()
+{
+	ProfileFrame frame;
+	frame.begin = g_FrameBegin;
+	frame.end = Now();
+	g_FrameBegin = frame.end;
+
+	uint32_t trackCount = g_TrackCount.load(std::memory_order_acquire);
+	for (uint32_t track = 0; track < trackCount; track++) Collect(*g_Tracks[track], track, frame.events);
+
+	if (g_Paused) return;
+
+	// Children finish before their parents, sorting puts them back under them
+	std::sort(frame.events.begin(), frame.events.end(), [](const ProfileEvent& a, const ProfileEvent& b)
+	{
+		if (a.track != b.track) return a.track < b.track;
+		if (a.begin != b.begin) return a.begin < b.begin;
+		return a.depth < b.depth;
+	});
+
+	g_Frames.push_back(std::move(frame));
+	if (g_Frames.size() > HistorySize) g_Frames.pop_front();
+}
+
+void Profiler::SetPaused(bool paused)
+{
+	g_Paused = paused;
+}
+
+bool Profiler::IsPaused()
+{
+	return g_Paused;
+}
+
+const std::deque<ProfileFrame>& Profiler::GetFrames()
+{
+	return g_Frames;
+}
+
+uint32_t Profiler::GetTrackCount()
+{
+	return g_TrackCount.load(std::memory_order_acquire);
+}
+
+std::string Profiler::GetTrackName(uint32_t track)
+{
+	if (track >= GetTrackCount()) return std::string();
+
+	std::lock_guard<std::mutex> lock(g_Mutex);
+	return g_Tracks[track]->name;
+}
+
+uint64_t Profiler::GetDroppedEvents()
+{
+	return g_DroppedEvents;
+}
+
+std::string Profiler::GetChromeTrace()
+{
+	std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool first = true;
+	auto separate = [&]()
+	{
+		if (!first) out += ",\n";
+		first = false;
+	};
+
+	// Times start from the oldest frame kept, rather than from whenever the clock started
+	uint64_t origin = g_Frames.empty() ? 0 : g_Frames.front().begin;
+	for (auto& frame : g_Frames)
+	{
+		for (auto& event : frame.events) origin = std::min(origin, event.begin);
+	}
+
+	uint32_t trackCount = GetTrackCount();
+	for (uint32_t track = 0; track < trackCount; track++)
+	{
+		separate();
+		out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" + std::to_string(track) + ",\"args\":{\"name\":\"";
+		AppendEscaped(out, GetTrackName(track).c_str());
+		out += "\"}},\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":0,\"tid\":" + std::to_string(track) +
+			",\"args\":{\"sort_index\":" + std::to_string(track) + "}}";
+	}
+
+	for (auto& frame : g_Frames)
+	{
+		for (auto& event : frame.events)
+		{
+			separate();
+			out += "{\"name\":\"";
+			AppendEscaped(out, event.name);
+			out += "\",\"ph\":\"X\",\"pid\":0,\"tid\":" + std::to_string(event.track) + ",\"ts\":";
+			AppendTime(out, event.begin - origin);
+			out += ",\"dur\":";
+			AppendTime(out, event.end > event.begin ? event.end - event.begin : 0);
+			out += "}";
+		}
+
+		// Frame boundaries, drawn across every track
+		separate();
+		out += "{\"name\":\"Frame\",\"ph\":\"i\",\"s\":\"g\",\"pid\":0,\"tid\":0,\"ts\":";
+		AppendTime(out, frame.end - origin);
+		out += "}";
+	}
+
+	out += "]}\n";
+	return out;
+}
+
+bool Profiler::ExportChromeTrace(const std::string& file)
+{
+	std::string trace = GetChromeTrace();
+
+	FILE* output = fopen(file.c_str(), "wb");
+	if (output == nullptr) return false;
+
+	bool written = fwrite(trace.data(), 1, trace.size(), output) == trace.size();
+	return fclose(output) == 0 && written;
+}
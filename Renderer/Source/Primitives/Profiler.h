@@ -0,0 +1,87 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+// A finished scope on one track of the timeline. Times are in nanoseconds of Profiler::Now()
+struct ProfileEvent
+{
+	// Never copied, so it has to outlive the profiler, like a string literal
+	const char* name;
+	uint64_t begin;
+	uint64_t end;
+	// How many scopes of the same track were open around it
+	uint32_t depth;
+	uint32_t track;
+};
+
+// Every event that finished between two calls to Profiler::EndFrame(), ordered by track and then by when they began
+struct ProfileFrame
+{
+	uint64_t begin = 0;
+	uint64_t end = 0;
+	std::vector<ProfileEvent> events;
+};
+
+// Hierarchical timing of everything the application does, for the timeline window and for Chrome's trace viewer.
+// Every thread that opens a scope gets a track of its own and writes its events into a ring on that track without taking any lock,
+// once a frame the main thread collects whatever finished into a rolling history. Rings that fill up faster than they are
+// collected lose their oldest events, which are counted rather than torn.
+class Profiler
+{
+public:
+	static constexpr size_t RingSize = 4096;
+	static constexpr size_t HistorySize = 120;
+	// Scopes nested deeper than this still balance, they just aren't recorded
+	static constexpr uint32_t MaxDepth = 32;
+	// Threads and tracks past this many aren't recorded
+	static constexpr uint32_t MaxTracks = 256;
+
+	// Nanoseconds on a steady clock, shared by every track
+	static uint64_t Now();
+
+	// Opens and closes a scope on the calling thread's track, End() closes the last one opened
+	static void Begin(const char* name);
+	static void End();
+
+	// Names the calling thread's track, tracks of threads that never name themselves are numbered
+	static void SetThreadName(const char* name);
+
+	// Tracks fed with events timed somewhere else, like the GPU. Each one must only be recorded to from one thread at a time,
+	// recording takes no lock. Returns MaxTracks if there's no room left, which Record() ignores
+	static uint32_t CreateTrack(const char* name);
+	static void Record(uint32_t track, const char* name, uint64_t begin, uint64_t end, uint32_t depth);
+
+	// Collects every event finished since the last call into a new frame, dropping the oldest frame once the history is full.
+	// Only one thread may call this, along with everything below. While paused events are still collected, just not kept
+	static void EndFrame();
+	static void SetPaused(bool paused);
+	static bool IsPaused();
+
+	static const std::deque<ProfileFrame>& GetFrames();
+	static uint32_t GetTrackCount();
+	static std::string GetTrackName(uint32_t track);
+	// Events lost to rings that wrapped before they were collected
+	static uint64_t GetDroppedEvents();
+
+	// The whole history as Chrome trace event JSON, for chrome://tracing or Perfetto
+	static std::string GetChromeTrace();
+	static bool ExportChromeTrace(const std::string& file);
+};
+
+// Times the scope it lives in
+class ProfileScope
+{
+public:
+	ProfileScope(const char* name) { Profiler::Begin(name); }
+	~ProfileScope() { Profiler::End(); }
+
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator =(const ProfileScope&) = delete;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
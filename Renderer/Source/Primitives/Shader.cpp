@@ -1,6 +1,8 @@
 #include "Shader.h"
 #include "GraphicsContext.h"
 #include <d3dcompiler.h>
+#include <functional>
+#include <string_view>
 
 #pragma comment(lib, "d3dcompiler.lib")
 
@@ -13,6 +15,8 @@ VertexShader::VertexShader(std::wstring compiledPath)
 		__debugbreak();
 	}
 
+	HashBlob();
+
 	hr = GraphicsContext::Device->CreateVertexShader(p_Blob->GetBufferPointer(), p_Blob->GetBufferSize(), NULL, &p_Shader);
 
 	if (FAILED(hr))
@@ -61,6 +65,7 @@ VertexShader* VertexShader::Compile(std::wstring sourcePath, std::vector<ShaderD
 	auto vShader = new VertexShader();
 	vShader->p_Blob = codeBlob;
 	vShader->p_Shader = shader;
+	vShader->HashBlob();
 
 	return vShader;
 }
@@ -75,6 +80,12 @@ void VertexShader::Unbind()
 	GraphicsContext::BindVertexShader(nullptr);
 }
 
+void VertexShader::HashBlob()
+{
+	if (!p_Blob) return;
+	m_BlobHash = std::hash<std::string_view>()(std::string_view((const char*) p_Blob->GetBufferPointer(), p_Blob->GetBufferSize()));
+}
+
 PixelShader::PixelShader(std::wstring compiledPath)
 {
 	HRESULT hr = D3DReadFileToBlob(compiledPath.c_str(), &p_Blob);
@@ -138,10 +149,10 @@ PixelShader* PixelShader::Compile(std::wstring sourcePath, std::vector<ShaderDef
 
 void PixelShader::Bind()
 {
-	GraphicsContext::Context->PSSetShader(p_Shader.Get(), NULL, 0);
+	GraphicsContext::BindPixelShader(this);
 }
 
 void PixelShader::Unbind()
 {
-	GraphicsContext::Context->PSSetShader(NULL, NULL, 0);
+	GraphicsContext::BindPixelShader(nullptr);
 }
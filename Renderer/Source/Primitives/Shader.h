@@ -24,10 +24,15 @@ public:
 
 	ID3D11VertexShader* GetShader() const { return p_Shader.Get(); }
 	ID3DBlob* GetBlob() const { return p_Blob.Get(); }
+	// Hash of the bytecode, shaders with the same input signature can share input layouts
+	size_t GetBlobHash() const { return m_BlobHash; }
 
 private:
+	void HashBlob();
+
 	Microsoft::WRL::ComPtr<ID3D11VertexShader> p_Shader;
 	Microsoft::WRL::ComPtr<ID3DBlob> p_Blob;
+	size_t m_BlobHash = 0;
 };
 
 class PixelShader
@@ -42,6 +47,8 @@ public:
 	void Bind();
 	void Unbind();
 
+	ID3D11PixelShader* GetShader() const { return p_Shader.Get(); }
+
 private:
 	Microsoft::WRL::ComPtr<ID3D11PixelShader> p_Shader;
 	Microsoft::WRL::ComPtr<ID3DBlob> p_Blob;
@@ -0,0 +1,22 @@
+#include "StateCache.h"
+
+bool StateCache::Bind(uint32_t slot, const void* object, uint32_t offset)
+{
+	auto& binding = m_Bindings[slot];
+	if (binding.valid && binding.object == object && binding.offset == offset)
+	{
+		++m_Skipped;
+		return false;
+	}
+
+	binding.object = object;
+	binding.offset = offset;
+	binding.valid = true;
+	++m_Changes;
+	return true;
+}
+
+void StateCache::Invalidate()
+{
+	for (auto& binding : m_Bindings) binding.valid = false;
+}
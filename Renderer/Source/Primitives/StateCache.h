@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+
+// Remembers what is bound to every pipeline slot, so binds that wouldn't change anything can be dropped
+// before they reach the device. Only deals in opaque pointers, so it doesn't depend on any graphics API.
+class StateCache
+{
+public:
+	enum Slot : uint32_t
+	{
+		VertexShader,
+		PixelShader,
+		VertexBuffer,
+		IndexBuffer,
+		InstanceBuffer,
+		InputLayout,
+		RenderTarget,
+		DepthStencil,
+		// Followed by one slot per constant buffer register
+		VSConstantBuffer,
+		PSConstantBuffer = VSConstantBuffer + 14,
+		// And one per shader resource register that is used
+		VSShaderResource = PSConstantBuffer + 14,
+		PSShaderResource = VSShaderResource + 8,
+		SlotCount = PSShaderResource + 8
+	};
+
+	// Returns whether binding object (at offset, for ranges) to the slot changes anything, and records it if so
+	bool Bind(uint32_t slot, const void* object, uint32_t offset = 0);
+
+	// Forgets everything, for when something else may have touched the pipeline behind our back
+	void Invalidate();
+
+	void ResetCounters() { m_Changes = 0; m_Skipped = 0; }
+	unsigned int GetChanges() const { return m_Changes; }
+	unsigned int GetSkipped() const { return m_Skipped; }
+
+private:
+	struct Binding
+	{
+		const void* object;
+		uint32_t offset;
+		bool valid;
+	};
+
+	Binding m_Bindings[SlotCount] = {};
+	unsigned int m_Changes = 0;
+	unsigned int m_Skipped = 0;
+};
@@ -0,0 +1,106 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+enum class ElementDataType
+{
+	float1, float2, float3, float4,
+	// Packed types, the input assembler expands them to floats so shaders read them like the ones above
+	half2, half4,
+	snorm16x2,
+	unorm16x2,
+	unorm8x4
+};
+
+// Mixes value into seed, for building hashes out of several parts
+inline size_t HashCombine(size_t seed, size_t value)
+{
+	return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+}
+
+struct VertexElement
+{
+	std::string semantic;
+	ElementDataType type;
+	unsigned int index = 0;
+	// Advances once per instance instead of once per vertex, the buffer holding it is bound with GraphicsContext::BindInstanceBuffer
+	bool perInstance = false;
+
+	bool operator==(const VertexElement& other) const
+	{
+		return semantic == other.semantic && type == other.type && index == other.index && perInstance == other.perInstance;
+	}
+
+	bool operator!=(const VertexElement& other) const
+	{
+		return !(*this == other);
+	}
+
+	unsigned int GetSize() const
+	{
+		switch (type)
+		{
+		case ElementDataType::float1: return (unsigned int) sizeof(float);
+		case ElementDataType::float2: return (unsigned int) sizeof(float) * 2;
+		case ElementDataType::float3: return (unsigned int) sizeof(float) * 3;
+		case ElementDataType::float4: return (unsigned int) sizeof(float) * 4;
+		case ElementDataType::half2: return (unsigned int) sizeof(uint16_t) * 2;
+		case ElementDataType::half4: return (unsigned int) sizeof(uint16_t) * 4;
+		case ElementDataType::snorm16x2: return (unsigned int) sizeof(int16_t) * 2;
+		case ElementDataType::unorm16x2: return (unsigned int) sizeof(uint16_t) * 2;
+		case ElementDataType::unorm8x4: return (unsigned int) sizeof(uint8_t) * 4;
+		}
+
+		return 0;
+	}
+};
+
+// Describes the elements of a vertex, without depending on any graphics API
+struct VertexLayout
+{
+	VertexLayout(std::initializer_list<VertexElement> list)
+		: VertexLayout(std::vector<VertexElement>(list))
+	{
+	}
+
+	VertexLayout(std::vector<VertexElement> list)
+		: elements(std::move(list))
+	{
+		for (auto& element : elements)
+		{
+			stride += element.GetSize();
+
+			hash = HashCombine(hash, std::hash<std::string_view>()(element.semantic));
+			hash = HashCombine(hash, ((size_t) element.type << 1 | (size_t) element.perInstance) << 32 | element.index);
+		}
+	}
+
+	// The hash rules out nearly every mismatch cheaply, the elements settle the rare collision
+	bool operator==(const VertexLayout& other) const
+	{
+		return hash == other.hash && stride == other.stride && elements == other.elements;
+	}
+
+	bool operator!=(const VertexLayout& other) const
+	{
+		return !(*this == other);
+	}
+
+	std::vector<VertexElement> elements;
+	unsigned int stride = 0;
+	size_t hash = 0;
+};
+
+// For keying containers on layouts, reuses the hash the layout already carries
+struct VertexLayoutHasher
+{
+	size_t operator()(const VertexLayout& layout) const
+	{
+		return layout.hash;
+	}
+};
@@ -0,0 +1,196 @@
+// The widest path the compiler targets is picked, CULLING_NO_SIMD forces the scalar one, e.g. to test it on x86
+#if defined(CULLING_NO_SIMD)
+#elif defined(__AVX__)
+#include <immintrin.h>
+#define CULLING_AVX
+#elif defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define CULLING_SSE
+#endif
+
+#include <cmath>
+
+#include "Culling.h"
+
+Frustum ExtractFrustum(const TransformMatrix& viewProjection)
+{
+	// Gribb-Hartmann: every plane is a sum or difference of the clip space w column and another column
+	const auto& m = viewProjection.m;
+	Frustum frustum;
+	for (int i = 0; i < 4; i++)
+	{
+		frustum.planes[0][i] = m[i][3] + m[i][0];
+		frustum.planes[1][i] = m[i][3] - m[i][0];
+		frustum.planes[2][i] = m[i][3] + m[i][1];
+		frustum.planes[3][i] = m[i][3] - m[i][1];
+		frustum.planes[4][i] = m[i][2];
+		frustum.planes[5][i] = m[i][3] - m[i][2];
+	}
+
+	return frustum;
+}
+
+#if defined(CULLING_AVX) || defined(CULLING_SSE)
+namespace
+{
+	// Appends the indices of the set bits of mask, starting at base
+	size_t AppendVisible(unsigned int mask, size_t base, uint32_t* visible)
+	{
+		size_t written = 0;
+		while (mask)
+		{
+			unsigned int bit = 0;
+			while (!(mask & (1u << bit))) bit++;
+
+			visible[written++] = (uint32_t) (base + bit);
+			mask &= mask - 1;
+		}
+
+		return written;
+	}
+}
+#endif
+
+size_t CullBounds(const Frustum& frustum, const WorldBounds& bounds, size_t count, uint32_t* visible)
+{
+	// A box is outside a plane if its center is further behind it than the box reaches along the plane normal:
+	// dot(n, c) + d + dot(|n|, e) < 0
+	size_t visibleCount = 0;
+
+#if defined(CULLING_AVX)
+	constexpr size_t Width = 8;
+	__m256 normal[6][3], absNormal[6][3], offset[6];
+	for (int plane = 0; plane < 6; plane++)
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			normal[plane][i] = _mm256_set1_ps(frustum.planes[plane][i]);
+			absNormal[plane][i] = _mm256_set1_ps(std::fabs(frustum.planes[plane][i]));
+		}
+		offset[plane] = _mm256_set1_ps(frustum.planes[plane][3]);
+	}
+
+	for (size_t group = 0; group < count; group += Width)
+	{
+		__m256 center[3], extent[3];
+		for (int i = 0; i < 3; i++)
+		{
+			center[i] = _mm256_loadu_ps(bounds.center[i] + group);
+			extent[i] = _mm256_loadu_ps(bounds.extent[i] + group);
+		}
+
+		__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+		for (int plane = 0; plane < 6; plane++)
+		{
+			__m256 distance = offset[plane];
+			for (int i = 0; i < 3; i++)
+			{
+				distance = _mm256_add_ps(distance, _mm256_mul_ps(center[i], normal[plane][i]));
+				distance = _mm256_add_ps(distance, _mm256_mul_ps(extent[i], absNormal[plane][i]));
+			}
+			inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_GE_OQ));
+		}
+
+		unsigned int mask = (unsigned int) _mm256_movemask_ps(inside);
+		if (count - group < Width) mask &= (1u << (count - group)) - 1;
+		visibleCount += AppendVisible(mask, group, visible + visibleCount);
+	}
+#elif defined(CULLING_SSE)
+	constexpr size_t Width = 4;
+	__m128 normal[6][3], absNormal[6][3], offset[6];
+	for (int plane = 0; plane < 6; plane++)
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			normal[plane][i] = _mm_set1_ps(frustum.planes[plane][i]);
+			absNormal[plane][i] = _mm_set1_ps(std::fabs(frustum.planes[plane][i]));
+		}
+		offset[plane] = _mm_set1_ps(frustum.planes[plane][3]);
+	}
+
+	for (size_t group = 0; group < count; group += Width)
+	{
+		__m128 center[3], extent[3];
+		for (int i = 0; i < 3; i++)
+		{
+			center[i] = _mm_loadu_ps(bounds.center[i] + group);
+			extent[i] = _mm_loadu_ps(bounds.extent[i] + group);
+		}
+
+		__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		for (int plane = 0; plane < 6; plane++)
+		{
+			__m128 distance = offset[plane];
+			for (int i = 0; i < 3; i++)
+			{
+				distance = _mm_add_ps(distance, _mm_mul_ps(center[i], normal[plane][i]));
+				distance = _mm_add_ps(distance, _mm_mul_ps(extent[i], absNormal[plane][i]));
+			}
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, _mm_setzero_ps()));
+		}
+
+		unsigned int mask = (unsigned int) _mm_movemask_ps(inside);
+		if (count - group < Width) mask &= (1u << (count - group)) - 1;
+		visibleCount += AppendVisible(mask, group, visible + visibleCount);
+	}
+#else
+	for (size_t i = 0; i < count; i++)
+	{
+		bool inside = true;
+		for (auto& plane : frustum.planes)
+		{
+			float distance = plane[3];
+			for (int axis = 0; axis < 3; axis++)
+				distance += bounds.center[axis][i] * plane[axis] + bounds.extent[axis][i] * std::fabs(plane[axis]);
+
+			if (distance < 0.f)
+			{
+				inside = false;
+				break;
+			}
+		}
+
+		if (inside) visible[visibleCount++] = (uint32_t) i;
+	}
+#endif
+
+	return visibleCount;
+}
+
+size_t CullMeshlets(const Frustum& frustum, const float camera[3], const Meshlet* meshlets, size_t count, const uint32_t* meshletVertices,
+	const uint8_t* meshletTriangles, std::vector<uint32_t>& indices)
+{
+	// The planes aren't normalized, so the sphere's radius is scaled by the length of each normal instead
+	float planeLength[6];
+	for (int plane = 0; plane < 6; plane++)
+	{
+		auto& p = frustum.planes[plane];
+		planeLength[plane] = std::sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+	}
+
+	size_t kept = 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		auto& meshlet = meshlets[i];
+
+		bool inside = true;
+		for (int plane = 0; plane < 6 && inside; plane++)
+		{
+			auto& p = frustum.planes[plane];
+			inside = p[0] * meshlet.center[0] + p[1] * meshlet.center[1] + p[2] * meshlet.center[2] + p[3] >= -meshlet.radius * planeLength[plane];
+		}
+		if (!inside) continue;
+
+		float view[3] = { meshlet.center[0] - camera[0], meshlet.center[1] - camera[1], meshlet.center[2] - camera[2] };
+		float distance = std::sqrt(view[0] * view[0] + view[1] * view[1] + view[2] * view[2]);
+		if (view[0] * meshlet.coneAxis[0] + view[1] * meshlet.coneAxis[1] + view[2] * meshlet.coneAxis[2] > meshlet.coneCutoff * distance + meshlet.radius)
+			continue;
+
+		const uint32_t* vertices = meshletVertices + meshlet.vertexOffset;
+		const uint8_t* triangles = meshletTriangles + meshlet.triangleOffset;
+		for (uint32_t corner = 0; corner < meshlet.triangleCount * 3; corner++) indices.push_back(vertices[triangles[corner]]);
+		kept++;
+	}
+
+	return kept;
+}
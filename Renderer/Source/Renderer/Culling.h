@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Scene/MeshletBuilder.h"
+#include "Scene/TransformStore.h"
+
+// Frustum planes as (a, b, c, d), a point p is inside a plane if a * p.x + b * p.y + c * p.z + d >= 0
+struct Frustum
+{
+	float planes[6][4];
+};
+
+// Extracts the left, right, bottom, top, near and far planes of a row-major, row-vector view projection matrix
+// with a 0 to 1 depth range, like the ones DirectXMath builds
+Frustum ExtractFrustum(const TransformMatrix& viewProjection);
+
+// Tests the first count boxes against the frustum, eight or four at a time depending on what the CPU supports.
+// The bounds arrays must be padded to a multiple of eight. Writes the indices of the boxes that are at least
+// partially inside to visible, which needs room for count entries, and returns how many there are.
+size_t CullBounds(const Frustum& frustum, const WorldBounds& bounds, size_t count, uint32_t* visible);
+
+// Tests meshlets against a frustum and a camera position, both in the space the meshlets were built in. Meshlets outside the frustum
+// and meshlets facing away from the camera are dropped, the triangles of the rest are appended to indices as indices of the vertices
+// the meshlets were built from. Returns how many meshlets were kept
+size_t CullMeshlets(const Frustum& frustum, const float camera[3], const Meshlet* meshlets, size_t count, const uint32_t* meshletVertices,
+	const uint8_t* meshletTriangles, std::vector<uint32_t>& indices);
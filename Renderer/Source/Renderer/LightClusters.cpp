@@ -0,0 +1,184 @@
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define CLUSTERS_SSE
+#endif
+
+#include <algorithm>
+#include <cmath>
+
+#include "LightClusters.h"
+
+#if defined(CLUSTERS_SSE)
+static_assert(LightClusters::ClustersX % 4 == 0, "Columns are tested four at a time");
+#endif
+
+float GetLightRange(const PointLight& light, float threshold)
+{
+	// intensity / (c + l * x + q * x^2) = threshold with x = d^2, solved for the positive root
+	float c = light.attConstant - light.intensity / threshold;
+	if (c >= 0.f) return 0.f;
+
+	float x;
+	if (light.attQuadratic > 0.f)
+		x = (-light.attLinear + std::sqrt(light.attLinear * light.attLinear - 4.f * light.attQuadratic * c)) / (2.f * light.attQuadratic);
+	else if (light.attLinear > 0.f)
+		x = -c / light.attLinear;
+	else
+		return INFINITY;
+
+	return std::sqrt(x);
+}
+
+void LightClusters::Build(const PointLight* lights, size_t count, const TransformMatrix& view, float projectionX, float projectionY,
+	float nearPlane, float farPlane)
+{
+	if (projectionX != m_ProjectionX || projectionY != m_ProjectionY || nearPlane != m_Near || farPlane != m_Far)
+		UpdateBounds(projectionX, projectionY, nearPlane, farPlane);
+
+	m_HitClusters.clear();
+	m_HitLights.clear();
+
+	const auto& m = view.m;
+	for (size_t i = 0; i < count; i++)
+	{
+		auto& light = lights[i];
+		if (light.range <= 0.f) continue;
+
+		float center[3];
+		for (int column = 0; column < 3; column++)
+			center[column] = light.position[0] * m[0][column] + light.position[1] * m[1][column] + light.position[2] * m[2][column] + m[3][column];
+
+		AddLight((uint32_t) i, center, light.range);
+	}
+
+	// Counting sort of the overlaps by cluster, which leaves every cluster's lights in the order they were given
+	std::fill(m_Clusters.begin(), m_Clusters.end(), 0);
+	for (uint32_t cluster : m_HitClusters) ++m_Clusters[cluster * 2 + 1];
+
+	uint32_t offset = 0;
+	for (unsigned int cluster = 0; cluster < ClusterCount; cluster++)
+	{
+		m_Clusters[cluster * 2] = offset;
+		offset += m_Clusters[cluster * 2 + 1];
+	}
+
+	m_LightIndices.resize(m_HitClusters.size());
+	for (size_t i = 0; i < m_HitClusters.size(); i++)
+	{
+		// The first entries are used as write cursors and are back where they started once every light is placed
+		uint32_t& cursor = m_Clusters[m_HitClusters[i] * 2];
+		m_LightIndices[cursor++] = m_HitLights[i];
+	}
+	for (unsigned int cluster = 0; cluster < ClusterCount; cluster++) m_Clusters[cluster * 2] -= m_Clusters[cluster * 2 + 1];
+}
+
+void LightClusters::UpdateBounds(float projectionX, float projectionY, float nearPlane, float farPlane)
+{
+	m_ProjectionX = projectionX;
+	m_ProjectionY = projectionY;
+	m_Near = nearPlane;
+	m_Far = farPlane;
+
+	float logRange = std::log2(farPlane / nearPlane);
+	m_SliceScale = (float) ClustersZ / logRange;
+	m_SliceBias = -std::log2(nearPlane) * m_SliceScale;
+
+	for (unsigned int z = 0; z <= ClustersZ; z++) m_SliceNear[z] = nearPlane * std::pow(farPlane / nearPlane, (float) z / ClustersZ);
+
+	// Tile edges are lines through the eye, so a cluster is widest at the far end of its slice.
+	// Comparing both ends covers tiles either side of the center
+	for (unsigned int z = 0; z < ClustersZ; z++)
+	{
+		float nearDepth = m_SliceNear[z], farDepth = m_SliceNear[z + 1];
+		for (unsigned int x = 0; x < ClustersX; x++)
+		{
+			float left = (-1.f + 2.f * x / ClustersX) / projectionX;
+			float right = (-1.f + 2.f * (x + 1) / ClustersX) / projectionX;
+			m_ColumnMin[z][x] = std::min(left * nearDepth, left * farDepth);
+			m_ColumnMax[z][x] = std::max(right * nearDepth, right * farDepth);
+		}
+
+		for (unsigned int y = 0; y < ClustersY; y++)
+		{
+			float top = (1.f - 2.f * y / ClustersY) / projectionY;
+			float bottom = (1.f - 2.f * (y + 1) / ClustersY) / projectionY;
+			m_RowMin[z][y] = std::min(bottom * nearDepth, bottom * farDepth);
+			m_RowMax[z][y] = std::max(top * nearDepth, top * farDepth);
+		}
+	}
+}
+
+void LightClusters::AddLight(uint32_t light, const float center[3], float radius)
+{
+	float minDepth = std::max(center[2] - radius, m_Near), maxDepth = std::min(center[2] + radius, m_Far);
+	if (minDepth > maxDepth) return;
+
+	auto slice = [this](float depth)
+	{
+		return (unsigned int) std::min(std::max(std::log2(depth) * m_SliceScale + m_SliceBias, 0.f), (float) ClustersZ - 1);
+	};
+	unsigned int firstSlice = slice(minDepth), lastSlice = slice(maxDepth);
+
+	// Screen rectangle of the sphere's bounding box over the depths it covers. x / z is monotonic in z for a fixed x,
+	// so the extremes are at the nearest and farthest depths
+	float minX = std::min((center[0] - radius) / minDepth, (center[0] - radius) / maxDepth) * m_ProjectionX;
+	float maxX = std::max((center[0] + radius) / minDepth, (center[0] + radius) / maxDepth) * m_ProjectionX;
+	float minY = std::min((center[1] - radius) / minDepth, (center[1] - radius) / maxDepth) * m_ProjectionY;
+	float maxY = std::max((center[1] + radius) / minDepth, (center[1] + radius) / maxDepth) * m_ProjectionY;
+	if (minX > 1.f || maxX < -1.f || minY > 1.f || maxY < -1.f) return;
+
+	auto tile = [](float ndc, unsigned int count)
+	{
+		return (unsigned int) std::min(std::max((ndc + 1.f) * 0.5f * count, 0.f), (float) count - 1);
+	};
+	unsigned int firstColumn = tile(minX, ClustersX), lastColumn = tile(maxX, ClustersX);
+	// Rows count down from the top of the screen
+	unsigned int firstRow = ClustersY - 1 - tile(maxY, ClustersY), lastRow = ClustersY - 1 - tile(minY, ClustersY);
+
+	float radiusSquared = radius * radius;
+	for (unsigned int z = firstSlice; z <= lastSlice; z++)
+	{
+		// Squared distance from the center to the box along each axis, zero where the center is inside the box's range
+		float dz = std::max(std::max(m_SliceNear[z] - center[2], center[2] - m_SliceNear[z + 1]), 0.f);
+		for (unsigned int y = firstRow; y <= lastRow; y++)
+		{
+			float dy = std::max(std::max(m_RowMin[z][y] - center[1], center[1] - m_RowMax[z][y]), 0.f);
+			float partial = dy * dy + dz * dz;
+			if (partial > radiusSquared) continue;
+
+			unsigned int base = GetClusterIndex(0, y, z);
+#if defined(CLUSTERS_SSE)
+			__m128 centerX = _mm_set1_ps(center[0]);
+			__m128 partialDistance = _mm_set1_ps(partial);
+			__m128 limit = _mm_set1_ps(radiusSquared);
+			for (unsigned int group = firstColumn & ~3u; group <= lastColumn; group += 4)
+			{
+				__m128 dx = _mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&m_ColumnMin[z][group]), centerX), _mm_sub_ps(centerX, _mm_loadu_ps(&m_ColumnMax[z][group])));
+				dx = _mm_max_ps(dx, _mm_setzero_ps());
+				__m128 distance = _mm_add_ps(_mm_mul_ps(dx, dx), partialDistance);
+
+				unsigned int mask = (unsigned int) _mm_movemask_ps(_mm_cmple_ps(distance, limit));
+				for (unsigned int lane = 0; lane < 4; lane++)
+				{
+					unsigned int x = group + lane;
+					if ((mask & (1u << lane)) && x >= firstColumn && x <= lastColumn)
+					{
+						m_HitClusters.push_back(base + x);
+						m_HitLights.push_back(light);
+					}
+				}
+			}
+#else
+			for (unsigned int x = firstColumn; x <= lastColumn; x++)
+			{
+				float dx = std::max(std::max(m_ColumnMin[z][x] - center[0], center[0] - m_ColumnMax[z][x]), 0.f);
+				if (dx * dx + partial <= radiusSquared)
+				{
+					m_HitClusters.push_back(base + x);
+					m_HitLights.push_back(light);
+				}
+			}
+#endif
+		}
+	}
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Scene/TransformStore.h"
+
+// Point light as LitSolidPS reads it from the light list. Attenuation is 1 / (constant + linear * d^2 + quadratic * d^4)
+struct PointLight
+{
+	float position[3];
+	// Past this distance the light is ignored, see GetLightRange()
+	float range;
+	float color[3];
+	float intensity;
+	float attConstant;
+	float attLinear;
+	float attQuadratic;
+	float padding;
+};
+
+// Distance at which the light's brightness falls below threshold
+float GetLightRange(const PointLight& light, float threshold = 1.f / 256.f);
+
+// Assigns lights to clusters of the view frustum, so every pixel only shades the lights that can reach it.
+// The screen is split into ClustersX by ClustersY tiles and view depth into ClustersZ slices spaced exponentially between
+// the near and far planes. Light spheres are tested against the bounding boxes of the clusters, four at a time where the CPU
+// allows, and the result is packed into one list of light indices with an offset and count per cluster.
+class LightClusters
+{
+public:
+	// LitSolidPS has these too
+	static constexpr unsigned int ClustersX = 16;
+	static constexpr unsigned int ClustersY = 9;
+	static constexpr unsigned int ClustersZ = 24;
+	static constexpr unsigned int ClusterCount = ClustersX * ClustersY * ClustersZ;
+
+	// Rebuilds the lists for a camera. view takes world space to view space (row-major, row vectors, +z forward),
+	// projectionX and projectionY are the [0][0] and [1][1] entries of its perspective projection
+	void Build(const PointLight* lights, size_t count, const TransformMatrix& view, float projectionX, float projectionY,
+		float nearPlane, float farPlane);
+
+	// Index of a cluster, tiles are counted from the top left of the screen
+	static unsigned int GetClusterIndex(unsigned int x, unsigned int y, unsigned int z) { return (z * ClustersY + y) * ClustersX + x; }
+
+	// The slice of a view depth is log2(depth) * GetSliceScale() + GetSliceBias()
+	float GetSliceScale() const { return m_SliceScale; }
+	float GetSliceBias() const { return m_SliceBias; }
+
+	// First entry in GetLightIndices() and number of lights, for every cluster
+	const std::vector<uint32_t>& GetClusters() const { return m_Clusters; }
+	const std::vector<uint32_t>& GetLightIndices() const { return m_LightIndices; }
+
+private:
+	void UpdateBounds(float projectionX, float projectionY, float nearPlane, float farPlane);
+	void AddLight(uint32_t light, const float center[3], float radius);
+
+	float m_ProjectionX = 0.f, m_ProjectionY = 0.f, m_Near = 0.f, m_Far = 0.f;
+	float m_SliceScale = 0.f, m_SliceBias = 0.f;
+
+	// View-space bounding boxes of the clusters. A cluster's x range only depends on its column and slice,
+	// and its y range on its row and slice, so they are stored per slice
+	float m_SliceNear[ClustersZ + 1];
+	float m_ColumnMin[ClustersZ][ClustersX], m_ColumnMax[ClustersZ][ClustersX];
+	float m_RowMin[ClustersZ][ClustersY], m_RowMax[ClustersZ][ClustersY];
+
+	// Cluster and light of every overlap found, sorted by cluster at the end of Build()
+	std::vector<uint32_t> m_HitClusters;
+	std::vector<uint32_t> m_HitLights;
+
+	std::vector<uint32_t> m_Clusters = std::vector<uint32_t>(ClusterCount * 2);
+	std::vector<uint32_t> m_LightIndices;
+};
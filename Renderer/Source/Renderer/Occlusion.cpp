@@ -0,0 +1,345 @@
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define OCCLUSION_SSE
+#endif
+
+#include <algorithm>
+#include <cmath>
+
+#include "Occlusion.h"
+
+namespace
+{
+	unsigned int RoundUpToTile(unsigned int size)
+	{
+		return (std::max(size, 1u) + OcclusionBuffer::TileSize - 1) / OcclusionBuffer::TileSize * OcclusionBuffer::TileSize;
+	}
+
+	// Row vector times a row-major matrix
+	void Project(const float* position, const TransformMatrix& matrix, float* clip)
+	{
+		const auto& m = matrix.m;
+		for (int column = 0; column < 4; column++)
+			clip[column] = position[0] * m[0][column] + position[1] * m[1][column] + position[2] * m[2][column] + m[3][column];
+	}
+}
+
+OcclusionBuffer::OcclusionBuffer(unsigned int width, unsigned int height, unsigned int threadCount)
+	: m_Width(RoundUpToTile(width)), m_Height(RoundUpToTile(height))
+{
+	m_TilesX = m_Width / TileSize;
+	m_TilesY = m_Height / TileSize;
+	m_Depth.resize(size_t(m_Width) * m_Height);
+	m_TileDepth.resize(size_t(m_TilesX) * m_TilesY);
+
+	// Small buffers don't have enough bands to be worth more than a couple of helpers
+	if (threadCount == 0) threadCount = std::min(std::max(std::thread::hardware_concurrency(), 2u) - 1, 3u);
+	for (unsigned int i = 1; i < threadCount; i++) m_Workers.emplace_back(&OcclusionBuffer::WorkerLoop, this);
+
+	Clear();
+}
+
+OcclusionBuffer::~OcclusionBuffer()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Stop = true;
+	}
+	m_Start.notify_all();
+
+	for (auto& worker : m_Workers) worker.join();
+}
+
+void OcclusionBuffer::Clear()
+{
+	std::fill(m_Depth.begin(), m_Depth.end(), 1.f);
+	std::fill(m_TileDepth.begin(), m_TileDepth.end(), 1.f);
+	m_Triangles.clear();
+}
+
+void OcclusionBuffer::AddOccluder(const float* positions, const uint32_t* indices, size_t indexCount, const TransformMatrix& worldViewProjection)
+{
+	// Every vertex is projected once, however many triangles use it
+	uint32_t vertexCount = 0;
+	for (size_t i = 0; i < indexCount; i++) vertexCount = std::max(vertexCount, indices[i] + 1);
+
+	m_Projected.resize(size_t(vertexCount) * 4);
+	for (uint32_t i = 0; i < vertexCount; i++)
+	{
+		float* clip = &m_Projected[size_t(i) * 4];
+		Project(positions + size_t(i) * 3, worldViewProjection, clip);
+
+		// Vertices in front of the near plane are marked with a negative depth, their triangles are dropped
+		if (clip[2] < 0.f || clip[3] <= 0.f)
+		{
+			clip[2] = -1.f;
+			continue;
+		}
+
+		float inverseW = 1.f / clip[3];
+		clip[0] = (clip[0] * inverseW * 0.5f + 0.5f) * m_Width;
+		clip[1] = (0.5f - clip[1] * inverseW * 0.5f) * m_Height;
+		clip[2] *= inverseW;
+	}
+
+	for (size_t i = 0; i + 2 < indexCount; i += 3)
+	{
+		const float* v[3] = { &m_Projected[size_t(indices[i]) * 4], &m_Projected[size_t(indices[i + 1]) * 4], &m_Projected[size_t(indices[i + 2]) * 4] };
+		if (v[0][2] < 0.f || v[1][2] < 0.f || v[2][2] < 0.f) continue;
+
+		float area = (v[1][0] - v[0][0]) * (v[2][1] - v[0][1]) - (v[2][0] - v[0][0]) * (v[1][1] - v[0][1]);
+		if (std::fabs(area) < 1e-6f) continue;
+
+		// Both sides are drawn, so turn everything the same way round
+		if (area < 0.f)
+		{
+			std::swap(v[1], v[2]);
+			area = -area;
+		}
+
+		// Pixels whose centers fall inside
+		float minX = std::min({ v[0][0], v[1][0], v[2][0] }), maxX = std::max({ v[0][0], v[1][0], v[2][0] });
+		float minY = std::min({ v[0][1], v[1][1], v[2][1] }), maxY = std::max({ v[0][1], v[1][1], v[2][1] });
+
+		Triangle triangle;
+		triangle.minX = std::max((int) std::ceil(minX - 0.5f), 0);
+		triangle.maxX = std::min((int) std::floor(maxX - 0.5f), (int) m_Width - 1);
+		triangle.minY = std::max((int) std::ceil(minY - 0.5f), 0);
+		triangle.maxY = std::min((int) std::floor(maxY - 0.5f), (int) m_Height - 1);
+		if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY) continue;
+
+		// edge(p) = a * x + b * y + c is at least 0 on the inside of the edge from one vertex to the next
+		for (int edge = 0; edge < 3; edge++)
+		{
+			const float* from = v[edge];
+			const float* to = v[(edge + 1) % 3];
+			triangle.edge[edge][0] = from[1] - to[1];
+			triangle.edge[edge][1] = to[0] - from[0];
+			triangle.edge[edge][2] = -(triangle.edge[edge][0] * from[0] + triangle.edge[edge][1] * from[1]);
+		}
+
+		// z / w is linear in screen space
+		float dzdx = ((v[1][2] - v[0][2]) * (v[2][1] - v[0][1]) - (v[2][2] - v[0][2]) * (v[1][1] - v[0][1])) / area;
+		float dzdy = ((v[2][2] - v[0][2]) * (v[1][0] - v[0][0]) - (v[1][2] - v[0][2]) * (v[2][0] - v[0][0])) / area;
+		triangle.depth[0] = dzdx;
+		triangle.depth[1] = dzdy;
+		triangle.depth[2] = v[0][2] - dzdx * v[0][0] - dzdy * v[0][1];
+
+		m_Triangles.push_back(triangle);
+	}
+}
+
+void OcclusionBuffer::Rasterize()
+{
+	m_NextBand = 0;
+	if (!m_Workers.empty())
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			++m_Generation;
+			m_Running = (unsigned int) m_Workers.size();
+		}
+		m_Start.notify_all();
+	}
+
+	for (unsigned int band = m_NextBand++; band < m_TilesY; band = m_NextBand++) RasterizeBand(band);
+
+	if (!m_Workers.empty())
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_Finished.wait(lock, [this]() { return m_Running == 0; });
+	}
+}
+
+bool OcclusionBuffer::IsVisible(const float center[3], const float extent[3], const TransformMatrix& viewProjection) const
+{
+	float minX = (float) m_Width, maxX = 0.f, minY = (float) m_Height, maxY = 0.f, minZ = 1.f;
+
+#ifdef OCCLUSION_SSE
+	// The corners are the projected center plus or minus each projected half axis
+	const auto& m = viewProjection.m;
+	__m128 projectedCenter = _mm_load_ps(m[3]);
+	__m128 projectedAxis[3];
+	for (int axis = 0; axis < 3; axis++)
+	{
+		__m128 row = _mm_load_ps(m[axis]);
+		projectedCenter = _mm_add_ps(projectedCenter, _mm_mul_ps(_mm_set1_ps(center[axis]), row));
+		projectedAxis[axis] = _mm_mul_ps(_mm_set1_ps(extent[axis]), row);
+	}
+#endif
+
+	for (int corner = 0; corner < 8; corner++)
+	{
+		alignas(16) float clip[4];
+#ifdef OCCLUSION_SSE
+		__m128 projected = projectedCenter;
+		for (int axis = 0; axis < 3; axis++)
+			projected = (corner >> axis) & 1 ? _mm_add_ps(projected, projectedAxis[axis]) : _mm_sub_ps(projected, projectedAxis[axis]);
+		_mm_store_ps(clip, projected);
+#else
+		float position[3];
+		for (int axis = 0; axis < 3; axis++) position[axis] = center[axis] + ((corner >> axis) & 1 ? extent[axis] : -extent[axis]);
+		Project(position, viewProjection, clip);
+#endif
+		if (clip[2] < 0.f || clip[3] <= 0.f) return true;
+
+		float inverseW = 1.f / clip[3];
+		float x = (clip[0] * inverseW * 0.5f + 0.5f) * m_Width;
+		float y = (0.5f - clip[1] * inverseW * 0.5f) * m_Height;
+		minX = std::min(minX, x);
+		maxX = std::max(maxX, x);
+		minY = std::min(minY, y);
+		maxY = std::max(maxY, y);
+		minZ = std::min(minZ, clip[2] * inverseW);
+	}
+
+	// Every pixel the box's rectangle touches
+	int x0 = std::max((int) std::floor(minX), 0), x1 = std::min((int) std::floor(maxX), (int) m_Width - 1);
+	int y0 = std::max((int) std::floor(minY), 0), y1 = std::min((int) std::floor(maxY), (int) m_Height - 1);
+	if (x0 > x1 || y0 > y1) return true;
+
+	for (int tileY = y0 / (int) TileSize; tileY <= y1 / (int) TileSize; tileY++)
+	{
+		for (int tileX = x0 / (int) TileSize; tileX <= x1 / (int) TileSize; tileX++)
+		{
+			// Everything in the tile is nearer than the box
+			if (m_TileDepth[size_t(tileY) * m_TilesX + tileX] < minZ) continue;
+
+			int pixelX0 = std::max(x0, tileX * (int) TileSize), pixelX1 = std::min(x1, tileX * (int) TileSize + (int) TileSize - 1);
+			int pixelY0 = std::max(y0, tileY * (int) TileSize), pixelY1 = std::min(y1, tileY * (int) TileSize + (int) TileSize - 1);
+			for (int y = pixelY0; y <= pixelY1; y++)
+			{
+				const float* row = &m_Depth[size_t(y) * m_Width];
+				for (int x = pixelX0; x <= pixelX1; x++)
+				{
+					if (row[x] >= minZ) return true;
+				}
+			}
+		}
+	}
+
+	return false;
+}
+
+size_t OcclusionBuffer::CullOccluded(const WorldBounds& bounds, const TransformMatrix& viewProjection, uint32_t* indices, size_t count) const
+{
+	size_t visibleCount = 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		uint32_t index = indices[i];
+		float center[3] = { bounds.center[0][index], bounds.center[1][index], bounds.center[2][index] };
+		float extent[3] = { bounds.extent[0][index], bounds.extent[1][index], bounds.extent[2][index] };
+
+		if (IsVisible(center, extent, viewProjection)) indices[visibleCount++] = index;
+	}
+
+	return visibleCount;
+}
+
+void OcclusionBuffer::RasterizeBand(unsigned int band)
+{
+	int minY = (int) (band * TileSize);
+	int maxY = minY + (int) TileSize - 1;
+
+	for (auto& triangle : m_Triangles)
+	{
+		if (triangle.maxY < minY || triangle.minY > maxY) continue;
+		RasterizeTriangle(triangle, std::max(triangle.minY, minY), std::min(triangle.maxY, maxY));
+	}
+
+	// Only this band's rows were touched, so its tiles can be finished here too
+	for (unsigned int tileX = 0; tileX < m_TilesX; tileX++)
+	{
+		float farthest = 0.f;
+		for (int y = minY; y <= maxY; y++)
+		{
+			const float* pixels = &m_Depth[size_t(y) * m_Width + tileX * TileSize];
+#ifdef OCCLUSION_SSE
+			__m128 rowMax = _mm_max_ps(_mm_loadu_ps(pixels), _mm_loadu_ps(pixels + 4));
+			rowMax = _mm_max_ps(rowMax, _mm_shuffle_ps(rowMax, rowMax, _MM_SHUFFLE(1, 0, 3, 2)));
+			rowMax = _mm_max_ps(rowMax, _mm_shuffle_ps(rowMax, rowMax, _MM_SHUFFLE(2, 3, 0, 1)));
+			farthest = std::max(farthest, _mm_cvtss_f32(rowMax));
+#else
+			for (unsigned int x = 0; x < TileSize; x++) farthest = std::max(farthest, pixels[x]);
+#endif
+		}
+
+		m_TileDepth[size_t(band) * m_TilesX + tileX] = farthest;
+	}
+}
+
+void OcclusionBuffer::RasterizeTriangle(const Triangle& triangle, int minY, int maxY)
+{
+	const auto& edge = triangle.edge;
+	const auto& depth = triangle.depth;
+
+	// Rows are walked four pixels at a time from a multiple of four, the width always is one
+	int startX = triangle.minX & ~3;
+
+#ifdef OCCLUSION_SSE
+	const __m128 offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+	const __m128 zero = _mm_setzero_ps();
+	__m128 a[3];
+	for (int i = 0; i < 3; i++) a[i] = _mm_set1_ps(edge[i][0]);
+	const __m128 depthX = _mm_set1_ps(depth[0]);
+
+	for (int y = minY; y <= maxY; y++)
+	{
+		float py = y + 0.5f;
+		__m128 rowEdge[3];
+		for (int i = 0; i < 3; i++) rowEdge[i] = _mm_set1_ps(edge[i][1] * py + edge[i][2]);
+		__m128 rowDepth = _mm_set1_ps(depth[1] * py + depth[2]);
+
+		float* row = &m_Depth[size_t(y) * m_Width];
+		for (int x = startX; x <= triangle.maxX; x += 4)
+		{
+			__m128 px = _mm_add_ps(_mm_set1_ps((float) x), offsets);
+
+			__m128 inside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a[0], px), rowEdge[0]), zero);
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a[1], px), rowEdge[1]), zero));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a[2], px), rowEdge[2]), zero));
+			if (_mm_movemask_ps(inside) == 0) continue;
+
+			__m128 old = _mm_loadu_ps(row + x);
+			__m128 z = _mm_min_ps(old, _mm_add_ps(_mm_mul_ps(depthX, px), rowDepth));
+			_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, z), _mm_andnot_ps(inside, old)));
+		}
+	}
+#else
+	for (int y = minY; y <= maxY; y++)
+	{
+		float py = y + 0.5f;
+		float* row = &m_Depth[size_t(y) * m_Width];
+		for (int x = startX; x <= triangle.maxX; x++)
+		{
+			float px = x + 0.5f;
+			if (edge[0][0] * px + edge[0][1] * py + edge[0][2] < 0.f) continue;
+			if (edge[1][0] * px + edge[1][1] * py + edge[1][2] < 0.f) continue;
+			if (edge[2][0] * px + edge[2][1] * py + edge[2][2] < 0.f) continue;
+
+			row[x] = std::min(row[x], depth[0] * px + depth[1] * py + depth[2]);
+		}
+	}
+#endif
+}
+
+void OcclusionBuffer::WorkerLoop()
+{
+	uint64_t generation = 0;
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_Start.wait(lock, [this, generation]() { return m_Stop || m_Generation != generation; });
+			if (m_Stop) return;
+			generation = m_Generation;
+		}
+
+		for (unsigned int band = m_NextBand++; band < m_TilesY; band = m_NextBand++) RasterizeBand(band);
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			if (--m_Running == 0) m_Finished.notify_one();
+		}
+	}
+}
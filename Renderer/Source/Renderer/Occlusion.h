@@ -0,0 +1,82 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Scene/TransformStore.h"
+
+// Low resolution software depth buffer for occlusion culling.
+// Occluder meshes are rasterized into it on the CPU, keeping the nearest depth of every pixel, then the farthest depth
+// of every tile of pixels is taken to build a second, coarser level. Bounding boxes are tested against the tiles first
+// and only against pixels where a tile can't decide. Rasterization is split into bands of tile rows shared between
+// worker threads, and works on four pixels at a time where the CPU allows.
+// Depths are z / w of a 0 to 1 depth range projection.
+class OcclusionBuffer
+{
+public:
+	static constexpr unsigned int TileSize = 8;
+
+	// The width and height are rounded up to whole tiles. Zero threads picks a count from the hardware,
+	// the calling thread always works on the buffer too
+	OcclusionBuffer(unsigned int width, unsigned int height, unsigned int threadCount = 0);
+	OcclusionBuffer(const OcclusionBuffer&) = delete;
+	OcclusionBuffer& operator =(const OcclusionBuffer&) = delete;
+	~OcclusionBuffer();
+
+	// Starts a new frame with nothing occluding
+	void Clear();
+
+	// Projects a triangle list into screen space, ready for Rasterize(). Positions are xyz triples in the space
+	// worldViewProjection (row-major, row vectors) takes to clip space. Triangles crossing the near plane are left out
+	void AddOccluder(const float* positions, const uint32_t* indices, size_t indexCount, const TransformMatrix& worldViewProjection);
+
+	// Draws every occluder added since Clear() and builds the tiles
+	void Rasterize();
+
+	// Whether any of the world-space box could be seen past the occluders. Boxes reaching behind the camera always can
+	bool IsVisible(const float center[3], const float extent[3], const TransformMatrix& viewProjection) const;
+
+	// Removes the hidden boxes from a list of indices into bounds, like the one CullBounds() writes.
+	// Keeps the order of the rest and returns how many there are
+	size_t CullOccluded(const WorldBounds& bounds, const TransformMatrix& viewProjection, uint32_t* indices, size_t count) const;
+
+	unsigned int GetWidth() const { return m_Width; }
+	unsigned int GetHeight() const { return m_Height; }
+	const float* GetDepth() const { return m_Depth.data(); }
+	size_t GetTriangleCount() const { return m_Triangles.size(); }
+
+private:
+	// Screen-space triangle with its edge functions and depth plane, counter-clockwise on screen
+	struct Triangle
+	{
+		float edge[3][3];
+		float depth[3];
+		int minX, minY, maxX, maxY;
+	};
+
+	void RasterizeBand(unsigned int band);
+	void RasterizeTriangle(const Triangle& triangle, int minY, int maxY);
+	void WorkerLoop();
+
+	unsigned int m_Width, m_Height;
+	unsigned int m_TilesX, m_TilesY;
+	std::vector<float> m_Depth;
+	// Farthest depth in every tile
+	std::vector<float> m_TileDepth;
+
+	std::vector<Triangle> m_Triangles;
+	std::vector<float> m_Projected;
+
+	std::vector<std::thread> m_Workers;
+	std::mutex m_Mutex;
+	std::condition_variable m_Start;
+	std::condition_variable m_Finished;
+	uint64_t m_Generation = 0;
+	unsigned int m_Running = 0;
+	bool m_Stop = false;
+	std::atomic<unsigned int> m_NextBand{ 0 };
+};
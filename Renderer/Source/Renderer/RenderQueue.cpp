@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <cstring>
+
+#include "RenderQueue.h"
+
+namespace
+{
+	constexpr int DepthShift = 0;
+	constexpr int BufferShift = DepthShift + SortKey::DepthBits;
+	constexpr int MaterialShift = BufferShift + SortKey::BufferBits;
+	constexpr int ShaderShift = MaterialShift + SortKey::MaterialBits;
+	constexpr int PassShift = ShaderShift + SortKey::ShaderBits;
+
+	uint64_t Field(uint32_t value, int bits, int shift)
+	{
+		return (uint64_t(value) & ((uint64_t(1) << bits) - 1)) << shift;
+	}
+
+	uint32_t Extract(uint64_t key, int bits, int shift)
+	{
+		return (uint32_t) ((key >> shift) & ((uint64_t(1) << bits) - 1));
+	}
+}
+
+uint64_t SortKey::Make(uint32_t pass, uint32_t shader, uint32_t material, uint32_t buffer, float depth)
+{
+	constexpr uint32_t MaxDepth = (1u << DepthBits) - 1;
+	// Written so NaN ends up at 0 as well
+	uint32_t quantized = depth > 0.f ? (depth < 1.f ? (uint32_t) (depth * MaxDepth) : MaxDepth) : 0;
+
+	return Field(pass, PassBits, PassShift) | Field(shader, ShaderBits, ShaderShift) | Field(material, MaterialBits, MaterialShift) |
+		Field(buffer, BufferBits, BufferShift) | Field(quantized, DepthBits, DepthShift);
+}
+
+uint32_t SortKey::GetPass(uint64_t key) { return Extract(key, PassBits, PassShift); }
+uint32_t SortKey::GetShader(uint64_t key) { return Extract(key, ShaderBits, ShaderShift); }
+uint32_t SortKey::GetMaterial(uint64_t key) { return Extract(key, MaterialBits, MaterialShift); }
+uint32_t SortKey::GetBuffer(uint64_t key) { return Extract(key, BufferBits, BufferShift); }
+uint32_t SortKey::GetDepth(uint64_t key) { return Extract(key, DepthBits, DepthShift); }
+
+uint32_t SortKey::Fold(uint64_t value, int bits)
+{
+	// Mix first so pointers, which share their high and low bits, still spread over the whole field
+	value ^= value >> 33;
+	value *= 0xff51afd7ed558ccdull;
+	value ^= value >> 33;
+	return (uint32_t) (value & ((uint64_t(1) << bits) - 1));
+}
+
+void RenderQueue::Sort()
+{
+	size_t count = m_Packets.size();
+	if (count < 2) return;
+
+	// Small queues aren't worth the histogram passes
+	if (count < 64)
+	{
+		std::stable_sort(m_Packets.begin(), m_Packets.end(), [](const DrawPacket& a, const DrawPacket& b) { return a.key < b.key; });
+		return;
+	}
+
+	// Count all eight digits in one pass over the keys
+	uint32_t histograms[8][256];
+	memset(histograms, 0, sizeof(histograms));
+	for (auto& packet : m_Packets)
+	{
+		for (int digit = 0; digit < 8; digit++)
+			histograms[digit][(packet.key >> (digit * 8)) & 0xff]++;
+	}
+
+	m_Scratch.resize(count);
+	DrawPacket* from = m_Packets.data();
+	DrawPacket* to = m_Scratch.data();
+
+	for (int digit = 0; digit < 8; digit++)
+	{
+		uint32_t* histogram = histograms[digit];
+
+		// A digit that is the same in every key doesn't change the order
+		if (histogram[(from[0].key >> (digit * 8)) & 0xff] == count) continue;
+
+		uint32_t offset = 0;
+		for (int i = 0; i < 256; i++)
+		{
+			uint32_t bucket = histogram[i];
+			histogram[i] = offset;
+			offset += bucket;
+		}
+
+		for (size_t i = 0; i < count; i++)
+		{
+			auto& packet = from[i];
+			to[histogram[(packet.key >> (digit * 8)) & 0xff]++] = packet;
+		}
+
+		std::swap(from, to);
+	}
+
+	if (from != m_Packets.data()) m_Packets.swap(m_Scratch);
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 64-bit draw sort key, from most to least significant:
+// pass (4 bits) | shader (12 bits) | material (12 bits) | buffer (12 bits) | depth (24 bits).
+// Sorting by key submits passes in order, and within a pass groups draws that share state, front to back.
+namespace SortKey
+{
+	constexpr int PassBits = 4, ShaderBits = 12, MaterialBits = 12, BufferBits = 12, DepthBits = 24;
+
+	// Fields wider than their bits are masked, depth is the view distance divided by the far plane and clamped to [0, 1]
+	uint64_t Make(uint32_t pass, uint32_t shader, uint32_t material, uint32_t buffer, float depth);
+
+	uint32_t GetPass(uint64_t key);
+	uint32_t GetShader(uint64_t key);
+	uint32_t GetMaterial(uint64_t key);
+	uint32_t GetBuffer(uint64_t key);
+	uint32_t GetDepth(uint64_t key);
+
+	// Folds a pointer or hash down to an id that fits in a field of the given width
+	uint32_t Fold(uint64_t value, int bits);
+}
+
+struct DrawPacket
+{
+	uint64_t key;
+	// Index of whatever the caller needs to issue the draw
+	uint32_t payload;
+};
+
+// Collects draw packets for a frame and orders them by key with an LSD radix sort,
+// skipping the byte passes where every key agrees
+class RenderQueue
+{
+public:
+	void Clear() { m_Packets.clear(); }
+	void Push(uint64_t key, uint32_t payload) { m_Packets.push_back({ key, payload }); }
+
+	// Stable, so packets with equal keys keep the order they were pushed in
+	void Sort();
+
+	const std::vector<DrawPacket>& GetPackets() const { return m_Packets; }
+	size_t GetSize() const { return m_Packets.size(); }
+
+private:
+	std::vector<DrawPacket> m_Packets;
+	std::vector<DrawPacket> m_Scratch;
+};
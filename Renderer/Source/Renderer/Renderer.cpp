@@ -1,10 +1,28 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <exception>
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
 #include <d3d11.h>
 
 #include "imgui.h"
 
 #include "Renderer.h"
 
+namespace
+{
+	// Largest factor a row-major transform scales lengths by, along any of its axes
+	float GetMaxScale(const float (&m)[4][4])
+	{
+		float scale = 0.f;
+		for (int row = 0; row < 3; row++) scale = std::max(scale, m[row][0] * m[row][0] + m[row][1] * m[row][1] + m[row][2] * m[row][2]);
+		return std::sqrt(scale);
+	}
+}
+
 Renderer::Renderer()
 	: m_MainCamera(ProjectionMode::Perspective, 1.f, 2.5f, 1000.f), m_Light("Light", "../../Renderer/Meshes/light.fbx")
 {
@@ -122,18 +140,28 @@ Renderer::Renderer()
 	// Bind the viewport to the pipeline
 	GraphicsContext::Context->RSSetViewports(1, &vp);
 
-	m_MaterialBuffer = new ConstantBuffer(nullptr, sizeof(Material), ConstantBufferTarget::PixelShader);
+	// Per-draw constants are streamed through one ring buffer, the per-frame ones keep their own buffers
+	m_ConstantRing = new ConstantRingBuffer(64 * 1024);
+	m_MaterialBuffer = new ConstantBuffer(sizeof(Material), ConstantBufferTarget::PixelShader, m_ConstantRing);
 	m_LightBuffer = new ConstantBuffer(nullptr, sizeof(LightBuffer), ConstantBufferTarget::PixelShader);
 	m_CameraBuffer = new ConstantBuffer(nullptr, sizeof(CameraBuffer), ConstantBufferTarget::PixelShader);
-	m_ObjectBuffer = new ConstantBuffer(nullptr, sizeof(ObjectBuffer), ConstantBufferTarget::VertexShader);
+	m_LightList = new StructuredBuffer(sizeof(PointLight), 64);
+	m_ClusterList = new StructuredBuffer(2 * sizeof(uint32_t), LightClusters::ClusterCount);
+	m_LightIndexList = new StructuredBuffer(sizeof(uint32_t), 1024);
+	m_InstanceBuffer = new VertexBuffer(m_InstanceLayout, BufferAccess::Dynamic, nullptr, 1024);
+	m_ClusterIndexBuffer = new IndexBuffer(BufferAccess::Dynamic, nullptr, 64 * 1024);
+	m_Backend = new D3D11Backend;
 
-	m_UnlitVS = new VertexShader(L"UnlitVS.cso");
+	for (uint32_t attributes = 0; attributes <= VertexAllAttributes; attributes++)
+		m_UnlitVS[attributes] = new VertexShader(L"UnlitVS" + std::to_wstring(attributes) + L".cso");
 
 	m_UnlitSolidPS = new PixelShader(L"UnlitSolidPS.cso");
 	m_LitSolidPS = new PixelShader(L"LitSolidPS.cso");
 
 	
 	m_MainCamera.Resize((float)bbDesc.Width / (float)bbDesc.Height);
+	m_LightData.tileScale = { (float) LightClusters::ClustersX / bbDesc.Width, (float) LightClusters::ClustersY / bbDesc.Height };
+	m_ViewportHeight = (float) bbDesc.Height;
 	m_Scene = new Scene(&m_IsSceneOpen);
 }
 
@@ -142,7 +170,7 @@ Renderer::~Renderer()
 	if (p_RenderTarget) p_RenderTarget->Release();
 	if (p_DepthStencil) p_DepthStencil->Release();
 
-	delete m_UnlitVS;
+	for (auto shader : m_UnlitVS) delete shader;
 
 	delete m_UnlitSolidPS;
 	delete m_LitSolidPS;
@@ -150,63 +178,332 @@ Renderer::~Renderer()
 	delete m_CameraBuffer;
 	delete m_MaterialBuffer;
 	delete m_LightBuffer;
-	delete m_ObjectBuffer;
+	delete m_LightList;
+	delete m_ClusterList;
+	delete m_LightIndexList;
+	delete m_InstanceBuffer;
+	delete m_ClusterIndexBuffer;
+	delete m_ConstantRing;
+	delete m_Backend;
 
 	delete m_Scene;
 }
 
 void Renderer::Render(float deltaTime)
 {
+	PROFILE_SCOPE("Render");
+
 	m_DeltaTime = deltaTime;
 	m_Stats.drawCalls = 0;
+	std::fill(std::begin(m_Stats.lodTriangles), std::end(m_Stats.lodTriangles), 0);
+
+	// ImGui and whatever else ran since last frame may have changed the pipeline without telling the cache
+	auto& stateCache = GraphicsContext::GetStateCache();
+	stateCache.Invalidate();
+	stateCache.ResetCounters();
 
 	// Clear the render target and depth stencil at the beginning of every frame so we don't have residue left over from the previous frame
+	// The frame is recorded first and handed to the backend at the end
+	m_CommandList.Clear();
+	m_CommandList.BeginScope("Scene");
 	float color[] = { 0.11f, 0.18f, 0.96f, 1.f };
-	GraphicsContext::Context->ClearRenderTargetView(p_RenderTarget, color);
-	GraphicsContext::Context->ClearDepthStencilView(p_DepthStencil, D3D11_CLEAR_DEPTH, 1.f, 0);
+	m_CommandList.ClearRenderTarget(p_RenderTarget, color);
+	m_CommandList.ClearDepth(p_DepthStencil, 1.f);
 
 	// Make sure we're rendering to our render target, because it could've been recreated on a resize event
-	GraphicsContext::Context->OMSetRenderTargets(1, &p_RenderTarget, p_DepthStencil);
+	m_CommandList.BindRenderTarget(p_RenderTarget, p_DepthStencil);
 
-	m_ObjectBuffer->Bind(0);
+	m_CommandList.BindConstantBuffer(m_LightBuffer, ShaderStage::Pixel, 0);
+	m_CommandList.BindConstantBuffer(m_CameraBuffer, ShaderStage::Pixel, 2);
 
-	m_LightBuffer->Bind(0);
-	m_MaterialBuffer->Bind(1);
-	m_CameraBuffer->Bind(2);
+	AssignLights();
 
-	m_LightBuffer->Set(&m_LightData);
+	// Objects whose import finished since last frame join the scene before anything is culled or drawn
+	{
+		PROFILE_SCOPE("Process Imports");
+		m_Scene->ProcessImports();
+	}
 
 	m_CameraData.cameraPosition = m_MainCamera.GetPosition();
-	m_CameraBuffer->Set(&m_CameraData);
+	m_CommandList.WriteBuffer(WriteTarget::ConstantBuffer, m_CameraBuffer, &m_CameraData, sizeof(CameraBuffer));
+
+	// Bring every object's matrices up to date in one go, before any of them are read
+	TransformMatrix viewProjection;
+	DirectX::XMStoreFloat4x4A((DirectX::XMFLOAT4X4A*) &viewProjection, m_MainCamera.GetViewProjection());
+	auto& transforms = Object::GetTransforms();
+	{
+		PROFILE_SCOPE("Transforms");
+		transforms.Update(viewProjection);
+	}
+
+	// Only objects whose world bounds touch the view frustum get drawn
+	size_t visibleCount;
+	{
+		PROFILE_SCOPE("Culling");
+		m_VisibleObjects.resize(transforms.GetSize());
+		visibleCount = CullBounds(ExtractFrustum(viewProjection), transforms.GetWorldBounds(), transforms.GetSize(), m_VisibleObjects.data());
+		m_Stats.occludedObjects = 0;
+		m_Stats.occluderTriangles = 0;
+		if (m_OcclusionCulling) visibleCount = CullOccluded(viewProjection, visibleCount);
+	}
+
+	// Queue a packet for every part of every visible object, keyed on the state it needs
+	Profiler::Begin("Queue");
+	m_DrawItems.clear();
+	m_RenderQueue.Clear();
+	m_Stats.visibleObjects = 0;
+	float nearPlane = m_MainCamera.GetNearPlane();
+	float farPlane = m_MainCamera.GetFarPlane();
+	auto bounds = transforms.GetWorldBounds();
+	for (size_t i = 0; i < visibleCount; i++)
+	{
+		uint32_t slot = m_VisibleObjects[i];
+		auto& object = *(Object*) transforms.GetOwner(slot);
+		bool isLight = &object == &m_Light;
+		if (!isLight) ++m_Stats.visibleObjects;
+
+		// The w row of the translation is the view depth of the object's origin
+		float depth = transforms.GetWorldViewProjection(object.GetTransform()).m[3][3] / farPlane;
+
+		// Levels of detail go by the nearest the object's bounding sphere gets to the camera
+		float center[3] = { bounds.center[0][slot], bounds.center[1][slot], bounds.center[2][slot] };
+		float radius = std::sqrt(bounds.extent[0][slot] * bounds.extent[0][slot] + bounds.extent[1][slot] * bounds.extent[1][slot] +
+			bounds.extent[2][slot] * bounds.extent[2][slot]);
+		float nearest = std::max(center[0] * viewProjection.m[0][3] + center[1] * viewProjection.m[1][3] + center[2] * viewProjection.m[2][3] +
+			viewProjection.m[3][3] - radius, nearPlane);
+		float scale = GetMaxScale(transforms.GetWorld(object.GetTransform()).m);
+
+		auto& material = object.GetMaterial();
+		uint32_t materialId = SortKey::Fold(std::hash<std::string_view>()(std::string_view((const char*) &material, sizeof(Material))), SortKey::MaterialBits);
+		auto& parts = object.GetMesh()->GetParts();
+		for (uint32_t part = 0; part < (uint32_t) parts.size(); part++)
+		{
+			uint32_t lod = isLight ? 0 : SelectLod(parts[part], scale * GetMaxScale(parts[part].transform), nearest);
+			uint64_t key = SortKey::Make(isLight ? GizmoPass : OpaquePass, isLight ? 1 : 0, materialId,
+				SortKey::Fold(HashCombine(HashCombine((uintptr_t) object.GetMesh(), part), lod), SortKey::BufferBits), depth);
+
+			m_RenderQueue.Push(key, (uint32_t) m_DrawItems.size());
+			m_DrawItems.push_back({ &object, part, lod });
+		}
+	}
+	Profiler::End();
+
+	{
+		PROFILE_SCOPE("Sort");
+		m_RenderQueue.Sort();
+	}
+
+	// Objects sharing a mesh and material sort next to each other, each run of the same part and level of detail becomes one instanced draw.
+	// The material is compared in full, so a hash collision in the key only costs a split, never a wrong draw
+	static const TransformMatrix identity = { { { 1.f, 0.f, 0.f, 0.f }, { 0.f, 1.f, 0.f, 0.f }, { 0.f, 0.f, 1.f, 0.f }, { 0.f, 0.f, 0.f, 1.f } } };
+	Profiler::Begin("Batching");
+	m_ConstantRing->Reset();
+	m_DrawGroups.clear();
+	m_Instances.clear();
+	m_ClusterIndices.clear();
+	m_Stats.clusters = 0;
+	m_Stats.culledClusters = 0;
+	for (auto& packet : m_RenderQueue.GetPackets())
+	{
+		auto& item = m_DrawItems[packet.payload];
+		Object* object = item.object;
+		auto mesh = object->GetMesh();
+		auto& part = mesh->GetParts()[item.part];
+		uint32_t pass = SortKey::GetPass(packet.key);
+
+		// Parts below the root of their file are placed by their node first, most files have only the one part at the root
+		auto& world = transforms.GetWorld(object->GetTransform());
+		auto& worldViewProjection = transforms.GetWorldViewProjection(object->GetTransform());
+		InstanceData instance;
+		if (memcmp(part.transform, identity.m, sizeof(identity.m)) == 0)
+		{
+			instance = { world, worldViewProjection };
+		}
+		else
+		{
+			auto localMatrix = DirectX::XMLoadFloat4x4((const DirectX::XMFLOAT4X4*) part.transform);
+			DirectX::XMStoreFloat4x4A((DirectX::XMFLOAT4X4A*) &instance.world,
+				DirectX::XMMatrixMultiply(localMatrix, DirectX::XMLoadFloat4x4A((const DirectX::XMFLOAT4X4A*) &world)));
+			DirectX::XMStoreFloat4x4A((DirectX::XMFLOAT4X4A*) &instance.worldViewProjection,
+				DirectX::XMMatrixMultiply(localMatrix, DirectX::XMLoadFloat4x4A((const DirectX::XMFLOAT4X4A*) &worldViewProjection)));
+		}
+
+		// Dense parts at full detail only draw the meshlets that are inside the frustum and facing the camera.
+		// Both are brought into the part's space, where the meshlets are
+		auto meshlets = mesh->GetPartMeshlets(item.part);
+		bool clustered = m_ClusterCulling && pass == OpaquePass && item.lod == 0 && meshlets.second >= MinClusteredMeshlets;
+		unsigned int firstIndex = mesh->GetFirstIndex() + part.lods[item.lod].firstIndex;
+		unsigned int indexCount = part.lods[item.lod].indexCount;
+		if (clustered)
+		{
+			float camera[3];
+			DirectX::XMStoreFloat3((DirectX::XMFLOAT3*) camera, DirectX::XMVector3TransformCoord(m_MainCamera.GetPosition(),
+				DirectX::XMMatrixInverse(nullptr, DirectX::XMLoadFloat4x4A((const DirectX::XMFLOAT4X4A*) &instance.world))));
+
+			firstIndex = (unsigned int) m_ClusterIndices.size();
+			size_t kept = CullMeshlets(ExtractFrustum(instance.worldViewProjection), camera, &mesh->GetMeshlets()[meshlets.first], meshlets.second,
+				mesh->GetMeshletVertices().data(), mesh->GetMeshletTriangles().data(), m_ClusterIndices);
+			indexCount = (unsigned int) m_ClusterIndices.size() - firstIndex;
+			m_Stats.clusters += meshlets.second;
+			m_Stats.culledClusters += (unsigned int) (meshlets.second - kept);
+
+			if (indexCount == 0) continue;
+		}
+
+		if (clustered || m_DrawGroups.empty() || m_DrawGroups.back().clustered || m_DrawGroups.back().pass != pass || m_DrawGroups.back().object->GetMesh() != mesh ||
+			m_DrawGroups.back().part != item.part || m_DrawGroups.back().lod != item.lod || memcmp(&m_DrawGroups.back().object->GetMaterial(), &object->GetMaterial(), sizeof(Material)) != 0)
+		{
+			m_DrawGroups.push_back({ object, item.part, item.lod, pass, clustered, firstIndex, indexCount, (unsigned int) m_Instances.size(), 0,
+				m_MaterialBuffer->Push(&object->GetMaterial()) });
+		}
 
-	m_UnlitVS->Bind();
-	m_LitSolidPS->Bind();
-	for (auto& object : m_Scene->GetObjects())
+		++m_DrawGroups.back().instanceCount;
+		m_Instances.push_back(instance);
+	}
+	Profiler::End();
+
+	auto& constants = m_ConstantRing->GetPacker();
+	if (constants.GetSize() > 0) m_CommandList.WriteBuffer(WriteTarget::ConstantRingBuffer, m_ConstantRing, constants.GetData(), constants.GetSize());
+	if (!m_Instances.empty())
+		m_CommandList.WriteBuffer(WriteTarget::VertexBuffer, m_InstanceBuffer, m_Instances.data(), (uint32_t) (m_Instances.size() * sizeof(InstanceData)));
+	if (!m_ClusterIndices.empty())
+		m_CommandList.WriteBuffer(WriteTarget::IndexBuffer, m_ClusterIndexBuffer, m_ClusterIndices.data(), (uint32_t) (m_ClusterIndices.size() * sizeof(uint32_t)));
+
+	m_Stats.culledObjects = (unsigned int) m_Scene->GetObjects().size() - m_Stats.visibleObjects;
+
+	// Redundant binds between consecutive groups are dropped by the state cache.
+	// Each pass gets a GPU scope of its own
+	Profiler::Begin("Record");
+	m_CommandList.BindInstanceBuffer(m_InstanceBuffer);
+	uint32_t scopePass = UINT32_MAX;
+	for (auto& group : m_DrawGroups)
 	{
-		m_ObjectData.world = object.GetWorldMatrix();
-		m_ObjectData.worldViewProjection = object.GetWorldMatrix() * m_MainCamera.GetViewProjection();
-		m_ObjectBuffer->Set(&m_ObjectData);
+		if (group.pass != scopePass)
+		{
+			if (scopePass != UINT32_MAX) m_CommandList.EndScope();
+			m_CommandList.BeginScope(group.pass == GizmoPass ? "Gizmos" : "Opaque");
+			scopePass = group.pass;
+		}
 
-		m_MaterialBuffer->Set(&object.GetMaterial());
+		m_CommandList.BindPixelShader(group.pass == GizmoPass ? m_UnlitSolidPS : m_LitSolidPS);
+		m_CommandList.BindConstantRecord(m_MaterialBuffer, ShaderStage::Pixel, 1, group.materialRecord);
 
-		object.GetVertexBuffer()->Bind();
-		object.GetIndexBuffer()->Bind();
+		// Meshes share the pool's buffers, so these mostly stay bound from one group to the next
+		auto mesh = group.object->GetMesh();
+		auto& part = mesh->GetParts()[group.part];
+		m_CommandList.BindVertexShader(m_UnlitVS[mesh->GetAttributes()]);
+		m_CommandList.BindVertexBuffer(mesh->GetVertexBuffer());
+		m_CommandList.BindIndexBuffer(group.clustered ? m_ClusterIndexBuffer : mesh->GetIndexBuffer());
 
 		++m_Stats.drawCalls;
-		GraphicsContext::Context->DrawIndexed(object.GetIndexBuffer()->GetSize(), 0, 0);
+		m_Stats.lodTriangles[group.lod] += group.indexCount / 3 * group.instanceCount;
+		m_CommandList.DrawIndexedInstanced(group.indexCount, group.instanceCount, group.firstIndex,
+			(int32_t) (mesh->GetBaseVertex() + part.baseVertex), group.firstInstance);
+	}
+	if (scopePass != UINT32_MAX) m_CommandList.EndScope();
+	m_CommandList.EndScope();
+	Profiler::End();
+
+	{
+		PROFILE_SCOPE("Submit");
+		m_Backend->Execute(m_CommandList);
+	}
+
+	m_Stats.stateChanges = stateCache.GetChanges();
+	m_Stats.redundantStates = stateCache.GetSkipped();
+}
+
+uint32_t Renderer::SelectLod(const MeshPart& part, float scale, float depth) const
+{
+	uint32_t lod = 0;
+	while (lod + 1 < part.lodCount && m_MainCamera.GetProjectedSize(part.lods[lod + 1].error * scale, depth, m_ViewportHeight) <= m_LodThreshold) lod++;
+	return lod;
+}
+
+size_t Renderer::CullOccluded(const TransformMatrix& viewProjection, size_t visibleCount)
+{
+	PROFILE_SCOPE("Occlusion");
+
+	auto& transforms = Object::GetTransforms();
+
+	// The nearest occluders hide the most, the light gizmo never hides anything
+	m_Occluders.clear();
+	for (size_t i = 0; i < visibleCount; i++)
+	{
+		auto& object = *(Object*) transforms.GetOwner(m_VisibleObjects[i]);
+		if (&object == &m_Light || !object.GetMesh()->IsOccluder() || !object.GetMesh()->IsUploaded()) continue;
+
+		m_Occluders.push_back({ transforms.GetWorldViewProjection(object.GetTransform()).m[3][3], m_VisibleObjects[i] });
+	}
+
+	size_t occluderCount = std::min(m_Occluders.size(), MaxOccluders);
+	std::partial_sort(m_Occluders.begin(), m_Occluders.begin() + occluderCount, m_Occluders.end());
+
+	m_Occlusion.Clear();
+	for (size_t i = 0; i < occluderCount; i++)
+	{
+		auto& object = *(Object*) transforms.GetOwner(m_Occluders[i].second);
+		auto& positions = object.GetMesh()->GetOccluderPositions();
+		auto& indices = object.GetMesh()->GetOccluderIndices();
+		m_Occlusion.AddOccluder(positions.data(), indices.data(), indices.size(), transforms.GetWorldViewProjection(object.GetTransform()));
 	}
+	m_Occlusion.Rasterize();
+	m_Stats.occluderTriangles = (unsigned int) m_Occlusion.GetTriangleCount();
+
+	size_t remaining = m_Occlusion.CullOccluded(transforms.GetWorldBounds(), viewProjection, m_VisibleObjects.data(), visibleCount);
+	m_Stats.occludedObjects = (unsigned int) (visibleCount - remaining);
+	return remaining;
+}
+
+void Renderer::AssignLights()
+{
+	PROFILE_SCOPE("Lights");
+
+	TransformMatrix view, projection;
+	DirectX::XMStoreFloat4x4A((DirectX::XMFLOAT4X4A*) &view, m_MainCamera.GetView());
+	DirectX::XMStoreFloat4x4A((DirectX::XMFLOAT4X4A*) &projection, m_MainCamera.GetProjection());
+
+	for (auto& light : m_Lights) light.range = GetLightRange(light);
+	m_LightClusters.Build(m_Lights.data(), m_Lights.size(), view, projection.m[0][0], projection.m[1][1], m_MainCamera.GetNearPlane(), m_MainCamera.GetFarPlane());
+
+	m_LightData.sliceScale = m_LightClusters.GetSliceScale();
+	m_LightData.sliceBias = m_LightClusters.GetSliceBias();
+	m_CommandList.WriteBuffer(WriteTarget::ConstantBuffer, m_LightBuffer, &m_LightData, sizeof(LightBuffer));
 
-	m_UnlitSolidPS->Bind();
+	// Written before they are bound, a write that has to grow a buffer replaces its view
+	auto& clusters = m_LightClusters.GetClusters();
+	auto& indices = m_LightClusters.GetLightIndices();
+	m_CommandList.WriteBuffer(WriteTarget::StructuredBuffer, m_LightList, m_Lights.data(), (uint32_t) (m_Lights.size() * sizeof(PointLight)));
+	m_CommandList.WriteBuffer(WriteTarget::StructuredBuffer, m_ClusterList, clusters.data(), (uint32_t) (clusters.size() * sizeof(uint32_t)));
+	if (!indices.empty())
+		m_CommandList.WriteBuffer(WriteTarget::StructuredBuffer, m_LightIndexList, indices.data(), (uint32_t) (indices.size() * sizeof(uint32_t)));
 
-	m_ObjectData.world = m_Light.GetWorldMatrix();
-	m_ObjectData.worldViewProjection = m_Light.GetWorldMatrix() * m_MainCamera.GetViewProjection();
-	m_ObjectBuffer->Set(&m_ObjectData);
-	m_MaterialBuffer->Set(&m_Light.GetMaterial());
+	m_CommandList.BindStructuredBuffer(m_LightList, ShaderStage::Pixel, 0);
+	m_CommandList.BindStructuredBuffer(m_ClusterList, ShaderStage::Pixel, 1);
+	m_CommandList.BindStructuredBuffer(m_LightIndexList, ShaderStage::Pixel, 2);
 
-	m_Light.GetVertexBuffer()->Bind();
-	m_Light.GetIndexBuffer()->Bind();
-	++m_Stats.drawCalls;
-	GraphicsContext::Context->DrawIndexed(m_Light.GetIndexBuffer()->GetSize(), 0, 0);
+	m_Stats.lights = (unsigned int) m_Lights.size();
+	m_Stats.lightAssignments = (unsigned int) indices.size();
+}
+
+void Renderer::ScatterLights()
+{
+	// Same seed every time, so the same count always gives the same lights
+	std::mt19937 random(0);
+	std::uniform_real_distribution<float> position(-m_ScatterRadius, m_ScatterRadius);
+	std::uniform_real_distribution<float> height(0.f, m_ScatterRadius * 0.2f);
+	std::uniform_real_distribution<float> color(0.2f, 1.f);
+
+	m_Lights.resize(1);
+	for (int i = 0; i < m_ScatteredLights; i++)
+	{
+		PointLight light = m_Lights[0];
+		light.position[0] = position(random);
+		light.position[1] = height(random);
+		light.position[2] = position(random);
+		for (auto& channel : light.color) channel = color(random);
+		m_Lights.push_back(light);
+	}
 }
 
 void Renderer::RenderGui()
@@ -225,6 +522,7 @@ void Renderer::RenderGui()
 		if (ImGui::BeginMenu("Renderer"))
 		{
 			ImGui::MenuItem("Stats", "", &m_IsStatsOpen);
+			ImGui::MenuItem("Profiler", "", &m_IsProfilerOpen);
 
 			ImGui::EndMenu();
 		}
@@ -273,23 +571,30 @@ void Renderer::RenderGui()
 
 			ImGui::Separator();
 
-			if (ImGui::DragFloat3("Position", (float*) &m_LightData.lightPosition, 0.01f, 0.005f, 0.002f, "%.3f", 1.f))
+			auto& light = m_Lights[0];
+			if (ImGui::DragFloat3("Position", light.position, 0.01f, 0.005f, 0.002f, "%.3f", 1.f))
 			{
-				m_Light.SetPosition(DirectX::XMLoadFloat4(&m_LightData.lightPosition));
+				m_Light.SetPosition(DirectX::XMVectorSet(light.position[0], light.position[1], light.position[2], 1.f));
 			}
 
-			if (ImGui::ColorEdit3("Color", (float*)&m_LightData.color))
+			if (ImGui::ColorEdit3("Color", light.color))
 			{
-				m_Light.GetMaterial().color[0] = m_LightData.color.x;
-				m_Light.GetMaterial().color[1] = m_LightData.color.y;
-				m_Light.GetMaterial().color[2] = m_LightData.color.z;
+				m_Light.GetMaterial().color[0] = light.color[0];
+				m_Light.GetMaterial().color[1] = light.color[1];
+				m_Light.GetMaterial().color[2] = light.color[2];
 			}
-			ImGui::DragFloat("Intensity", &m_LightData.intensity, 0.01f, 0.f, FLT_MAX / INT_MAX, "%.3f", 1.f);
+			ImGui::DragFloat("Intensity", &light.intensity, 0.01f, 0.f, FLT_MAX / INT_MAX, "%.3f", 1.f);
 
 			ImGui::Text("Attenuation");
-			ImGui::DragFloat("Constant", &m_LightData.attConstant, 0.01f, 0.f, 10.f, "%.3f", 1.f);
-			ImGui::DragFloat("Linear", &m_LightData.attLinear, 0.001f, 0.f, 1.f, "%.4f", 1.f);
-			ImGui::DragFloat("Quadratic", &m_LightData.attQuadratic, 0.0001f, 0.f, 0.1f, "%.5f", 1.f);
+			ImGui::DragFloat("Constant", &light.attConstant, 0.01f, 0.f, 10.f, "%.3f", 1.f);
+			ImGui::DragFloat("Linear", &light.attLinear, 0.001f, 0.f, 1.f, "%.4f", 1.f);
+			ImGui::DragFloat("Quadratic", &light.attQuadratic, 0.0001f, 0.f, 0.1f, "%.5f", 1.f);
+
+			// Copies of the light above with random positions and colors, to see what many lights cost
+			ImGui::Separator();
+			bool scatter = ImGui::SliderInt("Scattered Lights", &m_ScatteredLights, 0, 1024);
+			scatter |= ImGui::DragFloat("Scatter Radius", &m_ScatterRadius, 0.1f, 1.f, 500.f, "%.1f", 1.f);
+			if (scatter) ScatterLights();
 
 			ImGui::End();
 		}
@@ -313,6 +618,35 @@ void Renderer::RenderGui()
 			ImGui::Separator();
 
 			ImGui::Text("Draw Calls: %d", m_Stats.drawCalls);
+			ImGui::Text("State Changes: %d (%d redundant skipped)", m_Stats.stateChanges, m_Stats.redundantStates);
+			ImGui::Text("Visible Objects: %d", m_Stats.visibleObjects);
+			ImGui::Text("Culled Objects: %d (%d occluded)", m_Stats.culledObjects, m_Stats.occludedObjects);
+			ImGui::Text("Occluder Triangles: %d", m_Stats.occluderTriangles);
+			ImGui::Checkbox("Occlusion Culling", &m_OcclusionCulling);
+			ImGui::Text("Clusters: %d (%d culled)", m_Stats.clusters, m_Stats.culledClusters);
+			ImGui::Checkbox("Cluster Culling", &m_ClusterCulling);
+			ImGui::Text("Lights: %d (%d cluster assignments)", m_Stats.lights, m_Stats.lightAssignments);
+			ImGui::Text("LOD Triangles:");
+			for (unsigned int triangles : m_Stats.lodTriangles)
+			{
+				ImGui::SameLine();
+				ImGui::Text("%d", triangles);
+			}
+			ImGui::SliderFloat("LOD Threshold (px)", &m_LodThreshold, 0.f, 8.f, "%.1f", 1.f);
+
+			ImGui::End();
+		}
+		else
+		{
+			ImGui::End();
+		}
+	}
+
+	if (m_IsProfilerOpen)
+	{
+		if (ImGui::Begin("Profiler", &m_IsProfilerOpen))
+		{
+			DrawProfiler();
 
 			ImGui::End();
 		}
@@ -323,6 +657,110 @@ void Renderer::RenderGui()
 	}
 }
 
+void Renderer::DrawProfiler()
+{
+	auto& frames = Profiler::GetFrames();
+
+	bool paused = Profiler::IsPaused();
+	if (ImGui::Checkbox("Pause", &paused)) Profiler::SetPaused(paused);
+	ImGui::SameLine();
+	if (ImGui::Button("Export Chrome Trace"))
+		m_TraceStatus = Profiler::ExportChromeTrace("profile.json") ? "Written to profile.json" : "Failed to write profile.json";
+	ImGui::SameLine();
+	ImGui::Text("%s", m_TraceStatus);
+
+	if (frames.empty()) return;
+
+	// Clicking a bar of the history picks the frame the timeline shows
+	float frameTimes[Profiler::HistorySize];
+	for (size_t i = 0; i < frames.size(); i++) frameTimes[i] = (frames[i].end - frames[i].begin) / 1e6f;
+	ImGui::PlotHistogram("##Frame Times", frameTimes, (int) frames.size(), 0, "Frame Times (ms)", 0.f, FLT_MAX, ImVec2(-1.f, 60.f));
+	if (ImGui::IsItemHovered() && ImGui::IsMouseClicked(0))
+	{
+		float position = (ImGui::GetMousePos().x - ImGui::GetItemRectMin().x) / ImGui::GetItemRectSize().x;
+		m_ProfilerFrame = (int) frames.size() - 1 - std::clamp((int) (position * frames.size()), 0, (int) frames.size() - 1);
+	}
+
+	m_ProfilerFrame = std::clamp(m_ProfilerFrame, 0, (int) frames.size() - 1);
+	ImGui::SliderInt("Frames Ago", &m_ProfilerFrame, 0, (int) frames.size() - 1);
+	ImGui::SliderFloat("Zoom", &m_ProfilerZoom, 1.f, 50.f, "%.1fx", ImGuiSliderFlags_Logarithmic);
+
+	auto& selected = frames[frames.size() - 1 - m_ProfilerFrame];
+	uint64_t rangeBegin = selected.begin, rangeEnd = std::max(selected.end, selected.begin + 1);
+	ImGui::Text("Frame: %.3f ms, %llu events dropped", (rangeEnd - rangeBegin) / 1e6f, (unsigned long long) Profiler::GetDroppedEvents());
+
+	// Events are kept in the frame they were collected in, which for imports and the GPU isn't the one they ran in.
+	// So the timeline shows everything in the history that overlaps the selected frame
+	auto overlaps = [&](const ProfileEvent& event) { return event.end > rangeBegin && event.begin < rangeEnd; };
+
+	uint32_t trackCount = Profiler::GetTrackCount();
+	std::vector<uint32_t> lanes(trackCount, 0);
+	for (auto& frame : frames)
+	{
+		for (auto& event : frame.events)
+		{
+			if (event.track < trackCount && overlaps(event)) lanes[event.track] = std::max(lanes[event.track], event.depth + 1);
+		}
+	}
+
+	// Every track with something to show gets a lane for each level of nesting, one after the other
+	float rowHeight = ImGui::GetTextLineHeightWithSpacing();
+	std::vector<float> trackOffsets(trackCount, 0.f);
+	float height = 0.f;
+	for (uint32_t track = 0; track < trackCount; track++)
+	{
+		trackOffsets[track] = height;
+		if (lanes[track] > 0) height += (lanes[track] + 0.5f) * rowHeight;
+	}
+
+	if (ImGui::BeginChild("Timeline", ImVec2(0.f, 0.f), true, ImGuiWindowFlags_HorizontalScrollbar))
+	{
+		const float labelWidth = 100.f;
+		float width = std::max(ImGui::GetContentRegionAvail().x - labelWidth, 1.f) * m_ProfilerZoom;
+		float scale = width / (float) (rangeEnd - rangeBegin);
+
+		ImVec2 origin = ImGui::GetCursorScreenPos();
+		auto drawList = ImGui::GetWindowDrawList();
+		float scroll = ImGui::GetScrollX();
+
+		for (auto& frame : frames)
+		{
+			for (auto& event : frame.events)
+			{
+				if (event.track >= trackCount || !overlaps(event)) continue;
+
+				// Events running past the edges of the frame are cut off there
+				float x0 = origin.x + labelWidth + (event.begin > rangeBegin ? event.begin - rangeBegin : 0) * scale;
+				float x1 = origin.x + labelWidth + (std::min(event.end, rangeEnd) - rangeBegin) * scale;
+				float y0 = origin.y + trackOffsets[event.track] + event.depth * rowHeight;
+				ImVec2 min(x0, y0), max(std::max(x1, x0 + 1.f), y0 + rowHeight - 1.f);
+
+				// The same name always gets the same color
+				float hue = (std::hash<std::string_view>()(event.name) % 1024) / 1024.f;
+				drawList->AddRectFilled(min, max, ImColor::HSV(hue, 0.5f, 0.7f));
+				if (max.x - min.x > ImGui::CalcTextSize(event.name).x + 4.f)
+					drawList->AddText(ImVec2(min.x + 2.f, min.y), IM_COL32_WHITE, event.name);
+
+				if (ImGui::IsMouseHoveringRect(min, max) && ImGui::IsWindowHovered())
+					ImGui::SetTooltip("%s: %.3f ms", event.name, (event.end - event.begin) / 1e6f);
+			}
+		}
+
+		// Track names stay on the left while scrolling
+		for (uint32_t track = 0; track < trackCount; track++)
+		{
+			if (lanes[track] == 0) continue;
+
+			ImVec2 min(origin.x + scroll, origin.y + trackOffsets[track]);
+			drawList->AddRectFilled(min, ImVec2(min.x + labelWidth, min.y + lanes[track] * rowHeight), ImGui::GetColorU32(ImGuiCol_WindowBg));
+			drawList->AddText(min, ImGui::GetColorU32(ImGuiCol_Text), Profiler::GetTrackName(track).c_str());
+		}
+
+		ImGui::Dummy(ImVec2(labelWidth + width, height));
+	}
+	ImGui::EndChild();
+}
+
 void Renderer::Resize()
 {
 	// If we currently have a render target or depth stencil, release references to them
@@ -410,4 +848,6 @@ void Renderer::Resize()
 	GraphicsContext::Context->Flush();
 
 	m_MainCamera.Resize((float) bbDesc.Width / (float) bbDesc.Height);
+	m_LightData.tileScale = { (float) LightClusters::ClustersX / bbDesc.Width, (float) LightClusters::ClustersY / bbDesc.Height };
+	m_ViewportHeight = (float) bbDesc.Height;
 }
@@ -1,16 +1,40 @@
 #pragma once
 #include "Primitives/GraphicsContext.h"
 #include "Primitives/Buffer.h"
+#include "Primitives/CommandList.h"
+#include "Primitives/D3D11Backend.h"
+#include "Primitives/Profiler.h"
 #include "Primitives/Shader.h"
 
+#include "Renderer/Culling.h"
+#include "Renderer/LightClusters.h"
+#include "Renderer/Occlusion.h"
+#include "Renderer/RenderQueue.h"
+
 #include "Scene/Camera.h"
 #include "Scene/Scene.h"
+#include "Scene/VertexPacker.h"
 
 class Scene;
 
 struct RendererStats
 {
 	unsigned int drawCalls = 0;
+	unsigned int visibleObjects = 0;
+	unsigned int culledObjects = 0;
+	// Part of culledObjects, inside the frustum but hidden behind occluders
+	unsigned int occludedObjects = 0;
+	unsigned int occluderTriangles = 0;
+	// Meshlets of dense parts tested this frame, and how many of them were outside the frustum or facing away
+	unsigned int clusters = 0;
+	unsigned int culledClusters = 0;
+	unsigned int lights = 0;
+	// Light indices over every cluster, what the pixel shaders loop over
+	unsigned int lightAssignments = 0;
+	// Triangles drawn at every level of detail, the first is the full mesh
+	unsigned int lodTriangles[MeshPart::MaxLods] = {};
+	unsigned int stateChanges = 0;
+	unsigned int redundantStates = 0;
 };
 
 class Renderer
@@ -25,37 +49,125 @@ public:
 	void Resize();
 
 private:
+	// Draws the nearest occluders and drops the visible objects hidden behind them, returns how many are left
+	size_t CullOccluded(const TransformMatrix& viewProjection, size_t visibleCount);
+	// Bins the lights into clusters of the camera's frustum and records the lists for the pixel shader
+	void AssignLights();
+	// Replaces every light after the first with m_ScatteredLights random ones
+	void ScatterLights();
+	// Coarsest level of detail of a part whose error stays within m_LodThreshold pixels. scale takes the part's units to the world's,
+	// depth is the view depth of the nearest point of the object
+	uint32_t SelectLod(const MeshPart& part, float scale, float depth) const;
+	// Frame times of the profiler's history, and a timeline of the selected frame with a lane for every track
+	void DrawProfiler();
+
 	ID3D11RenderTargetView* p_RenderTarget = nullptr;
 	ID3D11DepthStencilView* p_DepthStencil = nullptr;
 
+	// Everything Render() does to the device, replayed by the backend once the frame is built
+	CommandList m_CommandList;
+	CommandBackend* m_Backend;
+
+	ConstantRingBuffer* m_ConstantRing;
 	ConstantBuffer* m_MaterialBuffer;
 
 	RendererStats m_Stats;
 
+	// Slots in Object::GetTransforms() that passed frustum and occlusion culling this frame
+	std::vector<uint32_t> m_VisibleObjects;
+
+	// Nearest few visible occluder meshes are drawn into it every frame, hiding whatever is behind them
+	static constexpr size_t MaxOccluders = 32;
+	OcclusionBuffer m_Occlusion{ 256, 128 };
+	bool m_OcclusionCulling = true;
+	// View depth and slot of every visible object that can occlude
+	std::vector<std::pair<float, uint32_t>> m_Occluders;
+
+	// Parts switch to a coarser level of detail once it is off by no more than this many pixels
+	float m_LodThreshold = 1.f;
+	float m_ViewportHeight = 0.f;
+
+	// Parts drawn at full detail with at least this many meshlets are culled meshlet by meshlet, each object in a draw of its own
+	static constexpr uint32_t MinClusteredMeshlets = 8;
+	bool m_ClusterCulling = true;
+	// Triangles of every meshlet that survived culling this frame, as indices of their part's vertices
+	std::vector<uint32_t> m_ClusterIndices;
+	IndexBuffer* m_ClusterIndexBuffer;
+
+	// Parts of visible objects queued this frame, indexed by the payload of their packet
+	struct DrawItem
+	{
+		Object* object;
+		uint32_t part;
+		uint32_t lod;
+	};
+	std::vector<DrawItem> m_DrawItems;
+
+	// Consecutive packets drawing the same level of detail of a part with the same material, drawn as one instanced call.
+	// Clustered groups draw a single object out of m_ClusterIndexBuffer
+	struct DrawGroup
+	{
+		Object* object;
+		uint32_t part;
+		uint32_t lod;
+		uint32_t pass;
+		bool clustered;
+		unsigned int firstIndex;
+		unsigned int indexCount;
+		unsigned int firstInstance;
+		unsigned int instanceCount;
+		unsigned int materialRecord;
+	};
+	std::vector<DrawGroup> m_DrawGroups;
+
+	// Per-instance stream, one entry per queued part in sorted order
+	struct InstanceData
+	{
+		TransformMatrix world;
+		TransformMatrix worldViewProjection;
+	};
+	std::vector<InstanceData> m_Instances;
+	VertexBuffer* m_InstanceBuffer;
+
+	inline static VertexLayout m_InstanceLayout =
+	{
+		{ "WORLD", ElementDataType::float4, 0, true },
+		{ "WORLD", ElementDataType::float4, 1, true },
+		{ "WORLD", ElementDataType::float4, 2, true },
+		{ "WORLD", ElementDataType::float4, 3, true },
+		{ "WVP", ElementDataType::float4, 0, true },
+		{ "WVP", ElementDataType::float4, 1, true },
+		{ "WVP", ElementDataType::float4, 2, true },
+		{ "WVP", ElementDataType::float4, 3, true }
+	};
+
+	// Draw passes, the first part of every sort key
+	enum RenderPass : uint32_t
+	{
+		OpaquePass, GizmoPass
+	};
+	RenderQueue m_RenderQueue;
+
 	struct LightBuffer
 	{
-		DirectX::XMFLOAT4 lightPosition;
 		DirectX::XMFLOAT3 ambient = { 1.f, 1.f, 1.f };
 		float ambientIntensity = 0.1f;
-		DirectX::XMFLOAT3 color = { 1.f, 1.f, 1.f };
-		float intensity = 1.f;
-		float attConstant = 1.0f;
-		float attLinear = 0.045f;
-		float attQuadratic = 0.0075f;
-
-	private:
-		float p0;
+		// Pixel position to cluster tile, and log2 of view depth to slice, as LightClusters lays them out
+		DirectX::XMFLOAT2 tileScale = { 0.f, 0.f };
+		float sliceScale = 0.f;
+		float sliceBias = 0.f;
 	};
 	ConstantBuffer* m_LightBuffer;
 	LightBuffer m_LightData;
 
-	struct ObjectBuffer
-	{
-		DirectX::XMMATRIX world;
-		DirectX::XMMATRIX worldViewProjection;
-	};
-	ConstantBuffer* m_ObjectBuffer;
-	ObjectBuffer m_ObjectData;
+	// The first light is the one the light gizmo shows and the Light Controls edit
+	std::vector<PointLight> m_Lights = { { { 0.f, 0.f, 0.f }, 0.f, { 1.f, 1.f, 1.f }, 1.f, 1.f, 0.045f, 0.0075f, 0.f } };
+	int m_ScatteredLights = 0;
+	float m_ScatterRadius = 50.f;
+	LightClusters m_LightClusters;
+	StructuredBuffer* m_LightList;
+	StructuredBuffer* m_ClusterList;
+	StructuredBuffer* m_LightIndexList;
 
 	struct CameraBuffer
 	{
@@ -64,7 +176,8 @@ private:
 	ConstantBuffer* m_CameraBuffer;
 	CameraBuffer m_CameraData;
 
-	VertexShader* m_UnlitVS;
+	// A permutation for every combination of VertexAttributes, indexed by them
+	VertexShader* m_UnlitVS[VertexAllAttributes + 1] = {};
 
 	PixelShader* m_UnlitSolidPS;
 	PixelShader* m_LitSolidPS;
@@ -84,4 +197,10 @@ private:
 
 	bool m_IsStatsOpen = false;
 	float m_DeltaTime = 0.f;
+
+	bool m_IsProfilerOpen = false;
+	// How many frames before the newest the timeline shows, and how many times wider than the window it is
+	int m_ProfilerFrame = 0;
+	float m_ProfilerZoom = 1.f;
+	const char* m_TraceStatus = "";
 };
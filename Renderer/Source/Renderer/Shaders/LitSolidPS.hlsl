@@ -1,14 +1,33 @@
 cbuffer LightBuffer : register(b0)
 {
-	float4 lightPosition;
 	float3 ambientColor;
 	float ambientIntensity;
+	float2 tileScale;
+	float sliceScale;
+	float sliceBias;
+}
+
+// Must match LightClusters
+static const uint ClustersX = 16;
+static const uint ClustersY = 9;
+static const uint ClustersZ = 24;
+
+struct PointLight
+{
+	float3 position;
+	float range;
 	float3 color;
-	float lightIntensity;
+	float intensity;
 	float attConstant;
 	float attLinear;
 	float attQuadratic;
-}
+	float padding;
+};
+
+StructuredBuffer<PointLight> lights : register(t0);
+// First index into lightIndices and light count of every cluster
+StructuredBuffer<uint2> clusters : register(t1);
+StructuredBuffer<uint> lightIndices : register(t2);
 
 cbuffer MaterialBuffer : register(b1)
 {
@@ -38,31 +57,44 @@ float4 main(PSIn input) : SV_TARGET
 	input.normal = normalize(input.normal);
 	
 	float3 ambientValue = ambientColor * ambientIntensity * ambientReflection;
+	float3 view = normalize(input.worldPosition.xyz - cameraPosition.xyz);
 	
-	float3 lightDirection = lightPosition.xyz - input.worldPosition.xyz;
-	float distance = length(lightDirection);
-	lightDirection /= distance;
-	distance *= distance;
-	
-	float attenuation = 1.0f / (attConstant + attLinear * distance + attQuadratic * (distance * distance));
-	
-	float normalDot = max(dot(lightDirection, input.normal), 0.f);
-	float intensity = saturate(normalDot);
+	// w of the pixel position is the view depth
+	uint3 cluster = uint3(input.outPosition.xy * tileScale, max(log2(input.outPosition.w) * sliceScale + sliceBias, 0.f));
+	cluster = min(cluster, uint3(ClustersX - 1, ClustersY - 1, ClustersZ - 1));
+	uint2 list = clusters[(cluster.z * ClustersY + cluster.y) * ClustersX + cluster.x];
 	
-	float3 diffuseValue = intensity * color * lightIntensity * diffuseReflection * attenuation;
-	
-	if (length(diffuseValue) != 0)
+	float3 diffuseValue = 0.f;
+	float3 specularValue = 0.f;
+	for (uint i = 0; i < list.y; i++)
 	{
-		float3 reflection = reflect(lightDirection, input.normal);
-		float3 view = normalize(input.worldPosition.xyz - cameraPosition.xyz);
-		float viewDot = max(dot(reflection, view), 0.f);
-		intensity = pow(saturate(viewDot), shininess);
-	
-		float3 specularValue = intensity * color * lightIntensity * specularReflection * attenuation;
+		PointLight light = lights[lightIndices[list.x + i]];
+		
+		float3 lightDirection = light.position - input.worldPosition.xyz;
+		float distance = length(lightDirection);
+		if (distance > light.range) continue;
+		
+		lightDirection /= distance;
+		distance *= distance;
+		
+		float attenuation = 1.0f / (light.attConstant + light.attLinear * distance + light.attQuadratic * (distance * distance));
+		
+		float normalDot = max(dot(lightDirection, input.normal), 0.f);
+		float intensity = saturate(normalDot);
+		
+		float3 diffuse = intensity * light.color * light.intensity * diffuseReflection * attenuation;
+		diffuseValue += diffuse;
+		
+		if (length(diffuse) != 0)
+		{
+			float3 reflection = reflect(lightDirection, input.normal);
+			float viewDot = max(dot(reflection, view), 0.f);
+			intensity = pow(saturate(viewDot), shininess);
 		
-		return float4(saturate(ambientValue + diffuseValue + specularValue) * input.color.rgb, input.color.a) * materialColor;
+			specularValue += intensity * light.color * light.intensity * specularReflection * attenuation;
+		}
 	}
 	
-	return float4(saturate(ambientValue) * input.color.rgb, input.color.a) * materialColor;
+	return float4(saturate(ambientValue + diffuseValue + specularValue) * input.color.rgb, input.color.a) * materialColor;
 
 }
\ No newline at end of file
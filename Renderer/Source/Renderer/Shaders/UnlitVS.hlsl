@@ -1,15 +1,29 @@
-cbuffer ObjectBuffer : register(b0)
-{
-	row_major float4x4 world;
-	row_major float4x4 worldViewProjection;
-}
+// Which attributes the mesh's layout has, see VertexAttributes. UnlitVS0.hlsl to UnlitVS7.hlsl build a permutation
+// for every combination by defining HAS_NORMAL, HAS_COLOR and HAS_TEXCOORD, this file isn't compiled on its own
 
 struct VSIn
 {
 	float3 position : POSITION;
-	float3 normal : NORMAL;
+#if HAS_NORMAL
+	// Octahedral encoded, see VertexPacker
+	float2 normal : NORMAL;
+#endif
+#if HAS_COLOR
 	float4 color : COLOR;
+#endif
+#if HAS_TEXCOORD
 	float2 texcoord : TEXCOORD;
+#endif
+
+	// Per-instance matrix rows
+	float4 world0 : WORLD0;
+	float4 world1 : WORLD1;
+	float4 world2 : WORLD2;
+	float4 world3 : WORLD3;
+	float4 worldViewProjection0 : WVP0;
+	float4 worldViewProjection1 : WVP1;
+	float4 worldViewProjection2 : WVP2;
+	float4 worldViewProjection3 : WVP3;
 };
 
 struct VSOut
@@ -21,14 +35,39 @@ struct VSOut
 	float4 outPosition : SV_POSITION;
 };
 
+float3 DecodeOctahedral(float2 encoded)
+{
+	float3 normal = float3(encoded, 1.f - abs(encoded.x) - abs(encoded.y));
+	float fold = saturate(-normal.z);
+	normal.xy += normal.xy >= 0.f ? -fold : fold;
+	return normalize(normal);
+}
+
 VSOut main(VSIn input)
 {
 	VSOut output;
 	
+	float4x4 world = float4x4(input.world0, input.world1, input.world2, input.world3);
+	float4x4 worldViewProjection = float4x4(input.worldViewProjection0, input.worldViewProjection1, input.worldViewProjection2, input.worldViewProjection3);
+
 	output.worldPosition = mul(float4(input.position, 1.f), world);
-	output.normal = mul(float4(input.normal, 0.f), world).xyz;
+	// Missing attributes get the same defaults the importer gives meshes without them
+#if HAS_NORMAL
+	float3 normal = DecodeOctahedral(input.normal);
+#else
+	float3 normal = float3(0.f, 0.f, 1.f);
+#endif
+#if HAS_COLOR
 	output.color = input.color;
+#else
+	output.color = float4(1.f, 1.f, 1.f, 1.f);
+#endif
+#if HAS_TEXCOORD
 	output.texcoord = input.texcoord;
+#else
+	output.texcoord = float2(0.f, 0.f);
+#endif
+	output.normal = mul(float4(normal, 0.f), world).xyz;
 	output.outPosition = mul(float4(input.position, 1.f), worldViewProjection);
 	
 	return output;
@@ -0,0 +1,5 @@
+// UnlitVS for layouts with the VertexAttributes 0, loaded as UnlitVS0.cso
+#define HAS_NORMAL 0
+#define HAS_COLOR 0
+#define HAS_TEXCOORD 0
+#include "UnlitVS.hlsl"
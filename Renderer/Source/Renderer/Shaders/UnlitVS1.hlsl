@@ -0,0 +1,5 @@
+// UnlitVS for layouts with the VertexAttributes 1, loaded as UnlitVS1.cso
+#define HAS_NORMAL 1
+#define HAS_COLOR 0
+#define HAS_TEXCOORD 0
+#include "UnlitVS.hlsl"
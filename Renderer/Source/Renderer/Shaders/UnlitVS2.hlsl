@@ -0,0 +1,5 @@
+// UnlitVS for layouts with the VertexAttributes 2, loaded as UnlitVS2.cso
+#define HAS_NORMAL 0
+#define HAS_COLOR 1
+#define HAS_TEXCOORD 0
+#include "UnlitVS.hlsl"
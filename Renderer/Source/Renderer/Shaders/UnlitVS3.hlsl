@@ -0,0 +1,5 @@
+// UnlitVS for layouts with the VertexAttributes 3, loaded as UnlitVS3.cso
+#define HAS_NORMAL 1
+#define HAS_COLOR 1
+#define HAS_TEXCOORD 0
+#include "UnlitVS.hlsl"
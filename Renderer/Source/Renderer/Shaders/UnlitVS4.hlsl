@@ -0,0 +1,5 @@
+// UnlitVS for layouts with the VertexAttributes 4, loaded as UnlitVS4.cso
+#define HAS_NORMAL 0
+#define HAS_COLOR 0
+#define HAS_TEXCOORD 1
+#include "UnlitVS.hlsl"
@@ -0,0 +1,5 @@
+// UnlitVS for layouts with the VertexAttributes 5, loaded as UnlitVS5.cso
+#define HAS_NORMAL 1
+#define HAS_COLOR 0
+#define HAS_TEXCOORD 1
+#include "UnlitVS.hlsl"
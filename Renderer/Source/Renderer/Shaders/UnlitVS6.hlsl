@@ -0,0 +1,5 @@
+// UnlitVS for layouts with the VertexAttributes 6, loaded as UnlitVS6.cso
+#define HAS_NORMAL 0
+#define HAS_COLOR 1
+#define HAS_TEXCOORD 1
+#include "UnlitVS.hlsl"
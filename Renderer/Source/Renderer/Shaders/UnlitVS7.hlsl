@@ -0,0 +1,5 @@
+// UnlitVS for layouts with the VertexAttributes 7, loaded as UnlitVS7.cso
+#define HAS_NORMAL 1
+#define HAS_COLOR 1
+#define HAS_TEXCOORD 1
+#include "UnlitVS.hlsl"
@@ -0,0 +1,73 @@
+#include <algorithm>
+
+#include "AsyncLoader.h"
+#include "Primitives/Profiler.h"
+
+AsyncLoader::AsyncLoader(ImportFunction import, unsigned int workerCount)
+	: m_Import(std::move(import))
+{
+	// Imports are heavy on memory, so only use part of the machine by default
+	if (workerCount == 0) workerCount = std::clamp(std::thread::hardware_concurrency() / 2, 1u, 4u);
+
+	for (unsigned int i = 0; i < workerCount; i++)
+		m_Workers.emplace_back(&AsyncLoader::Work, this);
+}
+
+AsyncLoader::~AsyncLoader()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Stopping = true;
+		m_Queued.clear();
+	}
+	m_WorkAvailable.notify_all();
+
+	for (auto& worker : m_Workers) worker.join();
+}
+
+std::shared_ptr<ImportJob> AsyncLoader::Submit(std::string name, std::string file)
+{
+	auto job = std::make_shared<ImportJob>();
+	job->name = std::move(name);
+	job->file = std::move(file);
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Queued.push_back(job);
+	}
+	m_WorkAvailable.notify_one();
+
+	return job;
+}
+
+void AsyncLoader::Work()
+{
+	Profiler::SetThreadName("Loader");
+
+	while (true)
+	{
+		std::shared_ptr<ImportJob> job;
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_WorkAvailable.wait(lock, [this]() { return m_Stopping || !m_Queued.empty(); });
+			if (m_Stopping) return;
+
+			job = std::move(m_Queued.front());
+			m_Queued.pop_front();
+		}
+
+		// A failed import just fails the job, it must never take the worker down with it
+		try
+		{
+			PROFILE_SCOPE("Import");
+			job->succeeded = m_Import(job->file, job->data, &job->progress);
+		}
+		catch (...)
+		{
+			job->succeeded = false;
+		}
+
+		job->progress.store(1.f);
+		m_Completed.Push(std::move(job));
+	}
+}
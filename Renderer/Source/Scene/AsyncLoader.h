@@ -0,0 +1,61 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CompletionQueue.h"
+#include "MeshImporter.h"
+
+// A file being imported in the background
+struct ImportJob
+{
+	std::string name;
+	std::string file;
+
+	// From 0 to 1, written by the worker and fine to read from any thread
+	std::atomic<float> progress = 0.f;
+
+	// Only valid once the job has come out of AsyncLoader::PopCompleted()
+	bool succeeded = false;
+	MeshData data;
+};
+
+// Runs imports on a few worker threads and hands the finished ones back through a lock-free queue.
+// Knows nothing about the GPU, creating buffers from the results is up to whoever pops them.
+class AsyncLoader
+{
+public:
+	typedef std::function<bool(const std::string& file, MeshData& data, std::atomic<float>* progress)> ImportFunction;
+
+	// A worker count of zero picks one based on the number of hardware threads
+	AsyncLoader(ImportFunction import, unsigned int workerCount = 0);
+	// Jobs that haven't started are dropped, running ones are waited for
+	~AsyncLoader();
+
+	std::shared_ptr<ImportJob> Submit(std::string name, std::string file);
+
+	// Appends every job finished since the last call to completed, never blocks
+	size_t PopCompleted(std::vector<std::shared_ptr<ImportJob>>& completed) { return m_Completed.PopAll(completed); }
+
+	size_t GetWorkerCount() const { return m_Workers.size(); }
+
+private:
+	void Work();
+
+	ImportFunction m_Import;
+	std::vector<std::thread> m_Workers;
+
+	// Submission is rare, so waiting for work can use a plain lock
+	std::mutex m_Mutex;
+	std::condition_variable m_WorkAvailable;
+	std::deque<std::shared_ptr<ImportJob>> m_Queued;
+	bool m_Stopping = false;
+
+	CompletionQueue<std::shared_ptr<ImportJob>> m_Completed;
+};
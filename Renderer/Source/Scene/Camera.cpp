@@ -8,6 +8,7 @@ Camera::Camera(ProjectionMode mode, float aspectRatio, float nearPlane, float fa
 	else
 		m_Projection = DirectX::XMMatrixOrthographicLH(aspectRatio * 2.f, 2.f, nearPlane, farPlane);
 
+	m_View = DirectX::XMMatrixIdentity();
 	m_ViewProjection = m_Projection;
 }
 
@@ -16,7 +17,8 @@ void Camera::SetPosition(DirectX::XMVECTOR position)
 	m_Position = position;
 	auto transformation = DirectX::XMMatrixRotationRollPitchYawFromVector(m_Rotation) * DirectX::XMMatrixTranslationFromVector(m_Position);
 
-	m_ViewProjection = DirectX::XMMatrixInverse(nullptr, transformation) * m_Projection;
+	m_View = DirectX::XMMatrixInverse(nullptr, transformation);
+	m_ViewProjection = m_View * m_Projection;
 }
 
 void Camera::SetRotation(DirectX::XMVECTOR rotation)
@@ -24,7 +26,8 @@ void Camera::SetRotation(DirectX::XMVECTOR rotation)
 	m_Rotation = rotation;
 	auto transformation = DirectX::XMMatrixRotationRollPitchYawFromVector(m_Rotation) * DirectX::XMMatrixTranslationFromVector(m_Position);
 
-	m_ViewProjection = DirectX::XMMatrixInverse(nullptr, transformation) * m_Projection;
+	m_View = DirectX::XMMatrixInverse(nullptr, transformation);
+	m_ViewProjection = m_View * m_Projection;
 }
 
 void Camera::Resize(float aspectRatio)
@@ -37,5 +40,12 @@ void Camera::Resize(float aspectRatio)
 		m_Projection = DirectX::XMMatrixOrthographicLH(aspectRatio * 2.f, 2.f, m_NearPlane, m_FarPlane);
 
 	auto transformation = DirectX::XMMatrixRotationRollPitchYawFromVector(m_Rotation) * DirectX::XMMatrixTranslationFromVector(m_Position);
-	m_ViewProjection = DirectX::XMMatrixInverse(nullptr, transformation) * m_Projection;
+	m_View = DirectX::XMMatrixInverse(nullptr, transformation);
+	m_ViewProjection = m_View * m_Projection;
+}
+
+float Camera::GetProjectedSize(float size, float depth, float viewportHeight) const
+{
+	float pixels = size * DirectX::XMVectorGetY(m_Projection.r[1]) * viewportHeight * 0.5f;
+	return m_Mode == ProjectionMode::Perspective ? pixels / depth : pixels;
 }
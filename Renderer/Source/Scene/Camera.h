@@ -17,7 +17,14 @@ public:
 	void Resize(float aspectRatio);
 
 	DirectX::XMMATRIX GetViewProjection() { return m_ViewProjection; }
+	DirectX::XMMATRIX GetView() { return m_View; }
+	DirectX::XMMATRIX GetProjection() { return m_Projection; }
 	DirectX::XMVECTOR GetPosition() { return m_Position; }
+	float GetNearPlane() const { return m_NearPlane; }
+	float GetFarPlane() const { return m_FarPlane; }
+
+	// Screen height in pixels of something size units tall at a view depth, depth is ignored by orthographic cameras
+	float GetProjectedSize(float size, float depth, float viewportHeight) const;
 
 private:
 	DirectX::XMMATRIX m_Projection;
@@ -25,6 +32,7 @@ private:
 	DirectX::XMVECTOR m_Position;
 	DirectX::XMVECTOR m_Rotation;
 
+	DirectX::XMMATRIX m_View;
 	DirectX::XMMATRIX m_ViewProjection;
 
 	ProjectionMode m_Mode;
@@ -0,0 +1,70 @@
+#pragma once
+#include <atomic>
+#include <utility>
+#include <vector>
+
+// Queue that any number of threads can push to without locking, drained by a single consumer.
+// Producers push onto an atomic list head and the consumer takes the whole list at once, so there is no ABA to worry about.
+template<typename T>
+class CompletionQueue
+{
+public:
+	CompletionQueue() = default;
+	CompletionQueue(const CompletionQueue& other) = delete;
+
+	~CompletionQueue()
+	{
+		Node* node = m_Head.exchange(nullptr);
+		while (node)
+		{
+			Node* next = node->next;
+			delete node;
+			node = next;
+		}
+	}
+
+	void Push(T value)
+	{
+		Node* node = new Node{ std::move(value), m_Head.load(std::memory_order_relaxed) };
+		while (!m_Head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	// Appends everything pushed so far to out, oldest first. Returns how many were taken
+	size_t PopAll(std::vector<T>& out)
+	{
+		Node* node = m_Head.exchange(nullptr, std::memory_order_acquire);
+
+		// The list is newest first
+		Node* reversed = nullptr;
+		while (node)
+		{
+			Node* next = node->next;
+			node->next = reversed;
+			reversed = node;
+			node = next;
+		}
+
+		size_t count = 0;
+		while (reversed)
+		{
+			out.push_back(std::move(reversed->value));
+			Node* next = reversed->next;
+			delete reversed;
+			reversed = next;
+			++count;
+		}
+
+		return count;
+	}
+
+	bool IsEmpty() const { return m_Head.load(std::memory_order_acquire) == nullptr; }
+
+private:
+	struct Node
+	{
+		T value;
+		Node* next;
+	};
+
+	std::atomic<Node*> m_Head = nullptr;
+};
@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "Mesh.h"
+#include "VertexPacker.h"
+
+Mesh::~Mesh()
+{
+	GeometryPool::Free(m_Allocation);
+}
+
+std::shared_ptr<Mesh> Mesh::Load(const std::string& file)
+{
+	MeshData data;
+	if (!MeshImporter::Import(file, data)) return nullptr;
+
+	auto mesh = Create(std::move(data));
+	size_t budget = SIZE_MAX;
+	mesh->Upload(budget);
+
+	return mesh;
+}
+
+std::shared_ptr<Mesh> Mesh::Create(MeshData&& data)
+{
+	// Somebody may already have loaded a file with the same contents
+	if (data.hashed)
+	{
+		auto it = m_Loaded.find(data.hash);
+		if (it != m_Loaded.end())
+		{
+			if (auto loaded = it->second.lock()) return loaded;
+		}
+	}
+
+	auto mesh = std::make_shared<Mesh>();
+	mesh->m_Layout = data.layout;
+	mesh->m_Attributes = VertexPacker::GetAttributes(data.layout);
+	mesh->m_VertexCount = data.vertexCount;
+	mesh->m_IndexCount = data.GetIndexCount();
+	mesh->m_Parts = std::move(data.parts);
+	for (auto& part : mesh->m_Parts) mesh->m_TriangleCount += part.indexCount / 3;
+	mesh->m_OccluderPositions = std::move(data.occluderPositions);
+	mesh->m_OccluderIndices = std::move(data.occluderIndices);
+	mesh->m_Meshlets = std::move(data.meshlets);
+	mesh->m_MeshletVertices = std::move(data.meshletVertices);
+	mesh->m_MeshletTriangles = std::move(data.meshletTriangles);
+	mesh->m_PartMeshlets = std::move(data.partMeshlets);
+	memcpy(mesh->m_BoundsMin, data.boundsMin, sizeof(mesh->m_BoundsMin));
+	memcpy(mesh->m_BoundsMax, data.boundsMax, sizeof(mesh->m_BoundsMax));
+
+	// What is left of data is the geometry to upload
+	bool hashed = data.hashed;
+	uint64_t hash = data.hash;
+	mesh->m_Pending = std::move(data);
+
+	mesh->m_Allocation = GeometryPool::Allocate(mesh->m_Layout, (unsigned int) mesh->m_VertexCount, (unsigned int) mesh->m_IndexCount);
+
+	// Registered straight away, so a second copy finishing its import while this one uploads waits for it instead
+	if (hashed) m_Loaded[hash] = mesh;
+	return mesh;
+}
+
+bool Mesh::Upload(size_t& budget)
+{
+	size_t stride = m_Layout.stride;
+	if (m_UploadedVertices < m_VertexCount)
+	{
+		size_t count = std::min(m_VertexCount - m_UploadedVertices, std::max<size_t>(budget / stride, 1));
+		m_Allocation.vertexBuffer->Update(m_Pending.GetVertices() + m_UploadedVertices * stride, m_Allocation.vertexOffset + (unsigned int) m_UploadedVertices, (unsigned int) count);
+		m_UploadedVertices += count;
+		budget -= std::min(budget, count * stride);
+	}
+
+	if (budget > 0 && m_UploadedVertices == m_VertexCount && m_UploadedIndices < m_IndexCount)
+	{
+		size_t count = std::min(m_IndexCount - m_UploadedIndices, std::max<size_t>(budget / sizeof(unsigned int), 1));
+		m_Allocation.indexBuffer->Update(m_Pending.GetIndices() + m_UploadedIndices, m_Allocation.indexOffset + (unsigned int) m_UploadedIndices, (unsigned int) count);
+		m_UploadedIndices += count;
+		budget -= std::min(budget, count * sizeof(unsigned int));
+	}
+
+	if (!IsUploaded()) return false;
+
+	// The GPU copy is all that's needed from here on, this also unmaps the cache
+	m_Pending = MeshData();
+	return true;
+}
+
+float Mesh::GetUploadProgress() const
+{
+	size_t total = m_VertexCount * m_Layout.stride + m_IndexCount * sizeof(unsigned int);
+	if (total == 0) return 1.f;
+
+	return (float) (m_UploadedVertices * m_Layout.stride + m_UploadedIndices * sizeof(unsigned int)) / total;
+}
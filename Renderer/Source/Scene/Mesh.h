@@ -0,0 +1,91 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Primitives/GeometryPool.h"
+#include "MeshImporter.h"
+
+// Geometry loaded from a file, shared between every object that uses the same file contents.
+// Lives in a range of the GeometryPool buffers and is drawn as one draw per part.
+// Objects drawing the same mesh can be batched into a single instanced draw per part.
+class Mesh
+{
+public:
+	Mesh() = default;
+	Mesh(const Mesh& other) = delete;
+	~Mesh();
+
+	// Imports and uploads on the calling thread. Returns nullptr if the import failed
+	static std::shared_ptr<Mesh> Load(const std::string& file);
+
+	// Returns the already loaded mesh if one with the same contents exists, otherwise a new one with an empty range
+	// of the shared buffers that Upload() has to fill before it can be drawn
+	static std::shared_ptr<Mesh> Create(MeshData&& data);
+
+	// Copies the next part of the geometry to the GPU, taking what it copied off budget, which is in bytes.
+	// Always makes some progress. Returns whether everything is uploaded
+	bool Upload(size_t& budget);
+	bool IsUploaded() const { return m_UploadedVertices == m_VertexCount && m_UploadedIndices == m_IndexCount; }
+	float GetUploadProgress() const;
+
+	size_t GetVertexCount() const { return m_VertexCount; }
+	size_t GetTriangleCount() const { return m_TriangleCount; }
+	// Picked by VertexPacker for whatever the mesh contains
+	const VertexLayout& GetLayout() const { return m_Layout; }
+	// The VertexAttributes of the layout, for picking the vertex shader permutation that reads it
+	uint32_t GetAttributes() const { return m_Attributes; }
+
+	// Shared with other meshes, the part offsets are relative to GetBaseVertex() and GetFirstIndex()
+	const VertexBuffer* GetVertexBuffer() const { return m_Allocation.vertexBuffer; }
+	const IndexBuffer* GetIndexBuffer() const { return m_Allocation.indexBuffer; }
+	unsigned int GetBaseVertex() const { return m_Allocation.vertexOffset; }
+	unsigned int GetFirstIndex() const { return m_Allocation.indexOffset; }
+	const std::vector<MeshPart>& GetParts() const { return m_Parts; }
+
+	// Meshes simple enough to be drawn into the occlusion buffer keep a copy of their triangles, with every part in place
+	bool IsOccluder() const { return !m_OccluderIndices.empty(); }
+	const std::vector<float>& GetOccluderPositions() const { return m_OccluderPositions; }
+	const std::vector<uint32_t>& GetOccluderIndices() const { return m_OccluderIndices; }
+
+	// Meshlets of the full level of detail of every part, kept on the CPU for cluster culling
+	const std::vector<Meshlet>& GetMeshlets() const { return m_Meshlets; }
+	const std::vector<uint32_t>& GetMeshletVertices() const { return m_MeshletVertices; }
+	const std::vector<uint8_t>& GetMeshletTriangles() const { return m_MeshletTriangles; }
+	// First meshlet and number of meshlets of a part
+	std::pair<uint32_t, uint32_t> GetPartMeshlets(size_t part) const { return m_PartMeshlets[part]; }
+
+	const float* GetBoundsMin() const { return m_BoundsMin; }
+	const float* GetBoundsMax() const { return m_BoundsMax; }
+
+private:
+	// Packed vertices and indices waiting to be uploaded, in the arrays or the cache mapping of the data they came with.
+	// Released once they are on the GPU
+	MeshData m_Pending;
+	size_t m_VertexCount = 0;
+	VertexLayout m_Layout = {};
+	uint32_t m_Attributes = 0;
+	size_t m_IndexCount = 0;
+	size_t m_UploadedVertices = 0;
+	size_t m_UploadedIndices = 0;
+
+	std::vector<MeshPart> m_Parts;
+	size_t m_TriangleCount = 0;
+
+	std::vector<float> m_OccluderPositions;
+	std::vector<uint32_t> m_OccluderIndices;
+
+	std::vector<Meshlet> m_Meshlets;
+	std::vector<uint32_t> m_MeshletVertices;
+	std::vector<uint8_t> m_MeshletTriangles;
+	std::vector<std::pair<uint32_t, uint32_t>> m_PartMeshlets;
+
+	GeometryAllocation m_Allocation;
+
+	float m_BoundsMin[3] = {};
+	float m_BoundsMax[3] = {};
+
+	// Keyed by the content hash of the source file, expired entries are replaced on the next load
+	inline static std::unordered_map<uint64_t, std::weak_ptr<Mesh>> m_Loaded;
+};
@@ -0,0 +1,241 @@
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "MeshCache.h"
+
+namespace
+{
+	// Offset of every section from the start of the file, all kept 16-byte aligned
+	uint64_t AlignUp(uint64_t offset)
+	{
+		return (offset + 15) & ~uint64_t(15);
+	}
+
+	// Replaces to with from in one step, so readers either see the old file or the new one
+	bool MoveOver(const std::string& from, const std::string& to)
+	{
+#ifdef _WIN32
+		auto widen = [](const std::string& path)
+		{
+			std::wstring wide(MultiByteToWideChar(CP_ACP, 0, path.c_str(), -1, nullptr, 0), L'\0');
+			MultiByteToWideChar(CP_ACP, 0, path.c_str(), -1, &wide[0], (int) wide.size());
+			return wide;
+		};
+		return MoveFileExW(widen(from).c_str(), widen(to).c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+		return rename(from.c_str(), to.c_str()) == 0;
+#endif
+	}
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+bool MappedFile::Open(const std::string& path)
+{
+	Close();
+
+#ifdef _WIN32
+	// Sharing delete lets a new cache be moved over one that is still mapped
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) return false;
+	p_File = file;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+	{
+		Close();
+		return false;
+	}
+	m_Size = (size_t) size.QuadPart;
+
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping == NULL)
+	{
+		Close();
+		return false;
+	}
+	p_Mapping = mapping;
+
+	p_Data = (const uint8_t*) MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+	m_File = open(path.c_str(), O_RDONLY);
+	if (m_File < 0) return false;
+
+	struct stat info;
+	if (fstat(m_File, &info) != 0 || info.st_size == 0)
+	{
+		Close();
+		return false;
+	}
+	m_Size = (size_t) info.st_size;
+
+	void* data = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, m_File, 0);
+	p_Data = data == MAP_FAILED ? nullptr : (const uint8_t*) data;
+#endif
+
+	if (p_Data == nullptr)
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+void MappedFile::Close()
+{
+#ifdef _WIN32
+	if (p_Data) UnmapViewOfFile(p_Data);
+	if (p_Mapping) CloseHandle(p_Mapping);
+	if (p_File) CloseHandle(p_File);
+	p_Mapping = nullptr;
+	p_File = nullptr;
+#else
+	if (p_Data) munmap((void*) p_Data, m_Size);
+	if (m_File >= 0) close(m_File);
+	m_File = -1;
+#endif
+
+	p_Data = nullptr;
+	m_Size = 0;
+}
+
+std::string MeshCache::GetCachePath(const std::string& sourceFile)
+{
+	return sourceFile + ".meshcache";
+}
+
+uint64_t MeshCache::Hash(const void* data, size_t size, uint64_t hash)
+{
+	// More than enough to tell two versions of a mesh apart
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= ((const uint8_t*) data)[i];
+		hash *= 0x100000001b3ull;
+	}
+
+	return hash;
+}
+
+bool MeshCache::HashSource(const std::string& sourceFile, uint64_t salt, uint64_t& hash)
+{
+	MappedFile file;
+	if (!file.Open(sourceFile)) return false;
+
+	hash = Hash(&salt, sizeof(salt));
+	hash = Hash(file.GetData(), file.GetSize(), hash);
+
+	return true;
+}
+
+bool MeshCache::Open(const std::string& cacheFile, uint64_t sourceHash, const uint32_t (&strides)[MeshCacheSectionCount])
+{
+	if (!m_File.Open(cacheFile)) return false;
+
+	// Validate everything before handing out pointers into the mapping, a stale or truncated file is just a miss
+	bool valid = m_File.GetSize() >= sizeof(MeshCacheHeader);
+	if (valid)
+	{
+		auto& header = GetHeader();
+		valid = header.magic == Magic && header.version == Version && header.sourceHash == sourceHash;
+
+		// Sections follow each other in order, each inside the file
+		uint64_t end = sizeof(MeshCacheHeader);
+		for (uint32_t i = 0; i < MeshCacheSectionCount && valid; i++)
+		{
+			auto& section = header.sections[i];
+			valid = (strides[i] == 0 || section.stride == strides[i]) && section.offset >= end && section.offset % 16 == 0;
+			end = section.offset + uint64_t(section.count) * section.stride;
+		}
+		valid = valid && end <= m_File.GetSize() && CheckDependencies();
+	}
+
+	if (!valid)
+	{
+		m_File.Close();
+		return false;
+	}
+
+	return true;
+}
+
+bool MeshCache::CheckDependencies() const
+{
+	if (GetStride(MeshCacheDependencies) != sizeof(MeshCacheDependency) || GetStride(MeshCacheDependencyPaths) != 1) return false;
+
+	auto dependencies = Get<MeshCacheDependency>(MeshCacheDependencies);
+	auto paths = Get<char>(MeshCacheDependencyPaths);
+	for (uint32_t i = 0; i < GetCount(MeshCacheDependencies); i++)
+	{
+		auto& dependency = dependencies[i];
+		if (uint64_t(dependency.pathOffset) + dependency.pathLength > GetCount(MeshCacheDependencyPaths)) return false;
+
+		uint64_t hash;
+		if (!HashSource(std::string(paths + dependency.pathOffset, dependency.pathLength), 0, hash) || hash != dependency.hash) return false;
+	}
+
+	return true;
+}
+
+bool MeshCache::Write(const std::string& cacheFile, uint64_t sourceHash, const MeshCacheData (&sections)[MeshCacheSectionCount],
+	const float boundsMin[3], const float boundsMax[3])
+{
+	MeshCacheHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = Magic;
+	header.version = Version;
+	header.sourceHash = sourceHash;
+	memcpy(header.boundsMin, boundsMin, sizeof(header.boundsMin));
+	memcpy(header.boundsMax, boundsMax, sizeof(header.boundsMax));
+
+	uint64_t end = sizeof(MeshCacheHeader);
+	for (uint32_t i = 0; i < MeshCacheSectionCount; i++)
+	{
+		uint64_t offset = AlignUp(end);
+		end = offset + uint64_t(sections[i].count) * sections[i].stride;
+		// Offsets are 32-bit, and a file that big isn't worth caching anyway
+		if (end > UINT32_MAX) return false;
+
+		header.sections[i] = { (uint32_t) offset, sections[i].count, sections[i].stride };
+	}
+
+	// Write to a temporary file first, so a crash halfway through never leaves a broken cache behind.
+	// Imports can run on several threads, so two of them writing the same cache mustn't share it
+	std::string tempFile = cacheFile + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+	FILE* file = fopen(tempFile.c_str(), "wb");
+	if (file == nullptr) return false;
+
+	static const uint8_t zeroes[16] = {};
+	bool written = fwrite(&header, sizeof(header), 1, file) == 1;
+	uint64_t position = sizeof(header);
+	for (uint32_t i = 0; i < MeshCacheSectionCount && written; i++)
+	{
+		size_t padding = (size_t) (header.sections[i].offset - position);
+		size_t bytes = size_t(sections[i].count) * sections[i].stride;
+		written = fwrite(zeroes, 1, padding, file) == padding && (bytes == 0 || fwrite(sections[i].data, 1, bytes, file) == bytes);
+		position = header.sections[i].offset + bytes;
+	}
+	written = fclose(file) == 0 && written;
+
+	written = written && MoveOver(tempFile, cacheFile);
+	if (!written) remove(tempFile.c_str());
+
+	return written;
+}
@@ -0,0 +1,130 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+// On-disk cache of imported meshes, stored next to the source file as "<file>.meshcache".
+// The file is a fixed header followed by one section for each kind of data in MeshCacheSection, each 16-byte aligned
+// so they can be uploaded or copied straight out of the mapping.
+
+enum MeshCacheSection : uint32_t
+{
+	// Vertex elements of the packed vertices, then the vertices themselves in that layout
+	MeshCacheLayout,
+	MeshCacheVertices,
+	MeshCacheIndices,
+	MeshCacheParts,
+	MeshCacheMeshlets,
+	MeshCacheMeshletVertices,
+	MeshCacheMeshletTriangles,
+	MeshCachePartMeshlets,
+	MeshCacheOccluderPositions,
+	MeshCacheOccluderIndices,
+	// Other files the source pulled in while it was imported, as MeshCacheDependency, and the characters of their paths
+	MeshCacheDependencies,
+	MeshCacheDependencyPaths,
+	MeshCacheSectionCount
+};
+
+// Where a section starts in the file, how many elements it has and how many bytes apart they are
+struct MeshCacheSectionHeader
+{
+	uint32_t offset;
+	uint32_t count;
+	uint32_t stride;
+};
+
+struct MeshCacheHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint64_t sourceHash;
+	float boundsMin[3];
+	float boundsMax[3];
+	MeshCacheSectionHeader sections[MeshCacheSectionCount];
+};
+
+// A file the cache stays valid for only as long as it hashes the same, like the materials next to an OBJ
+struct MeshCacheDependency
+{
+	// HashSource() of the file with a salt of 0
+	uint64_t hash;
+	// Where its path starts in MeshCacheDependencyPaths and how many characters it has
+	uint32_t pathOffset;
+	uint32_t pathLength;
+};
+
+// What to write into a section
+struct MeshCacheData
+{
+	const void* data;
+	uint32_t count;
+	uint32_t stride;
+};
+
+// Read-only view of an entire file, memory mapped where the platform allows it
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator =(const MappedFile&) = delete;
+	~MappedFile();
+
+	bool Open(const std::string& path);
+	void Close();
+
+	const uint8_t* GetData() const { return p_Data; }
+	size_t GetSize() const { return m_Size; }
+
+private:
+	const uint8_t* p_Data = nullptr;
+	size_t m_Size = 0;
+
+#ifdef _WIN32
+	void* p_File = nullptr;
+	void* p_Mapping = nullptr;
+#else
+	int m_File = -1;
+#endif
+};
+
+class MeshCache
+{
+public:
+	static constexpr uint32_t Magic = 0x4348534D; // "MSHC"
+	// Bump whenever the header or what a section holds changes, import settings go into the salt of the source hash instead
+	static constexpr uint32_t Version = 8;
+	static constexpr uint64_t HashBasis = 0xcbf29ce484222325ull;
+
+	// Returns the path the cache of the given source file lives at
+	static std::string GetCachePath(const std::string& sourceFile);
+
+	// 64-bit FNV-1a of size bytes, continuing from hash
+	static uint64_t Hash(const void* data, size_t size, uint64_t hash = HashBasis);
+
+	// Hashes the contents of the source file together with a salt describing how it was imported.
+	// Returns false if the source file could not be read
+	static bool HashSource(const std::string& sourceFile, uint64_t salt, uint64_t& hash);
+
+	// Maps the cache file and checks it against the expected hash and the stride of every section, a stride of 0 accepts any.
+	// Every dependency it lists is hashed again and has to match as well.
+	// Returns false on a miss, in which case nothing is kept open
+	bool Open(const std::string& cacheFile, uint64_t sourceHash, const uint32_t (&strides)[MeshCacheSectionCount]);
+
+	// Writes a new cache file, replacing any existing one
+	static bool Write(const std::string& cacheFile, uint64_t sourceHash, const MeshCacheData (&sections)[MeshCacheSectionCount],
+		const float boundsMin[3], const float boundsMax[3]);
+
+	template<typename T>
+	const T* Get(MeshCacheSection section) const { return (const T*) (m_File.GetData() + GetHeader().sections[section].offset); }
+	uint32_t GetCount(MeshCacheSection section) const { return GetHeader().sections[section].count; }
+	uint32_t GetStride(MeshCacheSection section) const { return GetHeader().sections[section].stride; }
+	const float* GetBoundsMin() const { return GetHeader().boundsMin; }
+	const float* GetBoundsMax() const { return GetHeader().boundsMax; }
+
+private:
+	const MeshCacheHeader& GetHeader() const { return *(const MeshCacheHeader*) m_File.GetData(); }
+	bool CheckDependencies() const;
+
+	MappedFile m_File;
+};
@@ -0,0 +1,548 @@
+#include "assimp/DefaultIOSystem.h"
+#include "assimp/Importer.hpp"
+#include "assimp/ProgressHandler.hpp"
+#include "assimp/scene.h"
+#include "assimp/postprocess.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+#include "MeshImporter.h"
+#include "MeshCache.h"
+#include "MeshSimplifier.h"
+#include "VertexPacker.h"
+#include "Primitives/Profiler.h"
+
+// Settings every mesh is imported with, they are part of the cache key so changing them invalidates old caches
+static constexpr unsigned int ImportFlags = aiProcess_ConvertToLeftHanded | aiProcessPreset_TargetRealtime_MaxQuality | aiProcess_GenBoundingBoxes;
+static constexpr float ImportSmoothingAngle = 90.f;
+
+// Each level of detail aims for this fraction of the triangles of the one before, and isn't kept unless it gets close.
+// Meshes with fewer triangles than the minimum aren't worth simplifying
+static constexpr float LodReduction = 0.5f;
+static constexpr float LodMinReduction = 0.8f;
+static constexpr unsigned int LodMinTriangles = 128;
+// Furthest a level may stray from the full mesh, as a fraction of the mesh's size
+static constexpr float LodMaxError = 0.05f;
+// Meshes with more triangles than this aren't drawn into the occlusion buffer
+static constexpr size_t MaxOccluderTriangles = 2048;
+
+// Everything above and everything the builders bake into the cache, hashed into the salt of the source hash
+struct ImportSettings
+{
+	uint32_t flags;
+	float smoothingAngle;
+	float lodReduction;
+	float lodMinReduction;
+	uint32_t lodMinTriangles;
+	float lodMaxError;
+	uint32_t maxOccluderTriangles;
+	uint32_t meshletMaxVertices;
+	uint32_t meshletMaxTriangles;
+	uint32_t packerFormats;
+};
+
+static constexpr ImportSettings Settings =
+{
+	ImportFlags, ImportSmoothingAngle, LodReduction, LodMinReduction, LodMinTriangles, LodMaxError, (uint32_t) MaxOccluderTriangles,
+	Meshlet::MaxVertices, Meshlet::MaxTriangles, VertexPacker::FormatVersion
+};
+
+namespace
+{
+	// Forwards Assimp's progress to whoever is watching the import
+	class ImportProgress : public Assimp::ProgressHandler
+	{
+	public:
+		ImportProgress(std::atomic<float>& progress) : m_Progress(progress) {}
+
+		bool Update(float percentage) override
+		{
+			if (percentage >= 0.f) m_Progress.store(percentage < 1.f ? percentage : 1.f);
+			return true;
+		}
+
+	private:
+		std::atomic<float>& m_Progress;
+	};
+
+	// Remembers every other file Assimp opens while importing one, like the materials of an OBJ or the buffers of a glTF
+	class RecordingIOSystem : public Assimp::DefaultIOSystem
+	{
+	public:
+		RecordingIOSystem(const std::string& file, std::vector<std::string>& opened) : m_File(file), m_Opened(opened) {}
+
+		Assimp::IOStream* Open(const char* file, const char* mode = "rb") override
+		{
+			Assimp::IOStream* stream = DefaultIOSystem::Open(file, mode);
+			if (stream && m_File != file && std::find(m_Opened.begin(), m_Opened.end(), file) == m_Opened.end()) m_Opened.push_back(file);
+			return stream;
+		}
+
+	private:
+		const std::string& m_File;
+		std::vector<std::string>& m_Opened;
+	};
+
+	// Adds the VertexAttributes the mesh has to attributes, the ones it doesn't get the defaults the shader would use
+	void AppendMesh(const aiMesh* mesh, std::vector<Vertex>& vertices, MeshData& data, uint32_t& attributes)
+	{
+		bool hasVertexColors = mesh->HasVertexColors(0);
+		bool hasNormals = mesh->HasNormals();
+		bool hasTexCoords = mesh->HasTextureCoords(0);
+		if (hasNormals) attributes |= VertexNormal;
+		if (hasVertexColors) attributes |= VertexColor;
+		if (hasTexCoords) attributes |= VertexTexcoord;
+
+		size_t first = vertices.size();
+		vertices.resize(first + mesh->mNumVertices);
+
+		for (unsigned int i = 0; i < mesh->mNumVertices; i++)
+		{
+			auto& vertex = vertices[first + i];
+
+			vertex.position.x = mesh->mVertices[i].x;
+			vertex.position.y = mesh->mVertices[i].y;
+			vertex.position.z = mesh->mVertices[i].z;
+
+			if (hasVertexColors)
+			{
+				vertex.color.r = mesh->mColors[0][i].r;
+				vertex.color.g = mesh->mColors[0][i].g;
+				vertex.color.b = mesh->mColors[0][i].b;
+				vertex.color.a = mesh->mColors[0][i].a;
+			}
+			else
+			{
+				vertex.color.r = 1.f;
+				vertex.color.g = 1.f;
+				vertex.color.b = 1.f;
+				vertex.color.a = 1.f;
+			}
+
+			if (hasNormals)
+			{
+				vertex.normal.x = mesh->mNormals[i].x;
+				vertex.normal.y = mesh->mNormals[i].y;
+				vertex.normal.z = mesh->mNormals[i].z;
+			}
+			else
+			{
+				vertex.normal.x = 0.f;
+				vertex.normal.y = 0.f;
+				vertex.normal.z = 0.f;
+			}
+
+			if (hasTexCoords)
+			{
+				vertex.texcoord.u = mesh->mTextureCoords[0][i].x;
+				vertex.texcoord.v = mesh->mTextureCoords[0][i].y;
+			}
+			else
+			{
+				vertex.texcoord.u = 0.f;
+				vertex.texcoord.v = 0.f;
+			}
+		}
+
+		// Points and lines are left out, indices stay relative to the mesh's own vertices
+		for (unsigned int i = 0; i < mesh->mNumFaces; i++)
+		{
+			if (mesh->mFaces[i].mNumIndices != 3) continue;
+
+			data.indices.push_back(mesh->mFaces[i].mIndices[0]);
+			data.indices.push_back(mesh->mFaces[i].mIndices[1]);
+			data.indices.push_back(mesh->mFaces[i].mIndices[2]);
+		}
+	}
+
+	// Appends simplified copies of the mesh in range to the index array and records them in the range's LOD table
+	void BuildLods(const aiMesh* mesh, MeshPart& range, const std::vector<Vertex>& vertices, MeshData& data)
+	{
+		PROFILE_SCOPE("LODs");
+
+		range.lods[0] = { range.firstIndex, range.indexCount, 0.f };
+		range.lodCount = 1;
+
+		aiVector3D size = mesh->mAABB.mMax - mesh->mAABB.mMin;
+		float maxError = std::max(std::max(size.x, size.y), size.z) * LodMaxError;
+
+		std::vector<unsigned int> simplified(range.indexCount);
+		while (range.lodCount < MeshPart::MaxLods)
+		{
+			auto& previous = range.lods[range.lodCount - 1];
+			if (previous.indexCount / 3 < LodMinTriangles) break;
+
+			// Every level starts from the full mesh rather than the one before, so errors don't pile up
+			const float* positions = &vertices[range.baseVertex].position.x;
+			size_t target = size_t(previous.indexCount * LodReduction) / 3 * 3;
+			float error = 0.f;
+			size_t count = MeshSimplifier::Simplify(positions, sizeof(Vertex), mesh->mNumVertices, &data.indices[range.firstIndex], range.indexCount,
+				target, maxError, simplified.data(), &error);
+			if (count == 0 || count > previous.indexCount * LodMinReduction) break;
+
+			range.lods[range.lodCount++] = { (unsigned int) data.indices.size(), (unsigned int) count, error };
+			data.indices.insert(data.indices.end(), simplified.begin(), simplified.begin() + count);
+		}
+	}
+
+	// Splits the full level of detail of every part into meshlets, parts placing the same mesh share them
+	void BuildMeshlets(const std::vector<Vertex>& vertices, MeshData& data)
+	{
+		PROFILE_SCOPE("Meshlets");
+
+		std::unordered_map<uint64_t, std::pair<uint32_t, uint32_t>> built;
+		for (auto& part : data.parts)
+		{
+			uint64_t key = uint64_t(part.baseVertex) << 32 | part.firstIndex;
+			auto it = built.find(key);
+			if (it == built.end())
+			{
+				const unsigned int* indices = &data.indices[part.firstIndex];
+				unsigned int vertexCount = 0;
+				for (unsigned int i = 0; i < part.indexCount; i++) vertexCount = std::max(vertexCount, indices[i] + 1);
+
+				uint32_t first = (uint32_t) data.meshlets.size();
+				size_t count = MeshletBuilder::Build(&vertices[part.baseVertex].position.x, sizeof(Vertex), vertexCount, indices, part.indexCount,
+					data.meshlets, data.meshletVertices, data.meshletTriangles);
+				it = built.emplace(key, std::make_pair(first, (uint32_t) count)).first;
+			}
+
+			data.partMeshlets.push_back(it->second);
+		}
+	}
+
+	// Bakes every part into the space of the whole mesh, so the occluder is one triangle list
+	void BuildOccluder(const std::vector<Vertex>& vertices, MeshData& data)
+	{
+		size_t triangles = 0;
+		for (auto& part : data.parts) triangles += part.indexCount / 3;
+		if (triangles > MaxOccluderTriangles) return;
+
+		for (auto& part : data.parts)
+		{
+			uint32_t base = (uint32_t) (data.occluderPositions.size() / 3);
+			for (unsigned int i = part.firstIndex; i < part.firstIndex + part.indexCount; i++) data.occluderIndices.push_back(base + data.indices[i]);
+
+			// Only the vertices up to the highest one the part uses
+			uint32_t vertexCount = 0;
+			for (unsigned int i = part.firstIndex; i < part.firstIndex + part.indexCount; i++) vertexCount = std::max(vertexCount, data.indices[i] + 1);
+
+			const auto& m = part.transform;
+			for (uint32_t i = 0; i < vertexCount; i++)
+			{
+				auto& position = vertices[part.baseVertex + i].position;
+				for (int column = 0; column < 3; column++)
+					data.occluderPositions.push_back(position.x * m[0][column] + position.y * m[1][column] + position.z * m[2][column] + m[3][column]);
+			}
+		}
+	}
+
+	// Vertex element as the cache stores it
+	struct CachedElement
+	{
+		char semantic[16];
+		uint32_t type;
+		uint32_t index;
+		uint32_t perInstance;
+	};
+
+	// Strides of the cache sections, the vertices depend on the layout and are checked against it instead
+	constexpr uint32_t CacheStrides[MeshCacheSectionCount] =
+	{
+		sizeof(CachedElement), 0, sizeof(uint32_t), sizeof(MeshPart), sizeof(Meshlet), sizeof(uint32_t), sizeof(uint8_t),
+		sizeof(uint32_t) * 2, sizeof(float) * 3, sizeof(uint32_t), sizeof(MeshCacheDependency), sizeof(char)
+	};
+
+	// Rebuilds the layout the cache was packed with. False if it isn't one this build could have written
+	bool ReadLayout(const MeshCache& cache, VertexLayout& layout)
+	{
+		std::vector<VertexElement> elements;
+		auto cached = cache.Get<CachedElement>(MeshCacheLayout);
+		for (uint32_t i = 0; i < cache.GetCount(MeshCacheLayout); i++)
+		{
+			auto& element = cached[i];
+			if (memchr(element.semantic, 0, sizeof(element.semantic)) == nullptr || element.type > (uint32_t) ElementDataType::unorm8x4) return false;
+			elements.push_back({ element.semantic, (ElementDataType) element.type, element.index, element.perInstance != 0 });
+		}
+
+		layout = VertexLayout(std::move(elements));
+		return layout.stride == cache.GetStride(MeshCacheVertices);
+	}
+
+	// Checks every range read from the cache against what it points into, so a damaged file can't send anything past the end
+	// of an array. The values of the index buffer are left to the GPU, which reads vertices out of range as zero
+	bool CheckRanges(const MeshData& data, size_t indexCount)
+	{
+		auto inside = [](uint64_t first, uint64_t count, size_t size) { return first + count <= size; };
+
+		for (auto& part : data.parts)
+		{
+			if (part.baseVertex >= data.vertexCount || !inside(part.firstIndex, part.indexCount, indexCount) || part.indexCount % 3 != 0) return false;
+			if (part.lodCount == 0 || part.lodCount > MeshPart::MaxLods) return false;
+			for (unsigned int i = 0; i < part.lodCount; i++)
+			{
+				if (!inside(part.lods[i].firstIndex, part.lods[i].indexCount, indexCount) || part.lods[i].indexCount % 3 != 0) return false;
+			}
+		}
+
+		if (data.partMeshlets.size() != data.parts.size()) return false;
+		for (auto& range : data.partMeshlets)
+		{
+			if (!inside(range.first, range.second, data.meshlets.size())) return false;
+		}
+
+		for (auto& meshlet : data.meshlets)
+		{
+			if (meshlet.vertexCount > Meshlet::MaxVertices || meshlet.triangleCount > Meshlet::MaxTriangles) return false;
+			if (!inside(meshlet.vertexOffset, meshlet.vertexCount, data.meshletVertices.size()) ||
+				!inside(meshlet.triangleOffset, meshlet.triangleCount * 3, data.meshletTriangles.size())) return false;
+			for (uint32_t i = 0; i < meshlet.triangleCount * 3; i++)
+			{
+				if (data.meshletTriangles[meshlet.triangleOffset + i] >= meshlet.vertexCount) return false;
+			}
+		}
+		for (uint32_t vertex : data.meshletVertices)
+		{
+			if (vertex >= data.vertexCount) return false;
+		}
+
+		if (data.occluderIndices.size() % 3 != 0) return false;
+		for (uint32_t index : data.occluderIndices)
+		{
+			if (index >= data.occluderPositions.size() / 3) return false;
+		}
+
+		return true;
+	}
+
+	// The mesh is only the same as another if everything it pulled in is too
+	uint64_t HashWithDependencies(uint64_t hash, const MeshCacheDependency* dependencies, size_t count)
+	{
+		for (size_t i = 0; i < count; i++) hash = MeshCache::Hash(&dependencies[i].hash, sizeof(dependencies[i].hash), hash);
+		return hash;
+	}
+
+	// Takes everything but the vertices and indices out of the cache, those are uploaded straight from its mapping
+	bool ReadCache(std::shared_ptr<MeshCache> cache, MeshData& data)
+	{
+		if (!ReadLayout(*cache, data.layout)) return false;
+
+		auto read = [&cache](MeshCacheSection section, auto& destination)
+		{
+			auto* first = cache->Get<typename std::remove_reference_t<decltype(destination)>::value_type>(section);
+			destination.assign(first, first + cache->GetCount(section));
+		};
+		read(MeshCacheParts, data.parts);
+		read(MeshCacheMeshlets, data.meshlets);
+		read(MeshCacheMeshletVertices, data.meshletVertices);
+		read(MeshCacheMeshletTriangles, data.meshletTriangles);
+		read(MeshCacheOccluderIndices, data.occluderIndices);
+
+		auto positions = cache->Get<float>(MeshCacheOccluderPositions);
+		data.occluderPositions.assign(positions, positions + cache->GetCount(MeshCacheOccluderPositions) * 3);
+		auto partMeshlets = cache->Get<uint32_t>(MeshCachePartMeshlets);
+		for (uint32_t i = 0; i < cache->GetCount(MeshCachePartMeshlets); i++) data.partMeshlets.push_back({ partMeshlets[i * 2], partMeshlets[i * 2 + 1] });
+
+		data.vertexCount = cache->GetCount(MeshCacheVertices);
+		if (!CheckRanges(data, cache->GetCount(MeshCacheIndices))) return false;
+
+		data.hash = HashWithDependencies(data.hash, cache->Get<MeshCacheDependency>(MeshCacheDependencies), cache->GetCount(MeshCacheDependencies));
+		memcpy(data.boundsMin, cache->GetBoundsMin(), sizeof(data.boundsMin));
+		memcpy(data.boundsMax, cache->GetBoundsMax(), sizeof(data.boundsMax));
+		data.cache = std::move(cache);
+		return true;
+	}
+
+	// Hashes the files Assimp opened besides the source. False if one of them can't be read anymore
+	bool HashDependencies(const std::vector<std::string>& files, std::vector<MeshCacheDependency>& dependencies, std::string& paths)
+	{
+		for (auto& file : files)
+		{
+			MeshCacheDependency dependency;
+			if (!MeshCache::HashSource(file, 0, dependency.hash)) return false;
+
+			dependency.pathOffset = (uint32_t) paths.size();
+			dependency.pathLength = (uint32_t) file.size();
+			paths += file;
+			dependencies.push_back(dependency);
+		}
+
+		return true;
+	}
+
+	bool WriteCache(const std::string& cacheFile, uint64_t sourceHash, const std::vector<MeshCacheDependency>& dependencies, const std::string& paths,
+		const MeshData& data)
+	{
+		std::vector<CachedElement> layout(data.layout.elements.size());
+		for (size_t i = 0; i < layout.size(); i++)
+		{
+			auto& element = data.layout.elements[i];
+			if (element.semantic.size() >= sizeof(layout[i].semantic)) return false;
+
+			memset(&layout[i], 0, sizeof(CachedElement));
+			memcpy(layout[i].semantic, element.semantic.data(), element.semantic.size());
+			layout[i].type = (uint32_t) element.type;
+			layout[i].index = element.index;
+			layout[i].perInstance = element.perInstance;
+		}
+
+		MeshCacheData sections[MeshCacheSectionCount] =
+		{
+			{ layout.data(), (uint32_t) layout.size(), CacheStrides[MeshCacheLayout] },
+			{ data.vertices.data(), (uint32_t) data.vertexCount, data.layout.stride },
+			{ data.indices.data(), (uint32_t) data.indices.size(), CacheStrides[MeshCacheIndices] },
+			{ data.parts.data(), (uint32_t) data.parts.size(), CacheStrides[MeshCacheParts] },
+			{ data.meshlets.data(), (uint32_t) data.meshlets.size(), CacheStrides[MeshCacheMeshlets] },
+			{ data.meshletVertices.data(), (uint32_t) data.meshletVertices.size(), CacheStrides[MeshCacheMeshletVertices] },
+			{ data.meshletTriangles.data(), (uint32_t) data.meshletTriangles.size(), CacheStrides[MeshCacheMeshletTriangles] },
+			{ data.partMeshlets.data(), (uint32_t) data.partMeshlets.size(), CacheStrides[MeshCachePartMeshlets] },
+			{ data.occluderPositions.data(), (uint32_t) data.occluderPositions.size() / 3, CacheStrides[MeshCacheOccluderPositions] },
+			{ data.occluderIndices.data(), (uint32_t) data.occluderIndices.size(), CacheStrides[MeshCacheOccluderIndices] },
+			{ dependencies.data(), (uint32_t) dependencies.size(), CacheStrides[MeshCacheDependencies] },
+			{ paths.data(), (uint32_t) paths.size(), CacheStrides[MeshCacheDependencyPaths] }
+		};
+		return MeshCache::Write(cacheFile, sourceHash, sections, data.boundsMin, data.boundsMax);
+	}
+
+	// Grows the bounds of data around a mesh's box moved by transform
+	void GrowBounds(const aiAABB& box, const float (&transform)[4][4], MeshData& data, bool& hasBounds)
+	{
+		float center[3] = { (box.mMin.x + box.mMax.x) * 0.5f, (box.mMin.y + box.mMax.y) * 0.5f, (box.mMin.z + box.mMax.z) * 0.5f };
+		float extent[3] = { (box.mMax.x - box.mMin.x) * 0.5f, (box.mMax.y - box.mMin.y) * 0.5f, (box.mMax.z - box.mMin.z) * 0.5f };
+
+		for (int column = 0; column < 3; column++)
+		{
+			float movedCenter = transform[3][column];
+			float movedExtent = 0.f;
+			for (int row = 0; row < 3; row++)
+			{
+				movedCenter += center[row] * transform[row][column];
+				movedExtent += extent[row] * std::fabs(transform[row][column]);
+			}
+
+			float min = movedCenter - movedExtent;
+			float max = movedCenter + movedExtent;
+			data.boundsMin[column] = hasBounds ? std::min(data.boundsMin[column], min) : min;
+			data.boundsMax[column] = hasBounds ? std::max(data.boundsMax[column], max) : max;
+		}
+
+		hasBounds = true;
+	}
+}
+
+bool MeshImporter::Import(const std::string& file, MeshData& data, std::atomic<float>* progress)
+{
+	uint64_t salt = MeshCache::Hash(&Settings, sizeof(Settings));
+
+	// If the file hasn't changed since it was last imported, skip Assimp entirely and read straight from the cache
+	uint64_t hash = 0;
+	std::string cacheFile = MeshCache::GetCachePath(file);
+	bool hashed = MeshCache::HashSource(file, salt, hash);
+
+	data.hash = hash;
+	data.hashed = hashed;
+
+	auto cache = std::make_shared<MeshCache>();
+	if (hashed && cache->Open(cacheFile, hash, CacheStrides))
+	{
+		PROFILE_SCOPE("Read Cache");
+		if (ReadCache(std::move(cache), data))
+		{
+			if (progress) progress->store(1.f);
+			return true;
+		}
+
+		// Whatever was read of a cache that turned out to be unusable is thrown away, and the file imported again
+		data = MeshData();
+		data.hash = hash;
+		data.hashed = hashed;
+	}
+	cache.reset();
+
+	std::vector<std::string> opened;
+	Assimp::Importer importer;
+	importer.SetIOHandler(new RecordingIOSystem(file, opened));
+	if (progress) importer.SetProgressHandler(new ImportProgress(*progress));
+	importer.SetPropertyFloat("PP_GSN_MAX_SMOOTHING_ANGLE", ImportSmoothingAngle);
+	const aiScene* scene;
+	{
+		PROFILE_SCOPE("Assimp");
+		scene = importer.ReadFile(file, ImportFlags);
+	}
+
+	if (scene == nullptr || scene->mNumMeshes == 0) return false;
+
+	// Every mesh goes into the same arrays, remembering where each one starts
+	std::vector<Vertex> vertices;
+	uint32_t attributes = 0;
+	std::vector<MeshPart> meshRanges(scene->mNumMeshes);
+	for (unsigned int i = 0; i < scene->mNumMeshes; i++)
+	{
+		meshRanges[i].baseVertex = (unsigned int) vertices.size();
+		meshRanges[i].firstIndex = (unsigned int) data.indices.size();
+		AppendMesh(scene->mMeshes[i], vertices, data, attributes);
+		meshRanges[i].indexCount = (unsigned int) data.indices.size() - meshRanges[i].firstIndex;
+		BuildLods(scene->mMeshes[i], meshRanges[i], vertices, data);
+	}
+
+	// Every node places the meshes it references with its transform combined with all of its parents'
+	bool hasBounds = false;
+	std::vector<std::pair<const aiNode*, aiMatrix4x4>> nodes = { { scene->mRootNode, aiMatrix4x4() } };
+	while (!nodes.empty())
+	{
+		auto node = nodes.back().first;
+		aiMatrix4x4 transform = nodes.back().second * node->mTransformation;
+		nodes.pop_back();
+
+		for (unsigned int i = node->mNumChildren; i > 0; i--) nodes.push_back({ node->mChildren[i - 1], transform });
+
+		for (unsigned int i = 0; i < node->mNumMeshes; i++)
+		{
+			MeshPart part = meshRanges[node->mMeshes[i]];
+			if (part.indexCount == 0) continue;
+
+			// Assimp's matrices transform column vectors, ours row vectors
+			for (int row = 0; row < 4; row++)
+			{
+				for (int column = 0; column < 4; column++) part.transform[row][column] = transform[column][row];
+			}
+
+			GrowBounds(scene->mMeshes[node->mMeshes[i]]->mAABB, part.transform, data, hasBounds);
+			data.parts.push_back(part);
+		}
+	}
+
+	BuildMeshlets(vertices, data);
+	BuildOccluder(vertices, data);
+
+	// Only the packed form is kept, the imported vertices are thrown away here.
+	// Attributes no mesh of the file has are left out, meshes without ones the others have keep the defaults
+	data.layout = VertexPacker::ChooseLayout(vertices, attributes);
+	VertexPacker::Pack(data.layout, vertices, data.vertices);
+	data.vertexCount = vertices.size();
+
+	// A file that went missing since Assimp read it leaves nothing to check the cache against
+	std::vector<MeshCacheDependency> dependencies;
+	std::string dependencyPaths;
+	if (hashed && !HashDependencies(opened, dependencies, dependencyPaths))
+	{
+		hashed = false;
+		data.hashed = false;
+	}
+	data.hash = HashWithDependencies(hash, dependencies.data(), dependencies.size());
+
+	// Failing to write the cache only costs us the next load, so there's nothing to report
+	if (hashed)
+	{
+		PROFILE_SCOPE("Write Cache");
+		WriteCache(cacheFile, hash, dependencies, dependencyPaths, data);
+	}
+
+	if (progress) progress->store(1.f);
+	return true;
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Primitives/VertexLayout.h"
+#include "MeshCache.h"
+#include "MeshletBuilder.h"
+
+struct Vertex
+{
+	struct
+	{
+		float x, y, z;
+	} position, normal;
+
+	struct
+	{
+		float r, g, b, a;
+	} color;
+
+	struct 
+	{
+		float u, v;
+	} texcoord;
+};
+
+// A range of the index array drawing a part at some level of detail, over the part's own vertices
+struct MeshLod
+{
+	unsigned int firstIndex = 0;
+	unsigned int indexCount = 0;
+	// Furthest the simplified surface is from the full one, in the units of the part before its transform
+	float error = 0.f;
+};
+
+// One mesh of the file, placed by one node of its hierarchy. Meshes used by several nodes get a part for each
+struct MeshPart
+{
+	static constexpr unsigned int MaxLods = 5;
+
+	// Indices of the part count from baseVertex, not from the start of the vertex array
+	unsigned int baseVertex = 0;
+	unsigned int firstIndex = 0;
+	unsigned int indexCount = 0;
+	// Coarser and coarser versions of the part, the first is the full index range above
+	MeshLod lods[MaxLods];
+	unsigned int lodCount = 0;
+	// Row-major transform from the part into the space of the whole file, like TransformMatrix
+	float transform[4][4] = {};
+};
+
+// Geometry of an imported file, before any of it is on the GPU.
+// Every mesh in the file is concatenated into the same vertex and index arrays
+struct MeshData
+{
+	// Vertices packed by VertexPacker into layout, vertexCount of them
+	VertexLayout layout = {};
+	std::vector<uint8_t> vertices;
+	size_t vertexCount = 0;
+	std::vector<unsigned int> indices;
+	std::vector<MeshPart> parts;
+	// Around every part, after its transform
+	float boundsMin[3] = {};
+	float boundsMax[3] = {};
+
+	// Clusters of the full level of detail of every part, see MeshletBuilder
+	std::vector<Meshlet> meshlets;
+	std::vector<uint32_t> meshletVertices;
+	std::vector<uint8_t> meshletTriangles;
+	// First meshlet and number of meshlets of every part
+	std::vector<std::pair<uint32_t, uint32_t>> partMeshlets;
+
+	// Every part's triangles in place as one list, for meshes simple enough to be drawn into the occlusion buffer. Empty otherwise
+	std::vector<float> occluderPositions;
+	std::vector<uint32_t> occluderIndices;
+
+	// Set if the mesh came out of the cache. The vertices and indices are then left in its mapping rather than copied
+	// into the arrays above, GetVertices() and GetIndices() find them wherever they are
+	std::shared_ptr<const MeshCache> cache;
+
+	const uint8_t* GetVertices() const { return cache ? cache->Get<uint8_t>(MeshCacheVertices) : vertices.data(); }
+	const unsigned int* GetIndices() const { return cache ? cache->Get<unsigned int>(MeshCacheIndices) : indices.data(); }
+	size_t GetIndexCount() const { return cache ? cache->GetCount(MeshCacheIndices) : indices.size(); }
+
+	// Content hash of the source file, the other files it pulled in and the import settings, only set if they could all be hashed
+	uint64_t hash = 0;
+	bool hashed = false;
+};
+
+// Turns files into MeshData. Doesn't touch the GPU, so imports can run on any thread and several at once
+class MeshImporter
+{
+public:
+	// Reads the mesh cache if it is up to date, otherwise runs Assimp and rewrites the cache.
+	// If progress is given it is moved from 0 to 1 as the import goes on
+	static bool Import(const std::string& file, MeshData& data, std::atomic<float>* progress = nullptr);
+};
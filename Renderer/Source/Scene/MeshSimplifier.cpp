@@ -0,0 +1,383 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#include "MeshSimplifier.h"
+
+namespace
+{
+	// Sum of squared distances to a set of planes, as the symmetric 4x4 matrix of the plane equations' outer products.
+	// Planes are weighted by the area of their triangle, so the error divided by weight is an average
+	struct Quadric
+	{
+		double xx = 0, xy = 0, xz = 0, xw = 0;
+		double yy = 0, yz = 0, yw = 0;
+		double zz = 0, zw = 0;
+		double ww = 0;
+		double weight = 0;
+
+		void AddPlane(double a, double b, double c, double d, double area)
+		{
+			xx += a * a * area; xy += a * b * area; xz += a * c * area; xw += a * d * area;
+			yy += b * b * area; yz += b * c * area; yw += b * d * area;
+			zz += c * c * area; zw += c * d * area;
+			ww += d * d * area;
+			weight += area;
+		}
+
+		void Add(const Quadric& other)
+		{
+			xx += other.xx; xy += other.xy; xz += other.xz; xw += other.xw;
+			yy += other.yy; yz += other.yz; yw += other.yw;
+			zz += other.zz; zw += other.zw;
+			ww += other.ww;
+			weight += other.weight;
+		}
+
+		// Average squared distance of the point to the planes
+		double Evaluate(const float* p) const
+		{
+			double x = p[0], y = p[1], z = p[2];
+			double sum = x * x * xx + 2 * x * y * xy + 2 * x * z * xz + 2 * x * xw
+				+ y * y * yy + 2 * y * z * yz + 2 * y * yw
+				+ z * z * zz + 2 * z * zw
+				+ ww;
+
+			return weight > 0 ? std::fabs(sum) / weight : 0;
+		}
+	};
+
+	struct Collapse
+	{
+		double cost;
+		uint32_t from;
+		uint32_t to;
+	};
+
+	// The vertices an edge between two welded vertices uses, it is a seam if its triangles don't agree on them
+	struct Edge
+	{
+		uint32_t first;
+		uint32_t second;
+		bool seam;
+	};
+
+	struct PositionHash
+	{
+		size_t operator ()(const std::array<uint32_t, 3>& key) const
+		{
+			return (size_t) (key[0] * 73856093u ^ key[1] * 19349663u ^ key[2] * 83492791u);
+		}
+	};
+
+	void Normal(const float* a, const float* b, const float* c, float* normal)
+	{
+		float u[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+		float v[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+		normal[0] = u[1] * v[2] - u[2] * v[1];
+		normal[1] = u[2] * v[0] - u[0] * v[2];
+		normal[2] = u[0] * v[1] - u[1] * v[0];
+	}
+}
+
+size_t MeshSimplifier::Simplify(const float* positions, size_t positionStride, size_t vertexCount, const unsigned int* indices,
+	size_t indexCount, size_t targetIndexCount, float maxError, unsigned int* destination, float* error)
+{
+	auto position = [&](size_t vertex) { return (const float*) ((const uint8_t*) positions + vertex * positionStride); };
+
+	// Vertices at the same position are welded into one, the first of them stands for the rest
+	std::vector<uint32_t> weld(vertexCount);
+	std::vector<uint32_t> wedges(vertexCount, 0);
+	{
+		std::unordered_map<std::array<uint32_t, 3>, uint32_t, PositionHash> first;
+		first.reserve(vertexCount);
+		for (size_t i = 0; i < vertexCount; i++)
+		{
+			std::array<uint32_t, 3> key;
+			memcpy(key.data(), position(i), sizeof(float) * 3);
+			weld[i] = first.emplace(key, (uint32_t) i).first->second;
+		}
+
+		// Only vertices the triangles use count towards a seam
+		std::vector<bool> used(vertexCount, false);
+		for (size_t i = 0; i < indexCount; i++) used[indices[i]] = true;
+		for (size_t i = 0; i < vertexCount; i++)
+		{
+			if (used[i]) ++wedges[weld[i]];
+		}
+	}
+
+	// Edges used by anything but exactly two triangles are borders or worse, their ends stay where they are.
+	// So do vertices where more than two seams meet
+	std::vector<bool> locked(vertexCount, false);
+	{
+		std::unordered_map<uint64_t, uint32_t> edges;
+		edges.reserve(indexCount);
+		for (size_t i = 0; i < indexCount; i += 3)
+		{
+			for (int edge = 0; edge < 3; edge++)
+			{
+				uint32_t a = weld[indices[i + edge]], b = weld[indices[i + (edge + 1) % 3]];
+				if (a > b) std::swap(a, b);
+				++edges[uint64_t(a) << 32 | b];
+			}
+		}
+
+		for (auto& edge : edges)
+		{
+			if (edge.second != 2) locked[edge.first >> 32] = locked[edge.first & 0xFFFFFFFF] = true;
+		}
+
+		for (size_t i = 0; i < vertexCount; i++)
+		{
+			if (wedges[i] > 2) locked[i] = true;
+		}
+	}
+
+	std::vector<Quadric> quadrics(vertexCount);
+	for (size_t i = 0; i < indexCount; i += 3)
+	{
+		uint32_t a = weld[indices[i]], b = weld[indices[i + 1]], c = weld[indices[i + 2]];
+		float normal[3];
+		Normal(position(a), position(b), position(c), normal);
+
+		double length = std::sqrt(double(normal[0]) * normal[0] + double(normal[1]) * normal[1] + double(normal[2]) * normal[2]);
+		if (length == 0) continue;
+
+		double nx = normal[0] / length, ny = normal[1] / length, nz = normal[2] / length;
+		double d = -(nx * position(a)[0] + ny * position(a)[1] + nz * position(a)[2]);
+		Quadric plane;
+		plane.AddPlane(nx, ny, nz, d, length * 0.5);
+		quadrics[a].Add(plane);
+		quadrics[b].Add(plane);
+		quadrics[c].Add(plane);
+	}
+
+	std::vector<unsigned int> result(indices, indices + indexCount);
+	double maxCost = double(maxError) * maxError;
+	double reachedCost = 0;
+
+	std::vector<uint32_t> triangleOffsets(vertexCount + 1);
+	std::vector<uint32_t> vertexTriangles;
+	std::unordered_map<uint64_t, Edge> edges;
+	std::vector<uint8_t> seamEdges(vertexCount);
+	std::vector<Collapse> collapses;
+	std::vector<int64_t> best(vertexCount);
+	// Vertex every vertex collapsed this pass is replaced by
+	std::vector<uint32_t> replacement(vertexCount);
+	std::vector<uint32_t> moved;
+	std::vector<bool> touched(vertexCount);
+	// Neighbours of the vertex a collapse starts from, marked with the number of the collapse
+	std::vector<uint32_t> neighbours(vertexCount, ~0u);
+	uint32_t attempt = 0;
+
+	// Every pass collapses a batch of edges that don't share any triangles, then rebuilds the list
+	while (result.size() > targetIndexCount)
+	{
+		size_t triangleCount = result.size() / 3;
+
+		// Triangles around every welded vertex
+		std::fill(triangleOffsets.begin(), triangleOffsets.end(), 0);
+		for (unsigned int index : result) ++triangleOffsets[weld[index] + 1];
+		for (size_t i = 0; i < vertexCount; i++) triangleOffsets[i + 1] += triangleOffsets[i];
+		vertexTriangles.resize(result.size());
+		{
+			std::vector<uint32_t> cursor(triangleOffsets.begin(), triangleOffsets.end() - 1);
+			for (size_t i = 0; i < result.size(); i++) vertexTriangles[cursor[weld[result[i]]]++] = (uint32_t) (i / 3);
+		}
+
+		// A vertex on a seam has a vertex for each side of it. It can only slide along the seam, so both sides
+		// keep their attributes, and only if the seam goes straight through it
+		edges.clear();
+		for (size_t i = 0; i < result.size(); i += 3)
+		{
+			for (int edge = 0; edge < 3; edge++)
+			{
+				unsigned int a = result[i + edge], b = result[i + (edge + 1) % 3];
+				if (weld[a] > weld[b]) std::swap(a, b);
+
+				auto inserted = edges.emplace(uint64_t(weld[a]) << 32 | weld[b], Edge{ a, b, false });
+				if (!inserted.second && (inserted.first->second.first != a || inserted.first->second.second != b)) inserted.first->second.seam = true;
+			}
+		}
+
+		std::fill(seamEdges.begin(), seamEdges.end(), 0);
+		for (auto& edge : edges)
+		{
+			if (!edge.second.seam) continue;
+			++seamEdges[edge.first >> 32];
+			++seamEdges[edge.first & 0xFFFFFFFF];
+		}
+
+		// The cheapest edge away from every vertex that can move
+		collapses.clear();
+		std::fill(best.begin(), best.end(), -1);
+		for (size_t i = 0; i < result.size(); i += 3)
+		{
+			for (int edge = 0; edge < 3; edge++)
+			{
+				for (int direction = 0; direction < 2; direction++)
+				{
+					unsigned int fromVertex = result[i + (direction ? (edge + 1) % 3 : edge)];
+					unsigned int toVertex = result[i + (direction ? edge : (edge + 1) % 3)];
+					uint32_t from = weld[fromVertex], to = weld[toVertex];
+					if (from == to || locked[from]) continue;
+					if (wedges[from] > 1 && (seamEdges[from] != 2 || !edges[uint64_t(std::min(from, to)) << 32 | std::max(from, to)].seam)) continue;
+
+					Quadric combined = quadrics[from];
+					combined.Add(quadrics[to]);
+					double cost = combined.Evaluate(position(to));
+
+					if (best[from] < 0 || cost < collapses[best[from]].cost)
+					{
+						if (best[from] < 0)
+						{
+							best[from] = (int64_t) collapses.size();
+							collapses.push_back({});
+						}
+						collapses[best[from]] = { cost, from, to };
+					}
+				}
+			}
+		}
+
+		std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.cost < b.cost; });
+
+		// Each collapse takes out about two triangles, don't go far past the target in one pass
+		size_t wanted = (triangleCount - targetIndexCount / 3 + 1) / 2;
+		size_t accepted = 0;
+		std::fill(touched.begin(), touched.end(), false);
+		std::fill(replacement.begin(), replacement.end(), ~0u);
+
+		for (auto& collapse : collapses)
+		{
+			if (accepted >= wanted || collapse.cost > maxCost) break;
+			if (touched[collapse.from] || touched[collapse.to]) continue;
+
+			// Moving the vertex must not turn any of the triangles that stay over
+			bool flips = false;
+			const float* target = position(collapse.to);
+			for (uint32_t t = triangleOffsets[collapse.from]; t < triangleOffsets[collapse.from + 1] && !flips; t++)
+			{
+				const unsigned int* triangle = &result[vertexTriangles[t] * 3];
+				uint32_t corners[3] = { weld[triangle[0]], weld[triangle[1]], weld[triangle[2]] };
+				if (corners[0] == collapse.to || corners[1] == collapse.to || corners[2] == collapse.to) continue;
+
+				const float* before[3] = { position(corners[0]), position(corners[1]), position(corners[2]) };
+				const float* after[3] = { before[0], before[1], before[2] };
+				for (int corner = 0; corner < 3; corner++)
+				{
+					if (corners[corner] == collapse.from) after[corner] = target;
+				}
+
+				float normalBefore[3], normalAfter[3];
+				Normal(before[0], before[1], before[2], normalBefore);
+				Normal(after[0], after[1], after[2], normalAfter);
+				flips = normalBefore[0] * normalAfter[0] + normalBefore[1] * normalAfter[1] + normalBefore[2] * normalAfter[2] <= 0.f;
+			}
+			if (flips) continue;
+
+			// The two ends may only share the neighbours across the triangles along the edge. Another one would end up with
+			// the same edge to the target twice, folding the surface onto itself
+			size_t shared = 0, common = 0;
+			++attempt;
+			for (uint32_t t = triangleOffsets[collapse.from]; t < triangleOffsets[collapse.from + 1]; t++)
+			{
+				const unsigned int* triangle = &result[vertexTriangles[t] * 3];
+				bool along = false;
+				for (int corner = 0; corner < 3; corner++)
+				{
+					neighbours[weld[triangle[corner]]] = attempt;
+					along |= weld[triangle[corner]] == collapse.to;
+				}
+				shared += along;
+			}
+			for (uint32_t t = triangleOffsets[collapse.to]; t < triangleOffsets[collapse.to + 1]; t++)
+			{
+				const unsigned int* triangle = &result[vertexTriangles[t] * 3];
+				for (int corner = 0; corner < 3; corner++)
+				{
+					uint32_t vertex = weld[triangle[corner]];
+					if (vertex == collapse.from || vertex == collapse.to || neighbours[vertex] != attempt) continue;
+					// Counted once
+					neighbours[vertex] = attempt - 1;
+					++common;
+				}
+			}
+			if (common > shared) continue;
+
+			// Each vertex at the collapsed position takes the target's vertex on its side of the edge
+			moved.clear();
+			for (uint32_t t = triangleOffsets[collapse.from]; t < triangleOffsets[collapse.from + 1]; t++)
+			{
+				const unsigned int* triangle = &result[vertexTriangles[t] * 3];
+				unsigned int fromVertex = ~0u, toVertex = ~0u;
+				for (int corner = 0; corner < 3; corner++)
+				{
+					if (weld[triangle[corner]] == collapse.from) fromVertex = triangle[corner];
+					if (weld[triangle[corner]] == collapse.to) toVertex = triangle[corner];
+				}
+
+				if (toVertex != ~0u && replacement[fromVertex] == ~0u)
+				{
+					replacement[fromVertex] = toVertex;
+					moved.push_back(fromVertex);
+				}
+			}
+
+			// A side without a triangle along the edge has nowhere to take its attributes
+			bool complete = true;
+			for (uint32_t t = triangleOffsets[collapse.from]; t < triangleOffsets[collapse.from + 1] && complete; t++)
+			{
+				const unsigned int* triangle = &result[vertexTriangles[t] * 3];
+				for (int corner = 0; corner < 3; corner++)
+				{
+					if (weld[triangle[corner]] == collapse.from && replacement[triangle[corner]] == ~0u) complete = false;
+				}
+			}
+			if (!complete)
+			{
+				for (uint32_t vertex : moved) replacement[vertex] = ~0u;
+				continue;
+			}
+
+			// Everything around the collapsed vertex changes shape, so none of it is touched again this pass
+			for (uint32_t t = triangleOffsets[collapse.from]; t < triangleOffsets[collapse.from + 1]; t++)
+			{
+				const unsigned int* triangle = &result[vertexTriangles[t] * 3];
+				for (int corner = 0; corner < 3; corner++) touched[weld[triangle[corner]]] = true;
+			}
+
+			quadrics[collapse.to].Add(quadrics[collapse.from]);
+			reachedCost = std::max(reachedCost, collapse.cost);
+			++accepted;
+		}
+
+		if (accepted == 0) break;
+
+		size_t written = 0;
+		for (size_t i = 0; i < result.size(); i += 3)
+		{
+			unsigned int triangle[3];
+			for (int corner = 0; corner < 3; corner++)
+			{
+				unsigned int vertex = result[i + corner];
+				triangle[corner] = replacement[vertex] != ~0u ? replacement[vertex] : vertex;
+			}
+
+			if (weld[triangle[0]] == weld[triangle[1]] || weld[triangle[1]] == weld[triangle[2]] || weld[triangle[0]] == weld[triangle[2]]) continue;
+
+			memcpy(&result[written], triangle, sizeof(triangle));
+			written += 3;
+		}
+		result.resize(written);
+	}
+
+	std::copy(result.begin(), result.end(), destination);
+	if (error) *error = (float) std::sqrt(reachedCost);
+	return result.size();
+}
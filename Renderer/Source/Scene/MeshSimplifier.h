@@ -0,0 +1,17 @@
+#pragma once
+#include <cstddef>
+
+// Quadric error mesh simplification (Garland and Heckbert). Edges are collapsed onto one of their two vertices,
+// cheapest first, so the result indexes the same vertex array as the input and can share its vertex buffer.
+// Vertices on open borders never move, and vertices on attribute seams (several vertices at the same position) only slide
+// along the seam, which keeps the outline of the mesh and its texture and normal seams in place.
+class MeshSimplifier
+{
+public:
+	// Writes a simplified copy of a triangle list to destination, which needs room for indexCount indices,
+	// and returns how many indices it wrote. Positions are xyz floats, positionStride bytes apart.
+	// Stops once the list is down to targetIndexCount or the next collapse would move the surface further than maxError.
+	// If error is given it receives how far the surface moved, in the units of the positions
+	static size_t Simplify(const float* positions, size_t positionStride, size_t vertexCount, const unsigned int* indices,
+		size_t indexCount, size_t targetIndexCount, float maxError, unsigned int* destination, float* error = nullptr);
+};
@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <cmath>
+
+#include "MeshletBuilder.h"
+
+namespace
+{
+	// Fills in the bounding sphere and normal cone of a finished meshlet
+	void ComputeBounds(Meshlet& meshlet, const float* positions, size_t positionStride, const uint32_t* vertices, const uint8_t* triangles)
+	{
+		auto position = [&](uint32_t local) { return (const float*) ((const uint8_t*) positions + vertices[local] * positionStride); };
+
+		// The center of the bounding box is close enough to the smallest sphere's for culling
+		float min[3] = { INFINITY, INFINITY, INFINITY }, max[3] = { -INFINITY, -INFINITY, -INFINITY };
+		for (uint32_t i = 0; i < meshlet.vertexCount; i++)
+		{
+			for (int axis = 0; axis < 3; axis++)
+			{
+				min[axis] = std::min(min[axis], position(i)[axis]);
+				max[axis] = std::max(max[axis], position(i)[axis]);
+			}
+		}
+
+		float radiusSquared = 0.f;
+		for (int axis = 0; axis < 3; axis++) meshlet.center[axis] = (min[axis] + max[axis]) * 0.5f;
+		for (uint32_t i = 0; i < meshlet.vertexCount; i++)
+		{
+			float dx = position(i)[0] - meshlet.center[0], dy = position(i)[1] - meshlet.center[1], dz = position(i)[2] - meshlet.center[2];
+			radiusSquared = std::max(radiusSquared, dx * dx + dy * dy + dz * dz);
+		}
+		meshlet.radius = std::sqrt(radiusSquared);
+
+		// The axis is the average of the triangle normals, the cone has to reach the one furthest from it
+		float normals[Meshlet::MaxTriangles][3];
+		uint32_t normalCount = 0;
+		float axis[3] = { 0.f, 0.f, 0.f };
+		for (uint32_t i = 0; i < meshlet.triangleCount; i++)
+		{
+			const float* a = position(triangles[i * 3]);
+			const float* b = position(triangles[i * 3 + 1]);
+			const float* c = position(triangles[i * 3 + 2]);
+			float u[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+			float v[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+			float* normal = normals[normalCount];
+			normal[0] = u[1] * v[2] - u[2] * v[1];
+			normal[1] = u[2] * v[0] - u[0] * v[2];
+			normal[2] = u[0] * v[1] - u[1] * v[0];
+
+			// Degenerate triangles are never drawn, so they don't face anywhere
+			float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+			if (length == 0.f) continue;
+
+			for (int k = 0; k < 3; k++)
+			{
+				normal[k] /= length;
+				axis[k] += normal[k];
+			}
+			normalCount++;
+		}
+
+		float axisLength = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+		float minDot = 1.f;
+		if (axisLength > 0.f)
+		{
+			for (int k = 0; k < 3; k++) axis[k] /= axisLength;
+			for (uint32_t i = 0; i < normalCount; i++)
+				minDot = std::min(minDot, normals[i][0] * axis[0] + normals[i][1] * axis[1] + normals[i][2] * axis[2]);
+		}
+
+		for (int k = 0; k < 3; k++) meshlet.coneAxis[k] = axis[k];
+		// A cone of 90 degrees or more can't be seen entirely from behind
+		meshlet.coneCutoff = axisLength > 0.f && minDot > 0.f ? std::sqrt(1.f - minDot * minDot) : 1.f;
+	}
+}
+
+size_t MeshletBuilder::Build(const float* positions, size_t positionStride, size_t vertexCount, const unsigned int* indices, size_t indexCount,
+	std::vector<Meshlet>& meshlets, std::vector<uint32_t>& meshletVertices, std::vector<uint8_t>& meshletTriangles)
+{
+	size_t firstMeshlet = meshlets.size();
+
+	// Slot of every vertex in the meshlet being filled, 0xFF if it isn't in it yet
+	std::vector<uint8_t> slots(vertexCount, 0xFF);
+	static_assert(Meshlet::MaxVertices < 0xFF, "Vertex slots have to fit in a byte");
+
+	Meshlet meshlet = {};
+	meshlet.vertexOffset = (uint32_t) meshletVertices.size();
+	meshlet.triangleOffset = (uint32_t) meshletTriangles.size();
+
+	auto finish = [&]()
+	{
+		ComputeBounds(meshlet, positions, positionStride, &meshletVertices[meshlet.vertexOffset], &meshletTriangles[meshlet.triangleOffset]);
+		meshlets.push_back(meshlet);
+
+		for (uint32_t i = 0; i < meshlet.vertexCount; i++) slots[meshletVertices[meshlet.vertexOffset + i]] = 0xFF;
+		meshlet = {};
+		meshlet.vertexOffset = (uint32_t) meshletVertices.size();
+		meshlet.triangleOffset = (uint32_t) meshletTriangles.size();
+	};
+
+	for (size_t i = 0; i + 2 < indexCount; i += 3)
+	{
+		const unsigned int* triangle = &indices[i];
+		uint32_t newVertices = (slots[triangle[0]] == 0xFF) + (slots[triangle[1]] == 0xFF) + (slots[triangle[2]] == 0xFF);
+		// Repeated corners would be counted twice, only degenerate triangles have them and the extra slot doesn't matter
+		if (meshlet.vertexCount + newVertices > Meshlet::MaxVertices || meshlet.triangleCount == Meshlet::MaxTriangles) finish();
+
+		for (int corner = 0; corner < 3; corner++)
+		{
+			uint8_t& slot = slots[triangle[corner]];
+			if (slot == 0xFF)
+			{
+				slot = (uint8_t) meshlet.vertexCount++;
+				meshletVertices.push_back(triangle[corner]);
+			}
+			meshletTriangles.push_back(slot);
+		}
+		meshlet.triangleCount++;
+	}
+
+	if (meshlet.triangleCount > 0) finish();
+
+	return meshlets.size() - firstMeshlet;
+}
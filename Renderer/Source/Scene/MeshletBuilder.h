@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// A small cluster of a triangle list, with its own list of the vertices it uses so its triangles fit in bytes.
+// Bounds are in the space of the positions the meshlet was built from
+struct Meshlet
+{
+	static constexpr unsigned int MaxVertices = 64;
+	static constexpr unsigned int MaxTriangles = 124;
+
+	// Where the meshlet's entries start in the meshlet vertex list and the meshlet triangle list, and how many there are
+	uint32_t vertexOffset;
+	uint32_t triangleOffset;
+	uint32_t vertexCount;
+	uint32_t triangleCount;
+	// Bounding sphere of the vertices
+	float center[3];
+	float radius;
+	// The normal of every triangle, cross(b - a, c - a) normalized, is within the cone around coneAxis, and coneCutoff is the sine
+	// of the cone's half angle. The meshlet faces away from a camera at p if dot(center - p, coneAxis) > coneCutoff * |center - p| + radius.
+	// Meshlets whose triangles face too many ways for that get a cutoff of 1, which never passes
+	float coneAxis[3];
+	float coneCutoff;
+};
+
+// Splits triangle lists into meshlets of at most Meshlet::MaxVertices vertices and Meshlet::MaxTriangles triangles.
+// Triangles are taken in order, so an index list already sorted for the vertex cache gives compact meshlets.
+class MeshletBuilder
+{
+public:
+	// Appends the meshlets of a triangle list to meshlets. Their vertex lists go to meshletVertices as indices into the positions,
+	// and their triangles to meshletTriangles as three bytes each, indexing the meshlet's vertex list.
+	// Positions are xyz floats, positionStride bytes apart. Returns how many meshlets were added
+	static size_t Build(const float* positions, size_t positionStride, size_t vertexCount, const unsigned int* indices, size_t indexCount,
+		std::vector<Meshlet>& meshlets, std::vector<uint32_t>& meshletVertices, std::vector<uint8_t>& meshletTriangles);
+};
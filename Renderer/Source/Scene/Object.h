@@ -1,27 +1,11 @@
 #pragma once
+#include <memory>
 #include <string>
 #include <vector>
 #include <DirectXMath.h>
 
-#include "Primitives/Buffer.h"
-
-struct Vertex
-{
-	struct
-	{
-		float x, y, z;
-	} position, normal;
-
-	struct
-	{
-		float r, g, b, a;
-	} color;
-
-	struct 
-	{
-		float u, v;
-	} texcoord;
-};
+#include "Mesh.h"
+#include "TransformStore.h"
 
 struct Material
 {
@@ -36,6 +20,7 @@ class Object
 {
 public:
 	Object(std::string name, std::string file);
+	Object(std::string name, std::shared_ptr<Mesh> mesh);
 	Object(const Object& other);
 	Object(Object&& other) noexcept;
 	~Object() noexcept;
@@ -46,7 +31,7 @@ public:
 		return *this;
 	}
 
-	bool operator ==(Object other)
+	bool operator ==(const Object& other) const
 	{
 		return other.Name == Name;
 	}
@@ -54,38 +39,31 @@ public:
 	std::string Name;
 
 	Material& GetMaterial() { return m_Material; }
-	const std::vector<Vertex>& GetVertices() const { return m_Vertices; }
-	const std::vector<unsigned int>& GetIndices() const { return m_Indices; }
+	size_t GetVertexCount() const { return m_Mesh->GetVertexCount(); }
+	size_t GetTriangleCount() const { return m_Mesh->GetTriangleCount(); }
 
-	const VertexBuffer* GetVertexBuffer() const { return m_VertexBuffer; }
-	const IndexBuffer* GetIndexBuffer() const { return m_IndexBuffer; }
+	const VertexBuffer* GetVertexBuffer() const { return m_Mesh->GetVertexBuffer(); }
+	const IndexBuffer* GetIndexBuffer() const { return m_Mesh->GetIndexBuffer(); }
+	const Mesh* GetMesh() const { return m_Mesh.get(); }
 
-	const DirectX::XMMATRIX& GetWorldMatrix() const { return m_World; }
+	// The matrices are brought up to date once per frame by GetTransforms().Update()
+	DirectX::XMMATRIX GetWorldMatrix() const { return DirectX::XMLoadFloat4x4A((const DirectX::XMFLOAT4X4A*) &m_Transforms.GetWorld(m_Transform)); }
+	DirectX::XMMATRIX GetWorldViewProjectionMatrix() const { return DirectX::XMLoadFloat4x4A((const DirectX::XMFLOAT4X4A*) &m_Transforms.GetWorldViewProjection(m_Transform)); }
 
-	const DirectX::XMVECTOR& GetPosition() const { return m_Position; }
-	void SetPosition(const DirectX::XMVECTOR& position) { m_Position = position; CalculateMatrix(); }
-	const DirectX::XMVECTOR& GetRotation() const { return m_Rotation; }
-	void SetRotation(const DirectX::XMVECTOR& rotation) { m_Rotation = rotation; CalculateMatrix(); }
+	DirectX::XMVECTOR GetPosition() const;
+	void SetPosition(const DirectX::XMVECTOR& position);
+	DirectX::XMVECTOR GetRotation() const;
+	void SetRotation(const DirectX::XMVECTOR& rotation);
 
-private:
-	void CalculateMatrix();
+	TransformHandle GetTransform() const { return m_Transform; }
+	static TransformStore& GetTransforms() { return m_Transforms; }
 
-	std::vector<Vertex> m_Vertices;
-	std::vector<unsigned int> m_Indices;
+private:
+	std::shared_ptr<Mesh> m_Mesh;
 	Material m_Material;
 
-	DirectX::XMMATRIX m_World;
-	DirectX::XMVECTOR m_Position;
-	DirectX::XMVECTOR m_Rotation;
-
-	VertexBuffer* m_VertexBuffer = nullptr;
-	IndexBuffer* m_IndexBuffer = nullptr;
+	TransformHandle m_Transform = InvalidTransform;
 
-	inline static VertexLayout m_VertexLayout =
-	{
-		{ "POSITION", ElementDataType::float3 },
-		{ "NORMAL", ElementDataType::float3 },
-		{ "COLOR", ElementDataType::float4 },
-		{ "TEXCOORD", ElementDataType::float2 }
-	};
+	// Transforms of every object live together, so the per-frame matrix update walks packed arrays instead of objects
+	inline static TransformStore m_Transforms;
 };
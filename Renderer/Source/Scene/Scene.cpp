@@ -1,10 +1,11 @@
+#include <algorithm>
 #include <Windows.h>
 #include "imgui.h"
 
 #include "Scene.h"
 
 Scene::Scene(bool* isOpen)
-	: m_IsOpen(isOpen)
+	: m_IsOpen(isOpen), m_Loader(MeshImporter::Import)
 {
 	HRESULT hr = CoInitializeEx(NULL, COINIT_MULTITHREADED);
 	if (FAILED(hr))
@@ -88,15 +89,53 @@ void Scene::AddObject()
 
 void Scene::AddObjectFromFile(std::string name, std::string filePath)
 {
-	try
+	auto job = m_Loader.Submit(name, filePath);
+	m_PendingObjects.push_back({ name, job, nullptr });
+}
+
+void Scene::ProcessImports()
+{
+	m_CompletedImports.clear();
+	m_Loader.PopCompleted(m_CompletedImports);
+
+	for (auto& job : m_CompletedImports)
 	{
-		p_CurrentObject = nullptr;
-		auto& obj = m_Objects.emplace_back(name, filePath);
-		++m_Stats.objects;
-		m_Stats.vertices += obj.GetVertices().size();
-		m_Stats.triangles += obj.GetIndices().size() / 3;
+		auto pending = std::find_if(m_PendingObjects.begin(), m_PendingObjects.end(), [&job](const PendingObject& object) { return object.job == job; });
+		if (pending == m_PendingObjects.end()) continue;
+
+		if (!job->succeeded)
+		{
+			MessageBox(NULL, L"Failed to load mesh!", L"Runtime Error", MB_OK | MB_ICONERROR);
+			m_PendingObjects.erase(pending);
+			continue;
+		}
+
+		pending->mesh = Mesh::Create(std::move(job->data));
+		pending->job = nullptr;
 	}
-	catch (...) {}
+
+	// Objects are added in the order they were requested, so one that finished early waits for those before it
+	size_t budget = UploadBudget;
+	size_t added = 0;
+	for (auto& pending : m_PendingObjects)
+	{
+		if (!pending.mesh) break;
+		if (!pending.mesh->IsUploaded() && (budget == 0 || !pending.mesh->Upload(budget))) break;
+
+		try
+		{
+			p_CurrentObject = nullptr;
+			auto& obj = m_Objects.emplace_back(pending.name, pending.mesh);
+			++m_Stats.objects;
+			m_Stats.vertices += obj.GetVertexCount();
+			m_Stats.triangles += obj.GetTriangleCount();
+		}
+		catch (...) {}
+
+		++added;
+	}
+
+	m_PendingObjects.erase(m_PendingObjects.begin(), m_PendingObjects.begin() + added);
 }
 
 void Scene::DrawObjects()
@@ -122,8 +161,8 @@ void Scene::DrawObjects()
 						if (p_CurrentObject == &object) p_CurrentObject = nullptr;
 
 						--m_Stats.objects;
-						m_Stats.vertices -= object.GetVertices().size();
-						m_Stats.triangles -= object.GetIndices().size() / 3;
+						m_Stats.vertices -= object.GetVertexCount();
+						m_Stats.triangles -= object.GetTriangleCount();
 
 						auto it = std::find(m_Objects.begin(), m_Objects.end(), object);
 						m_Objects.erase(it);
@@ -133,6 +172,15 @@ void Scene::DrawObjects()
 					ImGui::EndPopup();
 				}
 			}
+
+			for (auto& pending : m_PendingObjects)
+			{
+				ImGui::TextDisabled("%s", pending.name.c_str());
+				if (pending.mesh)
+					ImGui::ProgressBar(pending.mesh->GetUploadProgress(), ImVec2(-1.f, 0.f), "Uploading");
+				else
+					ImGui::ProgressBar(pending.job->progress.load(), ImVec2(-1.f, 0.f), "Importing");
+			}
 			ImGui::EndChild();
 
 			ImGui::End();
@@ -1,7 +1,9 @@
 #pragma once
 #include <shobjidl.h>
+#include <memory>
 #include <vector>
 
+#include "AsyncLoader.h"
 #include "Object.h"
 
 struct SceneStats
@@ -18,8 +20,12 @@ public:
 	~Scene();
 
 	void AddObject();
+	// The import runs in the background, the object shows up once ProcessImports() has uploaded it
 	void AddObjectFromFile(std::string name, std::string filePath);
 
+	// Called once per frame, turns finished imports into objects within the upload budget
+	void ProcessImports();
+
 	void DrawObjects();
 
 	std::vector<Object>& GetObjects() { return m_Objects; }
@@ -37,6 +43,21 @@ private:
 
 	SceneStats m_Stats;
 
+	// Objects whose mesh is still being imported or uploaded, in the order they were added
+	struct PendingObject
+	{
+		std::string name;
+		std::shared_ptr<ImportJob> job;
+		std::shared_ptr<Mesh> mesh;
+	};
+	std::vector<PendingObject> m_PendingObjects;
+	std::vector<std::shared_ptr<ImportJob>> m_CompletedImports;
+
+	// Bytes of geometry copied to the GPU per frame, so a huge mesh arriving doesn't stall a frame
+	static constexpr size_t UploadBudget = 16 * 1024 * 1024;
+
+	AsyncLoader m_Loader;
+
 	std::vector<Object> m_Objects;
 	Object* p_CurrentObject = nullptr;
 	float m_ObjectPosition[3];
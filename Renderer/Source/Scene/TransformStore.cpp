@@ -0,0 +1,333 @@
+#include <cmath>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <xmmintrin.h>
+#define TRANSFORM_STORE_SSE
+#endif
+
+#include "TransformStore.h"
+
+namespace
+{
+	enum DirtyFlags : uint8_t
+	{
+		MatrixDirty = 1, RotationDirty = 2
+	};
+
+	size_t PadToGroup(size_t count)
+	{
+		return (count + 7) & ~size_t(7);
+	}
+}
+
+TransformHandle TransformStore::Create()
+{
+	TransformHandle handle;
+	if (!m_FreeHandles.empty())
+	{
+		handle = m_FreeHandles.back();
+		m_FreeHandles.pop_back();
+	}
+	else
+	{
+		handle = (TransformHandle) m_Slots.size();
+		m_Slots.push_back(0);
+	}
+
+	uint32_t slot = (uint32_t) m_Count;
+	Resize(m_Count + 1);
+	m_Slots[handle] = slot;
+	m_Handles[slot] = handle;
+
+	m_PositionX[slot] = m_PositionY[slot] = m_PositionZ[slot] = 0.f;
+	m_Pitch[slot] = m_Yaw[slot] = m_Roll[slot] = 0.f;
+	for (int i = 0; i < 3; i++) m_LocalCenter[i][slot] = m_LocalExtent[i][slot] = 0.f;
+	m_Owners[slot] = nullptr;
+	MarkDirty(slot, MatrixDirty | RotationDirty);
+
+	return handle;
+}
+
+TransformHandle TransformStore::Clone(TransformHandle source)
+{
+	// Create() can grow the arrays, so the source's slot is looked up after it
+	TransformHandle handle = Create();
+	uint32_t from = m_Slots[source], slot = m_Slots[handle];
+
+	m_PositionX[slot] = m_PositionX[from];
+	m_PositionY[slot] = m_PositionY[from];
+	m_PositionZ[slot] = m_PositionZ[from];
+	m_Pitch[slot] = m_Pitch[from];
+	m_Yaw[slot] = m_Yaw[from];
+	m_Roll[slot] = m_Roll[from];
+	for (int i = 0; i < 3; i++)
+	{
+		m_LocalCenter[i][slot] = m_LocalCenter[i][from];
+		m_LocalExtent[i][slot] = m_LocalExtent[i][from];
+	}
+
+	return handle;
+}
+
+void TransformStore::Destroy(TransformHandle handle)
+{
+	uint32_t slot = m_Slots[handle];
+	uint32_t last = (uint32_t) m_Count - 1;
+
+	if (m_Dirty[slot]) --m_DirtyCount;
+
+	// Move the last transform into the hole so the arrays stay packed
+	if (slot != last)
+	{
+		m_PositionX[slot] = m_PositionX[last];
+		m_PositionY[slot] = m_PositionY[last];
+		m_PositionZ[slot] = m_PositionZ[last];
+		m_Pitch[slot] = m_Pitch[last];
+		m_Yaw[slot] = m_Yaw[last];
+		m_Roll[slot] = m_Roll[last];
+		for (auto& basis : m_Basis) basis[slot] = basis[last];
+		for (int i = 0; i < 3; i++)
+		{
+			m_LocalCenter[i][slot] = m_LocalCenter[i][last];
+			m_LocalExtent[i][slot] = m_LocalExtent[i][last];
+			m_WorldCenter[i][slot] = m_WorldCenter[i][last];
+			m_WorldExtent[i][slot] = m_WorldExtent[i][last];
+		}
+		m_Owners[slot] = m_Owners[last];
+		m_Dirty[slot] = m_Dirty[last];
+		m_World[slot] = m_World[last];
+		m_WorldViewProjection[slot] = m_WorldViewProjection[last];
+
+		m_Handles[slot] = m_Handles[last];
+		m_Slots[m_Handles[slot]] = slot;
+	}
+
+	m_Dirty[last] = 0;
+	m_FreeHandles.push_back(handle);
+	Resize(last);
+}
+
+void TransformStore::SetPosition(TransformHandle handle, float x, float y, float z)
+{
+	uint32_t slot = m_Slots[handle];
+	m_PositionX[slot] = x;
+	m_PositionY[slot] = y;
+	m_PositionZ[slot] = z;
+	MarkDirty(slot, MatrixDirty);
+}
+
+void TransformStore::SetRotation(TransformHandle handle, float pitch, float yaw, float roll)
+{
+	uint32_t slot = m_Slots[handle];
+	m_Pitch[slot] = pitch;
+	m_Yaw[slot] = yaw;
+	m_Roll[slot] = roll;
+	MarkDirty(slot, MatrixDirty | RotationDirty);
+}
+
+void TransformStore::GetPosition(TransformHandle handle, float& x, float& y, float& z) const
+{
+	uint32_t slot = m_Slots[handle];
+	x = m_PositionX[slot];
+	y = m_PositionY[slot];
+	z = m_PositionZ[slot];
+}
+
+void TransformStore::GetRotation(TransformHandle handle, float& pitch, float& yaw, float& roll) const
+{
+	uint32_t slot = m_Slots[handle];
+	pitch = m_Pitch[slot];
+	yaw = m_Yaw[slot];
+	roll = m_Roll[slot];
+}
+
+void TransformStore::SetBounds(TransformHandle handle, const float min[3], const float max[3])
+{
+	uint32_t slot = m_Slots[handle];
+	for (int i = 0; i < 3; i++)
+	{
+		m_LocalCenter[i][slot] = (min[i] + max[i]) * 0.5f;
+		m_LocalExtent[i][slot] = (max[i] - min[i]) * 0.5f;
+	}
+	MarkDirty(slot, MatrixDirty);
+}
+
+WorldBounds TransformStore::GetWorldBounds() const
+{
+	WorldBounds bounds;
+	for (int i = 0; i < 3; i++)
+	{
+		bounds.center[i] = m_WorldCenter[i].data();
+		bounds.extent[i] = m_WorldExtent[i].data();
+	}
+
+	return bounds;
+}
+
+void TransformStore::Update(const TransformMatrix& viewProjection)
+{
+	bool viewProjectionChanged = !m_HasViewProjection || memcmp(&viewProjection, &m_ViewProjection, sizeof(TransformMatrix)) != 0;
+	if (!viewProjectionChanged && m_DirtyCount == 0) return;
+
+	m_ViewProjection = viewProjection;
+	m_HasViewProjection = true;
+
+	// Rebuild the rotation rows of everything that was rotated, this is the same matrix as XMMatrixRotationRollPitchYaw
+	for (size_t i = 0; i < m_Count; i++)
+	{
+		if (!(m_Dirty[i] & RotationDirty)) continue;
+
+		float sp = std::sin(m_Pitch[i]), cp = std::cos(m_Pitch[i]);
+		float sy = std::sin(m_Yaw[i]), cy = std::cos(m_Yaw[i]);
+		float sr = std::sin(m_Roll[i]), cr = std::cos(m_Roll[i]);
+
+		m_Basis[0][i] = cr * cy + sr * sp * sy;
+		m_Basis[1][i] = sr * cp;
+		m_Basis[2][i] = sr * sp * cy - cr * sy;
+		m_Basis[3][i] = cr * sp * sy - sr * cy;
+		m_Basis[4][i] = cr * cp;
+		m_Basis[5][i] = sr * sy + cr * sp * cy;
+		m_Basis[6][i] = cp * sy;
+		m_Basis[7][i] = -sp;
+		m_Basis[8][i] = cp * cy;
+	}
+
+	// world = rotation * translation, worldViewProjection = world * viewProjection.
+	// Each group of four transforms is computed with one lane per transform, then transposed back into matrices.
+	// The world bounds are the rotated local box, re-fitted around its new center.
+	const auto& vp = viewProjection.m;
+	for (size_t group = 0; group < m_Count; group += 4)
+	{
+		if (!viewProjectionChanged)
+		{
+			uint32_t dirty;
+			memcpy(&dirty, &m_Dirty[group], sizeof(dirty));
+			if (dirty == 0) continue;
+		}
+
+#ifdef TRANSFORM_STORE_SSE
+		__m128 basis[9];
+		for (int i = 0; i < 9; i++) basis[i] = _mm_loadu_ps(&m_Basis[i][group]);
+		__m128 position[3] = { _mm_loadu_ps(&m_PositionX[group]), _mm_loadu_ps(&m_PositionY[group]), _mm_loadu_ps(&m_PositionZ[group]) };
+
+		const __m128 signMask = _mm_set1_ps(-0.f);
+		__m128 localCenter[3], localExtent[3];
+		for (int i = 0; i < 3; i++)
+		{
+			localCenter[i] = _mm_loadu_ps(&m_LocalCenter[i][group]);
+			localExtent[i] = _mm_loadu_ps(&m_LocalExtent[i][group]);
+		}
+
+		for (int column = 0; column < 3; column++)
+		{
+			__m128 center = position[column], extent = _mm_setzero_ps();
+			for (int row = 0; row < 3; row++)
+			{
+				center = _mm_add_ps(center, _mm_mul_ps(localCenter[row], basis[row * 3 + column]));
+				extent = _mm_add_ps(extent, _mm_mul_ps(localExtent[row], _mm_andnot_ps(signMask, basis[row * 3 + column])));
+			}
+			_mm_storeu_ps(&m_WorldCenter[column][group], center);
+			_mm_storeu_ps(&m_WorldExtent[column][group], extent);
+		}
+
+		for (int row = 0; row < 4; row++)
+		{
+			const __m128* in = row < 3 ? basis + row * 3 : position;
+
+			__m128 world[4] = { in[0], in[1], in[2], row < 3 ? _mm_setzero_ps() : _mm_set1_ps(1.f) };
+			__m128 wvp[4];
+			for (int column = 0; column < 4; column++)
+			{
+				wvp[column] = _mm_add_ps(_mm_add_ps(
+					_mm_mul_ps(in[0], _mm_set1_ps(vp[0][column])),
+					_mm_mul_ps(in[1], _mm_set1_ps(vp[1][column]))),
+					_mm_mul_ps(in[2], _mm_set1_ps(vp[2][column])));
+				if (row == 3) wvp[column] = _mm_add_ps(wvp[column], _mm_set1_ps(vp[3][column]));
+			}
+
+			_MM_TRANSPOSE4_PS(world[0], world[1], world[2], world[3]);
+			_MM_TRANSPOSE4_PS(wvp[0], wvp[1], wvp[2], wvp[3]);
+			for (int lane = 0; lane < 4; lane++)
+			{
+				_mm_store_ps(m_World[group + lane].m[row], world[lane]);
+				_mm_store_ps(m_WorldViewProjection[group + lane].m[row], wvp[lane]);
+			}
+		}
+#else
+		for (size_t i = group; i < group + 4; i++)
+		{
+			for (int column = 0; column < 3; column++)
+			{
+				float center = column == 0 ? m_PositionX[i] : column == 1 ? m_PositionY[i] : m_PositionZ[i];
+				float extent = 0.f;
+				for (int row = 0; row < 3; row++)
+				{
+					center += m_LocalCenter[row][i] * m_Basis[row * 3 + column][i];
+					extent += m_LocalExtent[row][i] * std::fabs(m_Basis[row * 3 + column][i]);
+				}
+				m_WorldCenter[column][i] = center;
+				m_WorldExtent[column][i] = extent;
+			}
+
+			const float* in[4][3] =
+			{
+				{ &m_Basis[0][i], &m_Basis[1][i], &m_Basis[2][i] },
+				{ &m_Basis[3][i], &m_Basis[4][i], &m_Basis[5][i] },
+				{ &m_Basis[6][i], &m_Basis[7][i], &m_Basis[8][i] },
+				{ &m_PositionX[i], &m_PositionY[i], &m_PositionZ[i] }
+			};
+
+			for (int row = 0; row < 4; row++)
+			{
+				float x = *in[row][0], y = *in[row][1], z = *in[row][2];
+				float w = row < 3 ? 0.f : 1.f;
+
+				m_World[i].m[row][0] = x;
+				m_World[i].m[row][1] = y;
+				m_World[i].m[row][2] = z;
+				m_World[i].m[row][3] = w;
+				for (int column = 0; column < 4; column++)
+					m_WorldViewProjection[i].m[row][column] = x * vp[0][column] + y * vp[1][column] + z * vp[2][column] + w * vp[3][column];
+			}
+		}
+#endif
+	}
+
+	memset(m_Dirty.data(), 0, m_Dirty.size());
+	m_DirtyCount = 0;
+}
+
+void TransformStore::Resize(size_t count)
+{
+	m_Count = count;
+	size_t padded = PadToGroup(count);
+	if (padded == m_Dirty.size()) return;
+
+	// Padding lanes get computed along with everything else, so they need to hold valid numbers
+	m_PositionX.resize(padded, 0.f);
+	m_PositionY.resize(padded, 0.f);
+	m_PositionZ.resize(padded, 0.f);
+	m_Pitch.resize(padded, 0.f);
+	m_Yaw.resize(padded, 0.f);
+	m_Roll.resize(padded, 0.f);
+	for (auto& basis : m_Basis) basis.resize(padded, 0.f);
+	for (int i = 0; i < 3; i++)
+	{
+		m_LocalCenter[i].resize(padded, 0.f);
+		m_LocalExtent[i].resize(padded, 0.f);
+		m_WorldCenter[i].resize(padded, 0.f);
+		m_WorldExtent[i].resize(padded, 0.f);
+	}
+	m_Owners.resize(padded, nullptr);
+	m_Dirty.resize(padded, 0);
+	m_Handles.resize(padded, InvalidTransform);
+	m_World.resize(padded);
+	m_WorldViewProjection.resize(padded);
+}
+
+void TransformStore::MarkDirty(uint32_t slot, uint8_t flags)
+{
+	if (!m_Dirty[slot]) ++m_DirtyCount;
+	m_Dirty[slot] |= flags;
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Row-major 4x4 matrix with the same memory layout as DirectX::XMFLOAT4X4A
+struct alignas(16) TransformMatrix
+{
+	float m[4][4];
+};
+
+// World-space bounding boxes of every transform, as centers and half extents in separate arrays
+struct WorldBounds
+{
+	const float* center[3];
+	const float* extent[3];
+};
+
+typedef uint32_t TransformHandle;
+constexpr TransformHandle InvalidTransform = ~0u;
+
+// Structure-of-arrays storage for object transforms.
+// Positions and rotations are kept in separate tightly packed arrays, edits only flag the transform as dirty,
+// and Update() rebuilds the world and world-view-projection matrices of the whole store in one pass, four transforms at a time.
+// Live transforms are always packed at the front of the arrays, handles stay valid while others are destroyed.
+class TransformStore
+{
+public:
+	TransformHandle Create();
+	// New transform with the position, rotation and bounds of source, and no owner
+	TransformHandle Clone(TransformHandle source);
+	void Destroy(TransformHandle handle);
+
+	// Rotation is in radians, as pitch, yaw and roll like DirectX::XMMatrixRotationRollPitchYaw
+	void SetPosition(TransformHandle handle, float x, float y, float z);
+	void SetRotation(TransformHandle handle, float pitch, float yaw, float roll);
+	void GetPosition(TransformHandle handle, float& x, float& y, float& z) const;
+	void GetRotation(TransformHandle handle, float& pitch, float& yaw, float& roll) const;
+
+	// Local-space bounding box of whatever the transform is attached to
+	void SetBounds(TransformHandle handle, const float min[3], const float max[3]);
+
+	// Lets whoever owns a transform be found again from its slot, e.g. after culling
+	void SetOwner(TransformHandle handle, void* owner) { m_Owners[m_Slots[handle]] = owner; }
+	void* GetOwner(size_t slot) const { return m_Owners[slot]; }
+
+	// Only valid after the Update() following the last change
+	const TransformMatrix& GetWorld(TransformHandle handle) const { return m_World[m_Slots[handle]]; }
+	const TransformMatrix& GetWorldViewProjection(TransformHandle handle) const { return m_WorldViewProjection[m_Slots[handle]]; }
+
+	// Recomputes the matrices and world bounds of every dirty transform, or of all of them if the view projection changed
+	void Update(const TransformMatrix& viewProjection);
+
+	// Indexed by slot, padded with empty boxes up to a multiple of eight
+	WorldBounds GetWorldBounds() const;
+
+	size_t GetSize() const { return m_Count; }
+
+private:
+	void Resize(size_t count);
+	void MarkDirty(uint32_t slot, uint8_t flags);
+
+	// Handle -> slot in the packed arrays, and back
+	std::vector<uint32_t> m_Slots;
+	std::vector<TransformHandle> m_Handles;
+	std::vector<TransformHandle> m_FreeHandles;
+	size_t m_Count = 0;
+
+	// Inputs, padded to a multiple of eight so passes four or eight wide never need a scalar tail
+	std::vector<float> m_PositionX, m_PositionY, m_PositionZ;
+	std::vector<float> m_Pitch, m_Yaw, m_Roll;
+	std::vector<float> m_LocalCenter[3], m_LocalExtent[3];
+	std::vector<void*> m_Owners;
+
+	// Rotation matrix rows, cached so the sines and cosines are only evaluated for dirty transforms
+	std::vector<float> m_Basis[9];
+
+	std::vector<uint8_t> m_Dirty;
+	size_t m_DirtyCount = 0;
+
+	// Outputs
+	std::vector<TransformMatrix> m_World;
+	std::vector<TransformMatrix> m_WorldViewProjection;
+	std::vector<float> m_WorldCenter[3], m_WorldExtent[3];
+
+	TransformMatrix m_ViewProjection = {};
+	bool m_HasViewProjection = false;
+};
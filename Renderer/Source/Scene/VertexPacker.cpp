@@ -0,0 +1,261 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+#include "VertexPacker.h"
+
+namespace
+{
+	bool InUnitRange(float value)
+	{
+		return value >= 0.f && value <= 1.f;
+	}
+
+	int16_t ToSnorm16(float value)
+	{
+		return (int16_t) std::lround(std::clamp(value, -1.f, 1.f) * 32767.f);
+	}
+
+	uint16_t ToUnorm16(float value)
+	{
+		return (uint16_t) std::lround(std::clamp(value, 0.f, 1.f) * 65535.f);
+	}
+
+	uint8_t ToUnorm8(float value)
+	{
+		return (uint8_t) std::lround(std::clamp(value, 0.f, 1.f) * 255.f);
+	}
+
+	// Writes count components of source as the element's type
+	void PackElement(ElementDataType type, const float* source, int count, uint8_t* destination)
+	{
+		switch (type)
+		{
+		case ElementDataType::float1:
+		case ElementDataType::float2:
+		case ElementDataType::float3:
+		case ElementDataType::float4:
+		{
+			int size = type == ElementDataType::float1 ? 1 : type == ElementDataType::float2 ? 2 : type == ElementDataType::float3 ? 3 : 4;
+			for (int i = 0; i < size; i++)
+			{
+				float value = i < count ? source[i] : 0.f;
+				memcpy(destination + i * sizeof(float), &value, sizeof(float));
+			}
+			break;
+		}
+		case ElementDataType::half2:
+		case ElementDataType::half4:
+		{
+			int size = type == ElementDataType::half2 ? 2 : 4;
+			for (int i = 0; i < size; i++)
+			{
+				uint16_t value = VertexPacker::FloatToHalf(i < count ? source[i] : 0.f);
+				memcpy(destination + i * sizeof(uint16_t), &value, sizeof(uint16_t));
+			}
+			break;
+		}
+		case ElementDataType::snorm16x2:
+		{
+			int16_t value[2] = { ToSnorm16(source[0]), ToSnorm16(count > 1 ? source[1] : 0.f) };
+			memcpy(destination, value, sizeof(value));
+			break;
+		}
+		case ElementDataType::unorm16x2:
+		{
+			uint16_t value[2] = { ToUnorm16(source[0]), ToUnorm16(count > 1 ? source[1] : 0.f) };
+			memcpy(destination, value, sizeof(value));
+			break;
+		}
+		case ElementDataType::unorm8x4:
+		{
+			for (int i = 0; i < 4; i++) destination[i] = ToUnorm8(i < count ? source[i] : 0.f);
+			break;
+		}
+		}
+	}
+}
+
+VertexLayout VertexPacker::ChooseLayout(const std::vector<Vertex>& vertices, uint32_t attributes)
+{
+	bool colorsInUnitRange = true;
+	bool texcoordsInUnitRange = true;
+	// Beyond this, half precision starts losing more than half a texel of a 1024 texture
+	bool texcoordsFitHalf = true;
+
+	for (auto& vertex : vertices)
+	{
+		colorsInUnitRange = colorsInUnitRange && InUnitRange(vertex.color.r) && InUnitRange(vertex.color.g) &&
+			InUnitRange(vertex.color.b) && InUnitRange(vertex.color.a);
+		texcoordsInUnitRange = texcoordsInUnitRange && InUnitRange(vertex.texcoord.u) && InUnitRange(vertex.texcoord.v);
+		texcoordsFitHalf = texcoordsFitHalf && std::fabs(vertex.texcoord.u) < 2.f && std::fabs(vertex.texcoord.v) < 2.f;
+	}
+
+	std::vector<VertexElement> elements = { { "POSITION", ElementDataType::float3 } };
+	if (attributes & VertexNormal) elements.push_back({ "NORMAL", ElementDataType::snorm16x2 });
+	if (attributes & VertexColor) elements.push_back({ "COLOR", colorsInUnitRange ? ElementDataType::unorm8x4 : ElementDataType::half4 });
+	if (attributes & VertexTexcoord)
+	{
+		elements.push_back({ "TEXCOORD", texcoordsInUnitRange ? ElementDataType::unorm16x2 : texcoordsFitHalf ? ElementDataType::half2 : ElementDataType::float2 });
+	}
+
+	return elements;
+}
+
+uint32_t VertexPacker::GetAttributes(const VertexLayout& layout)
+{
+	uint32_t attributes = 0;
+	for (auto& element : layout.elements)
+	{
+		if (element.semantic == "NORMAL") attributes |= VertexNormal;
+		else if (element.semantic == "COLOR") attributes |= VertexColor;
+		else if (element.semantic == "TEXCOORD") attributes |= VertexTexcoord;
+	}
+
+	return attributes;
+}
+
+void VertexPacker::Pack(const VertexLayout& layout, const std::vector<Vertex>& vertices, std::vector<uint8_t>& packed)
+{
+	packed.resize(vertices.size() * layout.stride);
+
+	unsigned int offset = 0;
+	for (auto& element : layout.elements)
+	{
+		// Find where the element comes from once, instead of for every vertex
+		size_t source = 0;
+		int count = 0;
+		if (element.semantic == "POSITION") { source = offsetof(Vertex, position); count = 3; }
+		else if (element.semantic == "NORMAL") { source = offsetof(Vertex, normal); count = 3; }
+		else if (element.semantic == "COLOR") { source = offsetof(Vertex, color); count = 4; }
+		else if (element.semantic == "TEXCOORD") { source = offsetof(Vertex, texcoord); count = 2; }
+
+		// Two components can only hold a normal in octahedral form
+		bool octahedral = element.semantic == "NORMAL" && element.type == ElementDataType::snorm16x2;
+
+		uint8_t* destination = packed.data() + offset;
+		for (auto& vertex : vertices)
+		{
+			const float* values = (const float*) ((const uint8_t*) &vertex + source);
+
+			if (count == 0)
+			{
+				memset(destination, 0, element.GetSize());
+			}
+			else if (octahedral)
+			{
+				float encoded[2];
+				EncodeOctahedral(values[0], values[1], values[2], encoded[0], encoded[1]);
+				PackElement(element.type, encoded, 2, destination);
+			}
+			else
+			{
+				PackElement(element.type, values, count, destination);
+			}
+
+			destination += layout.stride;
+		}
+
+		offset += element.GetSize();
+	}
+}
+
+uint16_t VertexPacker::FloatToHalf(float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+
+	uint32_t sign = (bits >> 16) & 0x8000;
+	uint32_t exponent = (bits >> 23) & 0xff;
+	uint32_t mantissa = bits & 0x7fffff;
+
+	// Infinity and NaN
+	if (exponent == 0xff) return (uint16_t) (sign | 0x7c00 | (mantissa ? 0x200 : 0));
+
+	int halfExponent = (int) exponent - 127 + 15;
+	if (halfExponent >= 0x1f) return (uint16_t) (sign | 0x7c00);
+
+	// Too small for a normal half, shift the mantissa into a denormal one
+	if (halfExponent <= 0)
+	{
+		if (halfExponent < -10) return (uint16_t) sign;
+
+		mantissa |= 0x800000;
+		uint32_t shift = (uint32_t) (14 - halfExponent);
+		uint32_t half = mantissa >> shift;
+		uint32_t remainder = mantissa & ((1u << shift) - 1);
+		uint32_t halfway = 1u << (shift - 1);
+		if (remainder > halfway || (remainder == halfway && (half & 1))) ++half;
+
+		return (uint16_t) (sign | half);
+	}
+
+	// Round to nearest even, a carry out of the mantissa correctly bumps the exponent
+	uint32_t half = ((uint32_t) halfExponent << 10) | (mantissa >> 13);
+	uint32_t remainder = mantissa & 0x1fff;
+	if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) ++half;
+
+	return (uint16_t) (sign | half);
+}
+
+float VertexPacker::HalfToFloat(uint16_t value)
+{
+	uint32_t sign = (uint32_t) (value & 0x8000) << 16;
+	uint32_t exponent = (value >> 10) & 0x1f;
+	uint32_t mantissa = value & 0x3ff;
+
+	uint32_t bits;
+	if (exponent == 0x1f)
+	{
+		bits = sign | 0x7f800000 | (mantissa << 13);
+	}
+	else if (exponent != 0)
+	{
+		bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+	}
+	else if (mantissa == 0)
+	{
+		bits = sign;
+	}
+	else
+	{
+		// Denormal, normalize it
+		exponent = 127 - 15 + 1;
+		while (!(mantissa & 0x400))
+		{
+			mantissa <<= 1;
+			--exponent;
+		}
+		bits = sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+	}
+
+	float result;
+	memcpy(&result, &bits, sizeof(result));
+	return result;
+}
+
+void VertexPacker::EncodeOctahedral(float x, float y, float z, float& u, float& v)
+{
+	float length = std::fabs(x) + std::fabs(y) + std::fabs(z);
+	if (length == 0.f)
+	{
+		u = v = 0.f;
+		return;
+	}
+
+	x /= length;
+	y /= length;
+
+	// Fold the lower hemisphere over the diagonals
+	if (z < 0.f)
+	{
+		float foldedX = (1.f - std::fabs(y)) * (x >= 0.f ? 1.f : -1.f);
+		float foldedY = (1.f - std::fabs(x)) * (y >= 0.f ? 1.f : -1.f);
+		x = foldedX;
+		y = foldedY;
+	}
+
+	u = x;
+	v = y;
+}
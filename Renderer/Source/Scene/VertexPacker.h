@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "Primitives/VertexLayout.h"
+#include "MeshImporter.h"
+
+// What a mesh has besides positions. Missing ones are left out of its layout, and the vertex shader permutation
+// for the mesh's attributes fills in a default for them
+enum VertexAttributes : uint32_t
+{
+	VertexNormal = 1 << 0,
+	VertexColor = 1 << 1,
+	VertexTexcoord = 1 << 2,
+	VertexAllAttributes = VertexNormal | VertexColor | VertexTexcoord
+};
+
+// Packs imported vertices into the smallest layout that still holds what the mesh actually contains.
+// Positions stay full floats, normals are octahedral encoded into two 16-bit values,
+// and colors and texture coordinates get the narrowest format their range allows.
+class VertexPacker
+{
+public:
+	// Bump whenever ChooseLayout() picks other formats or Pack() encodes them differently
+	static constexpr uint32_t FormatVersion = 1;
+
+	static VertexLayout ChooseLayout(const std::vector<Vertex>& vertices, uint32_t attributes);
+	// The VertexAttributes a layout holds
+	static uint32_t GetAttributes(const VertexLayout& layout);
+	// Writes vertices in the given layout, which may be any mix of the elements ChooseLayout() picks from
+	static void Pack(const VertexLayout& layout, const std::vector<Vertex>& vertices, std::vector<uint8_t>& packed);
+
+	static uint16_t FloatToHalf(float value);
+	static float HalfToFloat(uint16_t value);
+
+	// Maps a unit vector onto the [-1, 1] square, undone by DecodeOctahedral in the vertex shader
+	static void EncodeOctahedral(float x, float y, float z, float& u, float& v);
+};
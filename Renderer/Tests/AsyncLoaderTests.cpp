@@ -0,0 +1,224 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <stdexcept>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "Scene/AsyncLoader.h"
+
+namespace
+{
+	// Something to block workers on until the test lets them go
+	class Gate
+	{
+	public:
+		void Wait()
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			++m_Waiting;
+			m_Changed.notify_all();
+			m_Changed.wait(lock, [this]() { return m_Open; });
+		}
+
+		void WaitForWaiting(unsigned int count)
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_Changed.wait(lock, [this, count]() { return m_Waiting >= count; });
+		}
+
+		void Open()
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Open = true;
+			m_Changed.notify_all();
+		}
+
+	private:
+		std::mutex m_Mutex;
+		std::condition_variable m_Changed;
+		unsigned int m_Waiting = 0;
+		bool m_Open = false;
+	};
+
+	// Pops until count jobs came out, or gives up after a few seconds
+	std::vector<std::shared_ptr<ImportJob>> WaitForJobs(AsyncLoader& loader, size_t count)
+	{
+		std::vector<std::shared_ptr<ImportJob>> completed;
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+		while (completed.size() < count && std::chrono::steady_clock::now() < deadline)
+		{
+			if (loader.PopCompleted(completed) == 0) std::this_thread::yield();
+		}
+		return completed;
+	}
+}
+
+TEST(CompletionQueue, PopsOldestFirst)
+{
+	CompletionQueue<int> queue;
+	EXPECT_TRUE(queue.IsEmpty());
+	for (int i = 0; i < 100; i++) queue.Push(i);
+	EXPECT_FALSE(queue.IsEmpty());
+
+	// Appended after whatever is already there
+	std::vector<int> popped = { -1 };
+	EXPECT_EQ(100u, queue.PopAll(popped));
+	ASSERT_EQ(101u, popped.size());
+	for (int i = 0; i < 100; i++) EXPECT_EQ(i, popped[i + 1]);
+
+	EXPECT_TRUE(queue.IsEmpty());
+	EXPECT_EQ(0u, queue.PopAll(popped));
+	EXPECT_EQ(101u, popped.size());
+
+	queue.Push(7);
+	EXPECT_EQ(1u, queue.PopAll(popped));
+	EXPECT_EQ(7, popped.back());
+}
+
+TEST(CompletionQueue, ManyProducers)
+{
+	// Producers push while the consumer drains, everything comes out once and in the order each producer pushed it
+	constexpr int Producers = 4;
+	constexpr int Pushes = 20000;
+	CompletionQueue<std::pair<int, int>> queue;
+
+	std::atomic<int> running{ Producers };
+	std::vector<std::thread> threads;
+	for (int producer = 0; producer < Producers; producer++)
+	{
+		threads.emplace_back([&queue, &running, producer]()
+		{
+			for (int i = 0; i < Pushes; i++) queue.Push({ producer, i });
+			--running;
+		});
+	}
+
+	std::vector<std::pair<int, int>> popped;
+	while (running > 0) queue.PopAll(popped);
+	for (auto& thread : threads) thread.join();
+	queue.PopAll(popped);
+
+	ASSERT_EQ(size_t(Producers) * Pushes, popped.size());
+	int next[Producers] = {};
+	for (auto& value : popped) ASSERT_EQ(next[value.first]++, value.second) << "producer " << value.first;
+}
+
+TEST(CompletionQueue, FreesWhatWasNeverPopped)
+{
+	auto value = std::make_shared<int>(1);
+	{
+		CompletionQueue<std::shared_ptr<int>> queue;
+		for (int i = 0; i < 10; i++) queue.Push(value);
+		EXPECT_EQ(11, value.use_count());
+	}
+	EXPECT_EQ(1, value.use_count());
+}
+
+TEST(AsyncLoader, CompletesEveryJob)
+{
+	AsyncLoader loader([](const std::string& file, MeshData& data, std::atomic<float>* progress)
+	{
+		progress->store(0.5f);
+		if (file == "throws") throw std::runtime_error("import failed");
+		data.indices.assign(file.size(), 0);
+		return file != "fails";
+	}, 3);
+	EXPECT_EQ(3u, loader.GetWorkerCount());
+
+	std::vector<std::shared_ptr<ImportJob>> submitted;
+	for (int i = 0; i < 100; i++)
+	{
+		const char* file = i % 10 == 3 ? "fails" : i % 10 == 7 ? "throws" : "file";
+		submitted.push_back(loader.Submit("Job " + std::to_string(i), file));
+	}
+
+	std::vector<std::shared_ptr<ImportJob>> completed = WaitForJobs(loader, submitted.size());
+	ASSERT_EQ(submitted.size(), completed.size());
+
+	// Every job exactly once, the ones that failed or threw marked as such
+	std::sort(completed.begin(), completed.end());
+	EXPECT_EQ(completed.end(), std::adjacent_find(completed.begin(), completed.end()));
+	for (auto& job : submitted)
+	{
+		EXPECT_TRUE(std::binary_search(completed.begin(), completed.end(), job)) << job->name;
+		EXPECT_EQ(1.f, job->progress.load());
+		EXPECT_EQ(job->file == "file", job->succeeded) << job->name;
+		if (job->file != "throws")
+		{
+			EXPECT_EQ(job->file.size(), job->data.indices.size());
+		}
+	}
+
+	std::vector<std::shared_ptr<ImportJob>> more;
+	EXPECT_EQ(0u, loader.PopCompleted(more));
+}
+
+TEST(AsyncLoader, OneWorkerKeepsOrder)
+{
+	AsyncLoader loader([](const std::string&, MeshData&, std::atomic<float>*) { return true; }, 1);
+
+	std::vector<std::shared_ptr<ImportJob>> submitted;
+	for (int i = 0; i < 50; i++) submitted.push_back(loader.Submit(std::to_string(i), "file"));
+
+	EXPECT_EQ(submitted, WaitForJobs(loader, submitted.size()));
+}
+
+TEST(AsyncLoader, PicksAWorkerCount)
+{
+	AsyncLoader loader([](const std::string&, MeshData&, std::atomic<float>*) { return true; });
+	EXPECT_GE(loader.GetWorkerCount(), 1u);
+	EXPECT_LE(loader.GetWorkerCount(), 4u);
+}
+
+TEST(AsyncLoader, ShutdownWaitsForRunningJobsOnly)
+{
+	Gate gate;
+	std::atomic<int> imports{ 0 };
+	std::vector<std::shared_ptr<ImportJob>> submitted;
+
+	auto loader = std::make_unique<AsyncLoader>([&](const std::string&, MeshData&, std::atomic<float>*)
+	{
+		++imports;
+		gate.Wait();
+		return true;
+	}, 2);
+	for (int i = 0; i < 20; i++) submitted.push_back(loader->Submit(std::to_string(i), "file"));
+
+	// Both workers are busy with the first two jobs, the rest are queued
+	gate.WaitForWaiting(2);
+
+	std::atomic<bool> destroyed{ false };
+	std::thread shutdown([&]()
+	{
+		loader.reset();
+		destroyed = true;
+	});
+
+	// The destructor waits for the running imports, give it a moment to be stuck there
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	EXPECT_FALSE(destroyed);
+	gate.Open();
+	shutdown.join();
+	EXPECT_TRUE(destroyed);
+
+	// The queued jobs were dropped without ever starting
+	EXPECT_EQ(2, imports.load());
+	int finished = 0;
+	for (auto& job : submitted) finished += job->progress.load() == 1.f;
+	EXPECT_EQ(2, finished);
+}
+
+TEST(AsyncLoader, ShutdownWhileIdle)
+{
+	// Nothing submitted, or everything already collected, the workers are all waiting for work
+	for (unsigned int workers : { 1u, 4u })
+	{
+		AsyncLoader idle([](const std::string&, MeshData&, std::atomic<float>*) { return true; }, workers);
+
+		AsyncLoader drained([](const std::string&, MeshData&, std::atomic<float>*) { return true; }, workers);
+		drained.Submit("Job", "file");
+		EXPECT_EQ(1u, WaitForJobs(drained, 1).size());
+	}
+}
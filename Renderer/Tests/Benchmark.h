@@ -0,0 +1,30 @@
+#pragma once
+#include <chrono>
+#include <cstdio>
+
+#include "gtest/gtest.h"
+
+// Runs run() over and over for at least minSeconds, then prints and records the mean time of a run in microseconds.
+// Benchmarks are plain tests, so gtest's filters pick which ones run
+template<typename Function>
+double Benchmark(const char* name, Function&& run, double minSeconds = 0.25)
+{
+	// Once first, so whatever it sets up on the first call isn't timed
+	run();
+
+	using Clock = std::chrono::steady_clock;
+	size_t runs = 0;
+	auto start = Clock::now();
+	double elapsed = 0.0;
+	do
+	{
+		run();
+		++runs;
+		elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+	} while (elapsed < minSeconds);
+
+	double microseconds = elapsed * 1e6 / (double) runs;
+	printf("[ BENCH    ] %s: %.3f us over %zu runs\n", name, microseconds, runs);
+	testing::Test::RecordProperty(name, std::to_string(microseconds));
+	return microseconds;
+}
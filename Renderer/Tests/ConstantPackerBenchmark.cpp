@@ -0,0 +1,27 @@
+#include "Benchmark.h"
+
+#include "Primitives/ConstantPacker.h"
+
+// Packing the object and material records of a frame of draws, the way Render() does before its single upload
+TEST(ConstantPackerBenchmark, Frame)
+{
+	struct ObjectRecord { float world[16]; float worldViewProjection[16]; };
+	struct MaterialRecord { float color[4]; float specular[4]; };
+	ObjectRecord object = {};
+	MaterialRecord material = {};
+
+	ConstantPacker packer;
+	for (unsigned int draws : { 1000u, 10000u, 100000u })
+	{
+		Benchmark((std::to_string(draws) + " draws").c_str(), [&]()
+		{
+			packer.Reset();
+			for (unsigned int i = 0; i < draws; i++)
+			{
+				packer.Push(&object, sizeof(object));
+				packer.Push(&material, sizeof(material));
+			}
+		});
+		EXPECT_EQ(draws * 2 * ConstantPacker::RecordAlignment, packer.GetSize());
+	}
+}
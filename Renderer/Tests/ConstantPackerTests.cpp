@@ -0,0 +1,103 @@
+#include <cstring>
+#include <random>
+
+#include "gtest/gtest.h"
+
+#include "Primitives/ConstantPacker.h"
+
+namespace
+{
+	// Pushes a record of the given size filled with a pattern that tells records apart
+	uint32_t PushPattern(ConstantPacker& packer, uint32_t size, uint8_t seed, std::vector<uint8_t>& record)
+	{
+		record.resize(size);
+		for (uint32_t i = 0; i < size; i++) record[i] = (uint8_t) (seed + i * 7);
+		return packer.Push(record.data(), size);
+	}
+
+	// The record is where it was pushed, with only zeroes after it up to the next record
+	void ExpectRecord(const ConstantPacker& packer, uint32_t offset, const std::vector<uint8_t>& record)
+	{
+		const uint8_t* data = packer.GetRecord(offset);
+		EXPECT_EQ(data, packer.GetData() + offset);
+		EXPECT_EQ(0, memcmp(record.data(), data, record.size())) << "record at " << offset;
+
+		uint32_t recordSize = ConstantPacker::GetRecordSize((uint32_t) record.size());
+		for (uint32_t i = (uint32_t) record.size(); i < recordSize; i++) ASSERT_EQ(0, data[i]) << "padding byte " << i << " of record at " << offset;
+	}
+}
+
+TEST(ConstantPacker, RecordSizes)
+{
+	EXPECT_EQ(0u, ConstantPacker::GetRecordSize(0));
+	for (uint32_t size = 1; size <= 4 * ConstantPacker::RecordAlignment; size++)
+	{
+		uint32_t recordSize = ConstantPacker::GetRecordSize(size);
+		ASSERT_EQ(0u, recordSize % ConstantPacker::RecordAlignment) << size;
+		ASSERT_GE(recordSize, size);
+		ASSERT_LT(recordSize - size, ConstantPacker::RecordAlignment);
+	}
+}
+
+TEST(ConstantPacker, AlignsRecords)
+{
+	std::mt19937 random(1);
+	std::uniform_int_distribution<uint32_t> sizes(1, 600);
+
+	ConstantPacker packer;
+	std::vector<std::vector<uint8_t>> records(1000);
+	std::vector<uint32_t> offsets;
+	uint32_t expected = 0;
+	for (size_t i = 0; i < records.size(); i++)
+	{
+		// Around the alignment as well as anywhere
+		uint32_t size = i < 6 ? ConstantPacker::RecordAlignment + (uint32_t) i - 3 : sizes(random);
+		uint32_t offset = PushPattern(packer, size, (uint8_t) i, records[i]);
+		offsets.push_back(offset);
+
+		// Back to back, each on a boundary D3D11.1 can bind a range at: a multiple of 16 constants, 16 constants long or more
+		EXPECT_EQ(expected, offset);
+		EXPECT_EQ(0u, offset % ConstantPacker::RecordAlignment);
+		EXPECT_EQ(0u, offset / ConstantPacker::ConstantSize % 16);
+		EXPECT_EQ(0u, ConstantPacker::GetRecordSize(size) / ConstantPacker::ConstantSize % 16);
+		expected += ConstantPacker::GetRecordSize(size);
+	}
+	EXPECT_EQ(expected, packer.GetSize());
+
+	// Growing moved everything, but kept all of it
+	for (size_t i = 0; i < records.size(); i++) ExpectRecord(packer, offsets[i], records[i]);
+}
+
+TEST(ConstantPacker, WrapsAroundEveryFrame)
+{
+	ConstantPacker packer;
+
+	// A big frame first, then smaller ones over the same memory
+	std::vector<std::vector<uint8_t>> frame(200);
+	for (auto& pushed : frame) PushPattern(packer, ConstantPacker::RecordAlignment, 0xAB, pushed);
+	const uint8_t* data = packer.GetData();
+
+	for (uint8_t seed = 1; seed <= 5; seed++)
+	{
+		packer.Reset();
+		EXPECT_EQ(0u, packer.GetSize());
+
+		// Shorter records than last time, so their padding covers bytes the last frame wrote
+		std::vector<std::vector<uint8_t>> records(50 * seed);
+		for (size_t i = 0; i < records.size(); i++)
+		{
+			uint32_t offset = PushPattern(packer, 16 * seed + (uint32_t) i % 3, (uint8_t) (seed * 31 + i), records[i]);
+			EXPECT_EQ(i * ConstantPacker::RecordAlignment, offset);
+		}
+		for (size_t i = 0; i < records.size(); i++) ExpectRecord(packer, (uint32_t) i * ConstantPacker::RecordAlignment, records[i]);
+
+		// Frames no bigger than the biggest so far reuse its memory
+		EXPECT_EQ(data, packer.GetData());
+	}
+
+	// Past the end of everything used so far, the packer grows again
+	packer.Reset();
+	std::vector<std::vector<uint8_t>> bigger(1000);
+	for (size_t i = 0; i < bigger.size(); i++) PushPattern(packer, 100, (uint8_t) i, bigger[i]);
+	for (size_t i = 0; i < bigger.size(); i++) ExpectRecord(packer, (uint32_t) i * ConstantPacker::RecordAlignment, bigger[i]);
+}
@@ -0,0 +1,41 @@
+#include <random>
+
+#include "Benchmark.h"
+
+#include "Renderer/Culling.h"
+#include "ReferenceScene.h"
+#include "CullingPath.h"
+
+// Frustum culling a scene's worth of boxes spread all around the camera, about a fifth of them in view
+TEST(CullingBenchmark, CullBounds)
+{
+	if (!IsCullingPathSupported()) return;
+
+	float camera[] = { 0.f, 2.f, 0.f };
+	Frustum frustum = ExtractFrustum(MakeViewProjection(camera, 0.3f, 1.2f, 16.f / 9.f, 0.1f, 400.f));
+
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> position(-400.f, 400.f), size(0.1f, 10.f);
+	for (size_t count : { 1000u, 10000u, 100000u })
+	{
+		std::vector<float> center[3], extent[3];
+		WorldBounds bounds;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			for (size_t box = 0; box < (count + 7) / 8 * 8; box++)
+			{
+				center[axis].push_back(position(random));
+				extent[axis].push_back(size(random));
+			}
+			bounds.center[axis] = center[axis].data();
+			bounds.extent[axis] = extent[axis].data();
+		}
+
+		std::vector<uint32_t> visible(count);
+		size_t visibleCount = 0;
+		std::string name = std::to_string(count) + " boxes, " CULLING_TEST_PATH;
+		Benchmark(name.c_str(), [&]() { visibleCount = CullBounds(frustum, bounds, count, visible.data()); });
+		EXPECT_GT(visibleCount, 0u);
+		EXPECT_LT(visibleCount, count);
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdio>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// CullBounds() picks its path when Culling.cpp is compiled. The executables testing the AVX and scalar paths are built with
+// CULLING_TEST_AVX or CULLING_NO_SIMD, everything else gets whatever the build targets
+#if defined(CULLING_TEST_AVX)
+#define CULLING_TEST_PATH "AVX"
+#elif defined(CULLING_NO_SIMD)
+#define CULLING_TEST_PATH "scalar"
+#elif defined(__AVX__)
+#define CULLING_TEST_PATH "AVX"
+#elif defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define CULLING_TEST_PATH "SSE"
+#else
+#define CULLING_TEST_PATH "scalar"
+#endif
+
+// Culling.cpp built for AVX can't run on a CPU without it, so its tests only say so and pass there
+inline bool IsCullingPathSupported()
+{
+#if defined(CULLING_TEST_AVX) && defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 1);
+	bool supported = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+#elif defined(CULLING_TEST_AVX)
+	bool supported = __builtin_cpu_supports("avx");
+#else
+	bool supported = true;
+#endif
+
+	if (!supported) printf("[ SKIPPED  ] the CPU has no AVX\n");
+	return supported;
+}
@@ -0,0 +1,266 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+#include "gtest/gtest.h"
+
+#include "Renderer/Culling.h"
+#include "ReferenceScene.h"
+#include "CullingPath.h"
+
+namespace
+{
+	// Boxes, padded to a multiple of eight with boxes that would be visible if anything read them
+	struct Boxes
+	{
+		std::vector<float> center[3];
+		std::vector<float> extent[3];
+		size_t count = 0;
+
+		void Add(const double c[3], const double e[3])
+		{
+			for (int axis = 0; axis < 3; axis++)
+			{
+				center[axis].push_back((float) c[axis]);
+				extent[axis].push_back((float) e[axis]);
+			}
+			count++;
+		}
+
+		WorldBounds Pad(const float camera[3])
+		{
+			for (int axis = 0; axis < 3; axis++)
+			{
+				center[axis].resize(count, 0.f);
+				extent[axis].resize(count, 0.f);
+				center[axis].resize((count + 7) / 8 * 8, camera[axis]);
+				extent[axis].resize((count + 7) / 8 * 8, 1.f);
+			}
+
+			WorldBounds bounds;
+			for (int axis = 0; axis < 3; axis++)
+			{
+				bounds.center[axis] = center[axis].data();
+				bounds.extent[axis] = extent[axis].data();
+			}
+			return bounds;
+		}
+	};
+
+	enum class Reference { Inside, Outside, TooClose };
+
+	// A box is kept unless all eight of its corners are behind the same plane, in double precision.
+	// Boxes with their farthest corner so close to a plane that rounding could put it on either side can go either way
+	Reference TestCorners(const Frustum& frustum, const Boxes& boxes, size_t box)
+	{
+		bool inside = true, tooClose = false;
+		for (auto& plane : frustum.planes)
+		{
+			double farthest = -INFINITY, scale = std::fabs(plane[3]);
+			for (int corner = 0; corner < 8; corner++)
+			{
+				double distance = plane[3];
+				for (int axis = 0; axis < 3; axis++)
+				{
+					double position = (double) boxes.center[axis][box] + ((corner >> axis) & 1 ? boxes.extent[axis][box] : -boxes.extent[axis][box]);
+					distance += position * plane[axis];
+					scale += std::fabs(position * plane[axis]);
+				}
+				farthest = std::max(farthest, distance);
+			}
+
+			if (std::fabs(farthest) <= scale * 1e-6) tooClose = true;
+			if (farthest < 0.0) inside = false;
+		}
+
+		if (tooClose) return Reference::TooClose;
+		return inside ? Reference::Inside : Reference::Outside;
+	}
+
+	// Compares CullBounds() against the reference, returns how many boxes it kept
+	size_t ExpectMatchesReference(const Frustum& frustum, Boxes& boxes, const float camera[3])
+	{
+		WorldBounds bounds = boxes.Pad(camera);
+		std::vector<uint32_t> visible(boxes.count);
+		size_t visibleCount = CullBounds(frustum, bounds, boxes.count, visible.data());
+		EXPECT_LE(visibleCount, boxes.count);
+		visible.resize(visibleCount);
+
+		// In order, so the kept boxes can be walked through the list
+		EXPECT_TRUE(std::is_sorted(visible.begin(), visible.end()));
+
+		size_t tooClose = 0;
+		for (size_t box = 0, next = 0; box < boxes.count; box++)
+		{
+			bool kept = next < visible.size() && visible[next] == box;
+			if (kept) next++;
+
+			Reference reference = TestCorners(frustum, boxes, box);
+			if (reference == Reference::TooClose)
+			{
+				tooClose++;
+				continue;
+			}
+			EXPECT_EQ(reference == Reference::Inside, kept) << CULLING_TEST_PATH " path, box " << box << " at " << boxes.center[0][box] << ", " <<
+				boxes.center[1][box] << ", " << boxes.center[2][box];
+		}
+		EXPECT_LT(tooClose, boxes.count / 100 + 1);
+
+		return visibleCount;
+	}
+
+	// A camera somewhere random, looking somewhere random
+	struct Camera
+	{
+		float position[3];
+		float yaw, fovY, aspect, nearZ, farZ;
+		TransformMatrix viewProjection;
+
+		explicit Camera(std::mt19937& random)
+		{
+			auto uniform = [&](float min, float max) { return std::uniform_real_distribution<float>(min, max)(random); };
+			for (float& axis : position) axis = uniform(-100.f, 100.f);
+			yaw = uniform(-3.14f, 3.14f);
+			fovY = uniform(0.3f, 2.f);
+			aspect = uniform(0.5f, 2.5f);
+			nearZ = uniform(0.05f, 2.f);
+			farZ = nearZ + uniform(10.f, 300.f);
+			viewProjection = MakeViewProjection(position, yaw, fovY, aspect, nearZ, farZ);
+		}
+
+		// The point at x and y in normalized device coordinates, depth units in front of the camera
+		void GetPoint(double x, double y, double depth, double point[3]) const
+		{
+			double right[3] = { std::cos(yaw), 0.0, -std::sin(yaw) }, up[3] = { 0.0, 1.0, 0.0 }, forward[3] = { std::sin(yaw), 0.0, std::cos(yaw) };
+			double tanY = std::tan(fovY * 0.5), tanX = tanY * aspect;
+			for (int axis = 0; axis < 3; axis++)
+				point[axis] = position[axis] + forward[axis] * depth + right[axis] * x * depth * tanX + up[axis] * y * depth * tanY;
+		}
+	};
+}
+
+TEST(Culling, ExtractFrustum)
+{
+	std::mt19937 random(1);
+	for (int i = 0; i < 100; i++)
+	{
+		Camera camera(random);
+		Frustum frustum = ExtractFrustum(camera.viewProjection);
+
+		// The frustum's corners are on three of its planes each, and in front of the other three
+		for (int corner = 0; corner < 8; corner++)
+		{
+			double x = corner & 1 ? 1.0 : -1.0, y = corner & 2 ? 1.0 : -1.0, depth = corner & 4 ? camera.farZ : camera.nearZ;
+			double point[3];
+			camera.GetPoint(x, y, depth, point);
+
+			const auto& m = camera.viewProjection.m;
+			const int columns[6] = { 0, 0, 1, 1, 2, 2 };
+			bool onPlane[6] = { x < 0.0, x > 0.0, y < 0.0, y > 0.0, !(corner & 4), (corner & 4) != 0 };
+			for (int plane = 0; plane < 6; plane++)
+			{
+				auto& p = frustum.planes[plane];
+				double length = std::sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+				double distance = (p[0] * point[0] + p[1] * point[1] + p[2] * point[2] + p[3]) / length;
+				// Planes are sums and differences of the matrix's columns, the far plane of two nearly equal ones, so they are only
+				// as exact as the float columns they came from
+				double scale = std::fabs(m[3][3]) + std::fabs(m[3][columns[plane]]);
+				for (int i = 0; i < 3; i++) scale += (std::fabs(m[i][3]) + std::fabs(m[i][columns[plane]])) * std::fabs(point[i]);
+				double tolerance = 1e-6 * scale / length;
+				if (onPlane[plane]) EXPECT_NEAR(0.0, distance, tolerance) << "plane " << plane << ", corner " << corner;
+				else EXPECT_GT(distance, 0.0) << "plane " << plane << ", corner " << corner;
+			}
+		}
+	}
+}
+
+TEST(Culling, RandomBoxesMatchCorners)
+{
+	if (!IsCullingPathSupported()) return;
+
+	std::mt19937 random(2);
+	auto uniform = [&](double min, double max) { return std::uniform_real_distribution<double>(min, max)(random); };
+	for (int i = 0; i < 50; i++)
+	{
+		Camera camera(random);
+		Frustum frustum = ExtractFrustum(camera.viewProjection);
+
+		// Anywhere around the frustum, from specks to boxes bigger than it, an odd count so the last group is partial
+		Boxes boxes;
+		for (int box = 0; box < 1001; box++)
+		{
+			double point[3], extent[3];
+			camera.GetPoint(uniform(-3.0, 3.0), uniform(-3.0, 3.0), uniform(-camera.farZ, camera.farZ * 1.5), point);
+			double size = box % 10 == 0 ? uniform(10.0, 200.0) : uniform(0.01, 5.0);
+			for (double& axis : extent) axis = size * uniform(0.1, 1.0);
+			boxes.Add(point, extent);
+		}
+
+		size_t visible = ExpectMatchesReference(frustum, boxes, camera.position);
+		EXPECT_GT(visible, 0u);
+		EXPECT_LT(visible, boxes.count);
+	}
+}
+
+TEST(Culling, BoxesStraddlingPlanes)
+{
+	if (!IsCullingPathSupported()) return;
+
+	std::mt19937 random(3);
+	auto uniform = [&](double min, double max) { return std::uniform_real_distribution<double>(min, max)(random); };
+	for (int i = 0; i < 50; i++)
+	{
+		Camera camera(random);
+		Frustum frustum = ExtractFrustum(camera.viewProjection);
+
+		// Centered on a face of the frustum, then pushed out past it by a fraction or a multiple of the box's own size
+		Boxes boxes;
+		for (int box = 0; box < 600; box++)
+		{
+			int plane = box % 6;
+			double x = uniform(-1.0, 1.0), y = uniform(-1.0, 1.0), depth = uniform(camera.nearZ, camera.farZ);
+			if (plane < 2) x = plane == 0 ? -1.0 : 1.0;
+			else if (plane < 4) y = plane == 2 ? -1.0 : 1.0;
+			else depth = plane == 4 ? camera.nearZ : camera.farZ;
+
+			double point[3], extent[3];
+			camera.GetPoint(x, y, depth, point);
+			for (double& axis : extent) axis = uniform(0.01, 2.0);
+
+			auto& p = frustum.planes[plane];
+			double length = std::sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+			double reach = (extent[0] * std::fabs(p[0]) + extent[1] * std::fabs(p[1]) + extent[2] * std::fabs(p[2])) / length;
+			double push = box / 6 % 3 == 0 ? 0.0 : reach * (box / 6 % 3 == 1 ? uniform(0.0, 0.99) : uniform(1.01, 3.0));
+			for (int axis = 0; axis < 3; axis++) point[axis] -= p[axis] / length * push;
+
+			boxes.Add(point, extent);
+		}
+
+		ExpectMatchesReference(frustum, boxes, camera.position);
+	}
+}
+
+TEST(Culling, EveryGroupTail)
+{
+	if (!IsCullingPathSupported()) return;
+
+	// Every count up to a few groups, with everything in view, so only the padding is left out
+	float camera[] = { 0.f, 0.f, 0.f };
+	Frustum frustum = ExtractFrustum(MakeViewProjection(camera, 0.f, 1.f, 1.f, 0.1f, 100.f));
+	for (size_t count = 0; count <= 25; count++)
+	{
+		Boxes boxes;
+		for (size_t box = 0; box < count; box++)
+		{
+			double center[] = { 0.0, 0.0, 10.0 + (double) box }, extent[] = { 1.0, 1.0, 1.0 };
+			boxes.Add(center, extent);
+		}
+
+		WorldBounds bounds = boxes.Pad(camera);
+		std::vector<uint32_t> visible(count + 8, ~0u);
+		ASSERT_EQ(count, CullBounds(frustum, bounds, count, visible.data()));
+		for (size_t box = 0; box < count; box++) EXPECT_EQ(box, visible[box]);
+		EXPECT_EQ(~0u, visible[count]);
+	}
+}
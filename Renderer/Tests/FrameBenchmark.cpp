@@ -0,0 +1,32 @@
+#include "Benchmark.h"
+
+#include "Primitives/NullBackend.h"
+#include "ReferenceFrame.h"
+
+// The CPU cost of a frame, recording it and replaying it through the null backend, without anything the device would add
+TEST(FrameBenchmark, RecordAndReplay)
+{
+	for (unsigned int groups : { 200u, 2000u, 20000u })
+	{
+		ReferenceFrame frame;
+		frame.opaqueGroups = groups;
+		frame.clusteredGroups = groups / 10;
+
+		CommandList list;
+		NullBackend backend;
+		std::string name = std::to_string(groups) + " groups";
+		Benchmark((name + ", record").c_str(), [&]()
+		{
+			list.Clear();
+			frame.Record(list);
+		});
+		Benchmark((name + ", replay").c_str(), [&]()
+		{
+			backend.Reset();
+			backend.Execute(list);
+		});
+
+		EXPECT_TRUE(backend.GetErrors().empty());
+		EXPECT_EQ(frame.GetDraws(), backend.GetStats().draws);
+	}
+}
@@ -0,0 +1,34 @@
+#include <cmath>
+#include <random>
+
+#include "Benchmark.h"
+
+#include "Renderer/LightClusters.h"
+
+// Binning lights of a few units' reach spread through the view of a camera at the origin looking down +z
+TEST(LightClustersBenchmark, Build)
+{
+	TransformMatrix view = {};
+	for (int i = 0; i < 4; i++) view.m[i][i] = 1.f;
+	float projectionY = 1.f / std::tan(0.6f), projectionX = projectionY * 9.f / 16.f;
+
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> unit(-1.f, 1.f), depth(0.1f, 200.f), range(1.f, 10.f);
+	for (size_t count : { 256u, 1024u, 4096u })
+	{
+		std::vector<PointLight> lights(count);
+		for (PointLight& light : lights)
+		{
+			float z = depth(random);
+			light.position[0] = unit(random) * z / projectionX;
+			light.position[1] = unit(random) * z / projectionY;
+			light.position[2] = z;
+			light.range = range(random);
+		}
+
+		LightClusters clusters;
+		std::string name = std::to_string(count) + " lights";
+		Benchmark(name.c_str(), [&]() { clusters.Build(lights.data(), lights.size(), view, projectionX, projectionY, 0.1f, 200.f); });
+		EXPECT_GE(clusters.GetLightIndices().size(), count / 2);
+	}
+}
@@ -0,0 +1,336 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "gtest/gtest.h"
+
+#include "Renderer/LightClusters.h"
+
+namespace
+{
+	struct Vector
+	{
+		double x, y, z;
+
+		Vector operator +(const Vector& other) const { return { x + other.x, y + other.y, z + other.z }; }
+		Vector operator -(const Vector& other) const { return { x - other.x, y - other.y, z - other.z }; }
+		Vector operator *(double scale) const { return { x * scale, y * scale, z * scale }; }
+		double Dot(const Vector& other) const { return x * other.x + y * other.y + z * other.z; }
+	};
+
+	// Closest point to p on the triangle abc, from Real-Time Collision Detection
+	Vector ClosestOnTriangle(const Vector& p, const Vector& a, const Vector& b, const Vector& c)
+	{
+		Vector ab = b - a, ac = c - a, ap = p - a;
+		double d1 = ab.Dot(ap), d2 = ac.Dot(ap);
+		if (d1 <= 0.0 && d2 <= 0.0) return a;
+
+		Vector bp = p - b;
+		double d3 = ab.Dot(bp), d4 = ac.Dot(bp);
+		if (d3 >= 0.0 && d4 <= d3) return b;
+
+		double vc = d1 * d4 - d3 * d2;
+		if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0) return a + ab * (d1 / (d1 - d3));
+
+		Vector cp = p - c;
+		double d5 = ab.Dot(cp), d6 = ac.Dot(cp);
+		if (d6 >= 0.0 && d5 <= d6) return c;
+
+		double vb = d5 * d2 - d1 * d6;
+		if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0) return a + ac * (d2 / (d2 - d6));
+
+		double va = d3 * d6 - d5 * d4;
+		if (va <= 0.0 && d4 - d3 >= 0.0 && d5 - d6 >= 0.0) return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+		double denominator = 1.0 / (va + vb + vc);
+		return a + ab * (vb * denominator) + ac * (vc * denominator);
+	}
+
+	// One cluster worked out in double precision straight from its definition, the part of the view frustum between two
+	// slice depths and four tile edges
+	struct Cluster
+	{
+		double left, right, bottom, top;
+		double nearDepth, farDepth;
+		double projectionX, projectionY;
+
+		Cluster(unsigned int x, unsigned int y, unsigned int z, double projectionX, double projectionY, double nearPlane, double farPlane)
+			: projectionX(projectionX), projectionY(projectionY)
+		{
+			left = -1.0 + 2.0 * x / LightClusters::ClustersX;
+			right = -1.0 + 2.0 * (x + 1) / LightClusters::ClustersX;
+			top = 1.0 - 2.0 * y / LightClusters::ClustersY;
+			bottom = 1.0 - 2.0 * (y + 1) / LightClusters::ClustersY;
+			nearDepth = nearPlane * std::pow(farPlane / nearPlane, (double) z / LightClusters::ClustersZ);
+			farDepth = nearPlane * std::pow(farPlane / nearPlane, (double) (z + 1) / LightClusters::ClustersZ);
+		}
+
+		// Corner at the given screen position and depth
+		Vector Corner(double ndcX, double ndcY, double depth) const { return { ndcX * depth / projectionX, ndcY * depth / projectionY, depth }; }
+
+		// Distance from p to the cluster's bounding box
+		double BoxDistance(const Vector& p) const
+		{
+			double min[3] = { std::min(left * nearDepth, left * farDepth) / projectionX, std::min(bottom * nearDepth, bottom * farDepth) / projectionY, nearDepth };
+			double max[3] = { std::max(right * nearDepth, right * farDepth) / projectionX, std::max(top * nearDepth, top * farDepth) / projectionY, farDepth };
+			double point[3] = { p.x, p.y, p.z }, squared = 0.0;
+			for (int axis = 0; axis < 3; axis++)
+			{
+				double d = std::max(std::max(min[axis] - point[axis], point[axis] - max[axis]), 0.0);
+				squared += d * d;
+			}
+			return std::sqrt(squared);
+		}
+
+		// Distance from p to the cluster itself, zero inside, otherwise to the nearest of its six faces
+		double Distance(const Vector& p) const
+		{
+			if (p.z >= nearDepth && p.z <= farDepth && p.x * projectionX >= left * p.z && p.x * projectionX <= right * p.z &&
+				p.y * projectionY >= bottom * p.z && p.y * projectionY <= top * p.z)
+				return 0.0;
+
+			Vector c[8];
+			for (int i = 0; i < 8; i++) c[i] = Corner(i & 1 ? right : left, i & 2 ? top : bottom, i & 4 ? farDepth : nearDepth);
+
+			const int faces[6][4] = { { 0, 1, 3, 2 }, { 4, 5, 7, 6 }, { 0, 2, 6, 4 }, { 1, 3, 7, 5 }, { 0, 1, 5, 4 }, { 2, 3, 7, 6 } };
+			double nearest = INFINITY;
+			for (auto& face : faces)
+			{
+				for (const Vector& q : { ClosestOnTriangle(p, c[face[0]], c[face[1]], c[face[2]]), ClosestOnTriangle(p, c[face[0]], c[face[2]], c[face[3]]) })
+				{
+					Vector d = p - q;
+					nearest = std::min(nearest, std::sqrt(d.Dot(d)));
+				}
+			}
+			return nearest;
+		}
+	};
+
+	// A camera somewhere random, turned by yaw around y
+	struct Camera
+	{
+		float position[3];
+		float yaw, projectionX, projectionY, nearPlane, farPlane;
+		TransformMatrix view;
+
+		explicit Camera(std::mt19937& random)
+		{
+			auto uniform = [&](float min, float max) { return std::uniform_real_distribution<float>(min, max)(random); };
+			for (float& axis : position) axis = uniform(-50.f, 50.f);
+			yaw = uniform(-3.14f, 3.14f);
+			projectionY = 1.f / std::tan(uniform(0.3f, 1.f));
+			projectionX = projectionY / uniform(1.f, 2.5f);
+			nearPlane = uniform(0.05f, 1.f);
+			farPlane = uniform(50.f, 500.f);
+
+			// Rows are the world axes in view space, the camera's right, up and forward are its columns
+			float right[3] = { std::cos(yaw), 0.f, -std::sin(yaw) }, up[3] = { 0.f, 1.f, 0.f }, forward[3] = { std::sin(yaw), 0.f, std::cos(yaw) };
+			const float* axes[3] = { right, up, forward };
+			for (int column = 0; column < 3; column++)
+			{
+				for (int row = 0; row < 3; row++) view.m[row][column] = axes[column][row];
+				view.m[3][column] = -(position[0] * axes[column][0] + position[1] * axes[column][1] + position[2] * axes[column][2]);
+				view.m[column][3] = 0.f;
+			}
+			view.m[3][3] = 1.f;
+		}
+
+		// World space point at x and y in normalized device coordinates, depth units in front of the camera
+		void GetPoint(float x, float y, float depth, float point[3]) const
+		{
+			float right[3] = { std::cos(yaw), 0.f, -std::sin(yaw) }, up[3] = { 0.f, 1.f, 0.f }, forward[3] = { std::sin(yaw), 0.f, std::cos(yaw) };
+			for (int axis = 0; axis < 3; axis++)
+				point[axis] = position[axis] + forward[axis] * depth + right[axis] * x * depth / projectionX + up[axis] * y * depth / projectionY;
+		}
+
+		Vector ToView(const float point[3]) const
+		{
+			double result[3];
+			for (int column = 0; column < 3; column++)
+				result[column] = (double) point[0] * view.m[0][column] + (double) point[1] * view.m[1][column] + (double) point[2] * view.m[2][column] + view.m[3][column];
+			return { result[0], result[1], result[2] };
+		}
+
+		void Build(LightClusters& clusters, const std::vector<PointLight>& lights) const
+		{
+			clusters.Build(lights.data(), lights.size(), view, projectionX, projectionY, nearPlane, farPlane);
+		}
+	};
+
+	// Lights all around the camera, in and out of view, from specks to ones reaching past the whole frustum
+	std::vector<PointLight> MakeLights(const Camera& camera, size_t count, std::mt19937& random)
+	{
+		auto uniform = [&](float min, float max) { return std::uniform_real_distribution<float>(min, max)(random); };
+		std::vector<PointLight> lights(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			PointLight& light = lights[i];
+			camera.GetPoint(uniform(-1.5f, 1.5f), uniform(-1.5f, 1.5f), uniform(-20.f, camera.farPlane * 1.2f), light.position);
+			light.range = i % 20 == 0 ? uniform(50.f, 300.f) : i % 20 == 1 ? 0.f : uniform(0.05f, 20.f);
+			light.color[0] = light.color[1] = light.color[2] = 1.f;
+			light.intensity = 1.f;
+			light.attConstant = 1.f;
+			light.attLinear = light.attQuadratic = light.padding = 0.f;
+		}
+		return lights;
+	}
+
+	// Every cluster's lights as a sorted list, checking the offsets and counts describe one packed list on the way
+	std::vector<std::vector<uint32_t>> GetClusterLights(const LightClusters& clusters)
+	{
+		auto& entries = clusters.GetClusters();
+		auto& indices = clusters.GetLightIndices();
+
+		std::vector<std::vector<uint32_t>> result(LightClusters::ClusterCount);
+		uint32_t offset = 0;
+		for (unsigned int cluster = 0; cluster < LightClusters::ClusterCount; cluster++)
+		{
+			EXPECT_EQ(offset, entries[cluster * 2]) << "cluster " << cluster;
+			offset = entries[cluster * 2] + entries[cluster * 2 + 1];
+			if (offset > indices.size()) break;
+
+			result[cluster].assign(indices.begin() + entries[cluster * 2], indices.begin() + offset);
+			// In the order the lights were given, and each only once
+			EXPECT_TRUE(std::adjacent_find(result[cluster].begin(), result[cluster].end(), std::greater_equal<uint32_t>()) == result[cluster].end()) <<
+				"cluster " << cluster;
+		}
+		EXPECT_EQ(indices.size(), offset);
+		return result;
+	}
+}
+
+TEST(LightClusters, GetLightRange)
+{
+	auto brightness = [](const PointLight& light, float distance)
+	{
+		float squared = distance * distance;
+		return light.intensity / (light.attConstant + light.attLinear * squared + light.attQuadratic * squared * squared);
+	};
+
+	PointLight light = {};
+	light.intensity = 2.f;
+	light.attConstant = 1.f;
+	for (float linear : { 0.f, 0.1f, 1.f })
+	{
+		for (float quadratic : { 0.f, 0.01f, 0.5f })
+		{
+			if (linear == 0.f && quadratic == 0.f) continue;
+			light.attLinear = linear;
+			light.attQuadratic = quadratic;
+			for (float threshold : { 1.f / 256.f, 0.1f })
+			{
+				float range = GetLightRange(light, threshold);
+				EXPECT_NEAR(threshold, brightness(light, range), threshold * 1e-3f) << linear << ", " << quadratic;
+			}
+		}
+	}
+
+	// Never falling off reaches everywhere, never bright enough reaches nowhere
+	light.attLinear = light.attQuadratic = 0.f;
+	EXPECT_EQ(INFINITY, GetLightRange(light));
+	light.attConstant = 1000.f;
+	EXPECT_EQ(0.f, GetLightRange(light));
+}
+
+TEST(LightClusters, SliceOfDepth)
+{
+	// The shader finds a pixel's slice from GetSliceScale() and GetSliceBias(), it has to agree with where the slices are
+	std::mt19937 random(1);
+	LightClusters clusters;
+	for (int i = 0; i < 10; i++)
+	{
+		Camera camera(random);
+		camera.Build(clusters, {});
+		for (unsigned int z = 0; z < LightClusters::ClustersZ; z++)
+		{
+			Cluster cluster(0, 0, z, camera.projectionX, camera.projectionY, camera.nearPlane, camera.farPlane);
+			float depth = (float) std::sqrt(cluster.nearDepth * cluster.farDepth);
+			EXPECT_EQ(z, (unsigned int) std::floor(std::log2(depth) * clusters.GetSliceScale() + clusters.GetSliceBias())) << depth;
+		}
+	}
+}
+
+TEST(LightClusters, MatchesBruteForce)
+{
+	std::mt19937 random(2);
+	LightClusters clusters;
+	size_t hits = 0, exactHits = 0;
+	for (int i = 0; i < 8; i++)
+	{
+		// The same object for every camera, so changing projections are picked up
+		Camera camera(random);
+		std::vector<PointLight> lights = MakeLights(camera, 200, random);
+		camera.Build(clusters, lights);
+		std::vector<std::vector<uint32_t>> binned = GetClusterLights(clusters);
+
+		for (unsigned int z = 0; z < LightClusters::ClustersZ; z++)
+		{
+			for (unsigned int y = 0; y < LightClusters::ClustersY; y++)
+			{
+				for (unsigned int x = 0; x < LightClusters::ClustersX; x++)
+				{
+					Cluster cluster(x, y, z, camera.projectionX, camera.projectionY, camera.nearPlane, camera.farPlane);
+					auto& list = binned[LightClusters::GetClusterIndex(x, y, z)];
+					for (uint32_t light = 0; light < lights.size(); light++)
+					{
+						bool binnedHere = std::binary_search(list.begin(), list.end(), light);
+						Vector center = camera.ToView(lights[light].position);
+						double radius = lights[light].range;
+						// Whatever float rounding can move around, the clusters are far apart compared to it
+						double tolerance = 1e-4 * (radius + std::fabs(center.x) + std::fabs(center.y) + std::fabs(center.z));
+
+						// Every light reaching into the cluster is listed, and nothing listed misses the cluster's bounding box
+						double boxDistance = cluster.BoxDistance(center);
+						if (binnedHere)
+						{
+							EXPECT_LE(boxDistance, radius + tolerance) << "light " << light << " in " << x << ", " << y << ", " << z;
+						}
+						if (boxDistance < radius - tolerance)
+						{
+							double distance = cluster.Distance(center);
+							if (distance < radius - tolerance)
+							{
+								EXPECT_TRUE(binnedHere) << "light " << light << " missing from " << x << ", " << y << ", " << z << ", " <<
+									distance << " from a light of range " << radius;
+								exactHits++;
+							}
+						}
+						hits += binnedHere;
+					}
+				}
+			}
+		}
+	}
+
+	// Bounding boxes of clusters are a little bigger than the clusters, but not by much
+	EXPECT_GT(exactHits, 0u);
+	EXPECT_LT(hits * 10, exactHits * 11);
+	printf("%zu lights binned, %zu reach their cluster\n", hits, exactHits);
+}
+
+TEST(LightClusters, OutOfView)
+{
+	std::mt19937 random(3);
+	Camera camera(random);
+
+	// Behind the camera, past the far plane, off to the side, and lights with no range
+	std::vector<PointLight> lights = MakeLights(camera, 4, random);
+	camera.GetPoint(0.f, 0.f, -10.f, lights[0].position);
+	lights[0].range = 5.f;
+	camera.GetPoint(0.f, 0.f, camera.farPlane + 10.f, lights[1].position);
+	lights[1].range = 5.f;
+	camera.GetPoint(3.f, 0.f, 20.f, lights[2].position);
+	lights[2].range = 5.f;
+	camera.GetPoint(0.f, 0.f, 20.f, lights[3].position);
+	lights[3].range = 0.f;
+
+	LightClusters clusters;
+	camera.Build(clusters, lights);
+	EXPECT_TRUE(clusters.GetLightIndices().empty());
+
+	// Back in view after a rebuild
+	lights[3].range = 1.f;
+	camera.Build(clusters, lights);
+	EXPECT_FALSE(clusters.GetLightIndices().empty());
+	for (uint32_t light : clusters.GetLightIndices()) EXPECT_EQ(3u, light);
+}
@@ -0,0 +1,442 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include "gtest/gtest.h"
+
+#include "Scene/MeshCache.h"
+#include "Scene/MeshImporter.h"
+#include "Scene/VertexPacker.h"
+
+namespace
+{
+	// Tests write their files into the working directory and remove them again
+	const char* const CacheFile = "RendererMeshCacheTest.meshcache";
+
+	std::vector<char> ReadFile(const std::string& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	void WriteFile(const std::string& path, const std::vector<char>& contents, size_t size)
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file.write(contents.data(), (std::streamsize) size);
+	}
+
+	// Something in every section, of every stride, but one left empty. No dependencies, those need files to check
+	struct Sections
+	{
+		std::vector<uint8_t> bytes[MeshCacheSectionCount];
+		uint32_t strides[MeshCacheSectionCount];
+		float boundsMin[3] = { -1.f, -2.f, -3.f };
+		float boundsMax[3] = { 4.f, 5.f, 6.f };
+
+		Sections()
+		{
+			for (uint32_t i = 0; i < MeshCacheSectionCount; i++)
+			{
+				strides[i] = i == MeshCacheDependencies ? sizeof(MeshCacheDependency) : i == MeshCacheDependencyPaths ? 1 : i * 3 + 1;
+				bool empty = i == MeshCacheMeshlets || i == MeshCacheDependencies || i == MeshCacheDependencyPaths;
+				uint32_t count = empty ? 0 : i * 7 + 3;
+				for (uint32_t byte = 0; byte < count * strides[i]; byte++) bytes[i].push_back((uint8_t) (byte * 31 + i));
+			}
+		}
+
+		bool Write(uint64_t hash) const
+		{
+			MeshCacheData data[MeshCacheSectionCount];
+			for (uint32_t i = 0; i < MeshCacheSectionCount; i++) data[i] = { bytes[i].data(), (uint32_t) (bytes[i].size() / strides[i]), strides[i] };
+			return MeshCache::Write(CacheFile, hash, data, boundsMin, boundsMax);
+		}
+
+		bool Write(uint64_t hash, const std::vector<MeshCacheDependency>& dependencies, const std::string& paths)
+		{
+			bytes[MeshCacheDependencies].assign((const uint8_t*) dependencies.data(), (const uint8_t*) (dependencies.data() + dependencies.size()));
+			bytes[MeshCacheDependencyPaths].assign(paths.begin(), paths.end());
+			return Write(hash);
+		}
+
+		void ExpectMatches(const MeshCache& cache) const
+		{
+			for (uint32_t i = 0; i < MeshCacheSectionCount; i++)
+			{
+				auto section = (MeshCacheSection) i;
+				EXPECT_EQ(bytes[i].size() / strides[i], cache.GetCount(section)) << "section " << i;
+				EXPECT_EQ(strides[i], cache.GetStride(section)) << "section " << i;
+				EXPECT_EQ(0u, (uintptr_t) cache.Get<uint8_t>(section) % 16) << "section " << i;
+				EXPECT_EQ(0, memcmp(bytes[i].data(), cache.Get<uint8_t>(section), bytes[i].size())) << "section " << i;
+			}
+			EXPECT_EQ(0, memcmp(boundsMin, cache.GetBoundsMin(), sizeof(boundsMin)));
+			EXPECT_EQ(0, memcmp(boundsMax, cache.GetBoundsMax(), sizeof(boundsMax)));
+		}
+	};
+
+	// A copy of one of Assimp's test models, so its cache is written next to the copy instead of into the models
+	struct ModelCopy
+	{
+		std::string path;
+
+		explicit ModelCopy(const std::string& model)
+			: path("RendererMeshCacheTest" + model.substr(model.rfind('.')))
+		{
+			std::vector<char> contents = ReadFile(std::string(RENDERER_TEST_MODELS_DIR) + "/" + model);
+			EXPECT_FALSE(contents.empty()) << model;
+			WriteFile(path, contents, contents.size());
+			remove(MeshCache::GetCachePath(path).c_str());
+		}
+
+		~ModelCopy()
+		{
+			remove(path.c_str());
+			remove(MeshCache::GetCachePath(path).c_str());
+		}
+	};
+
+	template<typename T>
+	bool SameBytes(const T* a, const T* b, size_t count)
+	{
+		return count == 0 || memcmp(a, b, count * sizeof(T)) == 0;
+	}
+
+	template<typename T>
+	bool SameBytes(const std::vector<T>& a, const std::vector<T>& b)
+	{
+		return a.size() == b.size() && SameBytes(a.data(), b.data(), a.size());
+	}
+
+	void ExpectSameMesh(const MeshData& expected, const MeshData& data)
+	{
+		EXPECT_TRUE(expected.layout.elements == data.layout.elements);
+		EXPECT_EQ(expected.layout.stride, data.layout.stride);
+		ASSERT_EQ(expected.vertexCount, data.vertexCount);
+		EXPECT_TRUE(SameBytes(expected.GetVertices(), data.GetVertices(), expected.vertexCount * expected.layout.stride));
+		ASSERT_EQ(expected.GetIndexCount(), data.GetIndexCount());
+		EXPECT_TRUE(SameBytes(expected.GetIndices(), data.GetIndices(), expected.GetIndexCount()));
+
+		EXPECT_TRUE(SameBytes(expected.parts, data.parts));
+		EXPECT_TRUE(SameBytes(expected.meshlets, data.meshlets));
+		EXPECT_TRUE(expected.meshletVertices == data.meshletVertices);
+		EXPECT_TRUE(expected.meshletTriangles == data.meshletTriangles);
+		EXPECT_TRUE(expected.partMeshlets == data.partMeshlets);
+		EXPECT_TRUE(expected.occluderPositions == data.occluderPositions);
+		EXPECT_TRUE(expected.occluderIndices == data.occluderIndices);
+		EXPECT_TRUE(SameBytes(expected.boundsMin, data.boundsMin, 3));
+		EXPECT_TRUE(SameBytes(expected.boundsMax, data.boundsMax, 3));
+		EXPECT_EQ(expected.hash, data.hash);
+	}
+}
+
+TEST(MeshCache, HashSource)
+{
+	const char* source = "RendererMeshCacheTest.txt";
+	std::vector<char> contents(1000, 'a');
+	WriteFile(source, contents, contents.size());
+
+	uint64_t hash, again, salted, changed;
+	ASSERT_TRUE(MeshCache::HashSource(source, 1, hash));
+	ASSERT_TRUE(MeshCache::HashSource(source, 1, again));
+	ASSERT_TRUE(MeshCache::HashSource(source, 2, salted));
+	contents[500] = 'b';
+	WriteFile(source, contents, contents.size());
+	ASSERT_TRUE(MeshCache::HashSource(source, 1, changed));
+	remove(source);
+
+	EXPECT_EQ(hash, again);
+	EXPECT_NE(hash, salted);
+	EXPECT_NE(hash, changed);
+	EXPECT_FALSE(MeshCache::HashSource(source, 1, hash));
+}
+
+TEST(MeshCache, Hit)
+{
+	Sections sections;
+	ASSERT_TRUE(sections.Write(42));
+	{
+		MeshCache cache;
+		ASSERT_TRUE(cache.Open(CacheFile, 42, sections.strides));
+		sections.ExpectMatches(cache);
+
+		// A stride of 0 takes whatever is there
+		uint32_t anyVertices[MeshCacheSectionCount];
+		memcpy(anyVertices, sections.strides, sizeof(anyVertices));
+		anyVertices[MeshCacheVertices] = 0;
+		MeshCache other;
+		ASSERT_TRUE(other.Open(CacheFile, 42, anyVertices));
+		sections.ExpectMatches(other);
+
+		// Written over while the first one is still open
+		ASSERT_TRUE(sections.Write(43));
+		EXPECT_TRUE(other.Open(CacheFile, 43, sections.strides));
+		sections.ExpectMatches(cache);
+	}
+	remove(CacheFile);
+}
+
+TEST(MeshCache, Miss)
+{
+	Sections sections;
+	MeshCache cache;
+	remove(CacheFile);
+	EXPECT_FALSE(cache.Open(CacheFile, 42, sections.strides));
+
+	WriteFile(CacheFile, {}, 0);
+	EXPECT_FALSE(cache.Open(CacheFile, 42, sections.strides));
+
+	// Stale, another source, another version, another layout of any section
+	ASSERT_TRUE(sections.Write(42));
+	EXPECT_FALSE(cache.Open(CacheFile, 41, sections.strides));
+	for (uint32_t i = 0; i < MeshCacheSectionCount; i++)
+	{
+		uint32_t strides[MeshCacheSectionCount];
+		memcpy(strides, sections.strides, sizeof(strides));
+		strides[i]++;
+		EXPECT_FALSE(cache.Open(CacheFile, 42, strides)) << "section " << i;
+	}
+
+	std::vector<char> contents = ReadFile(CacheFile);
+	for (size_t field : { offsetof(MeshCacheHeader, magic), offsetof(MeshCacheHeader, version) })
+	{
+		std::vector<char> changed = contents;
+		changed[field]++;
+		WriteFile(CacheFile, changed, changed.size());
+		EXPECT_FALSE(cache.Open(CacheFile, 42, sections.strides)) << "field at " << field;
+	}
+
+	// And still good as written
+	WriteFile(CacheFile, contents, contents.size());
+	{
+		MeshCache good;
+		EXPECT_TRUE(good.Open(CacheFile, 42, sections.strides));
+	}
+	remove(CacheFile);
+}
+
+TEST(MeshCache, Truncated)
+{
+	Sections sections;
+	ASSERT_TRUE(sections.Write(42));
+	std::vector<char> contents = ReadFile(CacheFile);
+
+	// Cut off anywhere, the way a full disk or a copy stopped halfway would leave it
+	MeshCache cache;
+	for (size_t size = 0; size < contents.size(); size += size < sizeof(MeshCacheHeader) + 64 ? 1 : 7)
+	{
+		WriteFile(CacheFile, contents, size);
+		EXPECT_FALSE(cache.Open(CacheFile, 42, sections.strides)) << size << " of " << contents.size() << " bytes";
+	}
+
+	// Sections claiming more than the file holds, starting inside the one before or unaligned
+	auto patch = [&](MeshCacheSection section, size_t field, uint32_t value)
+	{
+		std::vector<char> changed = contents;
+		memcpy(&changed[offsetof(MeshCacheHeader, sections) + section * sizeof(MeshCacheSectionHeader) + field], &value, sizeof(value));
+		WriteFile(CacheFile, changed, changed.size());
+		return cache.Open(CacheFile, 42, sections.strides);
+	};
+	for (uint32_t i = 0; i < MeshCacheSectionCount; i++)
+	{
+		auto section = (MeshCacheSection) i;
+		EXPECT_FALSE(patch(section, offsetof(MeshCacheSectionHeader, count), UINT32_MAX)) << "section " << i;
+		EXPECT_FALSE(patch(section, offsetof(MeshCacheSectionHeader, offset), UINT32_MAX & ~15u)) << "section " << i;
+		EXPECT_FALSE(patch(section, offsetof(MeshCacheSectionHeader, offset), 16)) << "section " << i;
+		EXPECT_FALSE(patch(section, offsetof(MeshCacheSectionHeader, offset), (uint32_t) contents.size() - 8)) << "section " << i;
+	}
+	remove(CacheFile);
+}
+
+TEST(MeshCache, Dependencies)
+{
+	const char* dependency = "RendererMeshCacheTest.bin";
+	std::vector<char> contents(100, 'a');
+	WriteFile(dependency, contents, contents.size());
+
+	// Somewhere in the middle of the paths
+	std::string paths = std::string("other.bin") + dependency;
+	MeshCacheDependency entry = { 0, 9, (uint32_t) strlen(dependency) };
+	ASSERT_TRUE(MeshCache::HashSource(dependency, 0, entry.hash));
+
+	Sections sections;
+	ASSERT_TRUE(sections.Write(42, { entry }, paths));
+	{
+		MeshCache hit;
+		EXPECT_TRUE(hit.Open(CacheFile, 42, sections.strides));
+		sections.ExpectMatches(hit);
+	}
+
+	// Pointing past the paths
+	MeshCacheDependency outside = entry;
+	outside.pathOffset = (uint32_t) paths.size() - 2;
+	ASSERT_TRUE(sections.Write(42, { entry, outside }, paths));
+	MeshCache cache;
+	EXPECT_FALSE(cache.Open(CacheFile, 42, sections.strides));
+
+	// Changed or gone since
+	ASSERT_TRUE(sections.Write(42, { entry }, paths));
+	contents[50] = 'b';
+	WriteFile(dependency, contents, contents.size());
+	EXPECT_FALSE(cache.Open(CacheFile, 42, sections.strides));
+	remove(dependency);
+	EXPECT_FALSE(cache.Open(CacheFile, 42, sections.strides));
+	remove(CacheFile);
+}
+
+TEST(MeshImporter, ReadsBackFromCache)
+{
+	// The duck is too big to be an occluder, the rock isn't
+	for (const char* model : { "Collada/duck.dae", "3DS/fels.3ds" })
+	{
+		ModelCopy source(model);
+
+		MeshData imported;
+		ASSERT_TRUE(MeshImporter::Import(source.path, imported)) << model;
+		EXPECT_EQ(nullptr, imported.cache);
+		EXPECT_TRUE(imported.hashed);
+		EXPECT_EQ(imported.vertexCount * imported.layout.stride, imported.vertices.size());
+		EXPECT_EQ(imported.parts.size(), imported.partMeshlets.size());
+		EXPECT_EQ(std::string(model) == "3DS/fels.3ds", !imported.occluderIndices.empty()) << model;
+
+		// Straight out of the mapping, with nothing copied into the vertex and index arrays
+		std::atomic<float> progress{ 0.f };
+		MeshData cached;
+		ASSERT_TRUE(MeshImporter::Import(source.path, cached, &progress)) << model;
+		ASSERT_NE(nullptr, cached.cache) << model;
+		EXPECT_TRUE(cached.vertices.empty());
+		EXPECT_TRUE(cached.indices.empty());
+		EXPECT_EQ(1.f, progress.load());
+		ExpectSameMesh(imported, cached);
+
+		// Still readable after being moved around, like MeshData is on its way to the Mesh
+		MeshData moved = std::move(cached);
+		ExpectSameMesh(imported, moved);
+	}
+}
+
+TEST(MeshImporter, LeavesOutMissingAttributes)
+{
+	// Normals are generated where the file has none, colors and texture coordinates only come from the file
+	std::pair<const char*, uint32_t> models[] =
+	{
+		{ "Collada/duck.dae", VertexNormal | VertexTexcoord },
+		{ "PLY/float-color.ply", VertexNormal | VertexColor },
+		{ "3DS/fels.3ds", VertexNormal }
+	};
+
+	for (auto& model : models)
+	{
+		ModelCopy source(model.first);
+		MeshData imported;
+		ASSERT_TRUE(MeshImporter::Import(source.path, imported)) << model.first;
+		EXPECT_EQ(model.second, VertexPacker::GetAttributes(imported.layout)) << model.first;
+
+		// And they stay left out when the layout comes back from the cache
+		MeshData cached;
+		ASSERT_TRUE(MeshImporter::Import(source.path, cached)) << model.first;
+		ASSERT_NE(nullptr, cached.cache) << model.first;
+		EXPECT_EQ(imported.layout, cached.layout) << model.first;
+	}
+}
+
+TEST(MeshImporter, ReimportsStaleAndBrokenCaches)
+{
+	ModelCopy source("Collada/duck.dae");
+	MeshData imported;
+	ASSERT_TRUE(MeshImporter::Import(source.path, imported));
+	std::string cacheFile = MeshCache::GetCachePath(source.path);
+	std::vector<char> cacheContents = ReadFile(cacheFile);
+
+	// Cut short, down to the middle of the sections and to just past the header
+	for (size_t size : { cacheContents.size() / 2, sizeof(MeshCacheHeader) + 8 })
+	{
+		WriteFile(cacheFile, cacheContents, size);
+		MeshData data;
+		ASSERT_TRUE(MeshImporter::Import(source.path, data));
+		EXPECT_EQ(nullptr, data.cache);
+		ExpectSameMesh(imported, data);
+		EXPECT_EQ(cacheContents, ReadFile(cacheFile));
+	}
+
+	// Ranges pointing past what they index, which the hash of the source can't catch
+	MeshCacheHeader header;
+	memcpy(&header, cacheContents.data(), sizeof(header));
+	std::pair<MeshCacheSection, size_t> ranges[] =
+	{
+		{ MeshCacheParts, offsetof(MeshPart, indexCount) },
+		{ MeshCacheParts, offsetof(MeshPart, lods) + offsetof(MeshLod, firstIndex) },
+		{ MeshCacheParts, offsetof(MeshPart, lodCount) },
+		{ MeshCacheMeshlets, offsetof(Meshlet, vertexOffset) },
+		{ MeshCacheMeshlets, offsetof(Meshlet, triangleCount) },
+		{ MeshCacheMeshletVertices, 0 },
+		{ MeshCacheMeshletTriangles, 0 },
+		{ MeshCachePartMeshlets, sizeof(uint32_t) }
+	};
+	for (auto& range : ranges)
+	{
+		std::vector<char> changed = cacheContents;
+		uint32_t value = UINT32_MAX;
+		memcpy(&changed[header.sections[range.first].offset + range.second], &value, sizeof(value));
+		WriteFile(cacheFile, changed, changed.size());
+
+		MeshData data;
+		ASSERT_TRUE(MeshImporter::Import(source.path, data));
+		EXPECT_EQ(nullptr, data.cache) << "section " << range.first << " at " << range.second;
+		ExpectSameMesh(imported, data);
+		EXPECT_EQ(cacheContents, ReadFile(cacheFile));
+	}
+
+	// The source changed, trailing whitespace doesn't change the mesh but does change the hash
+	std::vector<char> contents = ReadFile(source.path);
+	contents.push_back('\n');
+	WriteFile(source.path, contents, contents.size());
+
+	MeshData changed;
+	ASSERT_TRUE(MeshImporter::Import(source.path, changed));
+	EXPECT_EQ(nullptr, changed.cache);
+	EXPECT_NE(imported.hash, changed.hash);
+	EXPECT_TRUE(SameBytes(imported.vertices, changed.vertices));
+
+	// Which is a hit again from then on
+	MeshData cached;
+	ASSERT_TRUE(MeshImporter::Import(source.path, cached));
+	EXPECT_NE(nullptr, cached.cache);
+	ExpectSameMesh(changed, cached);
+}
+
+TEST(MeshImporter, ReimportsWhenDependenciesChange)
+{
+	const char* model = "RendererMeshCacheTest.obj";
+	const char* material = "RendererMeshCacheTest.mtl";
+	std::string obj = std::string("mtllib ") + material + "\nv 0 0 0\nv 1 0 0\nv 0 1 0\nusemtl red\nf 1 2 3\n";
+	std::string mtl = "newmtl red\nKd 1 0 0\n";
+	WriteFile(model, std::vector<char>(obj.begin(), obj.end()), obj.size());
+	WriteFile(material, std::vector<char>(mtl.begin(), mtl.end()), mtl.size());
+	remove(MeshCache::GetCachePath(model).c_str());
+
+	MeshData imported, cached;
+	ASSERT_TRUE(MeshImporter::Import(model, imported));
+	ASSERT_TRUE(MeshImporter::Import(model, cached));
+	EXPECT_NE(nullptr, cached.cache);
+	ExpectSameMesh(imported, cached);
+
+	// Only the materials changed, which is still a miss
+	mtl = "newmtl red\nKd 0 1 0\n";
+	WriteFile(material, std::vector<char>(mtl.begin(), mtl.end()), mtl.size());
+	MeshData changed, again;
+	ASSERT_TRUE(MeshImporter::Import(model, changed));
+	EXPECT_EQ(nullptr, changed.cache);
+	EXPECT_NE(imported.hash, changed.hash);
+	ASSERT_TRUE(MeshImporter::Import(model, again));
+	EXPECT_NE(nullptr, again.cache);
+	ExpectSameMesh(changed, again);
+
+	// And so is losing them
+	remove(material);
+	MeshData missing;
+	ASSERT_TRUE(MeshImporter::Import(model, missing));
+	EXPECT_EQ(nullptr, missing.cache);
+
+	remove(model);
+	remove(MeshCache::GetCachePath(model).c_str());
+}
@@ -0,0 +1,27 @@
+#include <cmath>
+
+#include "Benchmark.h"
+
+#include "Scene/MeshSimplifier.h"
+#include "TestModels.h"
+
+// Halving the duck the way the importer builds its first level of detail, and taking it down as far as it goes
+TEST(MeshSimplifierBenchmark, Duck)
+{
+	std::vector<TestMesh> meshes = LoadTestModel("Collada/duck.dae");
+	ASSERT_FALSE(meshes.empty());
+	const TestMesh& mesh = meshes[0];
+
+	std::vector<unsigned int> simplified(mesh.indices.size());
+	for (size_t target : { mesh.indices.size() / 6 * 3, size_t(0) })
+	{
+		size_t count = 0;
+		std::string name = "Duck to " + std::to_string(target / 3) + " triangles";
+		Benchmark(name.c_str(), [&]()
+		{
+			count = MeshSimplifier::Simplify(mesh.positions.data(), sizeof(float) * 3, mesh.GetVertexCount(), mesh.indices.data(), mesh.indices.size(),
+				target, INFINITY, simplified.data());
+		});
+		EXPECT_LT(count, mesh.indices.size());
+	}
+}
@@ -0,0 +1,331 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+#include <numeric>
+#include <set>
+
+#include "gtest/gtest.h"
+
+#include "Scene/MeshSimplifier.h"
+#include "TestModels.h"
+
+namespace
+{
+	struct Simplified
+	{
+		std::vector<unsigned int> indices;
+		float error = -1.f;
+	};
+
+	Simplified Simplify(const TestMesh& mesh, size_t targetIndexCount, float maxError)
+	{
+		Simplified result;
+		result.indices.resize(mesh.indices.size());
+		size_t count = MeshSimplifier::Simplify(mesh.positions.data(), sizeof(float) * 3, mesh.GetVertexCount(), mesh.indices.data(), mesh.indices.size(),
+			targetIndexCount, maxError, result.indices.data(), &result.error);
+		EXPECT_EQ(0u, count % 3);
+		EXPECT_LE(count, mesh.indices.size());
+		result.indices.resize(count);
+		return result;
+	}
+
+	// Largest side of the mesh's bounding box
+	float GetSize(const TestMesh& mesh)
+	{
+		float min[3] = { INFINITY, INFINITY, INFINITY }, max[3] = { -INFINITY, -INFINITY, -INFINITY };
+		for (size_t i = 0; i < mesh.positions.size(); i++)
+		{
+			min[i % 3] = std::min(min[i % 3], mesh.positions[i]);
+			max[i % 3] = std::max(max[i % 3], mesh.positions[i]);
+		}
+		return std::max(std::max(max[0] - min[0], max[1] - min[1]), max[2] - min[2]);
+	}
+
+	typedef std::array<float, 3> Position;
+
+	Position GetPosition(const TestMesh& mesh, unsigned int vertex)
+	{
+		return { mesh.positions[vertex * 3], mesh.positions[vertex * 3 + 1], mesh.positions[vertex * 3 + 2] };
+	}
+
+	// Distance from p to the triangle abc, in double precision
+	double TriangleDistance(const Position& p, const Position& a, const Position& b, const Position& c)
+	{
+		double ab[3], ac[3], ap[3];
+		for (int i = 0; i < 3; i++)
+		{
+			ab[i] = (double) b[i] - a[i];
+			ac[i] = (double) c[i] - a[i];
+			ap[i] = (double) p[i] - a[i];
+		}
+		auto dot = [](const double* u, const double* v) { return u[0] * v[0] + u[1] * v[1] + u[2] * v[2]; };
+		auto at = [&](double s, double t)
+		{
+			double d[3];
+			for (int i = 0; i < 3; i++) d[i] = ap[i] - ab[i] * s - ac[i] * t;
+			return std::sqrt(dot(d, d));
+		};
+
+		// Inside the triangle the distance is to its plane, otherwise to the nearest edge
+		double abab = dot(ab, ab), abac = dot(ab, ac), acac = dot(ac, ac), abap = dot(ab, ap), acap = dot(ac, ap);
+		double determinant = abab * acac - abac * abac;
+		if (determinant > 0.0)
+		{
+			double s = (acac * abap - abac * acap) / determinant, t = (abab * acap - abac * abap) / determinant;
+			if (s >= 0.0 && t >= 0.0 && s + t <= 1.0) return at(s, t);
+		}
+
+		auto segment = [&](const double* from, const double* to, double s0, double t0, double s1, double t1)
+		{
+			double d[3], f[3];
+			for (int i = 0; i < 3; i++)
+			{
+				d[i] = to[i] - from[i];
+				f[i] = ap[i] - from[i];
+			}
+			double length = dot(d, d), u = length > 0.0 ? std::min(std::max(dot(f, d) / length, 0.0), 1.0) : 0.0;
+			return at(s0 + (s1 - s0) * u, t0 + (t1 - t0) * u);
+		};
+		double zero[3] = { 0.0, 0.0, 0.0 };
+		return std::min(std::min(segment(zero, ab, 0.0, 0.0, 1.0, 0.0), segment(zero, ac, 0.0, 0.0, 0.0, 1.0)), segment(ab, ac, 1.0, 0.0, 0.0, 1.0));
+	}
+
+	// Vertices welded by position the way the simplifier sees them, and the edges of a triangle list between them
+	struct Topology
+	{
+		std::map<Position, std::set<unsigned int>> wedges;
+		std::map<std::pair<Position, Position>, unsigned int> edges;
+
+		Topology(const TestMesh& mesh, const std::vector<unsigned int>& indices)
+		{
+			for (unsigned int index : indices) wedges[GetPosition(mesh, index)].insert(index);
+			for (size_t i = 0; i < indices.size(); i += 3)
+			{
+				// Triangles with two corners in the same place have no edges to speak of, the simplifier drops them
+				Position corners[3] = { GetPosition(mesh, indices[i]), GetPosition(mesh, indices[i + 1]), GetPosition(mesh, indices[i + 2]) };
+				if (corners[0] == corners[1] || corners[1] == corners[2] || corners[0] == corners[2]) continue;
+
+				for (int edge = 0; edge < 3; edge++)
+				{
+					Position a = GetPosition(mesh, indices[i + edge]), b = GetPosition(mesh, indices[i + (edge + 1) % 3]);
+					++edges[std::minmax(a, b)];
+				}
+			}
+		}
+
+		// Positions on an edge that isn't shared by exactly two triangles
+		std::set<Position> GetBorder() const
+		{
+			std::set<Position> border;
+			for (auto& edge : edges)
+			{
+				if (edge.second == 2) continue;
+				border.insert(edge.first.first);
+				border.insert(edge.first.second);
+			}
+			return border;
+		}
+	};
+
+	// Groups of vertices joined by the triangles' edges, vertices only sharing a position with another are in different
+	// groups unless something else joins them. Attributes only make sense within a group
+	std::vector<unsigned int> GetCharts(const TestMesh& mesh)
+	{
+		std::vector<unsigned int> parent(mesh.GetVertexCount());
+		std::iota(parent.begin(), parent.end(), 0u);
+		auto find = [&](unsigned int vertex)
+		{
+			while (parent[vertex] != vertex) vertex = parent[vertex] = parent[parent[vertex]];
+			return vertex;
+		};
+
+		for (size_t i = 0; i < mesh.indices.size(); i += 3)
+		{
+			unsigned int a = find(mesh.indices[i]);
+			for (int corner = 1; corner < 3; corner++) parent[find(mesh.indices[i + corner])] = a;
+		}
+		for (auto& vertex : parent) vertex = find(vertex);
+		return parent;
+	}
+
+	// A square of rolling hills, its open edges a border. With a seam, the vertices down the middle are doubled and the
+	// triangles right of it use the second copies, like a texture seam
+	TestMesh MakeTerrain(unsigned int size, bool seam)
+	{
+		TestMesh mesh;
+		for (unsigned int y = 0; y <= size; y++)
+		{
+			for (unsigned int x = 0; x <= size; x++)
+				mesh.positions.insert(mesh.positions.end(), { (float) x, std::sin(x * 0.3f) * std::cos(y * 0.2f), (float) y });
+		}
+
+		unsigned int middle = size / 2, columns = size + 1;
+		std::vector<unsigned int> right(columns * columns);
+		std::iota(right.begin(), right.end(), 0u);
+		if (seam)
+		{
+			for (unsigned int y = 0; y <= size; y++)
+			{
+				right[y * columns + middle] = (unsigned int) mesh.GetVertexCount();
+				Position p = GetPosition(mesh, y * columns + middle);
+				mesh.positions.insert(mesh.positions.end(), p.begin(), p.end());
+			}
+		}
+
+		for (unsigned int y = 0; y < size; y++)
+		{
+			for (unsigned int x = 0; x < size; x++)
+			{
+				unsigned int a = y * columns + x;
+				unsigned int corners[4] = { a, a + columns, a + 1, a + columns + 1 };
+				if (x >= middle)
+				{
+					for (unsigned int& corner : corners) corner = right[corner];
+				}
+				mesh.indices.insert(mesh.indices.end(), { corners[0], corners[1], corners[2], corners[2], corners[1], corners[3] });
+			}
+		}
+		return mesh;
+	}
+
+	// Largest distance from a vertex of the original mesh to the simplified one
+	double GetDeviation(const TestMesh& mesh, const std::vector<unsigned int>& simplified)
+	{
+		double deviation = 0.0;
+		for (unsigned int vertex : std::set<unsigned int>(mesh.indices.begin(), mesh.indices.end()))
+		{
+			double nearest = INFINITY;
+			Position p = GetPosition(mesh, vertex);
+			for (size_t i = 0; i < simplified.size() && nearest > deviation; i += 3)
+			{
+				nearest = std::min(nearest, TriangleDistance(p, GetPosition(mesh, simplified[i]), GetPosition(mesh, simplified[i + 1]),
+					GetPosition(mesh, simplified[i + 2])));
+			}
+			deviation = std::max(deviation, nearest);
+		}
+		return deviation;
+	}
+
+	// Checks nothing the simplifier has to keep in place moved. Returns how many positions the simplified list still uses
+	size_t ExpectKeepsBordersAndSeams(const TestMesh& mesh, const std::vector<unsigned int>& simplified, const char* name)
+	{
+		Topology before(mesh, mesh.indices), after(mesh, simplified);
+
+		// The outline stays exactly as it was, nothing on it goes and nothing new ends up on it
+		EXPECT_TRUE(before.GetBorder() == after.GetBorder()) << name;
+
+		// Corners where more than two seams meet stay, and seams nowhere else
+		for (auto& wedge : before.wedges)
+		{
+			if (wedge.second.size() > 2)
+			{
+				EXPECT_EQ(1u, after.wedges.count(wedge.first)) << name;
+			}
+		}
+		for (auto& wedge : after.wedges)
+		{
+			if (wedge.second.size() > 1)
+			{
+				EXPECT_GT(before.wedges.at(wedge.first).size(), 1u) << name;
+			}
+		}
+
+		// No triangle mixes up vertices from different sides of a seam
+		std::vector<unsigned int> charts = GetCharts(mesh);
+		for (size_t i = 0; i < simplified.size(); i += 3)
+		{
+			EXPECT_EQ(charts[simplified[i]], charts[simplified[i + 1]]) << name << ", triangle " << i / 3;
+			EXPECT_EQ(charts[simplified[i]], charts[simplified[i + 2]]) << name << ", triangle " << i / 3;
+		}
+
+		return after.wedges.size();
+	}
+
+	const char* const Models[] = { "Collada/duck.dae", "PLY/Wuson.ply", "STL/Spider_binary.stl", "3DS/fels.3ds" };
+}
+
+TEST(MeshSimplifier, StaysWithinMaxError)
+{
+	for (const char* model : Models)
+	{
+		std::vector<TestMesh> meshes = LoadTestModel(model);
+		ASSERT_FALSE(meshes.empty()) << model;
+
+		for (auto& mesh : meshes)
+		{
+			for (float fraction : { 0.01f, 0.05f })
+			{
+				float maxError = GetSize(mesh) * fraction;
+				Simplified simplified = Simplify(mesh, 0, maxError);
+				EXPECT_GE(simplified.error, 0.f) << model;
+				EXPECT_LE(simplified.error, maxError) << model;
+
+				// The error is an average over the planes of the triangles that were merged, so one vertex can end up a few times
+				// further away than it says, but not by more than that
+				double deviation = GetDeviation(mesh, simplified.indices);
+				EXPECT_LE(deviation, 4.0 * simplified.error + 1e-5 * GetSize(mesh)) << model << " at " << fraction;
+			}
+		}
+	}
+}
+
+TEST(MeshSimplifier, StopsAtTarget)
+{
+	for (const char* model : { "Collada/duck.dae", "3DS/fels.3ds" })
+	{
+		for (auto& mesh : LoadTestModel(model))
+		{
+			for (size_t fraction : { 2u, 8u })
+			{
+				size_t target = mesh.indices.size() / fraction / 3 * 3;
+				Simplified simplified = Simplify(mesh, target, INFINITY);
+				EXPECT_LE(simplified.indices.size(), target) << model;
+				EXPECT_GE(simplified.indices.size(), target * 9 / 10) << model;
+			}
+
+			// Nothing to do
+			Simplified simplified = Simplify(mesh, mesh.indices.size(), INFINITY);
+			EXPECT_EQ(mesh.indices, simplified.indices);
+			EXPECT_EQ(0.f, simplified.error);
+		}
+	}
+}
+
+TEST(MeshSimplifier, KeepsBordersAndSeams)
+{
+	for (const char* model : Models)
+	{
+		for (auto& mesh : LoadTestModel(model))
+		{
+			Simplified simplified = Simplify(mesh, 0, GetSize(mesh) * 0.05f);
+			ExpectKeepsBordersAndSeams(mesh, simplified.indices, model);
+		}
+	}
+
+	for (bool seam : { false, true })
+	{
+		TestMesh terrain = MakeTerrain(32, seam);
+		Simplified simplified = Simplify(terrain, 0, INFINITY);
+		size_t positions = ExpectKeepsBordersAndSeams(terrain, simplified.indices, seam ? "terrain with a seam" : "terrain");
+
+		// Everything inside the border can go, and the seam has nothing to keep it straight but its own ends
+		EXPECT_LT(positions, 32u * 4 + 1 + 32 / 2);
+
+		// Each side of the seam stays on its side
+		for (size_t i = 0; i < simplified.indices.size(); i += 3)
+		{
+			float minX = INFINITY, maxX = -INFINITY;
+			for (int corner = 0; corner < 3; corner++)
+			{
+				float x = GetPosition(terrain, simplified.indices[i + corner])[0];
+				minX = std::min(minX, x);
+				maxX = std::max(maxX, x);
+			}
+			if (seam)
+			{
+				EXPECT_TRUE(maxX <= 16.f || minX >= 16.f) << "triangle " << i / 3 << " crosses the seam";
+			}
+		}
+	}
+}
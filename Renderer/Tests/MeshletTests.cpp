@@ -0,0 +1,398 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "gtest/gtest.h"
+
+#include "Renderer/Culling.h"
+#include "Scene/MeshletBuilder.h"
+#include "ReferenceScene.h"
+#include "TestModels.h"
+
+namespace
+{
+	struct Meshlets
+	{
+		std::vector<Meshlet> meshlets;
+		std::vector<uint32_t> vertices;
+		std::vector<uint8_t> triangles;
+	};
+
+	Meshlets Build(const TestMesh& mesh)
+	{
+		Meshlets result;
+		size_t count = MeshletBuilder::Build(mesh.positions.data(), sizeof(float) * 3, mesh.GetVertexCount(), mesh.indices.data(), mesh.indices.size(),
+			result.meshlets, result.vertices, result.triangles);
+		EXPECT_EQ(count, result.meshlets.size());
+		return result;
+	}
+
+	// A sphere with its triangles facing out, the poles fans of triangles around a single vertex
+	TestMesh MakeSphere(unsigned int rings, unsigned int segments, float radius)
+	{
+		TestMesh mesh;
+		for (unsigned int ring = 0; ring <= rings; ring++)
+		{
+			float theta = 3.14159265f * (float) ring / (float) rings;
+			for (unsigned int segment = 0; segment < segments; segment++)
+			{
+				float phi = 6.2831853f * (float) segment / (float) segments;
+				mesh.positions.insert(mesh.positions.end(), { radius * std::sin(theta) * std::cos(phi), radius * std::cos(theta), radius * std::sin(theta) * std::sin(phi) });
+			}
+		}
+
+		for (unsigned int ring = 0; ring < rings; ring++)
+		{
+			for (unsigned int segment = 0; segment < segments; segment++)
+			{
+				unsigned int a = ring * segments + segment, b = ring * segments + (segment + 1) % segments;
+				unsigned int c = a + segments, d = b + segments;
+				if (ring > 0) mesh.indices.insert(mesh.indices.end(), { a, b, c });
+				if (ring + 1 < rings) mesh.indices.insert(mesh.indices.end(), { b, d, c });
+			}
+		}
+		return mesh;
+	}
+
+	// Triangles between vertices picked at random, so hardly any are shared and meshlets run out of vertices first.
+	// Some have the same corner twice
+	TestMesh MakeSoup(unsigned int vertexCount, unsigned int triangleCount, uint32_t seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> position(-10.f, 10.f);
+		std::uniform_int_distribution<unsigned int> vertex(0, vertexCount - 1);
+
+		TestMesh mesh;
+		for (unsigned int i = 0; i < vertexCount * 3; i++) mesh.positions.push_back(position(random));
+		for (unsigned int i = 0; i < triangleCount; i++)
+		{
+			unsigned int a = vertex(random), b = vertex(random), c = i % 13 == 0 ? a : vertex(random);
+			mesh.indices.insert(mesh.indices.end(), { a, b, c });
+		}
+		return mesh;
+	}
+
+	// A flat grid in rows, sharing most vertices between neighbouring triangles
+	TestMesh MakeGrid(unsigned int size)
+	{
+		TestMesh mesh;
+		for (unsigned int y = 0; y <= size; y++)
+		{
+			for (unsigned int x = 0; x <= size; x++) mesh.positions.insert(mesh.positions.end(), { (float) x, 0.f, (float) y });
+		}
+
+		for (unsigned int y = 0; y < size; y++)
+		{
+			for (unsigned int x = 0; x < size; x++)
+			{
+				unsigned int a = y * (size + 1) + x;
+				mesh.indices.insert(mesh.indices.end(), { a, a + size + 1, a + 1, a + 1, a + size + 1, a + size + 2 });
+			}
+		}
+		return mesh;
+	}
+
+	// The same small grid drawn over and over, like stacked decals, so meshlets run out of triangles long before vertices
+	TestMesh MakeLayers(unsigned int layers)
+	{
+		TestMesh mesh = MakeGrid(4);
+		std::vector<unsigned int> layer = mesh.indices;
+		for (unsigned int i = 1; i < layers; i++) mesh.indices.insert(mesh.indices.end(), layer.begin(), layer.end());
+		return mesh;
+	}
+
+	std::vector<TestMesh> GetMeshes()
+	{
+		std::vector<TestMesh> meshes = { MakeSphere(40, 64, 2.f), MakeSoup(5000, 3000, 1), MakeGrid(60), MakeLayers(20) };
+		for (const char* model : { "Collada/duck.dae", "PLY/Wuson.ply", "STL/Spider_binary.stl", "3DS/fels.3ds" })
+		{
+			std::vector<TestMesh> loaded = LoadTestModel(model);
+			EXPECT_FALSE(loaded.empty()) << model;
+			meshes.insert(meshes.end(), loaded.begin(), loaded.end());
+		}
+		return meshes;
+	}
+
+	void GetNormal(const TestMesh& mesh, const unsigned int* triangle, double normal[3])
+	{
+		const float* a = &mesh.positions[size_t(triangle[0]) * 3];
+		const float* b = &mesh.positions[size_t(triangle[1]) * 3];
+		const float* c = &mesh.positions[size_t(triangle[2]) * 3];
+		double u[3] = { (double) b[0] - a[0], (double) b[1] - a[1], (double) b[2] - a[2] };
+		double v[3] = { (double) c[0] - a[0], (double) c[1] - a[1], (double) c[2] - a[2] };
+		normal[0] = u[1] * v[2] - u[2] * v[1];
+		normal[1] = u[2] * v[0] - u[0] * v[2];
+		normal[2] = u[0] * v[1] - u[1] * v[0];
+	}
+
+	// Runs one meshlet through CullMeshlets() on its own, returns whether it was kept
+	bool IsKept(const Frustum& frustum, const float camera[3], const Meshlets& meshlets, size_t meshlet, std::vector<uint32_t>& indices)
+	{
+		return CullMeshlets(frustum, camera, &meshlets.meshlets[meshlet], 1, meshlets.vertices.data(), meshlets.triangles.data(), indices) == 1;
+	}
+}
+
+TEST(MeshletBuilder, StaysWithinLimits)
+{
+	for (auto& mesh : GetMeshes())
+	{
+		Meshlets meshlets = Build(mesh);
+		ASSERT_FALSE(meshlets.meshlets.empty());
+
+		uint32_t vertexOffset = 0, triangleOffset = 0;
+		size_t triangles = 0;
+		for (auto& meshlet : meshlets.meshlets)
+		{
+			EXPECT_GT(meshlet.triangleCount, 0u);
+			EXPECT_LE(meshlet.vertexCount, Meshlet::MaxVertices);
+			EXPECT_LE(meshlet.triangleCount, Meshlet::MaxTriangles);
+
+			// Packed one after the other
+			EXPECT_EQ(vertexOffset, meshlet.vertexOffset);
+			EXPECT_EQ(triangleOffset, meshlet.triangleOffset);
+			vertexOffset += meshlet.vertexCount;
+			triangleOffset += meshlet.triangleCount * 3;
+			triangles += meshlet.triangleCount;
+
+			// Every vertex once, and used by one of the triangles
+			std::vector<uint32_t> vertices(meshlets.vertices.begin() + meshlet.vertexOffset, meshlets.vertices.begin() + meshlet.vertexOffset + meshlet.vertexCount);
+			std::sort(vertices.begin(), vertices.end());
+			EXPECT_EQ(vertices.end(), std::unique(vertices.begin(), vertices.end()));
+
+			std::vector<bool> used(meshlet.vertexCount);
+			for (uint32_t corner = 0; corner < meshlet.triangleCount * 3; corner++)
+			{
+				uint8_t local = meshlets.triangles[meshlet.triangleOffset + corner];
+				ASSERT_LT(local, meshlet.vertexCount);
+				used[local] = true;
+			}
+			EXPECT_EQ(used.end(), std::find(used.begin(), used.end(), false));
+		}
+		EXPECT_EQ(vertexOffset, meshlets.vertices.size());
+		EXPECT_EQ(triangleOffset, meshlets.triangles.size());
+		EXPECT_EQ(mesh.indices.size() / 3, triangles);
+
+		// Greedy: a meshlet only ends when the next triangle wouldn't fit in it
+		for (size_t i = 0, triangle = 0; i + 1 < meshlets.meshlets.size(); i++)
+		{
+			auto& meshlet = meshlets.meshlets[i];
+			triangle += meshlet.triangleCount;
+			if (meshlet.triangleCount == Meshlet::MaxTriangles) continue;
+
+			const uint32_t* begin = &meshlets.vertices[meshlet.vertexOffset];
+			const uint32_t* end = begin + meshlet.vertexCount;
+			uint32_t newVertices = 0;
+			for (int corner = 0; corner < 3; corner++) newVertices += std::find(begin, end, mesh.indices[triangle * 3 + corner]) == end;
+			EXPECT_GT(meshlet.vertexCount + newVertices, Meshlet::MaxVertices) << "meshlet " << i;
+		}
+	}
+}
+
+TEST(MeshletBuilder, HitsBothLimits)
+{
+	// The soup fills meshlets up with vertices, the layers with triangles
+	Meshlets soup = Build(MakeSoup(5000, 3000, 2));
+	Meshlets layers = Build(MakeLayers(8));
+	EXPECT_EQ(Meshlet::MaxVertices, soup.meshlets.front().vertexCount);
+	EXPECT_LT(soup.meshlets.front().triangleCount, Meshlet::MaxTriangles);
+	ASSERT_EQ(3u, layers.meshlets.size());
+	EXPECT_EQ(Meshlet::MaxTriangles, layers.meshlets[0].triangleCount);
+	EXPECT_EQ(Meshlet::MaxTriangles, layers.meshlets[1].triangleCount);
+	EXPECT_EQ(8u * 32u - 2u * Meshlet::MaxTriangles, layers.meshlets[2].triangleCount);
+	EXPECT_EQ(25u, layers.meshlets[0].vertexCount);
+}
+
+TEST(MeshletBuilder, RebuildsIndices)
+{
+	for (auto& mesh : GetMeshes())
+	{
+		Meshlets meshlets = Build(mesh);
+
+		std::vector<unsigned int> rebuilt;
+		for (auto& meshlet : meshlets.meshlets)
+		{
+			for (uint32_t corner = 0; corner < meshlet.triangleCount * 3; corner++)
+				rebuilt.push_back(meshlets.vertices[meshlet.vertexOffset + meshlets.triangles[meshlet.triangleOffset + corner]]);
+		}
+		EXPECT_EQ(mesh.indices, rebuilt);
+
+		// And the same again through CullMeshlets() with nothing to cull
+		Frustum everything;
+		for (auto& plane : everything.planes)
+		{
+			for (int i = 0; i < 4; i++) plane[i] = i == 3 ? 1.f : 0.f;
+		}
+		for (auto& meshlet : meshlets.meshlets) meshlet.coneCutoff = 1.f;
+
+		float camera[] = { 0.f, 0.f, 0.f };
+		std::vector<uint32_t> culled;
+		EXPECT_EQ(meshlets.meshlets.size(), CullMeshlets(everything, camera, meshlets.meshlets.data(), meshlets.meshlets.size(),
+			meshlets.vertices.data(), meshlets.triangles.data(), culled));
+		EXPECT_TRUE(std::equal(mesh.indices.begin(), mesh.indices.end(), culled.begin(), culled.end()));
+	}
+}
+
+TEST(MeshletBuilder, AppendsToExistingLists)
+{
+	TestMesh first = MakeSphere(10, 16, 1.f), second = MakeGrid(20);
+	Meshlets meshlets = Build(first);
+	size_t firstCount = meshlets.meshlets.size();
+
+	Meshlets alone = Build(second);
+	size_t count = MeshletBuilder::Build(second.positions.data(), sizeof(float) * 3, second.GetVertexCount(), second.indices.data(), second.indices.size(),
+		meshlets.meshlets, meshlets.vertices, meshlets.triangles);
+	ASSERT_EQ(alone.meshlets.size(), count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		auto& appended = meshlets.meshlets[firstCount + i];
+		EXPECT_EQ(alone.meshlets[i].vertexCount, appended.vertexCount);
+		EXPECT_EQ(alone.meshlets[i].triangleCount, appended.triangleCount);
+		EXPECT_TRUE(std::equal(alone.vertices.begin() + alone.meshlets[i].vertexOffset, alone.vertices.begin() + alone.meshlets[i].vertexOffset + appended.vertexCount,
+			meshlets.vertices.begin() + appended.vertexOffset));
+		EXPECT_TRUE(std::equal(alone.triangles.begin() + alone.meshlets[i].triangleOffset,
+			alone.triangles.begin() + alone.meshlets[i].triangleOffset + appended.triangleCount * 3, meshlets.triangles.begin() + appended.triangleOffset));
+	}
+}
+
+TEST(MeshletBuilder, BoundsContainEverything)
+{
+	for (auto& mesh : GetMeshes())
+	{
+		Meshlets meshlets = Build(mesh);
+		for (auto& meshlet : meshlets.meshlets)
+		{
+			double axisLength = std::sqrt(meshlet.coneAxis[0] * meshlet.coneAxis[0] + meshlet.coneAxis[1] * meshlet.coneAxis[1] + meshlet.coneAxis[2] * meshlet.coneAxis[2]);
+			double minDot = std::sqrt(1.0 - (double) meshlet.coneCutoff * meshlet.coneCutoff);
+
+			for (uint32_t i = 0; i < meshlet.vertexCount; i++)
+			{
+				const float* position = &mesh.positions[size_t(meshlets.vertices[meshlet.vertexOffset + i]) * 3];
+				double dx = position[0] - meshlet.center[0], dy = position[1] - meshlet.center[1], dz = position[2] - meshlet.center[2];
+				EXPECT_LE(std::sqrt(dx * dx + dy * dy + dz * dz), meshlet.radius * (1.0 + 1e-6) + 1e-6);
+			}
+
+			if (meshlet.coneCutoff >= 1.f) continue;
+
+			// The cone holds every triangle's normal
+			EXPECT_NEAR(1.0, axisLength, 1e-5);
+			for (uint32_t i = 0; i < meshlet.triangleCount; i++)
+			{
+				unsigned int triangle[3];
+				for (int corner = 0; corner < 3; corner++)
+					triangle[corner] = meshlets.vertices[meshlet.vertexOffset + meshlets.triangles[meshlet.triangleOffset + i * 3 + corner]];
+
+				double normal[3];
+				GetNormal(mesh, triangle, normal);
+				double length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+				if (length == 0.0) continue;
+
+				double dot = (normal[0] * meshlet.coneAxis[0] + normal[1] * meshlet.coneAxis[1] + normal[2] * meshlet.coneAxis[2]) / (length * axisLength);
+				EXPECT_GE(dot, minDot - 1e-4);
+			}
+		}
+	}
+}
+
+TEST(CullMeshlets, NeverCullsVisibleTriangles)
+{
+	std::mt19937 random(4);
+	std::uniform_real_distribution<float> unit(-1.f, 1.f), distance(0.2f, 4.f);
+
+	Frustum everything;
+	for (auto& plane : everything.planes)
+	{
+		for (int i = 0; i < 4; i++) plane[i] = i == 3 ? 1.f : 0.f;
+	}
+
+	size_t culledMeshlets = 0, testedMeshlets = 0;
+	for (auto& mesh : GetMeshes())
+	{
+		Meshlets meshlets = Build(mesh);
+
+		float min[3] = { INFINITY, INFINITY, INFINITY }, max[3] = { -INFINITY, -INFINITY, -INFINITY };
+		for (size_t i = 0; i < mesh.positions.size(); i++)
+		{
+			min[i % 3] = std::min(min[i % 3], mesh.positions[i]);
+			max[i % 3] = std::max(max[i % 3], mesh.positions[i]);
+		}
+		float size = std::max({ max[0] - min[0], max[1] - min[1], max[2] - min[2] });
+
+		// Cameras all around the mesh, inside it and far away from it
+		for (int i = 0; i < 50; i++)
+		{
+			float camera[3];
+			float scale = size * distance(random);
+			for (int axis = 0; axis < 3; axis++) camera[axis] = (min[axis] + max[axis]) * 0.5f + unit(random) * scale;
+
+			std::vector<uint32_t> indices;
+			for (size_t meshlet = 0; meshlet < meshlets.meshlets.size(); meshlet++)
+			{
+				testedMeshlets++;
+				if (IsKept(everything, camera, meshlets, meshlet, indices)) continue;
+				culledMeshlets++;
+
+				// Only meshlets with nothing but triangles facing away from the camera, or edge on, may go
+				auto& culled = meshlets.meshlets[meshlet];
+				for (uint32_t triangle = 0; triangle < culled.triangleCount; triangle++)
+				{
+					unsigned int corners[3];
+					for (int corner = 0; corner < 3; corner++)
+						corners[corner] = meshlets.vertices[culled.vertexOffset + meshlets.triangles[culled.triangleOffset + triangle * 3 + corner]];
+
+					double normal[3];
+					GetNormal(mesh, corners, normal);
+					const float* a = &mesh.positions[size_t(corners[0]) * 3];
+					double view[3] = { (double) a[0] - camera[0], (double) a[1] - camera[1], (double) a[2] - camera[2] };
+					double facing = normal[0] * view[0] + normal[1] * view[1] + normal[2] * view[2];
+					double scale = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]) *
+						std::sqrt(view[0] * view[0] + view[1] * view[1] + view[2] * view[2]);
+					EXPECT_GE(facing, -1e-4 * scale) << "meshlet " << meshlet << ", triangle " << triangle;
+				}
+			}
+		}
+	}
+
+	// Closed meshes seen from outside lose about half their meshlets, make sure some actually were
+	EXPECT_GT(culledMeshlets, testedMeshlets / 10);
+}
+
+TEST(CullMeshlets, KeepsMeshletsInTheFrustum)
+{
+	std::mt19937 random(5);
+	std::uniform_real_distribution<float> unit(-1.f, 1.f);
+
+	TestMesh mesh = MakeGrid(200);
+	Meshlets meshlets = Build(mesh);
+	for (auto& meshlet : meshlets.meshlets) meshlet.coneCutoff = 1.f;
+
+	size_t culled = 0;
+	for (int i = 0; i < 50; i++)
+	{
+		float camera[] = { 100.f + unit(random) * 100.f, 1.f + std::fabs(unit(random)) * 30.f, 100.f + unit(random) * 100.f };
+		Frustum frustum = ExtractFrustum(MakeViewProjection(camera, unit(random) * 3.14f, 1.f, 1.5f, 0.1f, 80.f));
+
+		std::vector<uint32_t> indices;
+		for (size_t meshlet = 0; meshlet < meshlets.meshlets.size(); meshlet++)
+		{
+			if (IsKept(frustum, camera, meshlets, meshlet, indices)) continue;
+			culled++;
+
+			// Everything of a meshlet left out is behind one plane
+			auto& outside = meshlets.meshlets[meshlet];
+			bool behindOnePlane = false;
+			for (auto& plane : frustum.planes)
+			{
+				bool behind = true;
+				for (uint32_t vertex = 0; vertex < outside.vertexCount && behind; vertex++)
+				{
+					const float* p = &mesh.positions[size_t(meshlets.vertices[outside.vertexOffset + vertex]) * 3];
+					behind = plane[0] * p[0] + plane[1] * p[1] + plane[2] * p[2] + plane[3] < 0.f;
+				}
+				behindOnePlane = behindOnePlane || behind;
+			}
+			EXPECT_TRUE(behindOnePlane) << "meshlet " << meshlet;
+		}
+	}
+	EXPECT_GT(culled, 0u);
+}
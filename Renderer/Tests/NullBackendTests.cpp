@@ -0,0 +1,127 @@
+#include "gtest/gtest.h"
+
+#include "Primitives/NullBackend.h"
+#include "ReferenceFrame.h"
+
+namespace
+{
+	void ExpectReferenceCounts(const ReferenceFrame& frame, const NullBackendStats& stats)
+	{
+		EXPECT_EQ(frame.GetDraws(), stats.draws);
+		EXPECT_EQ(frame.GetDraws(), stats.commands[(size_t) CommandType::DrawIndexedInstanced]);
+		EXPECT_EQ(frame.GetStateChanges(), stats.stateChanges);
+		EXPECT_EQ(frame.GetRedundantStates(), stats.redundantStates);
+		EXPECT_EQ(1u, stats.commands[(size_t) CommandType::BindRenderTarget]);
+		EXPECT_EQ(2u, stats.maxScopeDepth);
+	}
+
+	template<typename T>
+	T* Stand(uintptr_t address) { return (T*) address; }
+}
+
+TEST(NullBackend, ReferenceFrame)
+{
+	ReferenceFrame frame;
+	CommandList list;
+	frame.Record(list);
+
+	NullBackend backend;
+	backend.Execute(list);
+	for (auto& error : backend.GetErrors()) ADD_FAILURE() << error;
+	ExpectReferenceCounts(frame, backend.GetStats());
+
+	uint64_t instances = 0, indices = 0;
+	for (unsigned int group = 0; group < frame.GetDraws(); group++)
+	{
+		instances += 1 + group % 4;
+		indices += uint64_t(36 + group % 7 * 3) * (1 + group % 4);
+	}
+	EXPECT_EQ(instances, backend.GetStats().instances);
+	EXPECT_EQ(indices, backend.GetStats().indices);
+}
+
+TEST(NullBackend, ReferenceFrameShapes)
+{
+	// Every pass empty in turn, and every opaque group clustered
+	ReferenceFrame frames[] = { { 0, 0, 1 }, { 1, 0, 0 }, { 50, 50, 3 }, { 1000, 0, 2 } };
+	for (auto& frame : frames)
+	{
+		CommandList list;
+		frame.Record(list);
+
+		NullBackend backend;
+		backend.Execute(list);
+		for (auto& error : backend.GetErrors()) ADD_FAILURE() << error;
+		ExpectReferenceCounts(frame, backend.GetStats());
+	}
+}
+
+TEST(NullBackend, ReplayKeepsState)
+{
+	// The state cache isn't reset between lists, so a second replay only changes what differs between the end of the frame and its start:
+	// the material records, and the pixel shader and index buffer once going into and once coming out of the gizmo and clustered groups
+	ReferenceFrame frame;
+	CommandList list;
+	frame.Record(list);
+
+	NullBackend backend;
+	backend.Execute(list);
+	backend.Execute(list);
+	EXPECT_TRUE(backend.GetErrors().empty());
+
+	auto& stats = backend.GetStats();
+	EXPECT_EQ(2 * frame.GetDraws(), stats.draws);
+	EXPECT_EQ(frame.GetStateChanges() + frame.GetDraws() + 4, stats.stateChanges);
+
+	backend.Reset();
+	backend.Execute(list);
+	ExpectReferenceCounts(frame, backend.GetStats());
+}
+
+TEST(NullBackend, RejectsInvalidCommands)
+{
+	float color[] = { 0.f, 0.f, 0.f, 1.f };
+	CommandList list;
+	list.DrawIndexedInstanced(3, 1, 0, 0, 0);
+	list.BindVertexBuffer(Stand<VertexBuffer>(16));
+	list.BindIndexBuffer(Stand<IndexBuffer>(32));
+	list.DrawIndexedInstanced(3, 1, 0, 0, 0);
+	list.BindVertexShader(Stand<VertexShader>(48));
+	list.BindPixelShader(Stand<PixelShader>(64));
+	list.DrawIndexedInstanced(3, 1, 0, 0, 0);
+	list.BindRenderTarget(nullptr, nullptr);
+	list.BindRenderTarget(Stand<void>(80), nullptr);
+	list.DrawIndexedInstanced(0, 1, 0, 0, 0);
+	list.ClearRenderTarget(nullptr, color);
+	list.ClearDepth(nullptr, 1.f);
+	list.BindConstantBuffer(nullptr, ShaderStage::Pixel, 14);
+	list.BindConstantRecord(nullptr, ShaderStage::Vertex, 0, 0);
+	list.BindStructuredBuffer(nullptr, ShaderStage::Pixel, 8);
+	list.WriteBuffer(WriteTarget::ConstantBuffer, nullptr, color, sizeof(color));
+	list.WriteBuffer(WriteTarget::ConstantBuffer, color, color, 0);
+	list.EndScope();
+	list.BeginScope("Open");
+	list.DrawIndexedInstanced(3, 1, 0, 0, 0);
+
+	NullBackend backend;
+	backend.Execute(list);
+
+	std::vector<std::string> expected = {
+		"Command 0: draw without vertex and index buffers",
+		"Command 3: draw without shaders",
+		"Command 6: draw without a render target",
+		"Command 7: render target bind without a render target",
+		"Command 9: empty draw",
+		"Command 10: clear without a render target",
+		"Command 11: clear without a depth target",
+		"Command 12: constant buffer slot out of range",
+		"Command 13: constant record without a buffer",
+		"Command 14: shader resource slot out of range",
+		"Command 15: write without a buffer",
+		"Command 16: empty write",
+		"Command 17: end of a scope that was never begun",
+		"Command 20: scope left open",
+	};
+	EXPECT_EQ(expected, backend.GetErrors());
+	EXPECT_EQ(5u, backend.GetStats().draws);
+}
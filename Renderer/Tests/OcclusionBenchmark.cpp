@@ -0,0 +1,47 @@
+#include "Benchmark.h"
+
+#include "Renderer/Occlusion.h"
+#include "ReferenceScene.h"
+
+// A frame of occlusion culling at the renderer's resolution: projecting and drawing the occluders, then testing every box
+TEST(OcclusionBenchmark, Street)
+{
+	for (unsigned int buildings : { 64u, 256u, 1024u })
+	{
+		ReferenceScene scene = ReferenceScene::Street(buildings, 1);
+		std::vector<uint32_t> indices(scene.GetBoxCount());
+
+		for (unsigned int threads : { 1u, 0u })
+		{
+			OcclusionBuffer buffer(256, 128, threads);
+			std::string name = std::to_string(buildings) + " buildings, " + (threads == 0 ? "default" : std::to_string(threads)) + " threads";
+
+			Benchmark((name + ", rasterize").c_str(), [&]()
+			{
+				buffer.Clear();
+				buffer.AddOccluder(scene.positions.data(), scene.indices.data(), scene.indices.size(), scene.viewProjection);
+				buffer.Rasterize();
+			});
+
+			size_t visible = 0;
+			Benchmark((name + ", " + std::to_string(indices.size()) + " boxes").c_str(), [&]()
+			{
+				for (uint32_t i = 0; i < (uint32_t) indices.size(); i++) indices[i] = i;
+				visible = buffer.CullOccluded(scene.GetBounds(), scene.viewProjection, indices.data(), indices.size());
+			});
+			EXPECT_LT(visible, indices.size());
+		}
+	}
+}
+
+TEST(OcclusionBenchmark, Scatter)
+{
+	ReferenceScene scene = ReferenceScene::Scatter(4000, 1);
+	OcclusionBuffer buffer(256, 128);
+	Benchmark("4000 scattered triangles, rasterize", [&]()
+	{
+		buffer.Clear();
+		buffer.AddOccluder(scene.positions.data(), scene.indices.data(), scene.indices.size(), scene.viewProjection);
+		buffer.Rasterize();
+	});
+}
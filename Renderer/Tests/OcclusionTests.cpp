@@ -0,0 +1,311 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+#include "Renderer/Occlusion.h"
+#include "ReferenceScene.h"
+
+namespace
+{
+	// How far from an edge, in pixels, a pixel center is close enough for rounding to put it on either side
+	constexpr double EdgeTolerance = 1e-3;
+	constexpr float DepthTolerance = 1e-5f;
+
+	// Depths of every pixel, drawn one pixel at a time against every triangle in double precision.
+	// Pixels with a center right on an edge could go either way, so there are two answers: the nearest depth of the triangles
+	// clearly covering the pixel, and the nearest of those that might
+	struct ReferenceDepth
+	{
+		std::vector<float> strict;
+		std::vector<float> loose;
+	};
+
+	ReferenceDepth RasterizeReference(const ReferenceScene& scene, unsigned int width, unsigned int height)
+	{
+		ReferenceDepth depth;
+		depth.strict.assign(size_t(width) * height, 1.f);
+		depth.loose.assign(size_t(width) * height, 1.f);
+
+		const auto& m = scene.viewProjection.m;
+		for (size_t i = 0; i + 2 < scene.indices.size(); i += 3)
+		{
+			double screen[3][3];
+			bool nearPlane = false;
+			for (int vertex = 0; vertex < 3; vertex++)
+			{
+				const float* position = &scene.positions[size_t(scene.indices[i + vertex]) * 3];
+				double clip[4];
+				for (int column = 0; column < 4; column++)
+					clip[column] = position[0] * (double) m[0][column] + position[1] * (double) m[1][column] + position[2] * (double) m[2][column] + m[3][column];
+
+				nearPlane = nearPlane || clip[2] < 0.0 || clip[3] <= 0.0;
+				screen[vertex][0] = (clip[0] / clip[3] * 0.5 + 0.5) * width;
+				screen[vertex][1] = (0.5 - clip[1] / clip[3] * 0.5) * height;
+				screen[vertex][2] = clip[2] / clip[3];
+			}
+			if (nearPlane) continue;
+
+			auto edge = [&](int from, int to, double x, double y)
+			{
+				return (screen[to][0] - screen[from][0]) * (y - screen[from][1]) - (screen[to][1] - screen[from][1]) * (x - screen[from][0]);
+			};
+			double area = edge(0, 1, screen[2][0], screen[2][1]);
+			if (std::fabs(area) < 1e-6) continue;
+
+			// Only the pixels around the triangle, the rest can't be in it
+			auto range = [&](int axis, int size, int& first, int& last)
+			{
+				double min = std::min({ screen[0][axis], screen[1][axis], screen[2][axis] });
+				double max = std::max({ screen[0][axis], screen[1][axis], screen[2][axis] });
+				first = (int) std::max(std::floor(min) - 1.0, 0.0);
+				last = (int) std::min(std::ceil(max) + 1.0, (double) size - 1);
+			};
+			int x0, x1, y0, y1;
+			range(0, (int) width, x0, x1);
+			range(1, (int) height, y0, y1);
+
+			for (int y = y0; y <= y1; y++)
+			{
+				for (int x = x0; x <= x1; x++)
+				{
+					double px = x + 0.5, py = y + 0.5;
+					bool inside = true, maybeInside = true;
+					double weights[3];
+					for (int vertex = 0; vertex < 3; vertex++)
+					{
+						int from = (vertex + 1) % 3, to = (vertex + 2) % 3;
+						double value = edge(from, to, px, py) / area;
+						double length = std::hypot(screen[to][0] - screen[from][0], screen[to][1] - screen[from][1]);
+						double distance = value * std::fabs(area) / length;
+
+						weights[vertex] = value;
+						inside = inside && distance > EdgeTolerance;
+						maybeInside = maybeInside && distance > -EdgeTolerance;
+					}
+					if (!maybeInside) continue;
+
+					float z = (float) (weights[0] * screen[0][2] + weights[1] * screen[1][2] + weights[2] * screen[2][2]);
+					size_t pixel = size_t(y) * width + x;
+					depth.loose[pixel] = std::min(depth.loose[pixel], z);
+					if (inside) depth.strict[pixel] = std::min(depth.strict[pixel], z);
+				}
+			}
+		}
+
+		return depth;
+	}
+
+	void Rasterize(OcclusionBuffer& buffer, const ReferenceScene& scene)
+	{
+		buffer.Clear();
+		buffer.AddOccluder(scene.positions.data(), scene.indices.data(), scene.indices.size(), scene.viewProjection);
+		buffer.Rasterize();
+	}
+
+	void ExpectMatchesReference(const OcclusionBuffer& buffer, const ReferenceScene& scene)
+	{
+		unsigned int width = buffer.GetWidth(), height = buffer.GetHeight();
+		ReferenceDepth reference = RasterizeReference(scene, width, height);
+
+		size_t mismatches = 0, covered = 0;
+		for (size_t pixel = 0; pixel < size_t(width) * height; pixel++)
+		{
+			float depth = buffer.GetDepth()[pixel];
+			if (depth < 1.f) ++covered;
+
+			// The buffer may take any of the triangles a pixel is on the edge of, but has to take every one it is inside
+			float tolerance = DepthTolerance * std::max(1.f, std::fabs(depth));
+			if (depth >= reference.loose[pixel] - tolerance && depth <= reference.strict[pixel] + tolerance) continue;
+
+			if (++mismatches <= 10)
+			{
+				ADD_FAILURE() << "pixel " << pixel % width << ", " << pixel / width << " has depth " << depth <<
+					", expected between " << reference.loose[pixel] << " and " << reference.strict[pixel];
+			}
+		}
+		EXPECT_EQ(0u, mismatches);
+
+		// Make sure the scene actually drew something, and didn't cover everything either
+		EXPECT_GT(covered, size_t(width) * height / 20);
+		EXPECT_LT(covered, size_t(width) * height);
+	}
+
+	// Everything IsVisible() looks at from the outside: the nearest depth of a box, and the pixels its corners' rectangle touches
+	bool IsHiddenInReference(const ReferenceScene& scene, size_t box, const std::vector<float>& depth, unsigned int width, unsigned int height)
+	{
+		const auto& m = scene.viewProjection.m;
+		double minX = width, maxX = 0.0, minY = height, maxY = 0.0, minZ = 1.0;
+		for (int corner = 0; corner < 8; corner++)
+		{
+			double position[3], clip[4];
+			for (int axis = 0; axis < 3; axis++)
+				position[axis] = scene.centers[axis][box] + ((corner >> axis) & 1 ? scene.extents[axis][box] : -scene.extents[axis][box]);
+			for (int column = 0; column < 4; column++)
+				clip[column] = position[0] * m[0][column] + position[1] * m[1][column] + position[2] * m[2][column] + m[3][column];
+			if (clip[2] < 0.0 || clip[3] <= 0.0) return false;
+
+			minX = std::min(minX, (clip[0] / clip[3] * 0.5 + 0.5) * width);
+			maxX = std::max(maxX, (clip[0] / clip[3] * 0.5 + 0.5) * width);
+			minY = std::min(minY, (0.5 - clip[1] / clip[3] * 0.5) * height);
+			maxY = std::max(maxY, (0.5 - clip[1] / clip[3] * 0.5) * height);
+			minZ = std::min(minZ, clip[2] / clip[3]);
+		}
+
+		int x0 = std::max((int) std::floor(minX), 0), x1 = std::min((int) std::floor(maxX), (int) width - 1);
+		int y0 = std::max((int) std::floor(minY), 0), y1 = std::min((int) std::floor(maxY), (int) height - 1);
+		if (x0 > x1 || y0 > y1) return false;
+
+		for (int y = y0; y <= y1; y++)
+		{
+			for (int x = x0; x <= x1; x++)
+			{
+				if (depth[size_t(y) * width + x] >= minZ) return false;
+			}
+		}
+		return true;
+	}
+}
+
+TEST(OcclusionBuffer, RoundsUpToTiles)
+{
+	OcclusionBuffer buffer(100, 50, 1);
+	EXPECT_EQ(104u, buffer.GetWidth());
+	EXPECT_EQ(56u, buffer.GetHeight());
+
+	buffer.Rasterize();
+	for (size_t pixel = 0; pixel < size_t(buffer.GetWidth()) * buffer.GetHeight(); pixel++) ASSERT_EQ(1.f, buffer.GetDepth()[pixel]);
+}
+
+TEST(OcclusionBuffer, StreetMatchesReference)
+{
+	for (uint32_t seed = 1; seed <= 3; seed++)
+	{
+		ReferenceScene scene = ReferenceScene::Street(40, seed);
+		OcclusionBuffer buffer(256, 128, 1);
+		Rasterize(buffer, scene);
+		ExpectMatchesReference(buffer, scene);
+	}
+}
+
+TEST(OcclusionBuffer, ScatterMatchesReference)
+{
+	for (uint32_t seed = 1; seed <= 3; seed++)
+	{
+		ReferenceScene scene = ReferenceScene::Scatter(200, seed);
+		OcclusionBuffer buffer(160, 96, 1);
+		Rasterize(buffer, scene);
+		ExpectMatchesReference(buffer, scene);
+	}
+}
+
+TEST(OcclusionBuffer, DropsTrianglesCrossingTheNearPlane)
+{
+	// One triangle in front of the camera and one reaching behind it
+	float camera[] = { 0.f, 0.f, 0.f };
+	TransformMatrix viewProjection = MakeViewProjection(camera, 0.f, 1.f, 1.f, 0.5f, 100.f);
+	float positions[] = { -5.f, -5.f, 10.f, 5.f, -5.f, 10.f, 0.f, 5.f, 10.f, -5.f, -5.f, -1.f, 5.f, -5.f, 10.f, 0.f, 5.f, 10.f };
+	uint32_t indices[] = { 0, 1, 2, 3, 4, 5 };
+
+	OcclusionBuffer buffer(64, 64, 1);
+	buffer.AddOccluder(positions, indices, 6, viewProjection);
+	EXPECT_EQ(1u, buffer.GetTriangleCount());
+
+	buffer.Clear();
+	EXPECT_EQ(0u, buffer.GetTriangleCount());
+}
+
+TEST(OcclusionBuffer, SameForAnyThreadCount)
+{
+	ReferenceScene scenes[] = { ReferenceScene::Street(200, 7), ReferenceScene::Scatter(1000, 7) };
+	for (auto& scene : scenes)
+	{
+		OcclusionBuffer single(256, 128, 1);
+		Rasterize(single, scene);
+		std::vector<float> expected(single.GetDepth(), single.GetDepth() + size_t(single.GetWidth()) * single.GetHeight());
+
+		std::vector<uint32_t> expectedVisible(scene.GetBoxCount());
+		for (uint32_t i = 0; i < (uint32_t) expectedVisible.size(); i++) expectedVisible[i] = i;
+		expectedVisible.resize(single.CullOccluded(scene.GetBounds(), scene.viewProjection, expectedVisible.data(), expectedVisible.size()));
+
+		for (unsigned int threads : { 2u, 3u, 4u, 7u, 16u })
+		{
+			OcclusionBuffer buffer(256, 128, threads);
+
+			// A few frames each, so workers are woken more than once
+			for (int frame = 0; frame < 3; frame++)
+			{
+				Rasterize(buffer, scene);
+				ASSERT_EQ(0, memcmp(expected.data(), buffer.GetDepth(), expected.size() * sizeof(float))) << threads << " threads";
+
+				std::vector<uint32_t> visible(scene.GetBoxCount());
+				for (uint32_t i = 0; i < (uint32_t) visible.size(); i++) visible[i] = i;
+				visible.resize(buffer.CullOccluded(scene.GetBounds(), scene.viewProjection, visible.data(), visible.size()));
+				EXPECT_EQ(expectedVisible, visible) << threads << " threads";
+			}
+		}
+	}
+}
+
+TEST(OcclusionBuffer, HidesBoxesBehindAWall)
+{
+	// A wall filling the screen ten metres away
+	float camera[] = { 0.f, 0.f, 0.f };
+	ReferenceScene scene;
+	scene.viewProjection = MakeViewProjection(camera, 0.f, 1.f, 2.f, 0.5f, 100.f);
+	float wall[] = { 0.f, 0.f, 10.f }, wallSize[] = { 50.f, 50.f, 0.1f };
+	scene.AddOccluderBox(wall, wallSize);
+
+	OcclusionBuffer buffer(256, 128, 2);
+	Rasterize(buffer, scene);
+
+	float small[] = { 1.f, 1.f, 1.f };
+	float behind[] = { 2.f, 1.f, 20.f }, inFront[] = { 2.f, 1.f, 5.f }, through[] = { 0.f, 0.f, 10.f }, behindCamera[] = { 0.f, 0.f, 0.5f };
+	float offScreen[] = { 100.f, 0.f, 5.f }, offScreenBehind[] = { 100.f, 0.f, 30.f };
+	EXPECT_FALSE(buffer.IsVisible(behind, small, scene.viewProjection));
+	EXPECT_TRUE(buffer.IsVisible(inFront, small, scene.viewProjection));
+	EXPECT_TRUE(buffer.IsVisible(through, small, scene.viewProjection));
+	EXPECT_TRUE(buffer.IsVisible(behindCamera, small, scene.viewProjection));
+
+	// Frustum culling is somebody else's job, boxes the buffer doesn't cover are visible
+	EXPECT_TRUE(buffer.IsVisible(offScreen, small, scene.viewProjection));
+	EXPECT_TRUE(buffer.IsVisible(offScreenBehind, small, scene.viewProjection));
+}
+
+TEST(OcclusionBuffer, CullsLikeReference)
+{
+	for (uint32_t seed = 1; seed <= 3; seed++)
+	{
+		ReferenceScene scene = ReferenceScene::Street(60, seed);
+		OcclusionBuffer buffer(256, 128, 2);
+		Rasterize(buffer, scene);
+		ReferenceDepth reference = RasterizeReference(scene, buffer.GetWidth(), buffer.GetHeight());
+
+		std::vector<uint32_t> visible;
+		size_t hidden = 0;
+		for (uint32_t box = 0; box < (uint32_t) scene.GetBoxCount(); box++)
+		{
+			float center[] = { scene.centers[0][box], scene.centers[1][box], scene.centers[2][box] };
+			float extent[] = { scene.extents[0][box], scene.extents[1][box], scene.extents[2][box] };
+			bool isVisible = buffer.IsVisible(center, extent, scene.viewProjection);
+			if (isVisible)
+			{
+				visible.push_back(box);
+				continue;
+			}
+
+			// Hiding a box that might show anywhere is the one mistake occlusion culling can't make
+			++hidden;
+			EXPECT_TRUE(IsHiddenInReference(scene, box, reference.loose, buffer.GetWidth(), buffer.GetHeight())) << "box " << box;
+		}
+		EXPECT_GT(hidden, 0u);
+		EXPECT_GT(visible.size(), 0u);
+
+		// Culling a list keeps the visible boxes in order
+		std::vector<uint32_t> culled(scene.GetBoxCount());
+		for (uint32_t i = 0; i < (uint32_t) culled.size(); i++) culled[i] = i;
+		culled.resize(buffer.CullOccluded(scene.GetBounds(), scene.viewProjection, culled.data(), culled.size()));
+		EXPECT_EQ(visible, culled);
+	}
+}
@@ -0,0 +1,441 @@
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "Primitives/Profiler.h"
+
+namespace
+{
+	// The profiler is shared by the whole process, so every test works on tracks of threads of its own
+	uint32_t FindTrack(const std::string& name)
+	{
+		for (uint32_t track = 0; track < Profiler::GetTrackCount(); track++)
+		{
+			if (Profiler::GetTrackName(track) == name) return track;
+		}
+
+		ADD_FAILURE() << "no track called " << name;
+		return ~0u;
+	}
+
+	// Runs work on a new thread with a track of the given name, and returns the track once the thread is done
+	template<typename Function>
+	uint32_t RunOnTrack(const char* name, Function&& work)
+	{
+		std::thread thread([&]()
+		{
+			Profiler::SetThreadName(name);
+			work();
+		});
+		thread.join();
+		return FindTrack(name);
+	}
+
+	// Collects a frame and returns what it has of one track
+	std::vector<ProfileEvent> EndFrame(uint32_t track)
+	{
+		Profiler::EndFrame();
+
+		std::vector<ProfileEvent> events;
+		for (auto& event : Profiler::GetFrames().back().events)
+		{
+			if (event.track == track) events.push_back(event);
+		}
+		return events;
+	}
+
+	// Just enough of a JSON parser to tell whether a document is valid, keeping every string in it decoded
+	class JsonChecker
+	{
+	public:
+		explicit JsonChecker(const std::string& text) : m_Text(text) {}
+
+		bool Check()
+		{
+			return Value() && (Space(), m_Position == m_Text.size());
+		}
+
+		const std::vector<std::string>& GetStrings() const { return m_Strings; }
+
+	private:
+		void Space()
+		{
+			while (m_Position < m_Text.size() && strchr(" \t\r\n", m_Text[m_Position])) m_Position++;
+		}
+
+		bool Take(char c)
+		{
+			Space();
+			if (m_Position >= m_Text.size() || m_Text[m_Position] != c) return false;
+			m_Position++;
+			return true;
+		}
+
+		bool Value()
+		{
+			Space();
+			if (m_Position >= m_Text.size()) return false;
+
+			char c = m_Text[m_Position];
+			if (c == '{') return Container('}', true);
+			if (c == '[') return Container(']', false);
+			if (c == '"') return String();
+			for (const char* word : { "true", "false", "null" })
+			{
+				if (m_Text.compare(m_Position, strlen(word), word) == 0)
+				{
+					m_Position += strlen(word);
+					return true;
+				}
+			}
+			return Number();
+		}
+
+		bool Container(char close, bool object)
+		{
+			m_Position++;
+			if (Take(close)) return true;
+			do
+			{
+				if (object && !(Space(), String() && Take(':'))) return false;
+				if (!Value()) return false;
+			} while (Take(','));
+			return Take(close);
+		}
+
+		bool String()
+		{
+			if (m_Position >= m_Text.size() || m_Text[m_Position++] != '"') return false;
+
+			std::string decoded;
+			while (m_Position < m_Text.size())
+			{
+				char c = m_Text[m_Position++];
+				if (c == '"')
+				{
+					m_Strings.push_back(decoded);
+					return true;
+				}
+				if ((unsigned char) c < 0x20) return false;
+				if (c != '\\')
+				{
+					decoded += c;
+					continue;
+				}
+
+				if (m_Position >= m_Text.size()) return false;
+				char escape = m_Text[m_Position++];
+				const char* simple = strchr("\"\\/bfnrt", escape);
+				if (escape == 'u')
+				{
+					if (m_Position + 4 > m_Text.size()) return false;
+					unsigned int code = 0;
+					for (int i = 0; i < 4; i++)
+					{
+						char digit = m_Text[m_Position++];
+						if (!isxdigit((unsigned char) digit)) return false;
+						code = code * 16 + (unsigned int) (isdigit((unsigned char) digit) ? digit - '0' : tolower(digit) - 'a' + 10);
+					}
+					// Only control characters are escaped like this, they fit in a char
+					decoded += (char) code;
+				}
+				else if (simple && escape != '\0')
+				{
+					decoded += "\"\\/\b\f\n\r\t"[simple - "\"\\/bfnrt"];
+				}
+				else
+				{
+					return false;
+				}
+			}
+			return false;
+		}
+
+		bool Number()
+		{
+			size_t start = m_Position;
+			if (m_Position < m_Text.size() && m_Text[m_Position] == '-') m_Position++;
+
+			auto digits = [&]()
+			{
+				size_t first = m_Position;
+				while (m_Position < m_Text.size() && isdigit((unsigned char) m_Text[m_Position])) m_Position++;
+				return m_Position > first;
+			};
+			if (!digits()) return false;
+			// No leading zeroes
+			if (m_Text[start + (m_Text[start] == '-')] == '0' && m_Position - start > 1u + (m_Text[start] == '-')) return false;
+			if (m_Position < m_Text.size() && m_Text[m_Position] == '.' && (m_Position++, !digits())) return false;
+			if (m_Position < m_Text.size() && (m_Text[m_Position] == 'e' || m_Text[m_Position] == 'E'))
+			{
+				m_Position++;
+				if (m_Position < m_Text.size() && (m_Text[m_Position] == '+' || m_Text[m_Position] == '-')) m_Position++;
+				if (!digits()) return false;
+			}
+			return true;
+		}
+
+		const std::string& m_Text;
+		size_t m_Position = 0;
+		std::vector<std::string> m_Strings;
+	};
+}
+
+TEST(Profiler, Nesting)
+{
+	Profiler::EndFrame();
+	uint32_t track = RunOnTrack("Nesting", []()
+	{
+		PROFILE_SCOPE("Outer");
+		{
+			PROFILE_SCOPE("First");
+		}
+		{
+			PROFILE_SCOPE("Second");
+			PROFILE_SCOPE("Inner");
+		}
+	});
+
+	std::vector<ProfileEvent> events = EndFrame(track);
+	ASSERT_EQ(4u, events.size());
+
+	// In the order they began, with their parents around them
+	const char* names[] = { "Outer", "First", "Second", "Inner" };
+	uint32_t depths[] = { 0, 1, 1, 2 };
+	int parents[] = { -1, 0, 0, 2 };
+	for (size_t i = 0; i < events.size(); i++)
+	{
+		EXPECT_STREQ(names[i], events[i].name);
+		EXPECT_EQ(depths[i], events[i].depth);
+		EXPECT_LE(events[i].begin, events[i].end);
+		if (parents[i] < 0) continue;
+
+		auto& parent = events[parents[i]];
+		EXPECT_LE(parent.begin, events[i].begin);
+		EXPECT_GE(parent.end, events[i].end);
+	}
+	EXPECT_LE(events[1].end, events[2].begin);
+}
+
+TEST(Profiler, DeeperThanMaxDepth)
+{
+	Profiler::EndFrame();
+	uint32_t track = RunOnTrack("Deep", []()
+	{
+		// Unbalanced ends are ignored
+		Profiler::End();
+
+		for (uint32_t i = 0; i < Profiler::MaxDepth + 10; i++) Profiler::Begin("Deep");
+		for (uint32_t i = 0; i < Profiler::MaxDepth + 10; i++) Profiler::End();
+
+		// Everything deeper than MaxDepth was closed again, so this is back at the top
+		PROFILE_SCOPE("After");
+	});
+
+	std::vector<ProfileEvent> events = EndFrame(track);
+	ASSERT_EQ(Profiler::MaxDepth + 1, events.size());
+
+	std::vector<bool> depths(Profiler::MaxDepth);
+	for (auto& event : events)
+	{
+		if (strcmp(event.name, "After") == 0)
+		{
+			EXPECT_EQ(0u, event.depth);
+			continue;
+		}
+
+		ASSERT_LT(event.depth, Profiler::MaxDepth);
+		EXPECT_FALSE(depths[event.depth]);
+		depths[event.depth] = true;
+	}
+	EXPECT_EQ(depths.end(), std::find(depths.begin(), depths.end(), false));
+}
+
+TEST(Profiler, DropsEventsOfAWrappedRing)
+{
+	Profiler::EndFrame();
+	uint64_t dropped = Profiler::GetDroppedEvents();
+
+	constexpr size_t Extra = 100;
+	uint32_t track = RunOnTrack("Wrapped", []()
+	{
+		for (size_t i = 0; i < Profiler::RingSize + Extra; i++)
+		{
+			PROFILE_SCOPE("Event");
+		}
+	});
+
+	// The newest RingSize - 1 events are kept, the slot before them could have been getting written
+	std::vector<ProfileEvent> events = EndFrame(track);
+	EXPECT_EQ(Profiler::RingSize - 1, events.size());
+	EXPECT_EQ(Extra + 1, Profiler::GetDroppedEvents() - dropped);
+
+	// Nothing more is lost once the ring is collected
+	std::thread([]()
+	{
+		Profiler::SetThreadName("Wrapped again");
+		PROFILE_SCOPE("Event");
+	}).join();
+	EXPECT_EQ(1u, EndFrame(FindTrack("Wrapped again")).size());
+	EXPECT_EQ(Extra + 1, Profiler::GetDroppedEvents() - dropped);
+}
+
+TEST(Profiler, ManyWriters)
+{
+	Profiler::EndFrame();
+	uint64_t dropped = Profiler::GetDroppedEvents();
+
+	// Writers fill their rings as fast as they can while frames are collected, so some of their events get dropped
+	// but every one is either collected whole or counted as dropped
+	constexpr int Writers = 4;
+	constexpr size_t Scopes = 20000;
+	std::atomic<int> running{ Writers };
+	std::vector<std::thread> threads;
+	for (int writer = 0; writer < Writers; writer++)
+	{
+		threads.emplace_back([writer, &running]()
+		{
+			Profiler::SetThreadName(("Writer " + std::to_string(writer)).c_str());
+			for (size_t i = 0; i < Scopes; i++)
+			{
+				PROFILE_SCOPE("Outer");
+				PROFILE_SCOPE("Inner");
+			}
+			--running;
+		});
+	}
+
+	size_t collected = 0;
+	auto collect = [&]()
+	{
+		Profiler::EndFrame();
+		for (auto& event : Profiler::GetFrames().back().events)
+		{
+			if (Profiler::GetTrackName(event.track).compare(0, 7, "Writer ") != 0) continue;
+
+			collected++;
+			bool outer = strcmp(event.name, "Outer") == 0;
+			bool inner = strcmp(event.name, "Inner") == 0;
+			ASSERT_TRUE(outer || inner);
+			EXPECT_EQ(outer ? 0u : 1u, event.depth);
+			EXPECT_LE(event.begin, event.end);
+		}
+	};
+
+	while (running > 0) collect();
+	for (auto& thread : threads) thread.join();
+	collect();
+
+	EXPECT_EQ(Writers * Scopes * 2, collected + (Profiler::GetDroppedEvents() - dropped));
+	EXPECT_GT(collected, 0u);
+}
+
+TEST(Profiler, RecordsOtherTracks)
+{
+	Profiler::EndFrame();
+	uint32_t track = Profiler::CreateTrack("Recorded");
+	EXPECT_EQ("Recorded", Profiler::GetTrackName(track));
+
+	// Out of order, like timings read back from the GPU
+	Profiler::Record(track, "Child", 150, 160, 1);
+	Profiler::Record(track, "Parent", 100, 200, 0);
+	Profiler::Record(Profiler::GetTrackCount(), "Nowhere", 0, 1, 0);
+
+	std::vector<ProfileEvent> events = EndFrame(track);
+	ASSERT_EQ(2u, events.size());
+	EXPECT_STREQ("Parent", events[0].name);
+	EXPECT_STREQ("Child", events[1].name);
+	EXPECT_EQ(150u, events[1].begin);
+	EXPECT_EQ(160u, events[1].end);
+}
+
+TEST(Profiler, RecordsWhileTracksAreAdded)
+{
+	Profiler::EndFrame();
+	uint32_t track = Profiler::CreateTrack("Recorded");
+
+	// Finding the track mustn't wait for, or trip over, another thread adding more
+	std::thread adder([]()
+	{
+		for (int i = 0; i < 16; i++) Profiler::CreateTrack("Added");
+	});
+	constexpr uint64_t Events = 2000;
+	for (uint64_t i = 0; i < Events; i++) Profiler::Record(track, "Recorded", i * 10, i * 10 + 5, 0);
+	adder.join();
+
+	std::vector<ProfileEvent> events = EndFrame(track);
+	ASSERT_EQ(Events, events.size());
+	for (uint64_t i = 0; i < Events; i++) EXPECT_EQ(i * 10, events[i].begin);
+	EXPECT_EQ("Added", Profiler::GetTrackName(Profiler::GetTrackCount() - 1));
+}
+
+TEST(Profiler, Paused)
+{
+	Profiler::EndFrame();
+	uint64_t lastFrame = Profiler::GetFrames().back().end;
+
+	Profiler::SetPaused(true);
+	EXPECT_TRUE(Profiler::IsPaused());
+	uint32_t track = RunOnTrack("Paused", []() { PROFILE_SCOPE("While paused"); });
+
+	// Nothing new is kept, and what finished while paused is thrown away rather than kept for later
+	Profiler::EndFrame();
+	EXPECT_EQ(lastFrame, Profiler::GetFrames().back().end);
+
+	Profiler::SetPaused(false);
+	EXPECT_FALSE(Profiler::IsPaused());
+	EXPECT_TRUE(EndFrame(track).empty());
+	EXPECT_NE(lastFrame, Profiler::GetFrames().back().end);
+}
+
+TEST(Profiler, KeepsHistorySize)
+{
+	for (size_t i = 0; i < Profiler::HistorySize + 10; i++) Profiler::EndFrame();
+	EXPECT_EQ(Profiler::HistorySize, Profiler::GetFrames().size());
+
+	// Oldest first, each beginning where the last ended
+	auto& frames = Profiler::GetFrames();
+	for (size_t i = 1; i < frames.size(); i++) EXPECT_EQ(frames[i - 1].end, frames[i].begin);
+}
+
+TEST(Profiler, ChromeTraceIsValidJson)
+{
+	Profiler::EndFrame();
+
+	// Names with everything that needs escaping
+	static const char* names[] = { "Quote \"", "Backslash \\", "Tab\tNewline\n", "Bell \x07", "Plain" };
+	RunOnTrack("Trace \"track\"", []()
+	{
+		for (const char* name : names)
+		{
+			PROFILE_SCOPE(name);
+		}
+	});
+	Profiler::EndFrame();
+
+	std::string trace = Profiler::GetChromeTrace();
+	JsonChecker checker(trace);
+	ASSERT_TRUE(checker.Check()) << trace.substr(0, 1000);
+
+	auto& strings = checker.GetStrings();
+	for (const char* expected : { names[0], names[1], names[2], names[3], names[4], "Trace \"track\"" })
+		EXPECT_NE(strings.end(), std::find(strings.begin(), strings.end(), std::string(expected))) << expected;
+
+	// Exported as is, into whatever directory the tests run in
+	std::string file = "RendererProfilerTrace.json";
+	ASSERT_TRUE(Profiler::ExportChromeTrace(file));
+
+	FILE* input = fopen(file.c_str(), "rb");
+	ASSERT_NE(nullptr, input);
+	std::string exported;
+	char buffer[4096];
+	for (size_t read; (read = fread(buffer, 1, sizeof(buffer), input)) > 0;) exported.append(buffer, read);
+	fclose(input);
+	remove(file.c_str());
+	EXPECT_EQ(trace, exported);
+}
@@ -0,0 +1,94 @@
+#include <vector>
+
+#include "ReferenceFrame.h"
+
+namespace
+{
+	// Stand-ins for the renderer's objects, only their addresses are used
+	uint8_t g_Objects[32];
+
+	template<typename T>
+	T* Stand(unsigned int index) { return (T*) &g_Objects[index]; }
+
+	enum StandIn
+	{
+		RenderTarget, DepthStencil, LightBuffer, CameraBuffer, LightList, ClusterList, LightIndexList, ConstantRing, InstanceBuffer,
+		ClusterIndexBuffer, VertexShaderStandIn, LitShader, UnlitShader, MaterialBuffer, PoolVertexBuffer, PoolIndexBuffer
+	};
+
+	// Writes as much as the renderer would, of nothing in particular
+	void Write(CommandList& list, WriteTarget target, unsigned int standIn, size_t size)
+	{
+		static std::vector<uint8_t> data;
+		if (data.size() < size) data.resize(size);
+		list.WriteBuffer(target, Stand<void>(standIn), data.data(), (uint32_t) size);
+	}
+}
+
+void ReferenceFrame::Record(CommandList& list) const
+{
+	list.BeginScope("Scene");
+	float color[] = { 0.11f, 0.18f, 0.96f, 1.f };
+	list.ClearRenderTarget(Stand<void>(RenderTarget), color);
+	list.ClearDepth(Stand<void>(DepthStencil), 1.f);
+	list.BindRenderTarget(Stand<void>(RenderTarget), Stand<void>(DepthStencil));
+
+	list.BindConstantBuffer(Stand<ConstantBuffer>(LightBuffer), ShaderStage::Pixel, 0);
+	list.BindConstantBuffer(Stand<ConstantBuffer>(CameraBuffer), ShaderStage::Pixel, 2);
+
+	Write(list, WriteTarget::ConstantBuffer, LightBuffer, 32);
+	Write(list, WriteTarget::StructuredBuffer, LightList, 32 * 64);
+	Write(list, WriteTarget::StructuredBuffer, ClusterList, 16 * 9 * 24 * 4);
+	Write(list, WriteTarget::StructuredBuffer, LightIndexList, 4096);
+	list.BindStructuredBuffer(Stand<StructuredBuffer>(LightList), ShaderStage::Pixel, 0);
+	list.BindStructuredBuffer(Stand<StructuredBuffer>(ClusterList), ShaderStage::Pixel, 1);
+	list.BindStructuredBuffer(Stand<StructuredBuffer>(LightIndexList), ShaderStage::Pixel, 2);
+
+	Write(list, WriteTarget::ConstantBuffer, CameraBuffer, 16);
+
+	// A material record per group, instances and the indices of the culled clusters
+	unsigned int groups = GetDraws();
+	if (groups > 0) Write(list, WriteTarget::ConstantRingBuffer, ConstantRing, groups * 256);
+	if (groups > 0) Write(list, WriteTarget::VertexBuffer, InstanceBuffer, groups * 128);
+	if (clusteredGroups > 0) Write(list, WriteTarget::IndexBuffer, ClusterIndexBuffer, clusteredGroups * 124 * 3 * 4);
+
+	list.BindInstanceBuffer(Stand<VertexBuffer>(InstanceBuffer));
+	for (unsigned int group = 0; group < groups; group++)
+	{
+		bool gizmo = group >= opaqueGroups;
+		if (group == 0 || group == opaqueGroups)
+		{
+			if (group > 0) list.EndScope();
+			list.BeginScope(gizmo ? "Gizmos" : "Opaque");
+		}
+
+		list.BindPixelShader(Stand<PixelShader>(gizmo ? UnlitShader : LitShader));
+		list.BindConstantRecord(Stand<ConstantBuffer>(MaterialBuffer), ShaderStage::Pixel, 1, group * 256);
+		list.BindVertexShader(Stand<VertexShader>(VertexShaderStandIn));
+		list.BindVertexBuffer(Stand<VertexBuffer>(PoolVertexBuffer));
+		list.BindIndexBuffer(Stand<IndexBuffer>(group < clusteredGroups ? ClusterIndexBuffer : PoolIndexBuffer));
+		list.DrawIndexedInstanced(36 + group % 7 * 3, 1 + group % 4, group * 36, (int32_t) (group * 24), group);
+	}
+	if (groups > 0) list.EndScope();
+	list.EndScope();
+}
+
+unsigned int ReferenceFrame::GetStateChanges() const
+{
+	// Render target and depth, two constant buffers, three light lists and the instance buffer
+	unsigned int changes = 8;
+	if (GetDraws() == 0) return changes;
+
+	// A pixel shader per pass, a material record per group, the vertex shader and the pool's vertex buffer, and the cluster and pool index buffers
+	changes += (opaqueGroups > 0) + (gizmoGroups > 0);
+	changes += GetDraws();
+	changes += 2;
+	changes += (clusteredGroups > 0) + (GetDraws() > clusteredGroups);
+	return changes;
+}
+
+unsigned int ReferenceFrame::GetRedundantStates() const
+{
+	// Five binds per group, the rest of them change something
+	return 5 * GetDraws() - (GetStateChanges() - 8);
+}
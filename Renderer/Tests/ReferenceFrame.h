@@ -0,0 +1,20 @@
+#pragma once
+#include "Primitives/CommandList.h"
+
+// A frame laid out the way Renderer::Render records one: clears, the render target, the light lists and constants,
+// then one instanced draw per group in an opaque and a gizmo pass. The buffers, shaders and views it binds are only
+// addresses that are never dereferenced, NullBackend doesn't need more than that
+struct ReferenceFrame
+{
+	unsigned int opaqueGroups = 200;
+	// The first clusteredGroups opaque groups draw from the cluster index buffer, like culled dense parts
+	unsigned int clusteredGroups = 20;
+	unsigned int gizmoGroups = 1;
+
+	void Record(CommandList& list) const;
+
+	// What a NullBackend should count for one replay of the frame on a fresh state cache
+	unsigned int GetDraws() const { return opaqueGroups + gizmoGroups; }
+	unsigned int GetStateChanges() const;
+	unsigned int GetRedundantStates() const;
+};
@@ -0,0 +1,160 @@
+#include <cmath>
+#include <random>
+
+#include "ReferenceScene.h"
+
+TransformMatrix MakeViewProjection(const float position[3], float yaw, float fovY, float aspect, float nearZ, float farZ)
+{
+	float right[3] = { std::cos(yaw), 0.f, -std::sin(yaw) };
+	float up[3] = { 0.f, 1.f, 0.f };
+	float forward[3] = { std::sin(yaw), 0.f, std::cos(yaw) };
+
+	TransformMatrix view = {};
+	for (int i = 0; i < 3; i++)
+	{
+		view.m[i][0] = right[i];
+		view.m[i][1] = up[i];
+		view.m[i][2] = forward[i];
+		view.m[3][0] -= position[i] * right[i];
+		view.m[3][1] -= position[i] * up[i];
+		view.m[3][2] -= position[i] * forward[i];
+	}
+	view.m[3][3] = 1.f;
+
+	float height = 1.f / std::tan(fovY * 0.5f);
+	float range = farZ / (farZ - nearZ);
+	TransformMatrix projection = {};
+	projection.m[0][0] = height / aspect;
+	projection.m[1][1] = height;
+	projection.m[2][2] = range;
+	projection.m[2][3] = 1.f;
+	projection.m[3][2] = -nearZ * range;
+
+	TransformMatrix viewProjection = {};
+	for (int row = 0; row < 4; row++)
+	{
+		for (int column = 0; column < 4; column++)
+		{
+			for (int i = 0; i < 4; i++) viewProjection.m[row][column] += view.m[row][i] * projection.m[i][column];
+		}
+	}
+	return viewProjection;
+}
+
+ReferenceScene ReferenceScene::Street(unsigned int buildings, uint32_t seed)
+{
+	std::mt19937 random(seed);
+	auto uniform = [&](float min, float max) { return std::uniform_real_distribution<float>(min, max)(random); };
+
+	ReferenceScene scene;
+	float camera[] = { 0.f, 1.7f, 0.f };
+	scene.viewProjection = MakeViewProjection(camera, 0.1f, 1.2f, 2.f, 0.1f, 500.f);
+
+	for (unsigned int i = 0; i < buildings; i++)
+	{
+		// Alternating sides, a few metres apart down the street, the first ones starting behind the camera
+		float side = i % 2 ? 1.f : -1.f;
+		float depth = -10.f + (float) (i / 2) * 4.f + uniform(0.f, 2.f);
+		float building[] = { side * uniform(6.f, 12.f), 0.f, depth };
+		float size[] = { uniform(1.f, 4.f), uniform(2.f, 20.f), uniform(1.f, 2.f) };
+		building[1] = size[1];
+		scene.AddOccluderBox(building, size);
+
+		// One the building hides from the camera, one in front of it and one next to it
+		float behind[] = { building[0] * 1.8f, uniform(0.5f, size[1]), depth * 1.3f + 5.f };
+		float inFront[] = { building[0] * 0.3f, uniform(0.5f, 3.f), depth * 0.7f };
+		float between[] = { building[0] + side * size[0] * 2.f, uniform(0.5f, 10.f), depth + uniform(-2.f, 2.f) };
+		float small[] = { 0.5f, 0.5f, 0.5f };
+		scene.AddBox(behind, small);
+		scene.AddBox(inFront, small);
+		scene.AddBox(between, size);
+	}
+
+	// The ground
+	float ground[] = { 0.f, -0.05f, 200.f };
+	float groundSize[] = { 100.f, 0.05f, 200.f };
+	scene.AddOccluderBox(ground, groundSize);
+
+	return scene;
+}
+
+ReferenceScene ReferenceScene::Scatter(unsigned int triangles, uint32_t seed)
+{
+	std::mt19937 random(seed);
+	auto uniform = [&](float min, float max) { return std::uniform_real_distribution<float>(min, max)(random); };
+
+	ReferenceScene scene;
+	float camera[] = { 0.f, 0.f, 0.f };
+	scene.viewProjection = MakeViewProjection(camera, 0.f, 1.f, 1.5f, 0.5f, 100.f);
+
+	for (unsigned int i = 0; i < triangles; i++)
+	{
+		float center[] = { uniform(-20.f, 20.f), uniform(-15.f, 15.f), uniform(-2.f, 40.f) };
+		float size = i % 5 == 0 ? uniform(5.f, 30.f) : uniform(0.05f, 3.f);
+
+		uint32_t first = (uint32_t) scene.positions.size() / 3;
+		for (int vertex = 0; vertex < 3; vertex++)
+		{
+			for (int axis = 0; axis < 3; axis++) scene.positions.push_back(center[axis] + uniform(-size, size));
+		}
+
+		// Every so often a degenerate one, two corners in the same place or all three on a line
+		if (i % 17 == 0)
+		{
+			for (int axis = 0; axis < 3; axis++) scene.positions[size_t(first + 2) * 3 + axis] = scene.positions[size_t(first) * 3 + axis];
+		}
+		else if (i % 19 == 0)
+		{
+			for (int axis = 0; axis < 3; axis++)
+			{
+				float a = scene.positions[size_t(first) * 3 + axis], b = scene.positions[size_t(first + 1) * 3 + axis];
+				scene.positions[size_t(first + 2) * 3 + axis] = a + (b - a) * 2.f;
+			}
+		}
+
+		scene.indices.insert(scene.indices.end(), { first, first + 1, first + 2 });
+
+		float extent[] = { uniform(0.1f, 2.f), uniform(0.1f, 2.f), uniform(0.1f, 2.f) };
+		float box[] = { uniform(-20.f, 20.f), uniform(-15.f, 15.f), uniform(-2.f, 40.f) };
+		scene.AddBox(box, extent);
+	}
+
+	return scene;
+}
+
+void ReferenceScene::AddOccluderBox(const float center[3], const float extent[3])
+{
+	uint32_t first = (uint32_t) positions.size() / 3;
+	for (int corner = 0; corner < 8; corner++)
+	{
+		for (int axis = 0; axis < 3; axis++) positions.push_back(center[axis] + ((corner >> axis) & 1 ? extent[axis] : -extent[axis]));
+	}
+
+	// Two triangles for each face, corners are numbered by their bits x, y and z
+	static const uint32_t faces[6][4] = { { 0, 2, 6, 4 }, { 1, 5, 7, 3 }, { 0, 4, 5, 1 }, { 2, 3, 7, 6 }, { 0, 1, 3, 2 }, { 4, 6, 7, 5 } };
+	for (auto& face : faces)
+	{
+		indices.insert(indices.end(), { first + face[0], first + face[1], first + face[2] });
+		indices.insert(indices.end(), { first + face[0], first + face[2], first + face[3] });
+	}
+}
+
+void ReferenceScene::AddBox(const float center[3], const float extent[3])
+{
+	for (int axis = 0; axis < 3; axis++)
+	{
+		centers[axis].push_back(center[axis]);
+		extents[axis].push_back(extent[axis]);
+	}
+}
+
+WorldBounds ReferenceScene::GetBounds() const
+{
+	WorldBounds bounds;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		bounds.center[axis] = centers[axis].data();
+		bounds.extent[axis] = extents[axis].data();
+	}
+	return bounds;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "Scene/TransformStore.h"
+
+// Row-major, row vector view projection with a 0 to 1 depth range, like DirectX::XMMatrixLookToLH times XMMatrixPerspectiveFovLH.
+// The camera sits at position looking down +z, turned by yaw radians around y
+TransformMatrix MakeViewProjection(const float position[3], float yaw, float fovY, float aspect, float nearZ, float farZ);
+
+// Occluder geometry and boxes to test against it, placed the way a scene would put them in front of a camera
+struct ReferenceScene
+{
+	TransformMatrix viewProjection;
+
+	// World-space triangle list
+	std::vector<float> positions;
+	std::vector<uint32_t> indices;
+
+	// Boxes as centers and half extents, in the structure-of-arrays layout of WorldBounds
+	std::vector<float> centers[3];
+	std::vector<float> extents[3];
+
+	// Buildings of random sizes along both sides of a street the camera looks down, some of them reaching behind it,
+	// with a box in front of, between and behind them for every building
+	static ReferenceScene Street(unsigned int buildings, uint32_t seed);
+
+	// Triangles of every size anywhere around the camera, crossing the near plane, off screen, slivers and degenerate
+	static ReferenceScene Scatter(unsigned int triangles, uint32_t seed);
+
+	void AddOccluderBox(const float center[3], const float extent[3]);
+	void AddBox(const float center[3], const float extent[3]);
+
+	size_t GetBoxCount() const { return centers[0].size(); }
+	WorldBounds GetBounds() const;
+};
@@ -0,0 +1,39 @@
+#include <algorithm>
+#include <random>
+
+#include "Benchmark.h"
+
+#include "Renderer/RenderQueue.h"
+
+// Sorting a frame's draws by key, against the std::stable_sort the queue would otherwise use
+TEST(RenderQueueBenchmark, Sort)
+{
+	std::mt19937 random(1);
+	for (unsigned int draws : { 1000u, 10000u, 100000u })
+	{
+		std::vector<DrawPacket> packets;
+		for (uint32_t i = 0; i < draws; i++)
+		{
+			uint64_t key = SortKey::Make(random() % 2, random() % 3, random() % 40, random() % 200, std::uniform_real_distribution<float>(0.f, 1.f)(random));
+			packets.push_back({ key, i });
+		}
+
+		RenderQueue queue;
+		std::string name = std::to_string(draws) + " draws";
+		Benchmark((name + ", radix").c_str(), [&]()
+		{
+			queue.Clear();
+			for (auto& packet : packets) queue.Push(packet.key, packet.payload);
+			queue.Sort();
+		});
+
+		std::vector<DrawPacket> sorted;
+		Benchmark((name + ", std::stable_sort").c_str(), [&]()
+		{
+			sorted.assign(packets.begin(), packets.end());
+			std::stable_sort(sorted.begin(), sorted.end(), [](const DrawPacket& a, const DrawPacket& b) { return a.key < b.key; });
+		});
+
+		EXPECT_EQ(sorted.size(), queue.GetSize());
+	}
+}
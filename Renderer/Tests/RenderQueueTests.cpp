@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "gtest/gtest.h"
+
+#include "Primitives/StateCache.h"
+#include "Renderer/RenderQueue.h"
+
+namespace
+{
+	// Sorts a copy of the queue's packets with std::stable_sort and the queue with its own sort, and compares them packet for packet
+	void ExpectSortsLikeStableSort(const std::vector<uint64_t>& keys)
+	{
+		RenderQueue queue;
+		for (size_t i = 0; i < keys.size(); i++) queue.Push(keys[i], (uint32_t) i);
+
+		std::vector<DrawPacket> expected = queue.GetPackets();
+		std::stable_sort(expected.begin(), expected.end(), [](const DrawPacket& a, const DrawPacket& b) { return a.key < b.key; });
+
+		queue.Sort();
+		ASSERT_EQ(expected.size(), queue.GetSize());
+		for (size_t i = 0; i < expected.size(); i++)
+		{
+			ASSERT_EQ(expected[i].key, queue.GetPackets()[i].key) << "packet " << i << " of " << keys.size();
+			ASSERT_EQ(expected[i].payload, queue.GetPackets()[i].payload) << "packet " << i << " of " << keys.size();
+		}
+	}
+
+	// Keys the way Render() makes them: a couple of passes, a few shaders, some materials and buffers, and any depth
+	uint64_t MakeSceneKey(std::mt19937& random)
+	{
+		uint32_t pass = random() % 2, shader = random() % 3, material = random() % 40, buffer = random() % 200;
+		return SortKey::Make(pass, shader, material, buffer, std::uniform_real_distribution<float>(0.f, 1.f)(random));
+	}
+}
+
+TEST(SortKey, Fields)
+{
+	uint64_t key = SortKey::Make(3, 1234, 567, 890, 0.5f);
+	EXPECT_EQ(3u, SortKey::GetPass(key));
+	EXPECT_EQ(1234u, SortKey::GetShader(key));
+	EXPECT_EQ(567u, SortKey::GetMaterial(key));
+	EXPECT_EQ(890u, SortKey::GetBuffer(key));
+	EXPECT_EQ((uint32_t) (0.5f * ((1u << SortKey::DepthBits) - 1)), SortKey::GetDepth(key));
+
+	// Too wide fields are masked instead of spilling into their neighbours
+	uint64_t masked = SortKey::Make(0x1F, 0x1FFF, 0x1FFF, 0x1FFF, 0.f);
+	EXPECT_EQ(0xFu, SortKey::GetPass(masked));
+	EXPECT_EQ(0xFFFu, SortKey::GetShader(masked));
+	EXPECT_EQ(0xFFFu, SortKey::GetMaterial(masked));
+	EXPECT_EQ(0xFFFu, SortKey::GetBuffer(masked));
+	EXPECT_EQ(0u, SortKey::GetDepth(masked));
+
+	// Depth is clamped, NaN included
+	uint32_t maxDepth = (1u << SortKey::DepthBits) - 1;
+	EXPECT_EQ(0u, SortKey::GetDepth(SortKey::Make(0, 0, 0, 0, -1.f)));
+	EXPECT_EQ(0u, SortKey::GetDepth(SortKey::Make(0, 0, 0, 0, NAN)));
+	EXPECT_EQ(maxDepth, SortKey::GetDepth(SortKey::Make(0, 0, 0, 0, 1.f)));
+	EXPECT_EQ(maxDepth, SortKey::GetDepth(SortKey::Make(0, 0, 0, 0, 1000.f)));
+}
+
+TEST(SortKey, Order)
+{
+	// Each field only matters when everything above it is equal
+	EXPECT_LT(SortKey::Make(0, 4095, 4095, 4095, 1.f), SortKey::Make(1, 0, 0, 0, 0.f));
+	EXPECT_LT(SortKey::Make(1, 0, 4095, 4095, 1.f), SortKey::Make(1, 1, 0, 0, 0.f));
+	EXPECT_LT(SortKey::Make(1, 1, 0, 4095, 1.f), SortKey::Make(1, 1, 1, 0, 0.f));
+	EXPECT_LT(SortKey::Make(1, 1, 1, 0, 1.f), SortKey::Make(1, 1, 1, 1, 0.f));
+	EXPECT_LT(SortKey::Make(1, 1, 1, 1, 0.25f), SortKey::Make(1, 1, 1, 1, 0.5f));
+
+	for (int bits : { SortKey::ShaderBits, SortKey::MaterialBits })
+	{
+		EXPECT_LT(SortKey::Fold(0x12345678abcdull, bits), 1u << bits);
+		EXPECT_EQ(SortKey::Fold(42, bits), SortKey::Fold(42, bits));
+	}
+}
+
+TEST(RenderQueue, SortsLikeStableSort)
+{
+	std::mt19937_64 random(1);
+	std::mt19937 sceneRandom(1);
+
+	// Either side of where the queue switches from std::stable_sort to radix passes, and up to a big scene
+	for (size_t count : { 0u, 1u, 2u, 3u, 63u, 64u, 65u, 100u, 1000u, 100000u })
+	{
+		std::vector<uint64_t> full(count), few(count), scene(count), oneByte(count), highBytes(count), equal(count, 0x0123456789abcdefull);
+		for (size_t i = 0; i < count; i++)
+		{
+			full[i] = random();
+			few[i] = random() % 5;
+			scene[i] = MakeSceneKey(sceneRandom);
+			oneByte[i] = (random() & 0xff) << 24 | 0xaa00000000ull;
+			highBytes[i] = random() & 0xffff000000000000ull;
+		}
+
+		// Full width keys need every pass, a few keys test stability, the rest skip passes where every key agrees
+		for (auto* keys : { &full, &few, &scene, &oneByte, &highBytes, &equal }) ExpectSortsLikeStableSort(*keys);
+
+		// Already sorted and reversed
+		std::sort(full.begin(), full.end());
+		ExpectSortsLikeStableSort(full);
+		std::reverse(full.begin(), full.end());
+		ExpectSortsLikeStableSort(full);
+	}
+}
+
+TEST(RenderQueue, Reuse)
+{
+	// Sorting twice leaves things where they were, clearing starts over
+	std::mt19937 random(2);
+	RenderQueue queue;
+	for (int frame = 0; frame < 3; frame++)
+	{
+		queue.Clear();
+		for (uint32_t i = 0; i < 500 + (uint32_t) frame * 100; i++) queue.Push(MakeSceneKey(random), i);
+		queue.Sort();
+
+		std::vector<DrawPacket> sorted = queue.GetPackets();
+		EXPECT_TRUE(std::is_sorted(sorted.begin(), sorted.end(), [](const DrawPacket& a, const DrawPacket& b) { return a.key < b.key; }));
+
+		queue.Sort();
+		for (size_t i = 0; i < sorted.size(); i++) ASSERT_EQ(sorted[i].payload, queue.GetPackets()[i].payload);
+	}
+}
+
+TEST(StateCache, SkipsRedundantBinds)
+{
+	StateCache cache;
+	int a = 0, b = 0;
+
+	// Nothing is known to start with, not even that slots are empty
+	EXPECT_TRUE(cache.Bind(StateCache::VertexShader, nullptr));
+	EXPECT_FALSE(cache.Bind(StateCache::VertexShader, nullptr));
+	EXPECT_TRUE(cache.Bind(StateCache::VertexShader, &a));
+	EXPECT_FALSE(cache.Bind(StateCache::VertexShader, &a));
+	EXPECT_TRUE(cache.Bind(StateCache::VertexShader, &b));
+	EXPECT_TRUE(cache.Bind(StateCache::VertexShader, &a));
+
+	// Slots are independent
+	EXPECT_TRUE(cache.Bind(StateCache::PixelShader, &a));
+	EXPECT_TRUE(cache.Bind(StateCache::PSConstantBuffer + 3, &a));
+	EXPECT_FALSE(cache.Bind(StateCache::PSConstantBuffer + 3, &a));
+	EXPECT_TRUE(cache.Bind(StateCache::PSConstantBuffer + 4, &a));
+	EXPECT_FALSE(cache.Bind(StateCache::VertexShader, &a));
+
+	// Ranges of the same buffer only match at the same offset
+	EXPECT_TRUE(cache.Bind(StateCache::VSConstantBuffer, &b, 256));
+	EXPECT_FALSE(cache.Bind(StateCache::VSConstantBuffer, &b, 256));
+	EXPECT_TRUE(cache.Bind(StateCache::VSConstantBuffer, &b, 512));
+	EXPECT_TRUE(cache.Bind(StateCache::VSConstantBuffer, &b));
+
+	EXPECT_EQ(10u, cache.GetChanges());
+	EXPECT_EQ(5u, cache.GetSkipped());
+	cache.ResetCounters();
+	EXPECT_EQ(0u, cache.GetChanges());
+	EXPECT_EQ(0u, cache.GetSkipped());
+
+	// After an invalidate every slot is bound again, once
+	cache.Invalidate();
+	EXPECT_TRUE(cache.Bind(StateCache::VertexShader, &a));
+	EXPECT_TRUE(cache.Bind(StateCache::PSConstantBuffer + 3, &a));
+	EXPECT_FALSE(cache.Bind(StateCache::PSConstantBuffer + 3, &a));
+	EXPECT_TRUE(cache.Bind(StateCache::SlotCount - 1, &a));
+	EXPECT_EQ(3u, cache.GetChanges());
+	EXPECT_EQ(1u, cache.GetSkipped());
+}
+
+TEST(StateCache, SortedDrawsBindLess)
+{
+	// Binding the shader, material and buffer of every draw in key order changes state far less often than in push order
+	std::mt19937 random(3);
+	RenderQueue queue;
+	for (uint32_t i = 0; i < 5000; i++) queue.Push(MakeSceneKey(random), i);
+
+	auto countChanges = [](const std::vector<DrawPacket>& packets)
+	{
+		StateCache cache;
+		for (auto& packet : packets)
+		{
+			cache.Bind(StateCache::PixelShader, (const void*) (uintptr_t) (SortKey::GetShader(packet.key) + 1));
+			cache.Bind(StateCache::PSConstantBuffer, (const void*) (uintptr_t) (SortKey::GetMaterial(packet.key) + 1));
+			cache.Bind(StateCache::VertexBuffer, (const void*) (uintptr_t) (SortKey::GetBuffer(packet.key) + 1));
+		}
+		EXPECT_EQ(packets.size() * 3, cache.GetChanges() + cache.GetSkipped());
+		return cache.GetChanges();
+	};
+
+	unsigned int unsorted = countChanges(queue.GetPackets());
+	queue.Sort();
+	unsigned int sorted = countChanges(queue.GetPackets());
+
+	// At most every buffer of every material of every shader of every pass, once each
+	EXPECT_LE(sorted, 2u * 3u * (1u + 40u * (1u + 200u)));
+	EXPECT_LT(sorted * 2, unsorted);
+}
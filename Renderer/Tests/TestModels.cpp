@@ -0,0 +1,33 @@
+#include "assimp/Importer.hpp"
+#include "assimp/scene.h"
+#include "assimp/postprocess.h"
+
+#include "TestModels.h"
+
+std::vector<TestMesh> LoadTestModel(const std::string& path)
+{
+	Assimp::Importer importer;
+	const aiScene* scene = importer.ReadFile(std::string(RENDERER_TEST_MODELS_DIR) + "/" + path,
+		aiProcess_Triangulate | aiProcess_JoinIdenticalVertices | aiProcess_SortByPType);
+
+	std::vector<TestMesh> meshes;
+	if (scene == nullptr) return meshes;
+
+	for (unsigned int i = 0; i < scene->mNumMeshes; i++)
+	{
+		const aiMesh* mesh = scene->mMeshes[i];
+		TestMesh result;
+		for (unsigned int vertex = 0; vertex < mesh->mNumVertices; vertex++)
+			result.positions.insert(result.positions.end(), { mesh->mVertices[vertex].x, mesh->mVertices[vertex].y, mesh->mVertices[vertex].z });
+
+		for (unsigned int face = 0; face < mesh->mNumFaces; face++)
+		{
+			if (mesh->mFaces[face].mNumIndices != 3) continue;
+			result.indices.insert(result.indices.end(), mesh->mFaces[face].mIndices, mesh->mFaces[face].mIndices + 3);
+		}
+
+		if (!result.indices.empty()) meshes.push_back(std::move(result));
+	}
+
+	return meshes;
+}
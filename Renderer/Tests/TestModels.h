@@ -0,0 +1,16 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// A triangle mesh out of one of Assimp's test models, as positions and a triangle list
+struct TestMesh
+{
+	std::vector<float> positions;
+	std::vector<unsigned int> indices;
+
+	size_t GetVertexCount() const { return positions.size() / 3; }
+};
+
+// Every mesh with triangles in a file under Assimp/test/models, triangulated and with identical vertices joined.
+// Vertices that only share a position, like those along a UV seam, stay apart. Empty if the file can't be read
+std::vector<TestMesh> LoadTestModel(const std::string& path);
@@ -0,0 +1,52 @@
+#include <random>
+
+#include "Benchmark.h"
+
+#include "Scene/TransformStore.h"
+
+// A hundred thousand objects scattered around, every one of them rotated and with bounds
+TEST(TransformStoreBenchmark, Update)
+{
+	constexpr size_t Count = 100000;
+
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> position(-500.f, 500.f), angle(-3.14f, 3.14f), size(0.1f, 10.f);
+	TransformStore store;
+	std::vector<TransformHandle> handles(Count);
+	for (auto& handle : handles)
+	{
+		handle = store.Create();
+		store.SetPosition(handle, position(random), position(random), position(random));
+		store.SetRotation(handle, angle(random), angle(random), angle(random));
+		float min[3] = { -size(random), -size(random), -size(random) }, max[3] = { size(random), size(random), size(random) };
+		store.SetBounds(handle, min, max);
+	}
+
+	TransformMatrix viewProjection = {};
+	for (int i = 0; i < 4; i++) viewProjection.m[i][i] = 1.f;
+	store.Update(viewProjection);
+
+	// The camera moved, so every matrix is rebuilt
+	Benchmark("100k, camera moved", [&]()
+	{
+		viewProjection.m[3][0] += 1.f;
+		store.Update(viewProjection);
+	});
+
+	// One object in a hundred moved, spread out so most groups of four have one
+	Benchmark("100k, 1% moved", [&]()
+	{
+		for (size_t i = 0; i < Count; i += 100) store.SetPosition(handles[i], position(random), position(random), position(random));
+		store.Update(viewProjection);
+	});
+
+	// As above, but turned as well, so their sines and cosines are evaluated again
+	Benchmark("100k, 1% turned", [&]()
+	{
+		for (size_t i = 0; i < Count; i += 100) store.SetRotation(handles[i], angle(random), angle(random), angle(random));
+		store.Update(viewProjection);
+	});
+
+	Benchmark("100k, nothing changed", [&]() { store.Update(viewProjection); });
+	EXPECT_EQ(Count, store.GetSize());
+}
@@ -0,0 +1,235 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+#include "gtest/gtest.h"
+
+#include "Scene/TransformStore.h"
+
+namespace
+{
+	struct Transform
+	{
+		float position[3];
+		float rotation[3];
+		float min[3], max[3];
+	};
+
+	Transform MakeTransform(std::mt19937& random)
+	{
+		auto uniform = [&](float min, float max) { return std::uniform_real_distribution<float>(min, max)(random); };
+		Transform transform;
+		for (int i = 0; i < 3; i++)
+		{
+			transform.position[i] = uniform(-100.f, 100.f);
+			transform.rotation[i] = uniform(-6.3f, 6.3f);
+			transform.min[i] = uniform(-5.f, 1.f);
+			transform.max[i] = transform.min[i] + uniform(0.f, 5.f);
+		}
+		return transform;
+	}
+
+	void Set(TransformStore& store, TransformHandle handle, const Transform& transform)
+	{
+		store.SetPosition(handle, transform.position[0], transform.position[1], transform.position[2]);
+		store.SetRotation(handle, transform.rotation[0], transform.rotation[1], transform.rotation[2]);
+		store.SetBounds(handle, transform.min, transform.max);
+	}
+
+	TransformMatrix MakeMatrix(std::mt19937& random)
+	{
+		TransformMatrix matrix;
+		for (auto& row : matrix.m)
+		{
+			for (float& value : row) value = std::uniform_real_distribution<float>(-2.f, 2.f)(random);
+		}
+		return matrix;
+	}
+
+	// Rotation * translation in double precision, with the rotation built like XMMatrixRotationRollPitchYaw,
+	// roll around z, then pitch around x, then yaw around y
+	void GetWorld(const Transform& transform, double world[4][4])
+	{
+		double sp = std::sin((double) transform.rotation[0]), cp = std::cos((double) transform.rotation[0]);
+		double sy = std::sin((double) transform.rotation[1]), cy = std::cos((double) transform.rotation[1]);
+		double sr = std::sin((double) transform.rotation[2]), cr = std::cos((double) transform.rotation[2]);
+		double roll[3][3] = { { cr, sr, 0.0 }, { -sr, cr, 0.0 }, { 0.0, 0.0, 1.0 } };
+		double pitch[3][3] = { { 1.0, 0.0, 0.0 }, { 0.0, cp, sp }, { 0.0, -sp, cp } };
+		double yaw[3][3] = { { cy, 0.0, -sy }, { 0.0, 1.0, 0.0 }, { sy, 0.0, cy } };
+
+		double rollPitch[3][3] = {};
+		for (int row = 0; row < 3; row++)
+		{
+			for (int column = 0; column < 3; column++)
+			{
+				for (int i = 0; i < 3; i++) rollPitch[row][column] += roll[row][i] * pitch[i][column];
+			}
+		}
+
+		for (int row = 0; row < 4; row++)
+		{
+			for (int column = 0; column < 4; column++)
+			{
+				double value = row == 3 ? (column < 3 ? (double) transform.position[column] : 1.0) : 0.0;
+				if (row < 3 && column < 3)
+				{
+					for (int i = 0; i < 3; i++) value += rollPitch[row][i] * yaw[i][column];
+				}
+				world[row][column] = value;
+			}
+		}
+	}
+
+	// Checks the matrices and world bounds of a transform against ones worked out from scratch
+	void ExpectMatches(const TransformStore& store, TransformHandle handle, size_t slot, const Transform& transform, const TransformMatrix& viewProjection)
+	{
+		double world[4][4];
+		GetWorld(transform, world);
+
+		const TransformMatrix& storedWorld = store.GetWorld(handle);
+		const TransformMatrix& storedWvp = store.GetWorldViewProjection(handle);
+		for (int row = 0; row < 4; row++)
+		{
+			for (int column = 0; column < 4; column++)
+			{
+				EXPECT_NEAR(world[row][column], storedWorld.m[row][column], 1e-4) << row << ", " << column;
+
+				double wvp = 0.0, scale = 0.0;
+				for (int i = 0; i < 4; i++)
+				{
+					wvp += world[row][i] * viewProjection.m[i][column];
+					scale += std::fabs(world[row][i] * viewProjection.m[i][column]);
+				}
+				EXPECT_NEAR(wvp, storedWvp.m[row][column], 1e-5 * scale + 1e-6) << row << ", " << column;
+			}
+		}
+
+		// The smallest box around the eight corners of the local box
+		double min[3] = { INFINITY, INFINITY, INFINITY }, max[3] = { -INFINITY, -INFINITY, -INFINITY };
+		for (int corner = 0; corner < 8; corner++)
+		{
+			double local[3] = { corner & 1 ? transform.max[0] : transform.min[0], corner & 2 ? transform.max[1] : transform.min[1], corner & 4 ? transform.max[2] : transform.min[2] };
+			for (int column = 0; column < 3; column++)
+			{
+				double value = world[3][column] + local[0] * world[0][column] + local[1] * world[1][column] + local[2] * world[2][column];
+				min[column] = std::min(min[column], value);
+				max[column] = std::max(max[column], value);
+			}
+		}
+
+		WorldBounds bounds = store.GetWorldBounds();
+		for (int axis = 0; axis < 3; axis++)
+		{
+			EXPECT_NEAR((min[axis] + max[axis]) * 0.5, bounds.center[axis][slot], 1e-4) << axis;
+			EXPECT_NEAR((max[axis] - min[axis]) * 0.5, bounds.extent[axis][slot], 1e-4) << axis;
+		}
+	}
+}
+
+TEST(TransformStore, MatchesReference)
+{
+	std::mt19937 random(1);
+	TransformStore store;
+	std::vector<TransformHandle> handles;
+	std::vector<Transform> transforms;
+
+	// Enough for a partial group at the end
+	for (int i = 0; i < 101; i++)
+	{
+		handles.push_back(store.Create());
+		transforms.push_back(MakeTransform(random));
+		Set(store, handles.back(), transforms.back());
+	}
+
+	TransformMatrix viewProjection = MakeMatrix(random);
+	store.Update(viewProjection);
+	for (size_t i = 0; i < handles.size(); i++) ExpectMatches(store, handles[i], i, transforms[i], viewProjection);
+
+	// Only a few of them move, the rest have to stay as they were
+	for (size_t i = 0; i < handles.size(); i += 7)
+	{
+		transforms[i] = MakeTransform(random);
+		Set(store, handles[i], transforms[i]);
+	}
+	store.Update(viewProjection);
+	for (size_t i = 0; i < handles.size(); i++) ExpectMatches(store, handles[i], i, transforms[i], viewProjection);
+
+	// Nothing moves but the camera
+	viewProjection = MakeMatrix(random);
+	store.Update(viewProjection);
+	for (size_t i = 0; i < handles.size(); i++) ExpectMatches(store, handles[i], i, transforms[i], viewProjection);
+}
+
+TEST(TransformStore, DestroyKeepsHandles)
+{
+	std::mt19937 random(2);
+	TransformStore store;
+	std::vector<TransformHandle> handles;
+	std::vector<Transform> transforms;
+	// The owners point into it
+	transforms.reserve(64);
+	for (int i = 0; i < 64; i++)
+	{
+		handles.push_back(store.Create());
+		transforms.push_back(MakeTransform(random));
+		Set(store, handles.back(), transforms.back());
+		store.SetOwner(handles.back(), &transforms.back());
+	}
+
+	// Every other one from the front, so the last ones are moved into the holes
+	for (size_t i = 0; i < handles.size(); i += 2) store.Destroy(handles[i]);
+	EXPECT_EQ(32u, store.GetSize());
+
+	TransformMatrix viewProjection = MakeMatrix(random);
+	store.Update(viewProjection);
+	for (size_t slot = 0; slot < store.GetSize(); slot++)
+	{
+		// The owners say which transform ended up in which slot
+		auto* transform = (const Transform*) store.GetOwner(slot);
+		size_t i = transform - transforms.data();
+		ASSERT_EQ(1u, i % 2);
+		ExpectMatches(store, handles[i], slot, *transform, viewProjection);
+
+		float position[3];
+		store.GetPosition(handles[i], position[0], position[1], position[2]);
+		EXPECT_EQ(0, memcmp(position, transform->position, sizeof(position)));
+	}
+
+	// Freed handles are handed out again
+	TransformHandle reused = store.Create();
+	EXPECT_EQ(0u, reused % 2);
+	EXPECT_LT(reused, 64u);
+}
+
+TEST(TransformStore, Clone)
+{
+	std::mt19937 random(3);
+	TransformStore store;
+	Transform transform = MakeTransform(random);
+	TransformHandle source = store.Create();
+	Set(store, source, transform);
+	store.SetOwner(source, &transform);
+
+	// Enough clones that the arrays grow under the source
+	TransformMatrix viewProjection = MakeMatrix(random);
+	std::vector<TransformHandle> clones;
+	for (int i = 0; i < 20; i++) clones.push_back(store.Clone(i % 2 ? clones.back() : source));
+	store.Update(viewProjection);
+
+	for (TransformHandle clone : clones)
+	{
+		// Copies don't take the owner along
+		ASSERT_NE(source, clone);
+		size_t slot = &store.GetWorld(clone) - &store.GetWorld(source);
+		EXPECT_EQ(nullptr, store.GetOwner(slot));
+		ExpectMatches(store, clone, slot, transform, viewProjection);
+	}
+
+	// Moving the copy leaves the original where it was
+	Transform moved = MakeTransform(random);
+	Set(store, clones[0], moved);
+	store.Update(viewProjection);
+	ExpectMatches(store, source, 0, transform, viewProjection);
+	ExpectMatches(store, clones[0], 1, moved, viewProjection);
+}
@@ -0,0 +1,37 @@
+#include <unordered_map>
+
+#include "gtest/gtest.h"
+
+#include "Primitives/VertexLayout.h"
+
+TEST(VertexLayout, ComparesElements)
+{
+	VertexLayout layout = { { "POSITION", ElementDataType::float3 }, { "NORMAL", ElementDataType::snorm16x2 } };
+	EXPECT_EQ(layout, VertexLayout({ { "POSITION", ElementDataType::float3 }, { "NORMAL", ElementDataType::snorm16x2 } }));
+	EXPECT_EQ(16u, layout.stride);
+
+	EXPECT_NE(layout, VertexLayout({ { "POSITION", ElementDataType::float3 }, { "NORMAL", ElementDataType::half2 } }));
+	EXPECT_NE(layout, VertexLayout({ { "POSITION", ElementDataType::float3 }, { "NORMAL", ElementDataType::snorm16x2, 1 } }));
+	EXPECT_NE(layout, VertexLayout({ { "POSITION", ElementDataType::float3 }, { "NORMAL", ElementDataType::snorm16x2, 0, true } }));
+	EXPECT_NE(layout, VertexLayout({ { "NORMAL", ElementDataType::snorm16x2 }, { "POSITION", ElementDataType::float3 } }));
+	EXPECT_NE(layout, VertexLayout({ { "POSITION", ElementDataType::float3 } }));
+	EXPECT_EQ(VertexLayout{}, VertexLayout{});
+}
+
+TEST(VertexLayout, HashCollisions)
+{
+	// Same hash and stride, different elements, a collision like this must not make them the same layout
+	VertexLayout a = { { "COLOR", ElementDataType::unorm8x4 } };
+	VertexLayout b = { { "TEXCOORD", ElementDataType::half2 } };
+	b.hash = a.hash;
+	ASSERT_EQ(a.stride, b.stride);
+	EXPECT_NE(a, b);
+
+	// Both get a slot of their own as keys
+	std::unordered_map<VertexLayout, int, VertexLayoutHasher> layouts;
+	layouts[a] = 1;
+	layouts[b] = 2;
+	EXPECT_EQ(2u, layouts.size());
+	EXPECT_EQ(1, layouts[a]);
+	EXPECT_EQ(2, layouts[b]);
+}
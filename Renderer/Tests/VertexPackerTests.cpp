@@ -0,0 +1,103 @@
+#include <cmath>
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+#include "Scene/VertexPacker.h"
+
+namespace
+{
+	Vertex MakeVertex(float position, float color, float texcoord)
+	{
+		Vertex vertex;
+		vertex.position = { position, position + 1.f, position + 2.f };
+		vertex.normal = { 0.f, 1.f, 0.f };
+		vertex.color = { color, color, color, 1.f };
+		vertex.texcoord = { texcoord, 1.f - texcoord };
+		return vertex;
+	}
+
+	ElementDataType GetType(const VertexLayout& layout, const char* semantic)
+	{
+		for (auto& element : layout.elements)
+		{
+			if (element.semantic == semantic) return element.type;
+		}
+
+		ADD_FAILURE() << "no " << semantic;
+		return ElementDataType::float1;
+	}
+}
+
+TEST(VertexPacker, LeavesOutMissingAttributes)
+{
+	std::vector<Vertex> vertices = { MakeVertex(0.f, 0.5f, 0.25f), MakeVertex(1.f, 1.f, 0.75f) };
+	const char* semantics[] = { "NORMAL", "COLOR", "TEXCOORD" };
+
+	for (uint32_t attributes = 0; attributes <= VertexAllAttributes; attributes++)
+	{
+		VertexLayout layout = VertexPacker::ChooseLayout(vertices, attributes);
+		EXPECT_EQ(attributes, VertexPacker::GetAttributes(layout));
+
+		// The position always comes first, then whatever the mesh has in a fixed order
+		ASSERT_FALSE(layout.elements.empty());
+		EXPECT_EQ("POSITION", layout.elements[0].semantic);
+		size_t next = 1;
+		for (uint32_t attribute = 0; attribute < 3; attribute++)
+		{
+			if (!(attributes & (1u << attribute))) continue;
+			ASSERT_LT(next, layout.elements.size()) << attributes;
+			EXPECT_EQ(semantics[attribute], layout.elements[next++].semantic) << attributes;
+		}
+		EXPECT_EQ(next, layout.elements.size()) << attributes;
+	}
+
+	// Positions alone are all a mesh without anything else needs
+	EXPECT_EQ(12u, VertexPacker::ChooseLayout(vertices, 0).stride);
+	EXPECT_EQ(24u, VertexPacker::ChooseLayout(vertices, VertexAllAttributes).stride);
+}
+
+TEST(VertexPacker, NarrowestFormats)
+{
+	std::vector<Vertex> vertices = { MakeVertex(0.f, 0.5f, 0.25f), MakeVertex(1.f, 1.f, 0.75f) };
+	VertexLayout layout = VertexPacker::ChooseLayout(vertices, VertexAllAttributes);
+	EXPECT_EQ(ElementDataType::float3, GetType(layout, "POSITION"));
+	EXPECT_EQ(ElementDataType::snorm16x2, GetType(layout, "NORMAL"));
+	EXPECT_EQ(ElementDataType::unorm8x4, GetType(layout, "COLOR"));
+	EXPECT_EQ(ElementDataType::unorm16x2, GetType(layout, "TEXCOORD"));
+
+	vertices.push_back(MakeVertex(2.f, 1.5f, -0.5f));
+	layout = VertexPacker::ChooseLayout(vertices, VertexAllAttributes);
+	EXPECT_EQ(ElementDataType::half4, GetType(layout, "COLOR"));
+	EXPECT_EQ(ElementDataType::half2, GetType(layout, "TEXCOORD"));
+
+	vertices.push_back(MakeVertex(3.f, 0.f, 10.f));
+	EXPECT_EQ(ElementDataType::float2, GetType(VertexPacker::ChooseLayout(vertices, VertexAllAttributes), "TEXCOORD"));
+}
+
+TEST(VertexPacker, PacksOnlyTheLayout)
+{
+	// Positions and texture coordinates, the normal and color the vertices carry are not written anywhere
+	std::vector<Vertex> vertices = { MakeVertex(0.f, 0.5f, 0.25f), MakeVertex(4.f, 1.f, 1.f) };
+	VertexLayout layout = VertexPacker::ChooseLayout(vertices, VertexTexcoord);
+	ASSERT_EQ(16u, layout.stride);
+
+	std::vector<uint8_t> packed;
+	VertexPacker::Pack(layout, vertices, packed);
+	ASSERT_EQ(2 * layout.stride, packed.size());
+
+	for (size_t i = 0; i < vertices.size(); i++)
+	{
+		const uint8_t* vertex = packed.data() + i * layout.stride;
+		float position[3];
+		memcpy(position, vertex, sizeof(position));
+		EXPECT_EQ(vertices[i].position.x, position[0]);
+		EXPECT_EQ(vertices[i].position.y, position[1]);
+		EXPECT_EQ(vertices[i].position.z, position[2]);
+
+		uint16_t texcoord[2];
+		memcpy(texcoord, vertex + sizeof(position), sizeof(texcoord));
+		EXPECT_EQ(std::lround(vertices[i].texcoord.u * 65535.f), texcoord[0]);
+		EXPECT_EQ(std::lround(vertices[i].texcoord.v * 65535.f), texcoord[1]);
+	}
+}